@@ -2,15 +2,125 @@
 #include "Program.h"
 #include "Class.h"
 #include "Modules/ModuleID.h"
+#include <cstddef>
 
-void* ASTExpression::operator new(std::size_t size) {
-	void* ptr = ::operator new(size);
-	Program::GetCompiledProgram()->AddCreatedExpression((ASTExpression*)ptr);
+void* ASTExpression::operator new(std::size_t size, Program* program) {
+	void* ptr = program->GetASTAllocator()->AllocAligned(size, alignof(std::max_align_t));
+	program->AddCreatedExpression((ASTExpression*)ptr);
 	return ptr;
 }
 
+void ASTExpression::operator delete(void* ptr, Program* program) noexcept {
+	// Memory belongs to the AST allocator
+}
+
 void ASTExpression::operator delete(void* ptr) noexcept {
-	::operator delete(ptr);
+	// Memory belongs to the AST allocator
+}
+
+static bool IsSignedIntegerLiteral(ASTExpression* expr, int64* value)
+{
+	ASTExpressionLiteral* literal = dynamic_cast<ASTExpressionLiteral*>(expr);
+	if (!literal || literal->value.pointerLevel > 0) return false;
+
+	switch ((ValueType)literal->value.type)
+	{
+	case ValueType::INT8:
+	case ValueType::INT16:
+	case ValueType::INT32:
+	case ValueType::INT64:
+		*value = literal->value.GetInt64();
+		return true;
+	}
+
+	return false;
+}
+
+// Matches conditions of the form local < integer literal, which are emitted as LESS_LOCAL_CONST_JUMP_IF_FALSE
+static ASTExpressionPushLocal* GetLessLocalConstCondition(ASTExpression* conditionExpr, int64* constant)
+{
+	ASTExpressionBinary* binaryExpr = dynamic_cast<ASTExpressionBinary*>(conditionExpr);
+	if (!binaryExpr || binaryExpr->op != Operator::LESS || binaryExpr->functionID != INVALID_ID)
+		return nullptr;
+
+	ASTExpressionPushLocal* localExpr = dynamic_cast<ASTExpressionPushLocal*>(binaryExpr->lhs);
+	if (localExpr && localExpr->typeInfo.pointerLevel == 0 && Value::IsPrimitiveType(localExpr->typeInfo.type) &&
+		IsSignedIntegerLiteral(binaryExpr->rhs, constant))
+	{
+		return localExpr;
+	}
+
+	return nullptr;
+}
+
+// Emits the condition and the jump taken when it is false, returns the position of the jump target to patch
+static uint32 EmitConditionJump(Program* program, ASTExpression* conditionExpr)
+{
+	int64 constant;
+	ASTExpressionPushLocal* localExpr = GetLessLocalConstCondition(conditionExpr, &constant);
+	if (localExpr)
+		return program->AddLessLocalConstJumpIfFalseCommand(localExpr->slot, constant);
+
+	conditionExpr->EmitCode(program);
+	program->WriteOPCode(OpCode::JUMP_IF_FALSE);
+	uint32 jumpIfFalsePos = program->GetCodeSize();
+	program->WriteUInt32(0);
+	return jumpIfFalsePos;
+}
+
+static ScopeUsage GetExprsScopeUsage(Program* program, const std::vector<ASTExpression*>& exprs)
+{
+	ScopeUsage usage = ScopeUsage::NONE;
+	for (uint32 i = 0; i < exprs.size() && usage != ScopeUsage::OBJECTS; i++)
+		usage = MaxScopeUsage(usage, exprs[i]->GetScopeUsage(program));
+
+	return usage;
+}
+
+static ScopeUsage GetConditionScopeUsage(Program* program, ASTExpression* conditionExpr)
+{
+	int64 constant;
+	if (GetLessLocalConstCondition(conditionExpr, &constant))
+		return ScopeUsage::NONE;
+
+	return conditionExpr->GetScopeUsage(program);
+}
+
+static bool HasCastFunctions(const std::vector<uint16>& castFunctionIDs)
+{
+	for (uint32 i = 0; i < castFunctionIDs.size(); i++)
+	{
+		if (castFunctionIDs[i] != INVALID_ID)
+			return true;
+	}
+
+	return false;
+}
+
+// Objects returned by value and arguments converted with a cast function are added to the caller's scope
+static ScopeUsage GetCallScopeUsage(Program* program, const TypeInfo& returnInfo, const std::vector<ASTExpression*>& argExprs, const std::vector<uint16>& castFunctionIDs)
+{
+	if (HasCastFunctions(castFunctionIDs))
+		return ScopeUsage::OBJECTS;
+
+	if (returnInfo.type != (uint16)ValueType::VOID_T && !Value::IsPrimitiveType(returnInfo.type) && returnInfo.pointerLevel == 0)
+		return ScopeUsage::OBJECTS;
+
+	return MaxScopeUsage(ScopeUsage::ALLOCATES, GetExprsScopeUsage(program, argExprs));
+}
+
+static void EmitPushScope(Program* program, ScopeUsage usage)
+{
+	if (usage != ScopeUsage::NONE)
+		program->WriteOPCode(OpCode::PUSH_SCOPE);
+}
+
+static void EmitPopScope(Program* program, ScopeUsage usage)
+{
+	if (usage == ScopeUsage::OBJECTS)
+		program->WriteOPCode(OpCode::POP_SCOPE);
+	else if (usage == ScopeUsage::ALLOCATES)
+		program->WriteOPCode(OpCode::POP_MARKER_SCOPE);
 }
 
 void ASTExpressionLiteral::EmitCode(Program* program)
@@ -54,9 +164,19 @@ TypeInfo ASTExpressionLiteral::GetTypeInfo(Program* program)
 	return TypeInfo(value.type, value.pointerLevel);
 }
 
+ScopeUsage ASTExpressionLiteral::GetScopeUsage(Program* program)
+{
+	return ScopeUsage::ALLOCATES;
+}
+
+bool ASTExpressionLiteral::IsTemporary(Program* program)
+{
+	return value.pointerLevel == 0 && Value::IsPrimitiveType(value.type);
+}
+
 ASTExpression* ASTExpressionLiteral::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
-	return new ASTExpressionLiteral(value, isStatement);
+	return new (program) ASTExpressionLiteral(value, isStatement);
 }
 
 void ASTExpressionConstUInt32::EmitCode(Program* program)
@@ -69,9 +189,35 @@ TypeInfo ASTExpressionConstUInt32::GetTypeInfo(Program* program)
 	return TypeInfo((uint16)ValueType::UINT32, 0);
 }
 
+ScopeUsage ASTExpressionConstUInt32::GetScopeUsage(Program* program)
+{
+	return ScopeUsage::ALLOCATES;
+}
+
 ASTExpression* ASTExpressionConstUInt32::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
-	return new ASTExpressionConstUInt32(value, isStatement);
+	return new (program) ASTExpressionConstUInt32(value, isStatement);
+}
+
+void ASTExpressionTemplateInteger::EmitCode(Program* program)
+{
+	program->AddPushConstantUInt32Command(0);
+}
+
+TypeInfo ASTExpressionTemplateInteger::GetTypeInfo(Program* program)
+{
+	return TypeInfo((uint16)ValueType::UINT32, 0);
+}
+
+ScopeUsage ASTExpressionTemplateInteger::GetScopeUsage(Program* program)
+{
+	return ScopeUsage::ALLOCATES;
+}
+
+ASTExpression* ASTExpressionTemplateInteger::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
+{
+	uint32 index = cls->InstantiateTemplateGetIndex(program, name);
+	return new (program) ASTExpressionConstUInt32(instantiation.args[index].value, isStatement);
 }
 
 void ASTExpressionModuleFunctionCall::EmitCode(Program* program)
@@ -81,12 +227,32 @@ void ASTExpressionModuleFunctionCall::EmitCode(Program* program)
 		argExprs[i]->EmitCode(program);
 	}
 
+	const NativeFunctionDesc* native = Module::GetNativeFunction(program, moduleID, functionID);
+	if (native && native->numParameters == argExprs.size())
+	{
+		// A temporary first argument is popped anyway, the result can take over its storage
+		bool reuseFirstArg = !isStatement && native->returnType != NativeType::VOID_T && !argExprs.empty() && argExprs[0]->IsTemporary(program);
+		program->AddNativeCallCommand(native, !isStatement, reuseFirstArg);
+		return;
+	}
+
 	program->AddModuleFunctionCallCommand(moduleID, functionID, argExprs.size(), !isStatement);
 }
 
 TypeInfo ASTExpressionModuleFunctionCall::GetTypeInfo(Program* program)
 {
-	return Module::GetFunctionReturnInfo(moduleID, functionID);
+	return Module::GetFunctionReturnInfo(program, moduleID, functionID);
+}
+
+ScopeUsage ASTExpressionModuleFunctionCall::GetScopeUsage(Program* program)
+{
+	return MaxScopeUsage(ScopeUsage::ALLOCATES, GetExprsScopeUsage(program, argExprs));
+}
+
+bool ASTExpressionModuleFunctionCall::IsTemporary(Program* program)
+{
+	const NativeFunctionDesc* native = Module::GetNativeFunction(program, moduleID, functionID);
+	return native && native->numParameters == argExprs.size();
 }
 
 ASTExpression* ASTExpressionModuleFunctionCall::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
@@ -95,7 +261,7 @@ ASTExpression* ASTExpressionModuleFunctionCall::InjectTemplateType(Program* prog
 	for (uint32 i = 0; i < argExprs.size(); i++)
 		injectedArgExprs.push_back(argExprs[i]->InjectTemplateType(program, cls, instantiation, templatedClass));
 
-	return new ASTExpressionModuleFunctionCall(moduleID, functionID, injectedArgExprs, isStatement);
+	return new (program) ASTExpressionModuleFunctionCall(moduleID, functionID, injectedArgExprs, isStatement);
 }
 
 void ASTExpressionDeclarePrimitive::EmitCode(Program* program)
@@ -131,10 +297,15 @@ TypeInfo ASTExpressionDeclarePrimitive::GetTypeInfo(Program* program)
 	return TypeInfo((uint16)type, 0);
 }
 
+ScopeUsage ASTExpressionDeclarePrimitive::GetScopeUsage(Program* program)
+{
+	return assignExpr ? MaxScopeUsage(ScopeUsage::ALLOCATES, assignExpr->GetScopeUsage(program)) : ScopeUsage::ALLOCATES;
+}
+
 ASTExpression* ASTExpressionDeclarePrimitive::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
 	ASTExpression* injectedAssignExpr = assignExpr ? assignExpr->InjectTemplateType(program, cls, instantiation, templatedClass) : nullptr;
-	return new ASTExpressionDeclarePrimitive(type, slot, injectedAssignExpr, isStatement);
+	return new (program) ASTExpressionDeclarePrimitive(type, slot, injectedAssignExpr, isStatement);
 }
 
 void ASTExpressionPushLocal::EmitCode(Program* program)
@@ -147,6 +318,11 @@ TypeInfo ASTExpressionPushLocal::GetTypeInfo(Program* program)
 	return typeInfo;
 }
 
+ScopeUsage ASTExpressionPushLocal::GetScopeUsage(Program* program)
+{
+	return ScopeUsage::NONE;
+}
+
 ASTExpression* ASTExpressionPushLocal::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
 	TypeInfo injectedTypeInfo = typeInfo;
@@ -166,7 +342,7 @@ ASTExpression* ASTExpressionPushLocal::InjectTemplateType(Program* program, Clas
 	if (slot == INVALID_ID)
 		uint32 bp = 0;
 
-	return new ASTExpressionPushLocal(slot, injectedTypeInfo, "", nullptr, isStatement);
+	return new (program) ASTExpressionPushLocal(slot, injectedTypeInfo, "", nullptr, isStatement);
 }
 
 void ASTExpressionDeclarePointer::EmitCode(Program* program)
@@ -188,6 +364,11 @@ TypeInfo ASTExpressionDeclarePointer::GetTypeInfo(Program* program)
 	return TypeInfo(type, pointerLevel);
 }
 
+ScopeUsage ASTExpressionDeclarePointer::GetScopeUsage(Program* program)
+{
+	return assignExpr ? MaxScopeUsage(ScopeUsage::ALLOCATES, assignExpr->GetScopeUsage(program)) : ScopeUsage::ALLOCATES;
+}
+
 ASTExpression* ASTExpressionDeclarePointer::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
 	uint16 injectedType = type;
@@ -205,7 +386,7 @@ ASTExpression* ASTExpressionDeclarePointer::InjectTemplateType(Program* program,
 	}
 
 	ASTExpression* injectedAssignExpr = assignExpr ? assignExpr->InjectTemplateType(program, cls, instantiation, templatedClass) : nullptr;
-	return new ASTExpressionDeclarePointer(injectedType, injectedPointerLevel, slot, injectedAssignExpr, "", nullptr, isStatement);
+	return new (program) ASTExpressionDeclarePointer(injectedType, injectedPointerLevel, slot, injectedAssignExpr, "", nullptr, isStatement);
 }
 
 void ASTExpressionSet::EmitCode(Program* program)
@@ -226,6 +407,14 @@ TypeInfo ASTExpressionSet::GetTypeInfo(Program* program)
 	return expr->GetTypeInfo(program);
 }
 
+ScopeUsage ASTExpressionSet::GetScopeUsage(Program* program)
+{
+	if (assignFunctionID != INVALID_ID)
+		return ScopeUsage::OBJECTS;
+
+	return MaxScopeUsage(expr->GetScopeUsage(program), assignExpr->GetScopeUsage(program));
+}
+
 bool ASTExpressionSet::Resolve(Program* program)
 {
 	TypeInfo exprTypeInfo = expr->GetTypeInfo(program);
@@ -235,7 +424,7 @@ bool ASTExpressionSet::Resolve(Program* program)
 	Class* cls = program->GetClass(exprTypeInfo.type);
 	std::vector<ASTExpression*> argExprs;
 	argExprs.push_back(assignExpr);
-	assignFunctionID = cls->GetFunctionID("operator=", argExprs, castFunctionIDs, true);
+	assignFunctionID = cls->GetFunctionID(program, "operator=", argExprs, castFunctionIDs, true);
 
 	return true;
 }
@@ -244,7 +433,7 @@ ASTExpression* ASTExpressionSet::InjectTemplateType(Program* program, Class* cls
 {
 	ASTExpression* injectedExpr = expr->InjectTemplateType(program, cls, instantiation, templatedClass);
 	ASTExpression* injectedAssignExpr = assignExpr->InjectTemplateType(program, cls, instantiation, templatedClass);
-	return new ASTExpressionSet(injectedExpr, injectedAssignExpr, isStatement);
+	return new (program) ASTExpressionSet(injectedExpr, injectedAssignExpr, isStatement);
 }
 
 void ASTExpressionAddressOf::EmitCode(Program* program)
@@ -261,10 +450,15 @@ TypeInfo ASTExpressionAddressOf::GetTypeInfo(Program* program)
 	return typeInfo;
 }
 
+ScopeUsage ASTExpressionAddressOf::GetScopeUsage(Program* program)
+{
+	return MaxScopeUsage(ScopeUsage::ALLOCATES, expr->GetScopeUsage(program));
+}
+
 ASTExpression* ASTExpressionAddressOf::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
 	ASTExpression* injectedExpr = expr->InjectTemplateType(program, cls, instantiation, templatedClass);
-	return new ASTExpressionAddressOf(injectedExpr, isStatement);
+	return new (program) ASTExpressionAddressOf(injectedExpr, isStatement);
 }
 
 void ASTExpressionDereference::EmitCode(Program* program)
@@ -281,10 +475,15 @@ TypeInfo ASTExpressionDereference::GetTypeInfo(Program* program)
 	return typeInfo;
 }
 
+ScopeUsage ASTExpressionDereference::GetScopeUsage(Program* program)
+{
+	return expr->GetScopeUsage(program);
+}
+
 ASTExpression* ASTExpressionDereference::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
 	ASTExpression* injectedExpr = expr->InjectTemplateType(program, cls, instantiation, templatedClass);
-	return new ASTExpressionDereference(injectedExpr, isStatement);
+	return new (program) ASTExpressionDereference(injectedExpr, isStatement);
 }
 
 void ASTExpressionStackArrayDeclare::EmitCode(Program* program)
@@ -306,6 +505,14 @@ TypeInfo ASTExpressionStackArrayDeclare::GetTypeInfo(Program* program)
 	return TypeInfo(type, 1);
 }
 
+ScopeUsage ASTExpressionStackArrayDeclare::GetScopeUsage(Program* program)
+{
+	if (!Value::IsPrimitiveType(type) && elementPointerLevel == 0)
+		return ScopeUsage::OBJECTS;
+
+	return MaxScopeUsage(ScopeUsage::ALLOCATES, GetExprsScopeUsage(program, initializerExprs));
+}
+
 ASTExpression* ASTExpressionStackArrayDeclare::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
 	uint16 injectedType = type;
@@ -336,7 +543,7 @@ ASTExpression* ASTExpressionStackArrayDeclare::InjectTemplateType(Program* progr
 	for (uint32 i = 0; i < initializerExprs.size(); i++)
 		injectedInitialzeExprs.push_back(initializerExprs[i]->InjectTemplateType(program, cls, instantiation, templatedClass));
 
-	return new ASTExpressionStackArrayDeclare(injectedType, injectedPointerLevel, slot, injectedDimensions, injectedInitialzeExprs, "", isStatement);
+	return new (program) ASTExpressionStackArrayDeclare(injectedType, injectedPointerLevel, slot, injectedDimensions, injectedInitialzeExprs, "", isStatement);
 }
 
 void ASTExpressionPushIndex::EmitCode(Program* program)
@@ -362,7 +569,7 @@ TypeInfo ASTExpressionPushIndex::GetTypeInfo(Program* program)
 	if (!Value::IsPrimitiveType(typeInfo.type) && typeInfo.pointerLevel == 0)
 	{
 		Class* cls = program->GetClass(typeInfo.type);
-		indexFunctionID = indexFunctionID == INVALID_ID ? cls->GetFunctionID("operator[]", indexExprs, castFunctionIDs) : indexFunctionID;
+		indexFunctionID = indexFunctionID == INVALID_ID ? cls->GetFunctionID(program, "operator[]", indexExprs, castFunctionIDs) : indexFunctionID;
 
 		if(indexFunctionID != INVALID_ID)
 		{
@@ -376,6 +583,14 @@ TypeInfo ASTExpressionPushIndex::GetTypeInfo(Program* program)
 	return typeInfo;
 }
 
+ScopeUsage ASTExpressionPushIndex::GetScopeUsage(Program* program)
+{
+	if (indexFunctionID != INVALID_ID)
+		return ScopeUsage::OBJECTS;
+
+	return MaxScopeUsage(expr->GetScopeUsage(program), GetExprsScopeUsage(program, indexExprs));
+}
+
 ASTExpression* ASTExpressionPushIndex::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
 	ASTExpression* injectedExpr = expr->InjectTemplateType(program, cls, instantiation, templatedClass);
@@ -383,7 +598,7 @@ ASTExpression* ASTExpressionPushIndex::InjectTemplateType(Program* program, Clas
 	for (uint32 i = 0; i < indexExprs.size(); i++)
 		injectedIndexExprs.push_back(indexExprs[i]->InjectTemplateType(program, cls, instantiation, templatedClass));
 
-	return new ASTExpressionPushIndex(injectedExpr, injectedIndexExprs, isStatement);
+	return new (program) ASTExpressionPushIndex(injectedExpr, injectedIndexExprs, isStatement);
 }
 
 bool ASTExpressionPushIndex::Resolve(Program* program)
@@ -392,7 +607,7 @@ bool ASTExpressionPushIndex::Resolve(Program* program)
 	if (Value::IsPrimitiveType(typeInfo.type) || typeInfo.pointerLevel > 0) return true;
 
 	Class* cls = program->GetClass(typeInfo.type);
-	indexFunctionID = indexFunctionID == INVALID_ID ? cls->GetFunctionID("operator[]", indexExprs, castFunctionIDs) : indexFunctionID;
+	indexFunctionID = indexFunctionID == INVALID_ID ? cls->GetFunctionID(program, "operator[]", indexExprs, castFunctionIDs) : indexFunctionID;
 }
 
 void ASTExpressionBinary::EmitCode(Program* program)
@@ -433,17 +648,17 @@ TypeInfo ASTExpressionBinary::GetTypeInfo(Program* program)
 		{
 			switch (op)
 			{
-			case Operator::ADD:		functionID = cls->GetFunctionID("operator+", args, castFunctioIDs); break;
-			case Operator::MINUS:	functionID = cls->GetFunctionID("operator-", args, castFunctioIDs); break;
-			case Operator::MULTIPLY: functionID = cls->GetFunctionID("operator*", args, castFunctioIDs); break;
-			case Operator::DIVIDE:	functionID = cls->GetFunctionID("operator/", args, castFunctioIDs); break;
-			case Operator::MOD:		functionID = cls->GetFunctionID("operator%", args, castFunctioIDs); break;
-			case Operator::EQUALS:		functionID = cls->GetFunctionID("operator==", args, castFunctioIDs); break;
-			case Operator::NOT_EQUALS:		functionID = cls->GetFunctionID("operator!=", args, castFunctioIDs); break;
-			case Operator::LESS:		functionID = cls->GetFunctionID("operator<", args, castFunctioIDs); break;
-			case Operator::GREATER:		functionID = cls->GetFunctionID("operator>", args, castFunctioIDs); break;
-			case Operator::LESS_EQUALS:		functionID = cls->GetFunctionID("operator<=", args, castFunctioIDs); break;
-			case Operator::GREATER_EQUALS:		functionID = cls->GetFunctionID("operator>=", args, castFunctioIDs); break;
+			case Operator::ADD:		functionID = cls->GetFunctionID(program, "operator+", args, castFunctioIDs); break;
+			case Operator::MINUS:	functionID = cls->GetFunctionID(program, "operator-", args, castFunctioIDs); break;
+			case Operator::MULTIPLY: functionID = cls->GetFunctionID(program, "operator*", args, castFunctioIDs); break;
+			case Operator::DIVIDE:	functionID = cls->GetFunctionID(program, "operator/", args, castFunctioIDs); break;
+			case Operator::MOD:		functionID = cls->GetFunctionID(program, "operator%", args, castFunctioIDs); break;
+			case Operator::EQUALS:		functionID = cls->GetFunctionID(program, "operator==", args, castFunctioIDs); break;
+			case Operator::NOT_EQUALS:		functionID = cls->GetFunctionID(program, "operator!=", args, castFunctioIDs); break;
+			case Operator::LESS:		functionID = cls->GetFunctionID(program, "operator<", args, castFunctioIDs); break;
+			case Operator::GREATER:		functionID = cls->GetFunctionID(program, "operator>", args, castFunctioIDs); break;
+			case Operator::LESS_EQUALS:		functionID = cls->GetFunctionID(program, "operator<=", args, castFunctioIDs); break;
+			case Operator::GREATER_EQUALS:		functionID = cls->GetFunctionID(program, "operator>=", args, castFunctioIDs); break;
 			}
 		}
 
@@ -456,6 +671,21 @@ TypeInfo ASTExpressionBinary::GetTypeInfo(Program* program)
 	return TypeInfo(INVALID_ID, 0);
 }
 
+ScopeUsage ASTExpressionBinary::GetScopeUsage(Program* program)
+{
+	if (functionID != INVALID_ID)
+		return ScopeUsage::OBJECTS;
+
+	return MaxScopeUsage(ScopeUsage::ALLOCATES, MaxScopeUsage(lhs->GetScopeUsage(program), rhs->GetScopeUsage(program)));
+}
+
+bool ASTExpressionBinary::IsTemporary(Program* program)
+{
+	// Primitive arithmetic and comparisons always allocate their result, pointer arithmetic does not
+	TypeInfo typeInfo = GetTypeInfo(program);
+	return functionID == INVALID_ID && typeInfo.pointerLevel == 0 && Value::IsPrimitiveType(typeInfo.type);
+}
+
 bool ASTExpressionBinary::Resolve(Program* program)
 {
 	TypeInfo lhsType = lhs->GetTypeInfo(program);
@@ -471,17 +701,17 @@ bool ASTExpressionBinary::Resolve(Program* program)
 
 	switch (op)
 	{
-	case Operator::ADD:				functionID = cls->GetFunctionID("operator+", args, castFunctioIDs); break;
-	case Operator::MINUS:			functionID = cls->GetFunctionID("operator-", args, castFunctioIDs); break;
-	case Operator::MULTIPLY:			functionID = cls->GetFunctionID("operator*", args, castFunctioIDs); break;
-	case Operator::DIVIDE:			functionID = cls->GetFunctionID("operator/", args, castFunctioIDs); break;
-	case Operator::MOD:				functionID = cls->GetFunctionID("operator%", args, castFunctioIDs); break;
-	case Operator::EQUALS:			functionID = cls->GetFunctionID("operator==", args, castFunctioIDs); break;
-	case Operator::NOT_EQUALS:		functionID = cls->GetFunctionID("operator!=", args, castFunctioIDs); break;
-	case Operator::LESS:				functionID = cls->GetFunctionID("operator<", args, castFunctioIDs); break;
-	case Operator::GREATER:			functionID = cls->GetFunctionID("operator>", args, castFunctioIDs); break;
-	case Operator::LESS_EQUALS:		functionID = cls->GetFunctionID("operator<=", args, castFunctioIDs); break;
-	case Operator::GREATER_EQUALS:	functionID = cls->GetFunctionID("operator>=", args, castFunctioIDs); break;
+	case Operator::ADD:				functionID = cls->GetFunctionID(program, "operator+", args, castFunctioIDs); break;
+	case Operator::MINUS:			functionID = cls->GetFunctionID(program, "operator-", args, castFunctioIDs); break;
+	case Operator::MULTIPLY:			functionID = cls->GetFunctionID(program, "operator*", args, castFunctioIDs); break;
+	case Operator::DIVIDE:			functionID = cls->GetFunctionID(program, "operator/", args, castFunctioIDs); break;
+	case Operator::MOD:				functionID = cls->GetFunctionID(program, "operator%", args, castFunctioIDs); break;
+	case Operator::EQUALS:			functionID = cls->GetFunctionID(program, "operator==", args, castFunctioIDs); break;
+	case Operator::NOT_EQUALS:		functionID = cls->GetFunctionID(program, "operator!=", args, castFunctioIDs); break;
+	case Operator::LESS:				functionID = cls->GetFunctionID(program, "operator<", args, castFunctioIDs); break;
+	case Operator::GREATER:			functionID = cls->GetFunctionID(program, "operator>", args, castFunctioIDs); break;
+	case Operator::LESS_EQUALS:		functionID = cls->GetFunctionID(program, "operator<=", args, castFunctioIDs); break;
+	case Operator::GREATER_EQUALS:	functionID = cls->GetFunctionID(program, "operator>=", args, castFunctioIDs); break;
 	}
 
 	return true;
@@ -491,24 +721,20 @@ ASTExpression* ASTExpressionBinary::InjectTemplateType(Program* program, Class*
 {
 	ASTExpression* injectedLHS = lhs->InjectTemplateType(program, cls, instantiation, templatedClass);
 	ASTExpression* injectedRHS = rhs->InjectTemplateType(program, cls, instantiation, templatedClass);
-	return new ASTExpressionBinary(injectedLHS, injectedRHS, op, isStatement);
+	return new (program) ASTExpressionBinary(injectedLHS, injectedRHS, op, isStatement);
 }
 
 void ASTExpressionIfElse::EmitCode(Program* program)
 {
-	conditionExpr->EmitCode(program);
-	program->WriteOPCode(OpCode::JUMP_IF_FALSE);
-	uint32 jumpIfFalsePos = program->GetCodeSize();
-	program->WriteUInt32(0);
+	uint32 jumpIfFalsePos = EmitConditionJump(program, conditionExpr);
 
-	if (pushIfScope)
-		program->WriteOPCode(OpCode::PUSH_SCOPE);
+	ScopeUsage ifUsage = pushIfScope ? GetExprsScopeUsage(program, ifExprs) : ScopeUsage::NONE;
+	EmitPushScope(program, ifUsage);
 
 	for (uint32 i = 0; i < ifExprs.size(); i++)
 		ifExprs[i]->EmitCode(program);
 
-	if (pushIfScope)
-		program->WriteOPCode(OpCode::POP_SCOPE);
+	EmitPopScope(program, ifUsage);
 
 	program->WriteOPCode(OpCode::JUMP);
 	uint32 jumpToEndPos = program->GetCodeSize();
@@ -517,14 +743,13 @@ void ASTExpressionIfElse::EmitCode(Program* program)
 	uint32 elseLablePos = program->GetCodeSize();
 	program->PatchUInt32(jumpIfFalsePos, elseLablePos);
 
-	if (pushElseScope)
-		program->WriteOPCode(OpCode::PUSH_SCOPE);
+	ScopeUsage elseUsage = pushElseScope ? GetExprsScopeUsage(program, elseExprs) : ScopeUsage::NONE;
+	EmitPushScope(program, elseUsage);
 
 	for (uint32 i = 0; i < elseExprs.size(); i++)
 		elseExprs[i]->EmitCode(program);
 
-	if (pushElseScope)
-		program->WriteOPCode(OpCode::POP_SCOPE);
+	EmitPopScope(program, elseUsage);
 
 	uint32 endLabelPos = program->GetCodeSize();
 	program->PatchUInt32(jumpToEndPos, endLabelPos);
@@ -535,6 +760,17 @@ TypeInfo ASTExpressionIfElse::GetTypeInfo(Program* program)
 	return TypeInfo(INVALID_ID, 0);
 }
 
+ScopeUsage ASTExpressionIfElse::GetScopeUsage(Program* program)
+{
+	ScopeUsage usage = GetConditionScopeUsage(program, conditionExpr);
+	if (!pushIfScope)
+		usage = MaxScopeUsage(usage, GetExprsScopeUsage(program, ifExprs));
+	if (!pushElseScope)
+		usage = MaxScopeUsage(usage, GetExprsScopeUsage(program, elseExprs));
+
+	return usage;
+}
+
 ASTExpression* ASTExpressionIfElse::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
 	ASTExpression* injectedConditionExpr = conditionExpr->InjectTemplateType(program, cls, instantiation, templatedClass);
@@ -547,7 +783,7 @@ ASTExpression* ASTExpressionIfElse::InjectTemplateType(Program* program, Class*
 	for (uint32 i = 0; i < elseExprs.size(); i++)
 		injectedElseExprs.push_back(elseExprs[i]->InjectTemplateType(program, cls, instantiation, templatedClass));
 
-	return new ASTExpressionIfElse(injectedConditionExpr, pushIfScope, pushElseScope, injectedIfExprs, injectedElseExprs, isStatement);
+	return new (program) ASTExpressionIfElse(injectedConditionExpr, pushIfScope, pushElseScope, injectedIfExprs, injectedElseExprs, isStatement);
 }
 
 void ASTExpressionFor::EmitCode(Program* program)
@@ -555,21 +791,26 @@ void ASTExpressionFor::EmitCode(Program* program)
 	if (declareExpr)
 		declareExpr->EmitCode(program);
 
-	uint32 pushLoopPos = program->AddPushLoopCommand();
+	ScopeUsage usage = conditionExpr ? GetConditionScopeUsage(program, conditionExpr) : ScopeUsage::ALLOCATES;
+	usage = MaxScopeUsage(usage, GetExprsScopeUsage(program, forExprs));
+	if (incrExpr)
+		usage = MaxScopeUsage(usage, incrExpr->GetScopeUsage(program));
+
+	uint32 pushLoopPos = program->AddPushLoopCommand(usage != ScopeUsage::NONE);
 	uint32 conditionPos = program->GetCodeSize();
-	program->WriteOPCode(OpCode::PUSH_SCOPE);
+	EmitPushScope(program, usage);
 
+	uint32 jumpIfFalsePos = 0;
 	if (conditionExpr)
-		conditionExpr->EmitCode(program);
+		jumpIfFalsePos = EmitConditionJump(program, conditionExpr);
 	else
 	{
 		program->AddPushConstantBoolCommand(true);
+		program->WriteOPCode(OpCode::JUMP_IF_FALSE);
+		jumpIfFalsePos = program->GetCodeSize();
+		program->WriteUInt32(0);
 	}
 
-	program->WriteOPCode(OpCode::JUMP_IF_FALSE);
-	uint32 jumpIfFalsePos = program->GetCodeSize();
-	program->WriteUInt32(0);
-
 	for (uint32 i = 0; i < forExprs.size(); i++)
 		forExprs[i]->EmitCode(program);
 
@@ -577,12 +818,12 @@ void ASTExpressionFor::EmitCode(Program* program)
 	if (incrExpr)
 		incrExpr->EmitCode(program);
 
-	program->WriteOPCode(OpCode::POP_SCOPE);
+	EmitPopScope(program, usage);
 	program->WriteOPCode(OpCode::JUMP);
 	program->WriteUInt32(conditionPos);
 	uint32 loopEndPos = program->GetCodeSize();
 	program->AddPopLoopCommand();
-	program->WriteOPCode(OpCode::POP_SCOPE);
+	EmitPopScope(program, usage);
 
 	program->PatchUInt32(jumpIfFalsePos, loopEndPos);
 	program->PatchPushLoopCommand(pushLoopPos, incrPos, loopEndPos);
@@ -593,6 +834,11 @@ TypeInfo ASTExpressionFor::GetTypeInfo(Program* program)
 	return TypeInfo(INVALID_ID, 0);
 }
 
+ScopeUsage ASTExpressionFor::GetScopeUsage(Program* program)
+{
+	return declareExpr ? declareExpr->GetScopeUsage(program) : ScopeUsage::NONE;
+}
+
 ASTExpression* ASTExpressionFor::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
 	ASTExpression* injectedDeclareExpr = declareExpr->InjectTemplateType(program, cls, instantiation, templatedClass);
@@ -603,7 +849,7 @@ ASTExpression* ASTExpressionFor::InjectTemplateType(Program* program, Class* cls
 	for (uint32 i = 0; i < forExprs.size(); i++)
 		injectedForExprs.push_back(forExprs[i]->InjectTemplateType(program, cls, instantiation, templatedClass));
 
-	return new ASTExpressionFor(injectedDeclareExpr, injectedConditionExpr, injectedIncrExpr, injectedForExprs, isStatement);
+	return new (program) ASTExpressionFor(injectedDeclareExpr, injectedConditionExpr, injectedIncrExpr, injectedForExprs, isStatement);
 }
 
 void ASTExpressionUnaryUpdate::EmitCode(Program* program)
@@ -617,35 +863,39 @@ TypeInfo ASTExpressionUnaryUpdate::GetTypeInfo(Program* program)
 	return expr->GetTypeInfo(program);
 }
 
+ScopeUsage ASTExpressionUnaryUpdate::GetScopeUsage(Program* program)
+{
+	return isStatement ? expr->GetScopeUsage(program) : MaxScopeUsage(ScopeUsage::ALLOCATES, expr->GetScopeUsage(program));
+}
+
 ASTExpression* ASTExpressionUnaryUpdate::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
 	ASTExpression* injectedExpr = expr->InjectTemplateType(program, cls, instantiation, templatedClass);
-	return new ASTExpressionUnaryUpdate(injectedExpr, op, isStatement);
+	return new (program) ASTExpressionUnaryUpdate(injectedExpr, op, isStatement);
 }
 
 void ASTExpressionWhile::EmitCode(Program* program)
 {
-	uint32 pushLoopPos = program->AddPushLoopCommand();
-	uint32 conditionPos = program->GetCodeSize();
-	program->WriteOPCode(OpCode::PUSH_SCOPE);
-	conditionExpr->EmitCode(program);
+	ScopeUsage usage = MaxScopeUsage(GetConditionScopeUsage(program, conditionExpr), GetExprsScopeUsage(program, whileExprs));
 
-	program->WriteOPCode(OpCode::JUMP_IF_FALSE);
-	uint32 jumpIfFalsePos = program->GetCodeSize();
-	program->WriteUInt32(0);
+	uint32 pushLoopPos = program->AddPushLoopCommand(usage != ScopeUsage::NONE);
+	uint32 conditionPos = program->GetCodeSize();
+	EmitPushScope(program, usage);
+	uint32 jumpIfFalsePos = EmitConditionJump(program, conditionExpr);
 
 	for (uint32 i = 0; i < whileExprs.size(); i++)
 		whileExprs[i]->EmitCode(program);
 
-	program->WriteOPCode(OpCode::POP_SCOPE);
+	uint32 continuePos = program->GetCodeSize();
+	EmitPopScope(program, usage);
 	program->WriteOPCode(OpCode::JUMP);
 	program->WriteUInt32(conditionPos);
 	uint32 loopEndPos = program->GetCodeSize();
 	program->AddPopLoopCommand();
-	program->WriteOPCode(OpCode::POP_SCOPE);
+	EmitPopScope(program, usage);
 
 	program->PatchUInt32(jumpIfFalsePos, loopEndPos);
-	program->PatchPushLoopCommand(pushLoopPos, conditionPos, loopEndPos);
+	program->PatchPushLoopCommand(pushLoopPos, continuePos, loopEndPos);
 }
 
 TypeInfo ASTExpressionWhile::GetTypeInfo(Program* program)
@@ -653,6 +903,11 @@ TypeInfo ASTExpressionWhile::GetTypeInfo(Program* program)
 	return TypeInfo(INVALID_ID, 0);
 }
 
+ScopeUsage ASTExpressionWhile::GetScopeUsage(Program* program)
+{
+	return ScopeUsage::NONE;
+}
+
 ASTExpression* ASTExpressionWhile::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
 	ASTExpression* injectedConditionExpr = conditionExpr->InjectTemplateType(program, cls, instantiation, templatedClass);
@@ -660,7 +915,7 @@ ASTExpression* ASTExpressionWhile::InjectTemplateType(Program* program, Class* c
 	for (uint32 i = 0; i < whileExprs.size(); i++)
 		injectedWhileExprs.push_back(whileExprs[i]->InjectTemplateType(program, cls, instantiation, templatedClass));
 
-	return new ASTExpressionWhile(injectedConditionExpr, injectedWhileExprs, isStatement);
+	return new (program) ASTExpressionWhile(injectedConditionExpr, injectedWhileExprs, isStatement);
 }
 
 void ASTExpressionBreak::EmitCode(Program* program)
@@ -673,9 +928,14 @@ TypeInfo ASTExpressionBreak::GetTypeInfo(Program* program)
 	return TypeInfo(INVALID_ID, 0);
 }
 
+ScopeUsage ASTExpressionBreak::GetScopeUsage(Program* program)
+{
+	return ScopeUsage::NONE;
+}
+
 ASTExpression* ASTExpressionBreak::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
-	return new ASTExpressionBreak(isStatement);
+	return new (program) ASTExpressionBreak(isStatement);
 }
 
 void ASTExpressionContinue::EmitCode(Program* program)
@@ -688,9 +948,14 @@ TypeInfo ASTExpressionContinue::GetTypeInfo(Program* program)
 	return TypeInfo(INVALID_ID, 0);
 }
 
+ScopeUsage ASTExpressionContinue::GetScopeUsage(Program* program)
+{
+	return ScopeUsage::NONE;
+}
+
 ASTExpression* ASTExpressionContinue::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
-	return new ASTExpressionContinue(isStatement);
+	return new (program) ASTExpressionContinue(isStatement);
 }
 
 void ASTExpressionStaticFunctionCall::EmitCode(Program* program)
@@ -705,13 +970,18 @@ void ASTExpressionStaticFunctionCall::EmitCode(Program* program)
 
 TypeInfo ASTExpressionStaticFunctionCall::GetTypeInfo(Program* program)
 {
-	functionID = functionID == INVALID_ID ? program->GetClass(classID)->GetFunctionID(functionName, argExprs, castFunctionIDs) : functionID;
+	functionID = functionID == INVALID_ID ? program->GetClass(classID)->GetFunctionID(program, functionName, argExprs, castFunctionIDs) : functionID;
 	return program->GetClass(classID)->GetFunction(functionID)->returnInfo;
 }
 
+ScopeUsage ASTExpressionStaticFunctionCall::GetScopeUsage(Program* program)
+{
+	return GetCallScopeUsage(program, GetTypeInfo(program), argExprs, castFunctionIDs);
+}
+
 bool ASTExpressionStaticFunctionCall::Resolve(Program* program)
 {
-	functionID = functionID == INVALID_ID ? program->GetClass(classID)->GetFunctionID(functionName, argExprs, castFunctionIDs) : functionID;
+	functionID = functionID == INVALID_ID ? program->GetClass(classID)->GetFunctionID(program, functionName, argExprs, castFunctionIDs) : functionID;
 	return true;
 }
 
@@ -721,7 +991,38 @@ ASTExpression* ASTExpressionStaticFunctionCall::InjectTemplateType(Program* prog
 	for (uint32 i = 0; i < argExprs.size(); i++)
 		injectedArgExprs.push_back(argExprs[i]->InjectTemplateType(program, cls, instantiation, templatedClass));
 
-	return new ASTExpressionStaticFunctionCall(templatedClass->GetID(), functionName, argExprs, isStatement);
+	return new (program) ASTExpressionStaticFunctionCall(templatedClass->GetID(), functionName, injectedArgExprs, isStatement);
+}
+
+void ASTExpressionFunctionReference::EmitCode(Program* program)
+{
+	if (isStatement) return;
+
+	// Unresolved references stay 0, calling through them is a runtime error
+	uint32 reference = functionID != INVALID_ID ? MAKE_FUNCTION_REFERENCE(classID, functionID) : 0;
+	program->AddPushConstantUInt32Command(reference);
+}
+
+TypeInfo ASTExpressionFunctionReference::GetTypeInfo(Program* program)
+{
+	return TypeInfo((uint16)ValueType::UINT32, 0);
+}
+
+ScopeUsage ASTExpressionFunctionReference::GetScopeUsage(Program* program)
+{
+	return ScopeUsage::ALLOCATES;
+}
+
+bool ASTExpressionFunctionReference::Resolve(Program* program)
+{
+	Function* function = program->GetClass(classID)->FindFunctionByName(functionName);
+	functionID = function ? function->id : INVALID_ID;
+	return function != nullptr;
+}
+
+ASTExpression* ASTExpressionFunctionReference::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
+{
+	return new (program) ASTExpressionFunctionReference(classID, functionName, isStatement);
 }
 
 void ASTExpressionReturn::EmitCode(Program* program)
@@ -751,10 +1052,39 @@ TypeInfo ASTExpressionReturn::GetTypeInfo(Program* program)
 	return expr->GetTypeInfo(program);
 }
 
+ScopeUsage ASTExpressionReturn::GetScopeUsage(Program* program)
+{
+	return expr ? expr->GetScopeUsage(program) : ScopeUsage::NONE;
+}
+
 ASTExpression* ASTExpressionReturn::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
 	ASTExpression* injectedExpr = expr ? expr->InjectTemplateType(program, cls, instantiation, templatedClass) : nullptr;
-	return new ASTExpressionReturn(injectedExpr, returnsReference, isStatement);
+	return new (program) ASTExpressionReturn(injectedExpr, returnsReference, isStatement);
+}
+
+void ASTExpressionYield::EmitCode(Program* program)
+{
+	if (expr)
+		expr->EmitCode(program);
+
+	program->AddYieldCommand(expr != nullptr);
+}
+
+TypeInfo ASTExpressionYield::GetTypeInfo(Program* program)
+{
+	return TypeInfo(INVALID_ID, 0);
+}
+
+ScopeUsage ASTExpressionYield::GetScopeUsage(Program* program)
+{
+	return expr ? expr->GetScopeUsage(program) : ScopeUsage::NONE;
+}
+
+ASTExpression* ASTExpressionYield::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
+{
+	ASTExpression* injectedExpr = expr ? expr->InjectTemplateType(program, cls, instantiation, templatedClass) : nullptr;
+	return new (program) ASTExpressionYield(injectedExpr, isStatement);
 }
 
 void ASTExpressionStaticVariable::EmitCode(Program* program)
@@ -770,6 +1100,11 @@ TypeInfo ASTExpressionStaticVariable::GetTypeInfo(Program* program)
 	return typeInfo;
 }
 
+ScopeUsage ASTExpressionStaticVariable::GetScopeUsage(Program* program)
+{
+	return ScopeUsage::NONE;
+}
+
 bool ASTExpressionStaticVariable::Resolve(Program* program)
 {
 	if(offset == UINT64_MAX)
@@ -779,7 +1114,7 @@ bool ASTExpressionStaticVariable::Resolve(Program* program)
 
 ASTExpression* ASTExpressionStaticVariable::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
-	return new ASTExpressionStaticVariable(classID, offset, typeInfo, isArray, isStatement);
+	return new (program) ASTExpressionStaticVariable(classID, offset, typeInfo, isArray, isStatement);
 }
 
 void ASTExpressionModuleConstant::EmitCode(Program* program)
@@ -790,12 +1125,17 @@ void ASTExpressionModuleConstant::EmitCode(Program* program)
 
 TypeInfo ASTExpressionModuleConstant::GetTypeInfo(Program* program)
 {
-	return Module::GetConstantTypeInfo(moduleID, constantID);
+	return Module::GetConstantTypeInfo(program, moduleID, constantID);
+}
+
+ScopeUsage ASTExpressionModuleConstant::GetScopeUsage(Program* program)
+{
+	return ScopeUsage::ALLOCATES;
 }
 
 ASTExpression* ASTExpressionModuleConstant::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
-	return new ASTExpressionModuleConstant(moduleID, constantID, isStatement);
+	return new (program) ASTExpressionModuleConstant(moduleID, constantID, isStatement);
 }
 
 void ASTExpressionDeclareObjectWithConstructor::EmitCode(Program* program)
@@ -818,7 +1158,7 @@ bool ASTExpressionDeclareObjectWithConstructor::Resolve(Program* program)
 	if (type == (uint16)ValueType::TEMPLATE_TYPE) return true;
 
 	Class* cls = program->GetClass(type);
-	functionID = cls->GetFunctionID(cls->GetName(), argExprs, castFunctionIDs);
+	functionID = cls->GetFunctionID(program, cls->GetName(), argExprs, castFunctionIDs);
 	return true;
 }
 
@@ -840,7 +1180,7 @@ ASTExpression* ASTExpressionDeclareObjectWithConstructor::InjectTemplateType(Pro
 	for (uint32 i = 0; i < argExprs.size(); i++)
 		injectedArgExprs.push_back(argExprs[i]->InjectTemplateType(program, cls, instantiation, templatedClass));
 
-	return new ASTExpressionDeclareObjectWithConstructor(injectedType, injectedArgExprs, slot, "", nullptr, isStatement);
+	return new (program) ASTExpressionDeclareObjectWithConstructor(injectedType, injectedArgExprs, slot, "", nullptr, isStatement);
 }
 
 void ASTExpressionDeclareObjectWithAssign::EmitCode(Program* program)
@@ -866,7 +1206,7 @@ bool ASTExpressionDeclareObjectWithAssign::Resolve(Program* program)
 	Class* cls = program->GetClass(type);
 	std::vector<ASTExpression*> argExprs;
 	argExprs.push_back(assignExpr);
-	copyConstructorID = cls->GetFunctionID(cls->GetName(), argExprs, castFunctionIDs);
+	copyConstructorID = cls->GetFunctionID(program, cls->GetName(), argExprs, castFunctionIDs);
 	return true;
 }
 
@@ -889,16 +1229,31 @@ ASTExpression* ASTExpressionDeclareObjectWithAssign::InjectTemplateType(Program*
 	ASTExpression* injectedAssignExpr = assignExpr->InjectTemplateType(program, cls, instantiation, templatedClass);
 	if (injectedPointerLevel > 0)
 	{
-		return new ASTExpressionDeclarePointer(injectedType, injectedPointerLevel, slot, injectedAssignExpr, "", nullptr, isStatement);
+		return new (program) ASTExpressionDeclarePointer(injectedType, injectedPointerLevel, slot, injectedAssignExpr, "", nullptr, isStatement);
 	}
 
-	return new ASTExpressionDeclareObjectWithAssign(injectedType, slot, injectedAssignExpr, "", nullptr, isStatement);
+	return new (program) ASTExpressionDeclareObjectWithAssign(injectedType, slot, injectedAssignExpr, "", nullptr, isStatement);
 }
 
 void ASTExpressionPushMember::EmitCode(Program* program)
 {
 	if (isStatement) return;
 
+	ASTExpressionDereference* dereferenceExpr = dynamic_cast<ASTExpressionDereference*>(expr);
+	ASTExpression* baseExpr = dereferenceExpr ? dereferenceExpr->expr : expr;
+	if (dereferenceExpr && dynamic_cast<ASTExpressionThis*>(baseExpr))
+	{
+		program->AddPushThisMemberCommand(typeInfo.type, typeInfo.pointerLevel, offset, false, isArray);
+		return;
+	}
+
+	ASTExpressionPushLocal* localExpr = dynamic_cast<ASTExpressionPushLocal*>(baseExpr);
+	if (localExpr && localExpr->typeInfo.pointerLevel == (dereferenceExpr ? 1 : 0))
+	{
+		program->AddPushLocalMemberCommand(localExpr->slot, dereferenceExpr != nullptr, typeInfo.type, typeInfo.pointerLevel, offset, false, isArray);
+		return;
+	}
+
 	expr->EmitCode(program);
 
 	if (typeInfo.type == INVALID_ID)
@@ -923,6 +1278,11 @@ TypeInfo ASTExpressionPushMember::GetTypeInfo(Program* program)
 	return typeInfo;
 }
 
+ScopeUsage ASTExpressionPushMember::GetScopeUsage(Program* program)
+{
+	return expr->GetScopeUsage(program);
+}
+
 bool ASTExpressionPushMember::Resolve(Program* program)
 {
 	if(!members.empty())
@@ -948,7 +1308,7 @@ bool ASTExpressionPushMember::Resolve(Program* program)
 ASTExpression* ASTExpressionPushMember::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
 	ASTExpression* injectedExpr = expr->InjectTemplateType(program, cls, instantiation, templatedClass);
-	return new ASTExpressionPushMember(injectedExpr, members, isStatement);
+	return new (program) ASTExpressionPushMember(injectedExpr, members, isStatement);
 }
 
 void ASTExpressionMemberFunctionCall::EmitCode(Program* program)
@@ -983,7 +1343,7 @@ TypeInfo ASTExpressionMemberFunctionCall::GetTypeInfo(Program* program)
 		return TypeInfo((uint16)ValueType::TEMPLATE_TYPE, 0);
 
 	Class* objClass = program->GetClass(objTypeInfo.type);
-	uint16 fid = (functionID == INVALID_ID) ? objClass->GetFunctionID(functionName, argExprs, castFunctionIDs) : functionID;
+	uint16 fid = (functionID == INVALID_ID) ? objClass->GetFunctionID(program, functionName, argExprs, castFunctionIDs) : functionID;
 	TypeInfo returnInfo = objClass->GetFunction(functionID)->returnInfo;
 	if (!isVirtual)
 		functionID = fid;
@@ -991,6 +1351,11 @@ TypeInfo ASTExpressionMemberFunctionCall::GetTypeInfo(Program* program)
 	return returnInfo;
 }
 
+ScopeUsage ASTExpressionMemberFunctionCall::GetScopeUsage(Program* program)
+{
+	return MaxScopeUsage(objExpr->GetScopeUsage(program), GetCallScopeUsage(program, GetTypeInfo(program), argExprs, castFunctionIDs));
+}
+
 bool ASTExpressionMemberFunctionCall::Resolve(Program* program)
 {
 	TypeInfo objTypeInfo = objExpr->GetTypeInfo(program);
@@ -998,7 +1363,7 @@ bool ASTExpressionMemberFunctionCall::Resolve(Program* program)
 	if(objTypeInfo.type == (uint16)ValueType::TEMPLATE_TYPE) return true;
 
 	Class* objClass = program->GetClass(objTypeInfo.type);
-	functionID = (functionID == INVALID_ID) ? objClass->GetFunctionID(functionName, argExprs, castFunctionIDs) : functionID;
+	functionID = (functionID == INVALID_ID) ? objClass->GetFunctionID(program, functionName, argExprs, castFunctionIDs) : functionID;
 	if(functionID != INVALID_ID)
 	{
 		isVirtual = objClass->GetFunction(functionID)->isVirtual;
@@ -1007,7 +1372,7 @@ bool ASTExpressionMemberFunctionCall::Resolve(Program* program)
 			std::vector<TypeInfo> parameters;
 			for (uint32 i = 0; i < argExprs.size(); i++)
 				parameters.push_back(argExprs[i]->GetTypeInfo(program));
-			functionID = objClass->GetVTable()->FindSlot(functionName, parameters);
+			functionID = objClass->GetVTable()->FindSlot(program, functionName, parameters);
 		}
 	}
 
@@ -1021,7 +1386,7 @@ ASTExpression* ASTExpressionMemberFunctionCall::InjectTemplateType(Program* prog
 	for (uint32 i = 0; i < argExprs.size(); i++)
 		injectedArgExprs.push_back(argExprs[i]->InjectTemplateType(program, cls, instantiation, templatedClass));
 
-	return new ASTExpressionMemberFunctionCall(injectedObjExpr, functionName, injectedArgExprs, isStatement);
+	return new (program) ASTExpressionMemberFunctionCall(injectedObjExpr, functionName, injectedArgExprs, isStatement);
 }
 
 void ASTExpressionThis::EmitCode(Program* program)
@@ -1035,9 +1400,14 @@ TypeInfo ASTExpressionThis::GetTypeInfo(Program* program)
 	return TypeInfo(classID, 1);
 }
 
+ScopeUsage ASTExpressionThis::GetScopeUsage(Program* program)
+{
+	return ScopeUsage::NONE;
+}
+
 ASTExpression* ASTExpressionThis::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
-	return new ASTExpressionThis(templatedClass->GetID(), isStatement);
+	return new (program) ASTExpressionThis(templatedClass->GetID(), isStatement);
 }
 
 void ASTExpressionDeclareReference::EmitCode(Program* program)
@@ -1053,6 +1423,11 @@ TypeInfo ASTExpressionDeclareReference::GetTypeInfo(Program* program)
 	return TypeInfo(type, pointerLevel);
 }
 
+ScopeUsage ASTExpressionDeclareReference::GetScopeUsage(Program* program)
+{
+	return assignExpr ? MaxScopeUsage(ScopeUsage::ALLOCATES, assignExpr->GetScopeUsage(program)) : ScopeUsage::ALLOCATES;
+}
+
 ASTExpression* ASTExpressionDeclareReference::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
 	uint16 injectedType = type;
@@ -1070,7 +1445,7 @@ ASTExpression* ASTExpressionDeclareReference::InjectTemplateType(Program* progra
 	}
 
 	ASTExpression* injectedAssignExpr = assignExpr->InjectTemplateType(program, cls, instantiation, templatedClass);
-	return new ASTExpressionDeclareReference(injectedType, injectedPointerLevel, injectedAssignExpr, slot, "", nullptr, isStatement);
+	return new (program) ASTExpressionDeclareReference(injectedType, injectedPointerLevel, injectedAssignExpr, slot, "", nullptr, isStatement);
 }
 
 void ASTExpressionConstructorCall::EmitCode(Program* program)
@@ -1093,7 +1468,7 @@ bool ASTExpressionConstructorCall::Resolve(Program* program)
 	if (type == (uint16)ValueType::TEMPLATE_TYPE) return true;
 	Class* cls = program->GetClass(type);
 
-	functionID = cls->GetFunctionID(cls->GetName(), argExprs, castFunctionIDs);
+	functionID = cls->GetFunctionID(program, cls->GetName(), argExprs, castFunctionIDs);
 	return functionID != INVALID_ID;
 }
 
@@ -1115,7 +1490,7 @@ ASTExpression* ASTExpressionConstructorCall::InjectTemplateType(Program* program
 	for (uint32 i = 0; i < argExprs.size(); i++)
 		injectedArgExprs.push_back(argExprs[i]->InjectTemplateType(program, cls, instantiation, templatedClass));
 
-	return new ASTExpressionConstructorCall(injectedType, injectedArgExprs, "", nullptr, isStatement);
+	return new (program) ASTExpressionConstructorCall(injectedType, injectedArgExprs, "", nullptr, isStatement);
 }
 
 void ASTExpressionNew::EmitCode(Program* program)
@@ -1123,7 +1498,10 @@ void ASTExpressionNew::EmitCode(Program* program)
 	for (uint32 i = 0; i < argExprs.size(); i++)
 		argExprs[i]->EmitCode(program);
 
-	program->AddNewCommand(type, functionID);
+	if (arenaExpr)
+		arenaExpr->EmitCode(program);
+
+	program->AddNewCommand(type, functionID, arenaExpr != nullptr);
 	for (int32 i = castFunctionIDs.size() - 1; i >= 0; i--)
 		program->WriteUInt16(castFunctionIDs[i]);
 }
@@ -1133,10 +1511,19 @@ TypeInfo ASTExpressionNew::GetTypeInfo(Program* program)
 	return TypeInfo(type, 1);
 }
 
+ScopeUsage ASTExpressionNew::GetScopeUsage(Program* program)
+{
+	if (HasCastFunctions(castFunctionIDs))
+		return ScopeUsage::OBJECTS;
+
+	ScopeUsage usage = MaxScopeUsage(ScopeUsage::ALLOCATES, GetExprsScopeUsage(program, argExprs));
+	return arenaExpr ? MaxScopeUsage(usage, arenaExpr->GetScopeUsage(program)) : usage;
+}
+
 bool ASTExpressionNew::Resolve(Program* program)
 {
 	Class* cls = program->GetClass(type);
-	functionID = cls->GetFunctionID(cls->GetName(), argExprs, castFunctionIDs);
+	functionID = cls->GetFunctionID(program, cls->GetName(), argExprs, castFunctionIDs);
 	return true;
 }
 
@@ -1153,7 +1540,8 @@ ASTExpression* ASTExpressionNew::InjectTemplateType(Program* program, Class* cls
 	for (uint32 i = 0; i < argExprs.size(); i++)
 		injectedArgExprs.push_back(argExprs[i]->InjectTemplateType(program, cls, instantiation, templatedClass));
 
-	return new ASTExpressionNew(injectedType, injectedArgExprs, "", isStatement);
+	ASTExpression* injectedArenaExpr = arenaExpr ? arenaExpr->InjectTemplateType(program, cls, instantiation, templatedClass) : nullptr;
+	return new (program) ASTExpressionNew(injectedType, injectedArgExprs, "", injectedArenaExpr, isStatement);
 }
 
 void ASTExpressionDelete::EmitCode(Program* program)
@@ -1168,16 +1556,24 @@ TypeInfo ASTExpressionDelete::GetTypeInfo(Program* program)
 	return TypeInfo(INVALID_ID, 0);
 }
 
+ScopeUsage ASTExpressionDelete::GetScopeUsage(Program* program)
+{
+	return MaxScopeUsage(ScopeUsage::ALLOCATES, expr->GetScopeUsage(program));
+}
+
 ASTExpression* ASTExpressionDelete::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
 	ASTExpression* injectedExpr = expr->InjectTemplateType(program, cls, instantiation, templatedClass);
-	return new ASTExpressionDelete(injectedExpr, deleteArray, isStatement);
+	return new (program) ASTExpressionDelete(injectedExpr, deleteArray, isStatement);
 }
 
 void ASTExpressionNewArray::EmitCode(Program* program)
 {
 	sizeExpr->EmitCode(program);
-	program->AddNewArrayCommand(type, pointerLevel);
+	if (arenaExpr)
+		arenaExpr->EmitCode(program);
+
+	program->AddNewArrayCommand(type, pointerLevel, arenaExpr != nullptr);
 }
 
 TypeInfo ASTExpressionNewArray::GetTypeInfo(Program* program)
@@ -1185,6 +1581,12 @@ TypeInfo ASTExpressionNewArray::GetTypeInfo(Program* program)
 	return TypeInfo(type, pointerLevel + 1);
 }
 
+ScopeUsage ASTExpressionNewArray::GetScopeUsage(Program* program)
+{
+	ScopeUsage usage = MaxScopeUsage(ScopeUsage::ALLOCATES, sizeExpr->GetScopeUsage(program));
+	return arenaExpr ? MaxScopeUsage(usage, arenaExpr->GetScopeUsage(program)) : usage;
+}
+
 ASTExpression* ASTExpressionNewArray::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
 	uint16 injectedType = type;
@@ -1198,7 +1600,8 @@ ASTExpression* ASTExpressionNewArray::InjectTemplateType(Program* program, Class
 
 	ASTExpression* injectedSizeExpr = sizeExpr->InjectTemplateType(program, cls, instantiation, templatedClass);
 
-	return new ASTExpressionNewArray(injectedType, injectedPointerLevel, injectedSizeExpr, "", isStatement);
+	ASTExpression* injectedArenaExpr = arenaExpr ? arenaExpr->InjectTemplateType(program, cls, instantiation, templatedClass) : nullptr;
+	return new (program) ASTExpressionNewArray(injectedType, injectedPointerLevel, injectedSizeExpr, "", injectedArenaExpr, isStatement);
 }
 
 void ASTExpressionCast::EmitCode(Program* program)
@@ -1214,6 +1617,14 @@ TypeInfo ASTExpressionCast::GetTypeInfo(Program* program)
 	return TypeInfo(targetType, targetPointerLevel);
 }
 
+ScopeUsage ASTExpressionCast::GetScopeUsage(Program* program)
+{
+	if (!Value::IsPrimitiveType(targetType) && targetPointerLevel == 0)
+		return ScopeUsage::OBJECTS;
+
+	return MaxScopeUsage(ScopeUsage::ALLOCATES, expr->GetScopeUsage(program));
+}
+
 ASTExpression* ASTExpressionCast::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
 	uint16 injectedType = targetType;
@@ -1226,7 +1637,7 @@ ASTExpression* ASTExpressionCast::InjectTemplateType(Program* program, Class* cl
 	}
 
 	ASTExpression* injectedExpr = expr->InjectTemplateType(program, cls, instantiation, templatedClass);
-	return new ASTExpressionCast(injectedExpr, injectedType, injectedPointerLevel, "", isStatement);
+	return new (program) ASTExpressionCast(injectedExpr, injectedType, injectedPointerLevel, "", isStatement);
 }
 
 void ASTExpressionNegate::EmitCode(Program* program)
@@ -1242,10 +1653,15 @@ TypeInfo ASTExpressionNegate::GetTypeInfo(Program* program)
 	return expr->GetTypeInfo(program);
 }
 
+ScopeUsage ASTExpressionNegate::GetScopeUsage(Program* program)
+{
+	return MaxScopeUsage(ScopeUsage::ALLOCATES, expr->GetScopeUsage(program));
+}
+
 ASTExpression* ASTExpressionNegate::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
 	ASTExpression* injectedExpr = expr->InjectTemplateType(program, cls, instantiation, templatedClass);
-	return new ASTExpressionNegate(injectedExpr, isStatement);
+	return new (program) ASTExpressionNegate(injectedExpr, isStatement);
 }
 
 void ASTExpressionInvert::EmitCode(Program* program)
@@ -1261,10 +1677,15 @@ TypeInfo ASTExpressionInvert::GetTypeInfo(Program* program)
 	return TypeInfo((uint16)ValueType::BOOL, 0);
 }
 
+ScopeUsage ASTExpressionInvert::GetScopeUsage(Program* program)
+{
+	return MaxScopeUsage(ScopeUsage::ALLOCATES, expr->GetScopeUsage(program));
+}
+
 ASTExpression* ASTExpressionInvert::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
 	ASTExpression* injectedExpr = expr->InjectTemplateType(program, cls, instantiation, templatedClass);
-	return new ASTExpressionInvert(injectedExpr, isStatement);
+	return new (program) ASTExpressionInvert(injectedExpr, isStatement);
 }
 
 void ASTExpressionStrlen::EmitCode(Program* program)
@@ -1280,10 +1701,15 @@ TypeInfo ASTExpressionStrlen::GetTypeInfo(Program* program)
 	return TypeInfo((uint16)ValueType::UINT32, 0);
 }
 
+ScopeUsage ASTExpressionStrlen::GetScopeUsage(Program* program)
+{
+	return MaxScopeUsage(ScopeUsage::ALLOCATES, expr->GetScopeUsage(program));
+}
+
 ASTExpression* ASTExpressionStrlen::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
 	ASTExpression* injectedExpr = expr->InjectTemplateType(program, cls, instantiation, templatedClass);
-	return new ASTExpressionStrlen(injectedExpr, isStatement);
+	return new (program) ASTExpressionStrlen(injectedExpr, isStatement);
 }
 
 void ASTExpressionSizeOfStatic::EmitCode(Program* program)
@@ -1301,6 +1727,11 @@ TypeInfo ASTExpressionSizeOfStatic::GetTypeInfo(Program* program)
 	return TypeInfo((uint16)ValueType::UINT64, 0);
 }
 
+ScopeUsage ASTExpressionSizeOfStatic::GetScopeUsage(Program* program)
+{
+	return ScopeUsage::ALLOCATES;
+}
+
 ASTExpression* ASTExpressionSizeOfStatic::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
 	uint16 injectedType = type;
@@ -1313,7 +1744,135 @@ ASTExpression* ASTExpressionSizeOfStatic::InjectTemplateType(Program* program, C
 			injectedPointer = instantiation.args[index].pointerLevel > 0;
 	}
 
-	return new ASTExpressionSizeOfStatic(type, injectedPointer, "", isStatement);
+	return new (program) ASTExpressionSizeOfStatic(injectedType, injectedPointer, "", isStatement);
+}
+
+void ASTExpressionIsTrivial::EmitCode(Program* program)
+{
+	if (isStatement) return;
+
+	// Uninstantiated template parameters are never trivial
+	bool trivial = false;
+	if (pointer || Value::IsPrimitiveType(type))
+		trivial = true;
+	else if (type != INVALID_ID)
+		trivial = program->GetClass(type)->IsTrivial(program);
+
+	program->AddPushConstantBoolCommand(trivial);
+}
+
+TypeInfo ASTExpressionIsTrivial::GetTypeInfo(Program* program)
+{
+	return TypeInfo((uint16)ValueType::BOOL, 0);
+}
+
+ScopeUsage ASTExpressionIsTrivial::GetScopeUsage(Program* program)
+{
+	return ScopeUsage::ALLOCATES;
+}
+
+ASTExpression* ASTExpressionIsTrivial::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
+{
+	uint16 injectedType = type;
+	bool injectedPointer = pointer;
+	if (!templateTypeName.empty())
+	{
+		uint32 index = cls->InstantiateTemplateGetIndex(program, templateTypeName);
+		injectedType = instantiation.args[index].value;
+		if (!injectedPointer)
+			injectedPointer = instantiation.args[index].pointerLevel > 0;
+	}
+
+	return new (program) ASTExpressionIsTrivial(injectedType, injectedPointer, "", isStatement);
+}
+
+void ASTExpressionFieldInfo::EmitCode(Program* program)
+{
+	if (isStatement || type == INVALID_ID) return;
+
+	// A primitive or pointer is a single field covering the whole value
+	if (pointer || Value::IsPrimitiveType(type))
+	{
+		switch (query)
+		{
+		case FieldQuery::COUNT: program->AddPushConstantUInt32Command(1); break;
+		case FieldQuery::OFFSET: program->AddPushConstantUInt64Command(0); break;
+		case FieldQuery::SIZE: program->AddPushConstantUInt64Command(pointer ? sizeof(void*) : program->GetTypeSize(type)); break;
+		}
+
+		return;
+	}
+
+	if (query == FieldQuery::COUNT)
+	{
+		program->AddPushConstantUInt32Command(program->GetClass(type)->GetFieldCount());
+		return;
+	}
+
+	indexExpr->EmitCode(program);
+	program->WriteOPCode(OpCode::FIELD_INFO);
+	program->WriteUInt16(type);
+	program->WriteUInt8((uint8)query);
+}
+
+TypeInfo ASTExpressionFieldInfo::GetTypeInfo(Program* program)
+{
+	if (query == FieldQuery::COUNT)
+		return TypeInfo((uint16)ValueType::UINT32, 0);
+
+	return TypeInfo((uint16)ValueType::UINT64, 0);
+}
+
+ScopeUsage ASTExpressionFieldInfo::GetScopeUsage(Program* program)
+{
+	if (!indexExpr)
+		return ScopeUsage::ALLOCATES;
+
+	return MaxScopeUsage(ScopeUsage::ALLOCATES, indexExpr->GetScopeUsage(program));
+}
+
+ASTExpression* ASTExpressionFieldInfo::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
+{
+	uint16 injectedType = type;
+	bool injectedPointer = pointer;
+	if (!templateTypeName.empty())
+	{
+		uint32 index = cls->InstantiateTemplateGetIndex(program, templateTypeName);
+		injectedType = instantiation.args[index].value;
+		if (!injectedPointer)
+			injectedPointer = instantiation.args[index].pointerLevel > 0;
+	}
+
+	ASTExpression* injectedIndexExpr = indexExpr ? indexExpr->InjectTemplateType(program, cls, instantiation, templatedClass) : nullptr;
+	return new (program) ASTExpressionFieldInfo(injectedType, injectedPointer, "", query, injectedIndexExpr, isStatement);
+}
+
+void ASTExpressionFieldIndex::EmitCode(Program* program)
+{
+	if (isStatement) return;
+
+	program->AddPushConstantUInt32Command(index);
+}
+
+TypeInfo ASTExpressionFieldIndex::GetTypeInfo(Program* program)
+{
+	return TypeInfo((uint16)ValueType::UINT32, 0);
+}
+
+ScopeUsage ASTExpressionFieldIndex::GetScopeUsage(Program* program)
+{
+	return ScopeUsage::ALLOCATES;
+}
+
+ASTExpression* ASTExpressionFieldIndex::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
+{
+	return new (program) ASTExpressionFieldIndex(classID, member, isStatement);
+}
+
+bool ASTExpressionFieldIndex::Resolve(Program* program)
+{
+	index = program->GetClass(classID)->GetFieldIndex(member);
+	return index != INVALID_ID;
 }
 
 void ASTExpressionOffsetOf::EmitCode(Program* program)
@@ -1328,9 +1887,14 @@ TypeInfo ASTExpressionOffsetOf::GetTypeInfo(Program* program)
 	return TypeInfo((uint16)ValueType::UINT64, 0);
 }
 
+ScopeUsage ASTExpressionOffsetOf::GetScopeUsage(Program* program)
+{
+	return ScopeUsage::ALLOCATES;
+}
+
 ASTExpression* ASTExpressionOffsetOf::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
-	return new ASTExpressionOffsetOf(classID, members, isStatement);
+	return new (program) ASTExpressionOffsetOf(classID, members, isStatement);
 }
 
 bool ASTExpressionOffsetOf::Resolve(Program* program)
@@ -1359,11 +1923,16 @@ TypeInfo ASTExpressionArithmaticEquals::GetTypeInfo(Program* program)
 	return expr->GetTypeInfo(program);
 }
 
+ScopeUsage ASTExpressionArithmaticEquals::GetScopeUsage(Program* program)
+{
+	return MaxScopeUsage(ScopeUsage::ALLOCATES, MaxScopeUsage(expr->GetScopeUsage(program), incrementExpr->GetScopeUsage(program)));
+}
+
 ASTExpression* ASTExpressionArithmaticEquals::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
 	ASTExpression* injectedExpr = expr->InjectTemplateType(program, cls, instantiation, templatedClass);
 	ASTExpression* injectedIncrementExpr = incrementExpr->InjectTemplateType(program, cls, instantiation, templatedClass);
-	return new ASTExpressionArithmaticEquals(injectedExpr, injectedIncrementExpr, op, isStatement);
+	return new (program) ASTExpressionArithmaticEquals(injectedExpr, injectedIncrementExpr, op, isStatement);
 }
 
 void ASTExpressionIntToStr::EmitCode(Program* program)
@@ -1379,10 +1948,15 @@ TypeInfo ASTExpressionIntToStr::GetTypeInfo(Program* program)
 	return TypeInfo((uint16)ValueType::CHAR, 1);
 }
 
+ScopeUsage ASTExpressionIntToStr::GetScopeUsage(Program* program)
+{
+	return MaxScopeUsage(ScopeUsage::ALLOCATES, expr->GetScopeUsage(program));
+}
+
 ASTExpression* ASTExpressionIntToStr::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
 	ASTExpression* injectedExpr = expr->InjectTemplateType(program, cls, instantiation, templatedClass);
-	return new ASTExpressionIntToStr(injectedExpr, isStatement);
+	return new (program) ASTExpressionIntToStr(injectedExpr, isStatement);
 }
 
 void ASTExpressionBreakPoint::EmitCode(Program* program)
@@ -1395,9 +1969,14 @@ TypeInfo ASTExpressionBreakPoint::GetTypeInfo(Program* program)
 	return TypeInfo(INVALID_ID, 0);
 }
 
+ScopeUsage ASTExpressionBreakPoint::GetScopeUsage(Program* program)
+{
+	return ScopeUsage::NONE;
+}
+
 ASTExpression* ASTExpressionBreakPoint::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
-	return new ASTExpressionBreakPoint(isStatement);
+	return new (program) ASTExpressionBreakPoint(isStatement);
 }
 
 void ASTExpressionStrToInt::EmitCode(Program* program)
@@ -1413,8 +1992,13 @@ TypeInfo ASTExpressionStrToInt::GetTypeInfo(Program* program)
 	return TypeInfo((uint16)ValueType::UINT64, 0);
 }
 
+ScopeUsage ASTExpressionStrToInt::GetScopeUsage(Program* program)
+{
+	return MaxScopeUsage(ScopeUsage::ALLOCATES, expr->GetScopeUsage(program));
+}
+
 ASTExpression* ASTExpressionStrToInt::InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
 	ASTExpression* injectedExpr = expr->InjectTemplateType(program, cls, instantiation, templatedClass);
-	return new ASTExpressionStrToInt(injectedExpr, isStatement);
+	return new (program) ASTExpressionStrToInt(injectedExpr, isStatement);
 }
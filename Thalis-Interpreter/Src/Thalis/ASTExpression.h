@@ -9,18 +9,36 @@
 
 class Program;
 class Class;
+
+// What a scope has to do at runtime for the expressions emitted directly in it, ordered by cost
+enum class ScopeUsage
+{
+	NONE,		// Nothing to undo, no scope opcodes are emitted
+	ALLOCATES,	// Only stack allocations, the scope just restores the allocator marker
+	OBJECTS		// May hold objects that need their destructors run
+};
+
+inline ScopeUsage MaxScopeUsage(ScopeUsage a, ScopeUsage b) { return a > b ? a : b; }
+
 struct ASTExpression
 {
 	
 
-	void* operator new(std::size_t size);
+	// Expressions live in the AST allocator of the program they are created for, as new (program) ASTExpression...
+	void* operator new(std::size_t size, Program* program);
+	void operator delete(void* ptr, Program* program) noexcept;
 	void operator delete(void* ptr) noexcept;
 
 	ASTExpression(bool isStatement = false) : isStatement(isStatement), setIsStatement(true) {}
+	virtual ~ASTExpression() {}
 	virtual void EmitCode(Program* program) = 0;
 	virtual TypeInfo GetTypeInfo(Program* program) = 0;
 	virtual bool Resolve(Program* program) { return true; }
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) = 0;
+	virtual ScopeUsage GetScopeUsage(Program* program) { return ScopeUsage::OBJECTS; }
+
+	// True if the pushed value has storage of its own that nothing else refers to once it is popped
+	virtual bool IsTemporary(Program* program) { return false; }
 
 	bool isStatement;
 	bool setIsStatement;
@@ -35,6 +53,8 @@ struct ASTExpressionLiteral : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
+	virtual bool IsTemporary(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -48,6 +68,22 @@ struct ASTExpressionConstUInt32 : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
+	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
+};
+
+// Integer template parameter, becomes a ConstUInt32 once the template is instantiated
+struct ASTExpressionTemplateInteger : public ASTExpression
+{
+	std::string name;
+
+	ASTExpressionTemplateInteger(const std::string& name, bool isStatement = false) :
+		ASTExpression(isStatement),
+		name(name) { }
+
+	virtual void EmitCode(Program* program) override;
+	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -63,6 +99,8 @@ struct ASTExpressionModuleFunctionCall : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
+	virtual bool IsTemporary(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -78,6 +116,7 @@ struct ASTExpressionDeclarePrimitive : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -94,6 +133,7 @@ struct ASTExpressionPushLocal : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -112,6 +152,7 @@ struct ASTExpressionDeclarePointer : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -128,6 +169,7 @@ struct ASTExpressionSet : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual bool Resolve(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
@@ -142,6 +184,7 @@ struct ASTExpressionAddressOf : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -155,6 +198,7 @@ struct ASTExpressionDereference : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -174,6 +218,7 @@ struct ASTExpressionStackArrayDeclare : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -190,6 +235,7 @@ struct ASTExpressionPushIndex : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 	virtual bool Resolve(Program* program) override;
 };
@@ -208,6 +254,8 @@ struct ASTExpressionBinary : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
+	virtual bool IsTemporary(Program* program) override;
 	virtual bool Resolve(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
@@ -226,6 +274,7 @@ struct ASTExpressionIfElse : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -242,6 +291,7 @@ struct ASTExpressionFor : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -264,6 +314,7 @@ struct ASTExpressionUnaryUpdate : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -278,6 +329,7 @@ struct ASTExpressionWhile : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -288,6 +340,7 @@ struct ASTExpressionBreak : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -298,6 +351,7 @@ struct ASTExpressionContinue : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -315,6 +369,25 @@ struct ASTExpressionStaticFunctionCall : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
+	virtual bool Resolve(Program* program) override;
+	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
+};
+
+// &Class.Function, pushed as a uint32 native code can call back through
+struct ASTExpressionFunctionReference : public ASTExpression
+{
+	uint16 classID;
+	std::string functionName;
+	uint16 functionID;
+
+	ASTExpressionFunctionReference(uint16 classID, const std::string& functionName, bool isStatement = false) :
+		ASTExpression(isStatement),
+		classID(classID), functionName(functionName), functionID(INVALID_ID) { }
+
+	virtual void EmitCode(Program* program) override;
+	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual bool Resolve(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
@@ -330,6 +403,22 @@ struct ASTExpressionReturn : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
+	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
+};
+
+// Suspends the running coroutine, the optional value is copied out for Co.Value
+struct ASTExpressionYield : public ASTExpression
+{
+	ASTExpression* expr;
+
+	ASTExpressionYield(ASTExpression* expr = nullptr, bool isStatement = false) :
+		ASTExpression(isStatement),
+		expr(expr) { }
+
+	virtual void EmitCode(Program* program) override;
+	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -351,6 +440,7 @@ struct ASTExpressionStaticVariable : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual bool Resolve(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
@@ -366,6 +456,7 @@ struct ASTExpressionModuleConstant : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -423,6 +514,7 @@ struct ASTExpressionPushMember : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual bool Resolve(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
@@ -442,6 +534,7 @@ struct ASTExpressionMemberFunctionCall : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual bool Resolve(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
@@ -456,6 +549,7 @@ struct ASTExpressionThis : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -474,6 +568,7 @@ struct ASTExpressionDeclareReference : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -503,13 +598,15 @@ struct ASTExpressionNew : public ASTExpression
 	uint16 functionID;
 	std::string templateTypeName;
 	std::vector<uint16> castFunctionIDs;
+	ASTExpression* arenaExpr; // new (arena) T(...), nullptr allocates on the heap
 
-	ASTExpressionNew(uint16 type, const std::vector<ASTExpression*> argExprs, const std::string& templateTypeName, bool isStatement = false) :
+	ASTExpressionNew(uint16 type, const std::vector<ASTExpression*> argExprs, const std::string& templateTypeName, ASTExpression* arenaExpr = nullptr, bool isStatement = false) :
 		ASTExpression(isStatement),
-		type(type), argExprs(argExprs), templateTypeName(templateTypeName), functionID(INVALID_ID) { }
+		type(type), argExprs(argExprs), templateTypeName(templateTypeName), functionID(INVALID_ID), arenaExpr(arenaExpr) { }
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual bool Resolve(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
@@ -525,6 +622,7 @@ struct ASTExpressionDelete : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -534,13 +632,15 @@ struct ASTExpressionNewArray : public ASTExpression
 	uint8 pointerLevel;
 	ASTExpression* sizeExpr;
 	std::string templateTypeName;
+	ASTExpression* arenaExpr;
 
-	ASTExpressionNewArray(uint16 type, uint8 pointerLevel, ASTExpression* sizeExpr, const std::string& templateTypeName, bool isStatement = false) :
+	ASTExpressionNewArray(uint16 type, uint8 pointerLevel, ASTExpression* sizeExpr, const std::string& templateTypeName, ASTExpression* arenaExpr = nullptr, bool isStatement = false) :
 		ASTExpression(isStatement),
-		type(type), pointerLevel(pointerLevel), sizeExpr(sizeExpr), templateTypeName(templateTypeName) { }
+		type(type), pointerLevel(pointerLevel), sizeExpr(sizeExpr), templateTypeName(templateTypeName), arenaExpr(arenaExpr) { }
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -557,6 +657,7 @@ struct ASTExpressionCast : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -570,6 +671,7 @@ struct ASTExpressionNegate : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -584,6 +686,7 @@ struct ASTExpressionInvert : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -597,7 +700,7 @@ struct ASTExpressionDummy : public ASTExpression
 
 	virtual void EmitCode(Program* program) override {}
 	virtual TypeInfo GetTypeInfo(Program* program) override { return typeInfo; }
-	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override { return  new ASTExpressionDummy(typeInfo, isStatement); }
+	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override { return new (program) ASTExpressionDummy(typeInfo, isStatement); }
 };
 
 struct ASTExpressionStrlen : public ASTExpression
@@ -610,6 +713,7 @@ struct ASTExpressionStrlen : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -625,9 +729,68 @@ struct ASTExpressionSizeOfStatic : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
+struct ASTExpressionIsTrivial : public ASTExpression
+{
+	uint16 type;
+	bool pointer;
+	std::string templateTypeName;
+
+	ASTExpressionIsTrivial(uint16 type, bool pointer, const std::string& templateTypeName, bool isStatement = false) :
+		ASTExpression(isStatement),
+		type(type), pointer(pointer), templateTypeName(templateTypeName) { }
+
+	virtual void EmitCode(Program* program) override;
+	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
+	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
+};
+
+enum class FieldQuery : uint8
+{
+	COUNT, OFFSET, SIZE
+};
+
+// fieldcount(T), fieldoffset(T, index) and fieldsize(T, index). Offsets and sizes of array
+// fields cover the elements only, the ArrayHeader is not part of the field's data.
+struct ASTExpressionFieldInfo : public ASTExpression
+{
+	uint16 type;
+	bool pointer;
+	std::string templateTypeName;
+	FieldQuery query;
+	ASTExpression* indexExpr;
+
+	ASTExpressionFieldInfo(uint16 type, bool pointer, const std::string& templateTypeName, FieldQuery query, ASTExpression* indexExpr, bool isStatement = false) :
+		ASTExpression(isStatement),
+		type(type), pointer(pointer), templateTypeName(templateTypeName), query(query), indexExpr(indexExpr) { }
+
+	virtual void EmitCode(Program* program) override;
+	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
+	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
+};
+
+struct ASTExpressionFieldIndex : public ASTExpression
+{
+	uint16 classID;
+	std::string member;
+	uint32 index;
+
+	ASTExpressionFieldIndex(uint16 classID, const std::string& member, bool isStatement = false) :
+		ASTExpression(isStatement),
+		classID(classID), member(member), index(INVALID_ID) { }
+
+	virtual void EmitCode(Program* program) override;
+	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
+	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
+	virtual bool Resolve(Program* program) override;
+};
+
 struct ASTExpressionOffsetOf : public ASTExpression
 {
 	uint16 classID;
@@ -640,6 +803,7 @@ struct ASTExpressionOffsetOf : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 	virtual bool Resolve(Program* program) override;
 };
@@ -656,6 +820,7 @@ struct ASTExpressionArithmaticEquals : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -669,6 +834,7 @@ struct ASTExpressionIntToStr : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -679,6 +845,7 @@ struct ASTExpressionBreakPoint : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
 
@@ -692,5 +859,6 @@ struct ASTExpressionStrToInt : public ASTExpression
 
 	virtual void EmitCode(Program* program) override;
 	virtual TypeInfo GetTypeInfo(Program* program) override;
+	virtual ScopeUsage GetScopeUsage(Program* program) override;
 	virtual ASTExpression* InjectTemplateType(Program* program, Class* cls, const TemplateInstantiation& instantiation, Class* templatedClass) override;
 };
\ No newline at end of file
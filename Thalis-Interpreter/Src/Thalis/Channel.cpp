@@ -0,0 +1,163 @@
+#include "Channel.h"
+
+#include <cstring>
+#include <new>
+#include <thread>
+
+#define CHANNEL_SPIN_COUNT 64
+
+Channel::Channel(ChannelKind kind, uint32 elementSize, uint32 capacity)
+{
+	uint64 numSlots = 1;
+	while (numSlots < capacity)
+		numSlots <<= 1;
+
+	m_Kind = kind;
+	m_ElementSize = elementSize;
+	m_ElementOffset = kind == ChannelKind::MPMC ? sizeof(std::atomic<uint64>) : 0;
+	m_SlotStride = (m_ElementOffset + elementSize + 7) & ~7u;
+	m_Mask = numSlots - 1;
+	m_Slots = new uint8[numSlots * m_SlotStride];
+	m_Closed = false;
+
+	if (kind == ChannelKind::MPMC)
+	{
+		for (uint64 i = 0; i < numSlots; i++)
+			new (GetSequence(i)) std::atomic<uint64>(i);
+	}
+
+	m_Tail = 0;
+	m_CachedHead = 0;
+	m_Head = 0;
+	m_CachedTail = 0;
+}
+
+Channel::~Channel()
+{
+	delete[] m_Slots;
+}
+
+bool Channel::TrySend(const void* element)
+{
+	return m_Kind == ChannelKind::SPSC ? TrySendSPSC(element) : TrySendMPMC(element);
+}
+
+bool Channel::TryRecv(void* element)
+{
+	return m_Kind == ChannelKind::SPSC ? TryRecvSPSC(element) : TryRecvMPMC(element);
+}
+
+bool Channel::Send(const void* element)
+{
+	for (uint32 spins = 0; !TrySend(element); spins++)
+	{
+		if (m_Closed.load(std::memory_order_relaxed))
+			return false;
+
+		if (spins >= CHANNEL_SPIN_COUNT)
+			std::this_thread::yield();
+	}
+
+	return true;
+}
+
+bool Channel::Recv(void* element)
+{
+	for (uint32 spins = 0; !TryRecv(element); spins++)
+	{
+		if (m_Closed.load(std::memory_order_relaxed))
+			return false;
+
+		if (spins >= CHANNEL_SPIN_COUNT)
+			std::this_thread::yield();
+	}
+
+	return true;
+}
+
+bool Channel::TrySendSPSC(const void* element)
+{
+	uint64 tail = m_Tail.load(std::memory_order_relaxed);
+	if (tail - m_CachedHead > m_Mask)
+	{
+		// Only go to the receiver's cache line once the ring looks full
+		m_CachedHead = m_Head.load(std::memory_order_acquire);
+		if (tail - m_CachedHead > m_Mask)
+			return false;
+	}
+
+	memcpy(GetElement(tail & m_Mask), element, m_ElementSize);
+	m_Tail.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+bool Channel::TryRecvSPSC(void* element)
+{
+	uint64 head = m_Head.load(std::memory_order_relaxed);
+	if (head == m_CachedTail)
+	{
+		m_CachedTail = m_Tail.load(std::memory_order_acquire);
+		if (head == m_CachedTail)
+			return false;
+	}
+
+	memcpy(element, GetElement(head & m_Mask), m_ElementSize);
+	m_Head.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+bool Channel::TrySendMPMC(const void* element)
+{
+	uint64 tail = m_Tail.load(std::memory_order_relaxed);
+	while (true)
+	{
+		// A slot is free for the sender at tail once its sequence caught up to tail
+		uint64 sequence = GetSequence(tail & m_Mask)->load(std::memory_order_acquire);
+		int64 diff = (int64)(sequence - tail);
+		if (diff == 0)
+		{
+			if (m_Tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+		{
+			return false;
+		}
+		else
+		{
+			tail = m_Tail.load(std::memory_order_relaxed);
+		}
+	}
+
+	memcpy(GetElement(tail & m_Mask), element, m_ElementSize);
+	GetSequence(tail & m_Mask)->store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+bool Channel::TryRecvMPMC(void* element)
+{
+	uint64 head = m_Head.load(std::memory_order_relaxed);
+	while (true)
+	{
+		// Filled slots carry head + 1, the sender published it after copying the element in
+		uint64 sequence = GetSequence(head & m_Mask)->load(std::memory_order_acquire);
+		int64 diff = (int64)(sequence - (head + 1));
+		if (diff == 0)
+		{
+			if (m_Head.compare_exchange_weak(head, head + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+		{
+			return false;
+		}
+		else
+		{
+			head = m_Head.load(std::memory_order_relaxed);
+		}
+	}
+
+	memcpy(element, GetElement(head & m_Mask), m_ElementSize);
+	GetSequence(head & m_Mask)->store(head + m_Mask + 1, std::memory_order_release);
+	return true;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+
+#include "Common.h"
+
+#define CHANNEL_CACHE_LINE_SIZE 64
+
+enum class ChannelKind : uint8
+{
+	SPSC, MPMC
+};
+
+// Bounded lock-free ring of fixed size elements, copied in and out with memcpy. The capacity
+// is rounded up to a power of two. SPSC channels are only correct with one sending and one
+// receiving thread, MPMC channels take any number of both.
+class Channel
+{
+public:
+	Channel(ChannelKind kind, uint32 elementSize, uint32 capacity);
+	~Channel();
+
+	bool TrySend(const void* element);
+	bool TryRecv(void* element);
+
+	// Spin and then yield until the channel has room or an element, false if it was closed meanwhile
+	bool Send(const void* element);
+	bool Recv(void* element);
+
+	// Wakes up every blocked Send and Recv, the channel is about to be deleted
+	inline void Close() { m_Closed.store(true, std::memory_order_relaxed); }
+
+	inline ChannelKind GetKind() const { return m_Kind; }
+	inline uint32 GetElementSize() const { return m_ElementSize; }
+	inline uint32 GetCapacity() const { return m_Mask + 1; }
+private:
+	bool TrySendSPSC(const void* element);
+	bool TryRecvSPSC(void* element);
+	bool TrySendMPMC(const void* element);
+	bool TryRecvMPMC(void* element);
+
+	// MPMC slots start with a sequence number telling whose turn it is, the element follows
+	inline std::atomic<uint64>* GetSequence(uint64 index) { return (std::atomic<uint64>*)(m_Slots + index * m_SlotStride); }
+	inline uint8* GetElement(uint64 index) { return m_Slots + index * m_SlotStride + m_ElementOffset; }
+private:
+	ChannelKind m_Kind;
+	uint32 m_ElementSize;
+	uint32 m_ElementOffset;
+	uint32 m_SlotStride;
+	uint64 m_Mask;
+	uint8* m_Slots;
+	std::atomic<bool> m_Closed;
+
+	// Senders and receivers each get their own cache line
+	alignas(CHANNEL_CACHE_LINE_SIZE) std::atomic<uint64> m_Tail;
+	uint64 m_CachedHead; // SPSC sender's last view of m_Head
+	alignas(CHANNEL_CACHE_LINE_SIZE) std::atomic<uint64> m_Head;
+	uint64 m_CachedTail; // SPSC receiver's last view of m_Tail
+};
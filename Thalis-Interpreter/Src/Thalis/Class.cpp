@@ -1,17 +1,30 @@
 #include "Class.h"
 #include "Program.h"
 #include "ASTExpression.h"
+#include "Memory/Memory.h"
+#include <algorithm>
 
 std::string Class::GetName() const
 {
     return m_Name;
 }
 
-void Class::AddFunction(Function* function)
+Class::~Class()
+{
+	for (auto& overloads : m_Functions)
+	{
+		for (uint32 i = 0; i < overloads.second.size(); i++)
+			delete overloads.second[i];
+	}
+
+	delete m_VTable;
+}
+
+void Class::AddFunction(Program* program, Function* function)
 {
 	m_Functions[function->name].push_back(function);
 
-	std::string signature = function->GenerateSignature();
+	std::string signature = function->GenerateSignature(program);
 
 	if (m_FunctionDefinitionMap.find(signature) == m_FunctionDefinitionMap.end())
 	{
@@ -68,9 +81,9 @@ static int32 GetConversionScore(Program* program, const TypeInfo& from, const Ty
 	{
 		Class* toClass = program->GetClass(to.type);
 		std::vector<ASTExpression*> args;
-		args.push_back(new ASTExpressionDummy(from));
+		args.push_back(new (program) ASTExpressionDummy(from));
 		std::vector<uint16> cf;
-		uint16 functionID = toClass->GetFunctionID(toClass->GetName(), args, cf, false);
+		uint16 functionID = toClass->GetFunctionID(program, toClass->GetName(), args, cf, false);
 		if (functionID == INVALID_ID) return -1;
 		*castFunctionID = functionID;
 		return 2;
@@ -114,10 +127,9 @@ static int32 GetConversionScore(Program* program, const TypeInfo& from, const Ty
 	return -1; // incompatible
 }
 
-uint16 Class::GetFunctionID(const std::string& name, const std::vector<ASTExpression*>& args, std::vector<uint16>& castFunctionIDs, bool checkParamConversion)
+uint16 Class::GetFunctionID(Program* program, const std::string& name, const std::vector<ASTExpression*>& args, std::vector<uint16>& castFunctionIDs, bool checkParamConversion)
 {
 	castFunctionIDs.clear();
-	Program* program = Program::GetCompiledProgram();
 
 	// First try exact signature match
 	std::string exactSignature = Function::GenerateSignatureFromArgs(program, name, args);
@@ -142,7 +154,7 @@ uint16 Class::GetFunctionID(const std::string& name, const std::vector<ASTExpres
 		if (sig.rfind(name + "-", 0) != 0)
 			continue;
 
-		Function* func = FindFunctionBySignature(sig);
+		Function* func = FindFunctionBySignature(sig, program);
 		if (!func || func->parameters.size() != args.size())
 			continue;
 
@@ -178,7 +190,7 @@ uint16 Class::GetFunctionID(const std::string& name, const std::vector<ASTExpres
 	return INVALID_ID;
 }
 
-Function* Class::FindFunctionBySignature(const std::string& signature)
+Function* Class::FindFunctionBySignature(const std::string& signature, Program* program)
 {
 	// Extract the function name before the first '-'
 	size_t dashPos = signature.find('-');
@@ -192,7 +204,7 @@ Function* Class::FindFunctionBySignature(const std::string& signature)
 	// Search for a function with an exact matching signature
 	for (Function* func : it->second)
 	{
-		std::string funcSig = func->GenerateSignature();
+		std::string funcSig = func->GenerateSignature(program);
 		if (funcSig == signature)
 			return func;
 	}
@@ -200,18 +212,31 @@ Function* Class::FindFunctionBySignature(const std::string& signature)
 	return nullptr;
 }
 
-void Class::AddMemberField(const std::string& name, uint16 type, uint8 pointerLevel, uint64 offset, uint64 size, const std::vector<std::pair<uint32,
-	std::string>>& dimensions, const std::string& templateTypeName, TemplateInstantiationCommand* command)
+Function* Class::FindFunctionByName(const std::string& name) const
 {
-	if (HasBaseClass())
-		offset += m_BaseClass->GetSize();
+	const auto it = m_Functions.find(name);
+	if (it == m_Functions.end() || it->second.size() != 1)
+		return nullptr;
+
+	return it->second[0];
+}
+
+uint32 Class::GetNumFunctionsNamed(const std::string& name) const
+{
+	const auto it = m_Functions.find(name);
+	return it == m_Functions.end() ? 0 : it->second.size();
+}
 
+void Class::AddMemberField(const std::string& name, uint16 type, uint8 pointerLevel, uint64 size, uint64 alignment, const std::vector<std::pair<uint32,
+	std::string>>& dimensions, const std::string& templateTypeName, TemplateInstantiationCommand* command)
+{
 	ClassField field;
 	field.name = name;
 	field.type.type = type;
 	field.type.pointerLevel = pointerLevel;
-	field.offset = offset;
+	field.offset = 0;
 	field.size = size;
+	field.alignment = alignment;
 	field.numDimensions = dimensions.size();
 	field.instantiationCommand = command;
 	field.templateTypeName = templateTypeName;
@@ -221,14 +246,15 @@ void Class::AddMemberField(const std::string& name, uint16 type, uint8 pointerLe
 	m_MemberFields.push_back(field);
 }
 
-void Class::AddStaticField(const std::string& name, uint16 type, uint8 pointerLevel, uint64 offset, uint64 size, const std::vector<std::pair<uint32, std::string>>& dimensions, ASTExpression* initializeExpr)
+void Class::AddStaticField(const std::string& name, uint16 type, uint8 pointerLevel, uint64 size, uint64 alignment, const std::vector<std::pair<uint32, std::string>>& dimensions, ASTExpression* initializeExpr)
 {
 	ClassField field;
 	field.name = name;
 	field.type.type = type;
 	field.type.pointerLevel = pointerLevel;
-	field.offset = offset;
+	field.offset = 0;
 	field.size = size;
+	field.alignment = alignment;
 	field.initializeExpr = initializeExpr;
 	field.numDimensions = dimensions.size();
 	field.instantiationCommand = nullptr;
@@ -238,6 +264,108 @@ void Class::AddStaticField(const std::string& name, uint16 type, uint8 pointerLe
 	m_StaticFields.push_back(field);
 }
 
+static uint64 GetFieldAlignment(Program* program, const ClassField& field)
+{
+	// Array fields are stored inline and their pointer level includes the array itself
+	uint8 elementPointerLevel = field.numDimensions > 0 ? field.type.pointerLevel - 1 : field.type.pointerLevel;
+	uint64 alignment = elementPointerLevel > 0 ? alignof(void*) : program->GetTypeAlignment(field.type.type);
+	if (field.numDimensions > 0)
+		alignment = std::max<uint64>(alignment, alignof(ArrayHeader));
+
+	return std::max(alignment, field.alignment);
+}
+
+static uint64 PlaceField(Program* program, ClassField& field, uint64 offset)
+{
+	// The ArrayHeader of an array field sits right in front of its first element
+	uint64 headerSize = field.numDimensions > 0 ? sizeof(ArrayHeader) : 0;
+	field.offset = Memory::AlignUp(offset + headerSize, GetFieldAlignment(program, field));
+	return field.offset - headerSize + field.size;
+}
+
+void Class::ComputeLayout(Program* program)
+{
+	uint64 baseSize = HasBaseClass() ? m_BaseClass->GetSize() : 0;
+	m_Alignment = HasBaseClass() ? m_BaseClass->GetAlignment() : 1;
+	m_Alignment = std::max(m_Alignment, m_RequestedAlignment);
+
+	uint64 offset = baseSize;
+	for (uint32 i = 0; i < m_MemberFields.size(); i++)
+	{
+		offset = PlaceField(program, m_MemberFields[i], offset);
+		m_Alignment = std::max(m_Alignment, GetFieldAlignment(program, m_MemberFields[i]));
+	}
+
+	// Padded so every element of an array of this class stays aligned
+	m_DeclaredOrderSize = Memory::AlignUp(offset, m_Alignment);
+
+	if (m_Packed || program->GetPackAllClasses())
+	{
+		// Only the offsets move, m_MemberFields keeps declaration order for construction and copies
+		std::vector<uint32> order(m_MemberFields.size());
+		for (uint32 i = 0; i < order.size(); i++)
+			order[i] = i;
+
+		std::stable_sort(order.begin(), order.end(), [&](uint32 a, uint32 b) {
+			return GetFieldAlignment(program, m_MemberFields[a]) > GetFieldAlignment(program, m_MemberFields[b]);
+		});
+
+		offset = baseSize;
+		for (uint32 i = 0; i < order.size(); i++)
+			offset = PlaceField(program, m_MemberFields[order[i]], offset);
+
+		m_Packed = true;
+	}
+
+	m_Size = Memory::AlignUp(offset, m_Alignment);
+
+	uint64 staticOffset = 0;
+	m_StaticAlignment = 1;
+	for (uint32 i = 0; i < m_StaticFields.size(); i++)
+	{
+		staticOffset = PlaceField(program, m_StaticFields[i], staticOffset);
+		m_StaticAlignment = std::max(m_StaticAlignment, GetFieldAlignment(program, m_StaticFields[i]));
+	}
+
+	m_StaticData.size = staticOffset;
+}
+
+uint32 Class::GetFieldCount() const
+{
+	uint32 baseCount = HasBaseClass() ? m_BaseClass->GetFieldCount() : 0;
+	return baseCount + m_MemberFields.size();
+}
+
+const ClassField& Class::GetField(uint32 index) const
+{
+	uint32 baseCount = HasBaseClass() ? m_BaseClass->GetFieldCount() : 0;
+	if (index < baseCount)
+		return m_BaseClass->GetField(index);
+
+	return m_MemberFields[index - baseCount];
+}
+
+uint32 Class::GetFieldIndex(const std::string& name) const
+{
+	uint32 baseCount = HasBaseClass() ? m_BaseClass->GetFieldCount() : 0;
+	for (uint32 i = 0; i < m_MemberFields.size(); i++)
+	{
+		if (m_MemberFields[i].name == name)
+			return baseCount + i;
+	}
+
+	return HasBaseClass() ? m_BaseClass->GetFieldIndex(name) : INVALID_ID;
+}
+
+uint64 Class::GetPadding() const
+{
+	uint64 used = HasBaseClass() ? m_BaseClass->GetSize() : 0;
+	for (uint32 i = 0; i < m_MemberFields.size(); i++)
+		used += m_MemberFields[i].size;
+
+	return m_Size - used;
+}
+
 void Class::EmitCode(Program* program)
 {
 	if (IsTemplateClass()) 
@@ -247,6 +375,7 @@ void Class::EmitCode(Program* program)
 	{
 		Function* function = m_FunctionMap[i];
 		function->pc = program->GetCodeSize();
+		uint64 savingsBefore = program->GetEncodingSavings();
 		for (uint32 i = 0; i < function->body.size(); i++)
 		{
 			function->body[i]->EmitCode(program);
@@ -258,12 +387,13 @@ void Class::EmitCode(Program* program)
 
 		uint64 functionCodeSize = program->GetCodeSize() - function->pc;
 		m_CodeSize += functionCodeSize;
+		m_FixedWidthCodeSize += functionCodeSize + (program->GetEncodingSavings() - savingsBefore);
 	}
 }
 
 void Class::InitStaticData(Program* program)
 {
-	m_StaticData.data = program->GetStackAllocator()->Alloc(m_StaticData.size);
+	m_StaticData.data = program->GetHeapAllocator()->AllocAligned(m_StaticData.size, m_StaticAlignment);
 	memset(m_StaticData.data, 0, m_StaticData.size);
 
 	for (uint32 i = 0; i < m_StaticFields.size(); i++)
@@ -271,13 +401,22 @@ void Class::InitStaticData(Program* program)
 		const ClassField& field = m_StaticFields[i];
 		if (field.initializeExpr)
 		{
-			ASTExpressionStaticVariable* variableExpr = new ASTExpressionStaticVariable(m_ID, field.offset, field.type, field.dimensions > 0);
-			ASTExpressionSet* setExpr = new ASTExpressionSet(variableExpr, field.initializeExpr);
+			ASTExpressionStaticVariable* variableExpr = new (program) ASTExpressionStaticVariable(m_ID, field.offset, field.type, field.dimensions > 0);
+			ASTExpressionSet* setExpr = new (program) ASTExpressionSet(variableExpr, field.initializeExpr);
 			setExpr->EmitCode(program);
 		}
 	}
 }
 
+void Class::ReleaseCompileData()
+{
+	for (uint32 i = 0; i < m_FunctionMap.size(); i++)
+		std::vector<ASTExpression*>().swap(m_FunctionMap[i]->body);
+
+	for (uint32 i = 0; i < m_StaticFields.size(); i++)
+		m_StaticFields[i].initializeExpr = nullptr;
+}
+
 uint64 Class::CalculateMemberOffset(Program* program, const std::vector<std::string>& members, TypeInfo* typeInfo, bool* isArray, uint32 currentMember, uint32 currentOffset)
 {
 	for (uint32 i = currentMember; i < members.size(); i++)
@@ -300,7 +439,7 @@ uint64 Class::CalculateMemberOffset(Program* program, const std::vector<std::str
 				}
 
 				// Recurse into sub-class
-				Class* subClass = Program::GetCompiledProgram()->GetClass(member.type.type);
+				Class* subClass = program->GetClass(member.type.type);
 				if (!subClass)
 					throw std::runtime_error("Invalid class type for member: " + member.name);
 
@@ -373,6 +512,12 @@ uint64 Class::CalculateStaticOffset(Program* program, const std::vector<std::str
 	return UINT64_MAX;
 }
 
+void Class::ReleaseStaticData(Program* program)
+{
+	program->GetHeapAllocator()->Free(m_StaticData.data);
+	m_StaticData.data = nullptr;
+}
+
 void* Class::GetStaticData(uint64 offset) const
 {
 	return (uint8*)m_StaticData.data + offset;
@@ -393,8 +538,9 @@ uint16 Class::InstantiateTemplate(Program* program, const TemplateInstantiation&
 	Class* cls = new Class(name);
 	classID = program->AddClass(cls);
 	cls->m_IsTemplateInstance = true;
-	
-	uint64 memberOffset = 0;
+	cls->SetRequestedAlignment(m_RequestedAlignment);
+	cls->SetPacked(m_Packed);
+
 	for (uint32 i = 0; i < m_MemberFields.size(); i++)
 	{
 		const ClassField& member = m_MemberFields[i];
@@ -411,14 +557,16 @@ uint16 Class::InstantiateTemplate(Program* program, const TemplateInstantiation&
 			typeInfo.pointerLevel += instantiation.args[index].pointerLevel;
 		}
 
-		uint64 typeSize = (typeInfo.pointerLevel > 0) ? sizeof(void*) : program->GetTypeSize(typeInfo.type);
+		// Array members are stored inline behind an ArrayHeader, their pointer level includes the array itself
+		uint8 elementPointerLevel = (member.numDimensions > 0) ? typeInfo.pointerLevel - 1 : typeInfo.pointerLevel;
+		uint64 typeSize = (elementPointerLevel > 0) ? sizeof(void*) : program->GetTypeSize(typeInfo.type);
 
 		std::vector<std::pair<uint32, std::string>> dimensions;
 		for (uint32 j = 0; j < member.numDimensions; j++)
 		{
 			if (!member.dimensions[j].second.empty())
 			{
-				uint32 index = InstantiateTemplateGetIndex(program, member.dimensions->second);
+				uint32 index = InstantiateTemplateGetIndex(program, member.dimensions[j].second);
 				uint32 arrayLength = instantiation.args[index].value;
 				dimensions.push_back(std::make_pair(arrayLength, ""));
 			}
@@ -430,18 +578,19 @@ uint16 Class::InstantiateTemplate(Program* program, const TemplateInstantiation&
 			typeSize *= dimensions[j].first;
 		}
 
-		cls->AddMemberField(member.name, typeInfo.type, typeInfo.pointerLevel, memberOffset, typeSize, dimensions, "");
-		memberOffset += typeSize;
+		if (!dimensions.empty())
+			typeSize += sizeof(ArrayHeader);
+
+		cls->AddMemberField(member.name, typeInfo.type, typeInfo.pointerLevel, typeSize, member.alignment, dimensions, "");
 	}
 
-	cls->SetSize(memberOffset);
-	cls->SetStaticDataSize(0);
+	cls->ComputeLayout(program);
 
 	for (uint32 i = 0; i < m_FunctionMap.size(); i++)
 	{
 		Function* function = m_FunctionMap[i];
 		Function* injectedFunction = InstantiateTemplateInjectFunction(program, function, name, instantiation, cls);
-		cls->AddFunction(injectedFunction);
+		cls->AddFunction(program, injectedFunction);
 	}
 
 	return classID;
@@ -475,11 +624,36 @@ bool Class::InheritsFrom(uint16 type) const
 	return false;
 }
 
+bool Class::IsTrivial(Program* program) const
+{
+	// Objects that can be moved with a plain memcpy: no user copy/assign functions, no destructor, and only trivial members
+	if (HasDestructor()) return false;
+	if (HasCopyConstructor() && !m_CopyConstructor->isGenerated) return false;
+	if (HasAssignSTFunction() && !m_AssignSTFunction->isGenerated) return false;
+	if (HasBaseClass() && !m_BaseClass->IsTrivial(program)) return false;
+
+	for (uint32 i = 0; i < m_MemberFields.size(); i++)
+	{
+		const TypeInfo& type = m_MemberFields[i].type;
+		if (type.type == (uint16)ValueType::TEMPLATE_TYPE || type.type == INVALID_ID)
+			return false;
+
+		if (type.pointerLevel > 0 || Value::IsPrimitiveType(type.type))
+			continue;
+
+		if (!program->GetClass(type.type)->IsTrivial(program))
+			return false;
+	}
+
+	return true;
+}
+
 Function* Class::InstantiateTemplateInjectFunction(Program* program, Function* templatedFunction, const std::string& templatedTypeName, const TemplateInstantiation& instantiation, Class* templatedClass)
 {
 	Function* injectedFunction = new Function();
 	injectedFunction->accessModifier = templatedFunction->accessModifier;
 	injectedFunction->isStatic = templatedFunction->isStatic;
+	injectedFunction->isGenerated = templatedFunction->isGenerated;
 	injectedFunction->name = templatedFunction->name;
 	injectedFunction->returnInfo = templatedFunction->returnInfo;
 	injectedFunction->numLocals = templatedFunction->numLocals;
@@ -585,13 +759,15 @@ uint16 Class::ExecuteInstantiationCommand(Program* program, TemplateInstantiatio
 	return type;
 }
 
-void Class::BuildVTable()
+void Class::BuildVTable(Program* program)
 {
 	VTable* vtable = new VTable();
 
 	if (HasBaseClass())
 		*vtable = *m_BaseClass->GetVTable();
 
+	vtable->classID = m_ID;
+
 	for (uint32 i = 0; i < m_FunctionMap.size(); i++)
 	{
 		Function* function = m_FunctionMap[i];
@@ -605,7 +781,7 @@ void Class::BuildVTable()
 			for (uint32 j = 0; j < function->parameters.size(); j++)
 				parameters.push_back(function->parameters[j].type);
 
-			overrideIndex = m_BaseClass->GetVTable()->FindSlot(function->name, parameters);
+			overrideIndex = m_BaseClass->GetVTable()->FindSlot(program, function->name, parameters);
 		}
 
 		if (overrideIndex >= 0)
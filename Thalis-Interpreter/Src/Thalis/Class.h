@@ -20,6 +20,7 @@ struct ClassField
 	TypeInfo type;
 	uint64 offset;
 	uint64 size;
+	uint64 alignment; // Requested with align[N], 0 uses the natural alignment of the type
 	std::string name;
 	ASTExpression* initializeExpr;
 	std::pair<uint32, std::string> dimensions[MAX_ARRAY_DIMENSIONS];
@@ -33,28 +34,54 @@ class Class
 {
 public:
 	Class(const std::string& name, Class* baseClass = nullptr) :
-		m_Name(name), m_BaseName(name), m_BaseClass(baseClass), m_NextFunctionID(0), m_CodeSize(0),
-		m_Destructor(nullptr), m_AssignSTFunction(nullptr), m_CopyConstructor(nullptr), m_DefaultConstructor(nullptr) { }
+		m_Name(name), m_BaseName(name), m_BaseClass(baseClass), m_NextFunctionID(0), m_CodeSize(0), m_FixedWidthCodeSize(0),
+		m_Destructor(nullptr), m_AssignSTFunction(nullptr), m_CopyConstructor(nullptr), m_DefaultConstructor(nullptr),
+		m_Size(0), m_DeclaredOrderSize(0), m_Alignment(1), m_RequestedAlignment(0), m_StaticAlignment(1), m_Packed(false), m_StaticData{ nullptr, 0 }, m_VTable(nullptr) { }
+	~Class();
 
 	std::string GetName() const;
 
-	void AddFunction(Function* function);
+	void AddFunction(Program* program, Function* function);
 	Function* GetFunction(uint16 id);
-	uint16 GetFunctionID(const std::string& name, const std::vector<ASTExpression*>& args, std::vector<uint16>& castFunctionIDs, bool checkParamConversion = true);
-	Function* FindFunctionBySignature(const std::string& signature);
+	inline uint32 GetNumFunctions() const { return m_FunctionMap.size(); }
+	uint16 GetFunctionID(Program* program, const std::string& name, const std::vector<ASTExpression*>& args, std::vector<uint16>& castFunctionIDs, bool checkParamConversion = true);
+	Function* FindFunctionBySignature(const std::string& signature, Program* program);
+	Function* FindFunctionByName(const std::string& name) const; // nullptr unless exactly one overload has this name
+	uint32 GetNumFunctionsNamed(const std::string& name) const;
 
-	void AddMemberField(const std::string& name, uint16 type, uint8 pointerLevel, uint64 offset, uint64 size, const std::vector<std::pair<uint32, std::string>>& dimensions, const std::string& templateTypeName, TemplateInstantiationCommand * command = nullptr);
-	void AddStaticField(const std::string& name, uint16 type, uint8 pointerLevel, uint64 offset, uint64 size, const std::vector<std::pair<uint32, std::string>>& dimensions, ASTExpression* initializeExpr);
+	void AddMemberField(const std::string& name, uint16 type, uint8 pointerLevel, uint64 size, uint64 alignment, const std::vector<std::pair<uint32, std::string>>& dimensions, const std::string& templateTypeName, TemplateInstantiationCommand * command = nullptr);
+	void AddStaticField(const std::string& name, uint16 type, uint8 pointerLevel, uint64 size, uint64 alignment, const std::vector<std::pair<uint32, std::string>>& dimensions, ASTExpression* initializeExpr);
+
+	// Assigns field offsets and pads every field to its alignment. Packed classes place their
+	// fields by decreasing alignment instead of declaration order to leave fewer holes.
+	void ComputeLayout(Program* program);
 
 	inline const std::vector<ClassField>& GetMemberFields() const { return m_MemberFields; }
+
+	// Fields including those of the base classes, base fields come first
+	uint32 GetFieldCount() const;
+	const ClassField& GetField(uint32 index) const;
+	uint32 GetFieldIndex(const std::string& name) const;
 	inline const std::vector<ClassField>& GetStaticFields() const { return m_StaticFields; }
 
 	void EmitCode(Program* program);
 	void InitStaticData(Program* program);
+	void ReleaseStaticData(Program* program);
+	void ReleaseCompileData();
 
-	inline void SetSize(uint64 size) { if (HasBaseClass()) m_Size = m_BaseClass->GetSize() + size; else m_Size = size; }
 	inline uint64 GetSize() const { return m_Size; }
-	inline void SetStaticDataSize(uint64 size) { m_StaticData.size = size; }
+	inline uint64 GetAlignment() const { return m_Alignment; }
+	inline void SetRequestedAlignment(uint64 alignment) { m_RequestedAlignment = alignment; }
+	inline void SetPacked(bool packed) { m_Packed = packed; }
+	inline bool IsPacked() const { return m_Packed; }
+
+	// Bytes of this class (excluding its base) that no field occupies
+	uint64 GetPadding() const;
+	inline uint64 GetDeclaredOrderSize() const { return m_DeclaredOrderSize; }
+
+	// Objects are preceded by their VTable pointer, padded so the object itself stays aligned
+	inline uint64 GetObjectAlignment() const { return m_Alignment > sizeof(VTable*) ? m_Alignment : sizeof(VTable*); }
+	inline uint64 GetObjectHeaderSize() const { return GetObjectAlignment(); }
 
 	inline uint16 GetID() const { return m_ID; }
 	inline void SetID(uint16 id) { m_ID = id; }
@@ -68,6 +95,7 @@ public:
 	int32 InstantiateTemplateGetIndex(Program* program, const std::string& templateTypeName);
 
 	bool InheritsFrom(uint16 type) const;
+	bool IsTrivial(Program* program) const;
 
 	inline bool HasDestructor() const { return m_Destructor != nullptr; }
 	inline bool HasAssignSTFunction() const { return m_AssignSTFunction != nullptr; }
@@ -88,10 +116,11 @@ public:
 	inline VTable* GetVTable() const { return m_VTable; }
 
 	inline uint64 GetCodeSize() const { return m_CodeSize; }
+	inline uint64 GetFixedWidthCodeSize() const { return m_FixedWidthCodeSize; }
 
 	uint16 ExecuteInstantiationCommand(Program* program, TemplateInstantiationCommand* command, const TemplateInstantiation& instantiation);
 
-	void BuildVTable();
+	void BuildVTable(Program* program);
 private:
 	Function* InstantiateTemplateInjectFunction(Program* program, Function* templatedFunction, const std::string& templatedTypeName,
 		const TemplateInstantiation& instantiation, Class* templatedClass);
@@ -105,6 +134,7 @@ private:
 	TemplateDefinition m_TemplateDefinition;
 	bool m_IsTemplateInstance;
 	uint64 m_CodeSize;
+	uint64 m_FixedWidthCodeSize;
 
 	Class* m_BaseClass;
 
@@ -121,6 +151,11 @@ private:
 	std::vector<TemplateInstantiationCommand*> m_InstantiationCommands;
 
 	uint64 m_Size;
+	uint64 m_DeclaredOrderSize;
+	uint64 m_Alignment;
+	uint64 m_RequestedAlignment;
+	uint64 m_StaticAlignment;
+	bool m_Packed;
 
 	std::vector<ClassField> m_MemberFields;
 	std::vector<ClassField> m_StaticFields;
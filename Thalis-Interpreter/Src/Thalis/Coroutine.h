@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+
+#include "ExecutionContext.h"
+
+// A suspended call chain. Everything the coroutine allocates goes to its own stack allocator,
+// so suspending never copies locals: the frames, the call frames and the scopes above the
+// resume point are moved into the coroutine and moved back on the next resume. Indices into
+// the context's stacks are kept relative to where the coroutine was resumed.
+struct Coroutine
+{
+	Function* function;
+	uint16 classID;
+	void* object; // Only set for member functions
+	SegmentedBumpAllocator* stackAllocator;
+
+	std::vector<Value> stack;
+	std::vector<CallFrame> callStack;
+	std::vector<Frame*> frameStack;
+	std::vector<ScopeInfo> scopeStack;
+	std::vector<LoopFrame> loopStack;
+	std::vector<Value> thisStack;
+	uint32 pc;
+
+	bool started;
+	bool running;
+	bool finished;
+	bool detached; // Started with Co.Spawn, the scheduler destroys it once it finished
+	uint32 inlineCallDepth; // Yielding is only allowed at the depth the coroutine was resumed at
+
+	std::vector<uint8> yieldValue; // Bytes of the last yielded value, empty if the last yield had no value
+	real64 wakeTime; // Set by Co.Sleep, read by the scheduler once the coroutine yields
+};
@@ -0,0 +1,2368 @@
+#include "ExecutionContext.h"
+#include "Class.h"
+#include "ASTExpression.h"
+#include "Modules/ModuleID.h"
+#include "Modules/IOModule.h"
+#include "Modules/MathModule.h"
+#include "Modules/WindowModule.h"
+#include "Modules/GLModule.h"
+#include "Modules/JobModule.h"
+#include "Modules/ChanModule.h"
+#include "Modules/HostModule.h"
+#include "PluginModule.h"
+#include "NativeCall.h"
+#include "Memory/Memory.h"
+#include "OpCodeHistogram.h"
+#include "JobSystem.h"
+#include "Coroutine.h"
+#include <thread>
+
+static inline void UnpackValueFlags(uint8 flags, Value& value)
+{
+	value.pointerLevel = flags & 0x3F;
+	value.isReference = (flags >> 6) & 1;
+	value.isArray = (flags >> 7) & 1;
+}
+
+ExecutionContext::ExecutionContext(Program* program)
+{
+	m_Program = program;
+	m_Code = nullptr;
+	m_ProgramCounter = 0;
+	m_OpCodeHistogram = nullptr;
+	m_CurrentScope = -1;
+	m_StackAllocator = new SegmentedBumpAllocator(Memory::KBToBytes(DEFAULT_STACK_SEGMENT_SIZE_KB), Memory::MBToBytes(DEFAULT_STACK_CAPACITY_MB));
+	m_HeapAllocator = new HeapAllocator();
+	m_ReturnAllocator = new BumpAllocator(Memory::KBToBytes(16));
+	m_MaxCallDepth = DEFAULT_MAX_CALL_DEPTH;
+	m_MaxCallStackSize = 0;
+	m_CallbackDepth = 0;
+	m_InlineCallDepth = 0;
+	m_RunningCoroutine = nullptr;
+	m_YieldRequested = false;
+	m_ScopeStack.resize(64);
+	m_CallStack.reserve(64);
+	m_LoopStack.reserve(16);
+	m_JobSystem = nullptr;
+	m_OwnsJobSystem = false;
+	m_JobWorkerIndex = -1;
+	m_NumJobWorkers = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+	m_RestrictStaticsInJobs = false;
+	m_StaticAccessRestricted = false;
+	TimeModule::SetBeginTime(this);
+}
+
+ExecutionContext::~ExecutionContext()
+{
+	if (m_OwnsJobSystem)
+		delete m_JobSystem;
+
+	MemModule::DestroyArenas(this);
+	CoModule::DestroyCoroutines(this);
+	delete m_OpCodeHistogram;
+
+	m_ReturnAllocator->Destroy();
+	m_StackAllocator->Destroy();
+	delete m_ReturnAllocator;
+	delete m_StackAllocator;
+	delete m_HeapAllocator;
+}
+
+void ExecutionContext::Execute(uint32 pc)
+{
+	m_Code = m_Program->GetCode();
+	m_ProgramCounter = pc;
+	OpCode opcode = ReadOPCode();
+	while (opcode != OpCode::END)
+	{
+		ExecuteOpCode(opcode);
+		opcode = ReadOPCode();
+	}
+}
+
+Value ExecutionContext::CallFunction(Function* function, const std::vector<Value>& args)
+{
+	return RunFunction(function, args, nullptr);
+}
+
+Value ExecutionContext::CallMemberFunction(Function* function, uint16 classID, void* object, const std::vector<Value>& args)
+{
+	Value thisValue = Value::MakePointer(classID, 1, object, m_StackAllocator);
+	return RunFunction(function, args, &thisValue);
+}
+
+Value ExecutionContext::CallFunctionReference(uint32 reference, const std::vector<Value>& args, void* object)
+{
+	uint16 classID;
+	Function* function = m_Program->GetFunctionFromReference(reference, &classID);
+	if (!function)
+		throw std::runtime_error("Invalid function reference " + std::to_string(reference));
+
+	if (function->parameters.size() != args.size())
+		throw std::runtime_error("Function " + function->name + " takes " + std::to_string(function->parameters.size()) + " arguments, called with " + std::to_string(args.size()));
+
+	if (function->isStatic)
+		return RunFunction(function, args, nullptr);
+
+	if (!object)
+		throw std::runtime_error("Member function " + function->name + " called without an object");
+
+	return CallMemberFunction(function, classID, object, args);
+}
+
+Value ExecutionContext::RunFunction(Function* function, const std::vector<Value>& args, const Value* thisValue)
+{
+	m_Code = m_Program->GetCode();
+
+	// Everything the call may leave behind if it throws
+	uint32 returnPC = m_ProgramCounter;
+	uint32 stackSize = m_Stack.size();
+	uint32 callStackSize = m_CallStack.size();
+	uint32 frameStackSize = m_FrameStack.size();
+	uint32 thisStackSize = m_ThisStack.size();
+	uint32 loopStackSize = m_LoopStack.size();
+	int32 currentScope = m_CurrentScope;
+	uint32 inlineCallDepth = m_InlineCallDepth;
+	uint64 marker = m_StackAllocator->GetMarker();
+
+	for (uint32 i = 0; i < args.size(); i++)
+		m_Stack.push_back(args[i]);
+
+	CallFrame callFrame;
+	callFrame.basePointer = m_Stack.size();
+	callFrame.popThisStack = thisValue != nullptr;
+	callFrame.usesReturnValue = function->returnInfo.type != (uint16)ValueType::VOID_T || function->returnInfo.pointerLevel > 0;
+	callFrame.loopCount = m_LoopStack.size();
+	callFrame.function = function;
+
+	PushCallScope(function);
+	callFrame.scopeCount = m_CurrentScope;
+
+	Frame* frame = m_FramePool.Acquire(function->numLocals);
+	AddFunctionArgsToFrame(frame, function, false);
+
+	if (thisValue)
+		m_ThisStack.push_back(*thisValue);
+
+	callFrame.returnPC = returnPC;
+	m_CallStack.push_back(callFrame);
+	m_FrameStack.push_back(frame);
+	m_ProgramCounter = function->pc;
+
+	// The module that called us still reads its arguments from m_ArgStorage once we return
+	if (m_CallbackDepth == m_SavedArgStorage.size())
+		m_SavedArgStorage.emplace_back();
+	m_SavedArgStorage[m_CallbackDepth++].swap(m_ArgStorage);
+	m_InlineCallDepth++;
+
+	try
+	{
+		while (m_CallStack.size() > callStackSize)
+			ExecuteOpCode(ReadOPCode());
+	}
+	catch (...)
+	{
+		for (uint32 i = frameStackSize; i < m_FrameStack.size(); i++)
+			m_FramePool.Release(m_FrameStack[i]);
+
+		for (int32 i = m_CurrentScope; i > currentScope; i--)
+			m_ScopeStack[i].objects.clear();
+
+		m_Stack.resize(stackSize);
+		m_CallStack.resize(callStackSize);
+		m_FrameStack.resize(frameStackSize);
+		m_ThisStack.resize(thisStackSize);
+		m_LoopStack.resize(loopStackSize);
+		m_CurrentScope = currentScope;
+		m_StackAllocator->FreeToMarker(marker);
+		m_ProgramCounter = returnPC;
+		m_SavedArgStorage[--m_CallbackDepth].swap(m_ArgStorage);
+		m_InlineCallDepth = inlineCallDepth;
+		throw;
+	}
+
+	m_SavedArgStorage[--m_CallbackDepth].swap(m_ArgStorage);
+	m_InlineCallDepth--;
+
+	if (!callFrame.usesReturnValue)
+		return Value::MakeNULL();
+
+	Value returnValue = m_Stack.back();
+	m_Stack.pop_back();
+	return returnValue;
+}
+
+Coroutine* ExecutionContext::CreateCoroutine(Function* function, uint16 classID, void* object)
+{
+	Coroutine* coroutine = new Coroutine();
+	coroutine->function = function;
+	coroutine->classID = classID;
+	coroutine->object = object;
+	coroutine->stackAllocator = new SegmentedBumpAllocator(Memory::KBToBytes(COROUTINE_STACK_SEGMENT_SIZE_KB), Memory::MBToBytes(DEFAULT_STACK_CAPACITY_MB));
+	coroutine->pc = function->pc;
+	coroutine->started = false;
+	coroutine->running = false;
+	coroutine->finished = false;
+	coroutine->detached = false;
+	coroutine->inlineCallDepth = 0;
+	coroutine->wakeTime = 0.0;
+	return coroutine;
+}
+
+bool ExecutionContext::ResumeCoroutine(Coroutine* coroutine)
+{
+	if (coroutine->finished)
+		return false;
+
+	if (coroutine->running)
+		throw std::runtime_error("Coroutine " + coroutine->function->name + " resumed while it is running");
+
+	m_Code = m_Program->GetCode();
+
+	// The coroutine's part of every stack starts here, it is rebased onto these on every resume
+	uint32 returnPC = m_ProgramCounter;
+	uint32 stackBase = m_Stack.size();
+	uint32 callStackBase = m_CallStack.size();
+	uint32 frameStackBase = m_FrameStack.size();
+	uint32 thisStackBase = m_ThisStack.size();
+	uint32 loopStackBase = m_LoopStack.size();
+	int32 scopeBase = m_CurrentScope;
+	uint32 inlineCallDepth = m_InlineCallDepth;
+	SegmentedBumpAllocator* stackAllocator = m_StackAllocator;
+	Coroutine* previousCoroutine = m_RunningCoroutine;
+
+	m_StackAllocator = coroutine->stackAllocator;
+	m_RunningCoroutine = coroutine;
+	coroutine->running = true;
+	coroutine->inlineCallDepth = inlineCallDepth;
+
+	if (m_CallbackDepth == m_SavedArgStorage.size())
+		m_SavedArgStorage.emplace_back();
+	m_SavedArgStorage[m_CallbackDepth++].swap(m_ArgStorage);
+
+	try
+	{
+		if (!coroutine->started)
+		{
+			Function* function = coroutine->function;
+
+			CallFrame callFrame;
+			callFrame.basePointer = m_Stack.size();
+			callFrame.popThisStack = coroutine->object != nullptr;
+			callFrame.usesReturnValue = false;
+			callFrame.loopCount = m_LoopStack.size();
+			callFrame.function = function;
+			callFrame.returnPC = returnPC;
+
+			PushCallScope(function);
+			callFrame.scopeCount = m_CurrentScope;
+
+			if (coroutine->object)
+				m_ThisStack.push_back(Value::MakePointer(coroutine->classID, 1, coroutine->object, m_StackAllocator));
+
+			m_CallStack.push_back(callFrame);
+			m_FrameStack.push_back(m_FramePool.Acquire(function->numLocals));
+			coroutine->started = true;
+		}
+		else
+		{
+			m_Stack.insert(m_Stack.end(), coroutine->stack.begin(), coroutine->stack.end());
+			m_FrameStack.insert(m_FrameStack.end(), coroutine->frameStack.begin(), coroutine->frameStack.end());
+			m_ThisStack.insert(m_ThisStack.end(), coroutine->thisStack.begin(), coroutine->thisStack.end());
+
+			for (uint32 i = 0; i < coroutine->callStack.size(); i++)
+			{
+				CallFrame callFrame = coroutine->callStack[i];
+				callFrame.basePointer += stackBase;
+				callFrame.loopCount += loopStackBase;
+				callFrame.scopeCount += scopeBase;
+				m_CallStack.push_back(callFrame);
+			}
+			m_CallStack[callStackBase].returnPC = returnPC;
+
+			for (uint32 i = 0; i < coroutine->loopStack.size(); i++)
+			{
+				LoopFrame loop = coroutine->loopStack[i];
+				loop.scopeCount += scopeBase;
+				m_LoopStack.push_back(loop);
+			}
+
+			for (uint32 i = 0; i < coroutine->scopeStack.size(); i++)
+			{
+				m_CurrentScope++;
+				if ((uint32)m_CurrentScope == m_ScopeStack.size())
+					m_ScopeStack.emplace_back();
+
+				m_ScopeStack[m_CurrentScope].marker = coroutine->scopeStack[i].marker;
+				m_ScopeStack[m_CurrentScope].objects.swap(coroutine->scopeStack[i].objects);
+			}
+
+			coroutine->stack.clear();
+			coroutine->frameStack.clear();
+			coroutine->thisStack.clear();
+			coroutine->callStack.clear();
+			coroutine->loopStack.clear();
+			coroutine->scopeStack.clear();
+		}
+
+		m_ProgramCounter = coroutine->pc;
+		while (m_CallStack.size() > callStackBase && !m_YieldRequested)
+			ExecuteOpCode(ReadOPCode());
+	}
+	catch (...)
+	{
+		for (uint32 i = frameStackBase; i < m_FrameStack.size(); i++)
+			m_FramePool.Release(m_FrameStack[i]);
+
+		for (int32 i = m_CurrentScope; i > scopeBase; i--)
+			m_ScopeStack[i].objects.clear();
+
+		m_Stack.resize(stackBase);
+		m_CallStack.resize(callStackBase);
+		m_FrameStack.resize(frameStackBase);
+		m_ThisStack.resize(thisStackBase);
+		m_LoopStack.resize(loopStackBase);
+		m_CurrentScope = scopeBase;
+		m_InlineCallDepth = inlineCallDepth;
+		m_YieldRequested = false;
+		m_StackAllocator = stackAllocator;
+		m_RunningCoroutine = previousCoroutine;
+		m_ProgramCounter = returnPC;
+		m_SavedArgStorage[--m_CallbackDepth].swap(m_ArgStorage);
+
+		coroutine->running = false;
+		coroutine->finished = true;
+		FreeCoroutineStack(coroutine);
+		throw;
+	}
+
+	if (m_YieldRequested)
+	{
+		m_YieldRequested = false;
+		coroutine->pc = m_ProgramCounter;
+
+		coroutine->stack.assign(m_Stack.begin() + stackBase, m_Stack.end());
+		coroutine->frameStack.assign(m_FrameStack.begin() + frameStackBase, m_FrameStack.end());
+		coroutine->thisStack.assign(m_ThisStack.begin() + thisStackBase, m_ThisStack.end());
+
+		for (uint32 i = callStackBase; i < m_CallStack.size(); i++)
+		{
+			CallFrame callFrame = m_CallStack[i];
+			callFrame.basePointer -= stackBase;
+			callFrame.loopCount -= loopStackBase;
+			callFrame.scopeCount -= scopeBase;
+			coroutine->callStack.push_back(callFrame);
+		}
+
+		for (uint32 i = loopStackBase; i < m_LoopStack.size(); i++)
+		{
+			LoopFrame loop = m_LoopStack[i];
+			loop.scopeCount -= scopeBase;
+			coroutine->loopStack.push_back(loop);
+		}
+
+		coroutine->scopeStack.resize(m_CurrentScope - scopeBase);
+		for (int32 i = scopeBase + 1; i <= m_CurrentScope; i++)
+		{
+			ScopeInfo& scope = coroutine->scopeStack[i - scopeBase - 1];
+			scope.marker = m_ScopeStack[i].marker;
+			scope.objects.swap(m_ScopeStack[i].objects);
+		}
+
+		m_Stack.resize(stackBase);
+		m_CallStack.resize(callStackBase);
+		m_FrameStack.resize(frameStackBase);
+		m_ThisStack.resize(thisStackBase);
+		m_LoopStack.resize(loopStackBase);
+		m_CurrentScope = scopeBase;
+		m_ProgramCounter = returnPC;
+	}
+	else
+	{
+		// The last RETURN already unwound the coroutine's scopes and jumped back to returnPC
+		coroutine->finished = true;
+		FreeCoroutineStack(coroutine);
+	}
+
+	m_StackAllocator = stackAllocator;
+	m_RunningCoroutine = previousCoroutine;
+	m_SavedArgStorage[--m_CallbackDepth].swap(m_ArgStorage);
+	coroutine->running = false;
+	return !coroutine->finished;
+}
+
+void ExecutionContext::DestroyCoroutine(Coroutine* coroutine)
+{
+	if (coroutine->running)
+		throw std::runtime_error("Coroutine " + coroutine->function->name + " destroyed while it is running");
+
+	// A suspended coroutine still owns objects in its scopes, their destructors run on its own stack
+	if (coroutine->started && !coroutine->finished)
+	{
+		SegmentedBumpAllocator* stackAllocator = m_StackAllocator;
+		m_StackAllocator = coroutine->stackAllocator;
+
+		uint32 dcount = m_PendingDestructors.size();
+		for (int32 i = (int32)coroutine->scopeStack.size() - 1; i >= 0; i--)
+		{
+			ScopeInfo& scope = coroutine->scopeStack[i];
+			for (uint32 j = 0; j < scope.objects.size(); j++)
+				AddDestructorRecursive(scope.objects[j]);
+		}
+
+		try
+		{
+			ExecutePendingDestructors(dcount);
+		}
+		catch (...)
+		{
+			m_StackAllocator = stackAllocator;
+			throw;
+		}
+
+		m_StackAllocator = stackAllocator;
+		for (uint32 i = 0; i < coroutine->frameStack.size(); i++)
+			m_FramePool.Release(coroutine->frameStack[i]);
+	}
+
+	FreeCoroutineStack(coroutine);
+	delete coroutine;
+}
+
+void ExecutionContext::YieldCoroutine()
+{
+	if (!m_RunningCoroutine)
+		throw std::runtime_error("yield outside of a coroutine");
+
+	if (m_InlineCallDepth != m_RunningCoroutine->inlineCallDepth)
+		throw std::runtime_error("yield inside a constructor, destructor, operator or native callback of coroutine " + m_RunningCoroutine->function->name);
+
+	m_YieldRequested = true;
+}
+
+void ExecutionContext::FreeCoroutineStack(Coroutine* coroutine)
+{
+	if (!coroutine->stackAllocator)
+		return;
+
+	coroutine->stackAllocator->Destroy();
+	delete coroutine->stackAllocator;
+	coroutine->stackAllocator = nullptr;
+}
+
+JobSystem* ExecutionContext::GetJobSystem()
+{
+	if (!m_JobSystem)
+	{
+		m_JobSystem = new JobSystem(m_Program, m_NumJobWorkers, m_RestrictStaticsInJobs);
+		m_OwnsJobSystem = true;
+	}
+
+	return m_JobSystem;
+}
+
+void ExecutionContext::SetJobWorker(JobSystem* jobSystem, uint32 workerIndex)
+{
+	m_JobSystem = jobSystem;
+	m_OwnsJobSystem = false;
+	m_JobWorkerIndex = workerIndex;
+}
+
+void ExecutionContext::EnableOpCodeHistogram()
+{
+	if (!m_OpCodeHistogram)
+		m_OpCodeHistogram = new OpCodeHistogram();
+}
+
+void ExecutionContext::PrintOpCodeHistogram(uint32 maxEntries) const
+{
+	if (m_OpCodeHistogram)
+		m_OpCodeHistogram->Print(maxEntries);
+}
+
+void ExecutionContext::ExecuteOpCode(OpCode opcode)
+{
+	if (m_OpCodeHistogram)
+		m_OpCodeHistogram->Record(opcode);
+
+	switch (opcode)
+	{
+	case OpCode::JUMP: {
+		m_ProgramCounter = ReadUInt32();
+	} break;
+	case OpCode::JUMP_IF_FALSE: {
+		uint32 target = ReadUInt32();
+		Value condition = m_Stack.back();
+		m_Stack.pop_back();
+		if (!condition.GetBool())
+			m_ProgramCounter = target;
+	} break;
+	case OpCode::LESS_LOCAL_CONST_JUMP_IF_FALSE: {
+		uint16 slot = (uint16)ReadVarUInt();
+		int64 constant = ReadVarInt();
+		uint32 target = ReadUInt32();
+
+		Value local = m_FrameStack.back()->GetLocal(slot).Actual();
+		bool less = local.IsReal() ? local.GetReal64() < (real64)constant : local.GetInt64() < constant;
+		if (!less)
+			m_ProgramCounter = target;
+	} break;
+	case OpCode::PUSH_UINT8: {
+		m_Stack.push_back(Value::MakeUInt8(ReadUInt8(), m_StackAllocator));
+	} break;
+	case OpCode::PUSH_UINT16: {
+		m_Stack.push_back(Value::MakeUInt16(ReadUInt16(), m_StackAllocator));
+	} break;
+	case OpCode::PUSH_UINT32: {
+		m_Stack.push_back(Value::MakeUInt32(ReadUInt32(), m_StackAllocator));
+	} break;
+	case OpCode::PUSH_UINT64: {
+		m_Stack.push_back(Value::MakeUInt64(ReadUInt64(), m_StackAllocator));
+	} break;
+	case OpCode::PUSH_INT8: {
+		m_Stack.push_back(Value::MakeInt8(ReadInt8(), m_StackAllocator));
+	} break;
+	case OpCode::PUSH_INT16: {
+		m_Stack.push_back(Value::MakeInt16(ReadInt16(), m_StackAllocator));
+	} break;
+	case OpCode::PUSH_INT32: {
+		m_Stack.push_back(Value::MakeInt32(ReadInt32(), m_StackAllocator));
+	} break;
+	case OpCode::PUSH_INT32_SMALL: {
+		m_Stack.push_back(Value::MakeInt32(ReadInt8(), m_StackAllocator));
+	} break;
+	case OpCode::PUSH_INT64: {
+		m_Stack.push_back(Value::MakeInt64(ReadInt64(), m_StackAllocator));
+	} break;
+	case OpCode::PUSH_REAL32: {
+		m_Stack.push_back(Value::MakeReal32(ReadReal32(), m_StackAllocator));
+	} break;
+	case OpCode::PUSH_REAL64: {
+		m_Stack.push_back(Value::MakeReal64(ReadReal64(), m_StackAllocator));
+	} break;
+	case OpCode::PUSH_CHAR: {
+		m_Stack.push_back(Value::MakeChar(ReadInt8(), m_StackAllocator));
+	} break;
+	case OpCode::PUSH_BOOL: {
+		m_Stack.push_back(Value::MakeBool(ReadUInt8(), m_StackAllocator));
+	} break;
+	case OpCode::PUSH_CSTR: {
+		m_Stack.push_back(Value::MakePointer((uint16)ValueType::CHAR, 1, ReadCStr(), m_StackAllocator));
+	} break;
+	case OpCode::PUSH_LOCAL: {
+		uint16 slot = (uint16)ReadVarUInt();
+		Frame* frame = m_FrameStack.back();
+		m_Stack.push_back(frame->GetLocal(slot).Actual());
+	} break;
+	case OpCode::PUSH_TYPED_NULL: {
+		uint16 type = ReadUInt16();
+		uint8 pointerLevel = ReadUInt8();
+		m_Stack.push_back(Value::MakeNULL(type, pointerLevel));
+	} break;
+	case OpCode::PUSH_UNTYPED_NULL: {
+		m_Stack.push_back(Value::MakeNULL());
+	} break;
+	case OpCode::PUSH_INDEXED: {
+		uint64 typeSize = ReadVarUInt();
+		uint8 numIndices = ReadUInt8();
+		uint16 indexFunctionID = ReadUInt16();
+
+		if (indexFunctionID != INVALID_ID)
+		{
+			uint16 classID = ReadUInt16();
+			Class* cls = m_Program->GetClass(classID);
+			Function* function = cls->GetFunction(indexFunctionID);
+
+			CallFrame callFrame;
+			callFrame.basePointer = m_Stack.size();
+			callFrame.popThisStack = true;
+			callFrame.usesReturnValue = true;
+			callFrame.loopCount = m_LoopStack.size();
+			callFrame.function = function;
+
+			PushCallScope(callFrame.function);
+			callFrame.scopeCount = m_CurrentScope;
+
+			Frame* frame = m_FramePool.Acquire(function->numLocals);
+			AddFunctionArgsToFrame(frame, function);
+
+			callFrame.returnPC = m_ProgramCounter;
+
+			Value objToCallFunctionOn = m_Stack.back(); m_Stack.pop_back();
+			m_ThisStack.push_back(Value::MakePointer(classID, 1, objToCallFunctionOn.data, m_StackAllocator));
+
+			m_CallStack.push_back(callFrame);
+			m_FrameStack.push_back(frame);
+
+			m_ProgramCounter = function->pc;
+
+			break;
+		}
+
+		for (uint8 i = 0; i < numIndices; i++)
+		{
+			m_Dimensions[i] = m_Stack.back().Actual().GetUInt32();
+			m_Stack.pop_back();
+		}
+
+		Value base = m_Stack.back();
+		m_Stack.pop_back();
+		
+		Value element;
+		element.type = base.type;
+		element.pointerLevel = base.pointerLevel - 1;
+		element.isArray = false;
+		element.isReference = false;
+
+		if (base.isArray)
+		{
+			uint32 index = base.Calculate1DArrayIndex(m_Dimensions);
+
+			if (element.pointerLevel > 0)
+			{
+				element.data = (void**)((uint8*)base.data + index * sizeof(void*));
+			}
+			else
+			{
+				element.data = (uint8*)base.data + index * typeSize;
+			}
+		}
+		else if (base.IsPointer())
+		{
+			void* ptr = *(void**)base.data;
+
+			uint8 pointerLevel = element.pointerLevel;
+			for (uint32 i = 0; i < numIndices; i++)
+			{
+				if (pointerLevel > 0)
+				{
+					ptr = (void**)((uint8*)ptr + m_Dimensions[i] * sizeof(void*));
+				}
+				else
+				{
+					ptr = (uint8*)ptr + m_Dimensions[i] * typeSize;
+				}
+
+				pointerLevel--;
+			}
+
+			element.data = ptr;
+		}
+
+		m_Stack.push_back(element);
+	} break;
+	case OpCode::PUSH_STATIC_VARIABLE: {
+		uint16 classID = ReadUInt16();
+
+		Value value;
+		value.type = ReadUInt16();
+		UnpackValueFlags(ReadUInt8(), value);
+		uint64 offset = ReadVarUInt();
+		if (m_StaticAccessRestricted)
+			throw std::runtime_error("Static variable of " + m_Program->GetClass(classID)->GetName() + " accessed from a job");
+
+		value.data = m_Program->GetClass(classID)->GetStaticData(offset);
+
+		m_Stack.push_back(value);
+	} break;
+	case OpCode::PUSH_MEMBER: {
+		Value base = m_Stack.back();
+		m_Stack.pop_back();
+
+		Value member;
+		member.type = ReadUInt16();
+		UnpackValueFlags(ReadUInt8(), member);
+		uint64 offset = ReadVarUInt();
+		member.data = (uint8*)base.data + offset;
+
+		m_Stack.push_back(member);
+	} break;
+	case OpCode::PUSH_THIS_MEMBER: {
+		Value member;
+		member.type = ReadUInt16();
+		UnpackValueFlags(ReadUInt8(), member);
+		uint64 offset = ReadVarUInt();
+		member.data = (uint8*)*(void**)m_ThisStack.back().data + offset;
+
+		m_Stack.push_back(member);
+	} break;
+	case OpCode::PUSH_LOCAL_MEMBER: {
+		uint16 slot = (uint16)ReadVarUInt();
+		Value base = m_FrameStack.back()->GetLocal(slot).Actual();
+
+		Value member;
+		member.type = ReadUInt16();
+		UnpackValueFlags(ReadUInt8(), member);
+		uint64 offset = ReadVarUInt();
+		member.data = (uint8*)base.data + offset;
+
+		m_Stack.push_back(member);
+	} break;
+	case OpCode::PUSH_LOCAL_POINTER_MEMBER: {
+		uint16 slot = (uint16)ReadVarUInt();
+		Value base = m_FrameStack.back()->GetLocal(slot).Actual();
+
+		Value member;
+		member.type = ReadUInt16();
+		UnpackValueFlags(ReadUInt8(), member);
+		uint64 offset = ReadVarUInt();
+		member.data = (uint8*)*(void**)base.data + offset;
+
+		m_Stack.push_back(member);
+	} break;
+	case OpCode::PUSH_THIS: {
+		m_Stack.push_back(m_ThisStack.back());
+		uint32 bp = 0;
+	} break;
+	case OpCode::DECLARE_UINT8: {
+		uint16 slot = ReadUInt16();
+		Frame* frame = m_FrameStack.back();
+		Value assignValue = m_Stack.back();
+		m_Stack.pop_back();
+		frame->DeclareLocal(slot, Value::MakeUInt8(assignValue.GetUInt8(), m_StackAllocator));
+	} break;
+	case OpCode::DECLARE_UINT16: {
+		uint16 slot = ReadUInt16();
+		Frame* frame = m_FrameStack.back();
+		Value assignValue = m_Stack.back();
+		m_Stack.pop_back();
+		frame->DeclareLocal(slot, Value::MakeUInt16(assignValue.GetUInt16(), m_StackAllocator));
+	} break;
+	case OpCode::DECLARE_UINT32: {
+		uint16 slot = ReadUInt16();
+		Frame* frame = m_FrameStack.back();
+		Value assignValue = m_Stack.back();
+		m_Stack.pop_back();
+		frame->DeclareLocal(slot, Value::MakeUInt32(assignValue.GetUInt32(), m_StackAllocator));
+	} break;
+	case OpCode::DECLARE_UINT64: {
+		uint16 slot = ReadUInt16();
+		Frame* frame = m_FrameStack.back();
+		Value assignValue = m_Stack.back();
+		m_Stack.pop_back();
+		frame->DeclareLocal(slot, Value::MakeUInt64(assignValue.GetUInt64(), m_StackAllocator));
+	} break;
+	case OpCode::DECLARE_INT8: {
+		uint16 slot = ReadUInt16();
+		Frame* frame = m_FrameStack.back();
+		Value assignValue = m_Stack.back();
+		m_Stack.pop_back();
+		frame->DeclareLocal(slot, Value::MakeInt8(assignValue.GetInt8(), m_StackAllocator));
+	} break;
+	case OpCode::DECLARE_INT16: {
+		uint16 slot = ReadUInt16();
+		Frame* frame = m_FrameStack.back();
+		Value assignValue = m_Stack.back();
+		m_Stack.pop_back();
+		frame->DeclareLocal(slot, Value::MakeInt16(assignValue.GetInt16(), m_StackAllocator));
+	} break;
+	case OpCode::DECLARE_INT32: {
+		uint16 slot = ReadUInt16();
+		Frame* frame = m_FrameStack.back();
+		Value assignValue = m_Stack.back();
+		m_Stack.pop_back();
+		frame->DeclareLocal(slot, Value::MakeInt32(assignValue.GetInt32(), m_StackAllocator));
+	} break;
+	case OpCode::DECLARE_INT64: {
+		uint16 slot = ReadUInt16();
+		Frame* frame = m_FrameStack.back();
+		Value assignValue = m_Stack.back();
+		m_Stack.pop_back();
+		frame->DeclareLocal(slot, Value::MakeInt64(assignValue.GetInt64(), m_StackAllocator));
+	} break;
+	case OpCode::DECLARE_REAL32: {
+		uint16 slot = ReadUInt16();
+		Frame* frame = m_FrameStack.back();
+		Value assignValue = m_Stack.back();
+		m_Stack.pop_back();
+		frame->DeclareLocal(slot, Value::MakeReal32(assignValue.GetReal32(), m_StackAllocator));
+	} break;
+	case OpCode::DECLARE_REAL64: {
+		uint16 slot = ReadUInt16();
+		Frame* frame = m_FrameStack.back();
+		Value assignValue = m_Stack.back();
+		m_Stack.pop_back();
+		frame->DeclareLocal(slot, Value::MakeReal64(assignValue.GetReal64(), m_StackAllocator));
+	} break;
+	case OpCode::DECLARE_CHAR: {
+		uint16 slot = ReadUInt16();
+		Frame* frame = m_FrameStack.back();
+		Value assignValue = m_Stack.back();
+		m_Stack.pop_back();
+		frame->DeclareLocal(slot, Value::MakeChar(assignValue.GetChar(), m_StackAllocator));
+	} break;
+	case OpCode::DECLARE_BOOL: {
+		uint16 slot = ReadUInt16();
+		Frame* frame = m_FrameStack.back();
+		Value assignValue = m_Stack.back();
+		m_Stack.pop_back();
+		frame->DeclareLocal(slot, Value::MakeBool(assignValue.GetBool(), m_StackAllocator));
+	} break;
+	case OpCode::DECLARE_POINTER: {
+		uint16 type = ReadUInt16();
+		uint8 pointerLevel = ReadUInt8();
+		uint16 slot = ReadUInt16();
+		Frame* frame = m_FrameStack.back();
+		Value assignValue = m_Stack.back();
+
+		// null is pushed untyped and takes the declared type
+		if (assignValue.type == INVALID_ID)
+			assignValue = Value::MakePointer(type, pointerLevel, nullptr, m_StackAllocator);
+		else
+			assignValue = assignValue.Clone(m_Program, m_StackAllocator);
+
+		m_Stack.pop_back();
+		frame->DeclareLocal(slot, assignValue);
+	} break;
+	case OpCode::DECLARE_STACK_ARRAY: {
+		uint16 type = ReadUInt16();
+		uint8 elementPointerLevel = ReadUInt8();
+		uint8 numDimensions = ReadUInt8();
+		uint32 initializerCount = ReadUInt32();
+		uint16 slot = ReadUInt16();
+
+		uint32 elementCount = 1;
+		for (uint32 i = 0; i < numDimensions; i++)
+		{
+			m_Dimensions[i] = ReadUInt32();
+			elementCount *= m_Dimensions[i];
+		}
+
+		uint64 typeSize = m_Program->GetTypeSize(type);
+		Value array = Value::MakeArray(m_Program, type, elementPointerLevel, m_Dimensions, numDimensions, m_StackAllocator);
+
+		if (!Value::IsPrimitiveType(type))
+		{
+			uint32 ccount = m_PendingConstructors.size();
+			for (uint32 i = 0; i < elementCount; i++)
+			{
+				Value element;
+				element.type = type;
+				element.pointerLevel = elementPointerLevel;
+				element.isReference = false;
+				element.isArray = false;
+				element.data = (uint8*)array.data + i * typeSize;
+
+				AddConstructorRecursive(element, true);
+			}
+
+			ExecutePendingConstructors(ccount);
+		}
+
+		for (uint32 i = 0; i < initializerCount; i++)
+		{
+			Value assignValue = m_Stack.back();
+			m_Stack.pop_back();
+			array.AssignOffset(assignValue, type, elementPointerLevel, typeSize, i * typeSize);
+		}
+
+		m_FrameStack.back()->DeclareLocal(slot, array);
+	} break;
+	case OpCode::DECLARE_OBJECT_WITH_CONSTRUCTOR: {
+		uint16 type = ReadUInt16();
+		uint16 functionID = ReadUInt16();
+		uint16 slot = ReadUInt16();
+
+		Value object = Value::MakeObject(m_Program, type, m_StackAllocator);
+		m_FrameStack.back()->DeclareLocal(slot, object);
+		m_ScopeStack[m_CurrentScope].objects.push_back(object);
+
+		uint32 ccount = m_PendingConstructors.size();
+		AddConstructorRecursive(object);
+		ExecutePendingConstructors(ccount);
+
+		if (functionID != INVALID_ID)
+		{
+			Function* function = m_Program->GetClass(type)->GetFunction(functionID);
+
+			CallFrame callFrame;
+			callFrame.basePointer = m_Stack.size();
+			callFrame.popThisStack = true;
+			callFrame.usesReturnValue = false;
+			callFrame.loopCount = m_LoopStack.size();
+			callFrame.function = function;
+
+			PushCallScope(callFrame.function);
+			callFrame.scopeCount = m_CurrentScope;
+
+			Frame* frame = m_FramePool.Acquire(function->numLocals);
+			AddFunctionArgsToFrame(frame, function);
+
+			callFrame.returnPC = m_ProgramCounter;
+
+			m_CallStack.push_back(callFrame);
+			m_FrameStack.push_back(frame);
+			m_ThisStack.push_back(Value::MakePointer(type, 1, object.data, m_StackAllocator));
+
+			m_ProgramCounter = function->pc;
+		}
+	} break;
+	case OpCode::DECLARE_OBJECT_WITH_ASSIGN: {
+		uint16 type = ReadUInt16();
+		uint16 slot = ReadUInt16();
+		uint16 copyConstructorID = ReadUInt16();
+
+		Value assignValue = m_Stack.back();
+		m_Stack.pop_back();
+
+		Value object = Value::MakeObject(m_Program, type, m_StackAllocator);
+		m_FrameStack.back()->DeclareLocal(slot, object);
+		m_ScopeStack[m_CurrentScope].objects.push_back(object);
+
+		uint32 ccount = m_PendingConstructors.size();
+		AddConstructorRecursive(object);
+		ExecutePendingConstructors(ccount);
+
+		if (copyConstructorID != INVALID_ID)
+		{
+			Class* cls = m_Program->GetClass(type);
+			Function* copyConstructorFunction = cls->GetFunction(copyConstructorID);
+
+			ExecuteAssignFunction(object, assignValue, copyConstructorFunction);
+		}
+		else
+		{
+			uint64 size = m_Program->GetClass(type)->GetSize();
+			object.Assign(assignValue, size);
+		}
+	} break;
+	case OpCode::DECLARE_REFERENCE: {
+		uint16 slot = ReadUInt16();
+
+		Value assignValue = m_Stack.back();
+		m_Stack.pop_back();
+
+		Value reference = Value::MakeReference(assignValue, m_StackAllocator);
+		m_FrameStack.back()->DeclareLocal(slot, reference);
+	} break;
+	case OpCode::SET: {
+		uint16 assignFunctionID = ReadUInt16();
+		Value variable = m_Stack.back(); m_Stack.pop_back();
+		Value assignValue = m_Stack.back(); m_Stack.pop_back();
+
+		if (assignFunctionID == INVALID_ID)
+		{
+			if (!variable.IsPrimitive())
+			{
+				uint32 bp = 0;
+			}
+
+			variable.Assign(assignValue, m_Program->GetTypeSize(variable.type));
+		}
+		else
+		{
+			Class* cls = m_Program->GetClass(variable.type);
+			Function* assignFunction = cls->GetFunction(assignFunctionID);
+
+			ExecuteAssignFunction(variable, assignValue, assignFunction);
+		}
+	} break;
+	case OpCode::MODULE_CONSTANT: {
+		uint16 moduleID = ReadUInt16();
+		uint16 constantID = ReadUInt16();
+		ExecuteModuleConstant(moduleID, constantID);
+	} break;
+	case OpCode::MODULE_FUNCTION_CALL: {
+		uint16 moduleID = ReadUInt16();
+		uint16 functionID = ReadUInt16();
+		uint8 argCount = ReadUInt8();
+		bool usesReturnValue = ReadUInt8();
+
+		m_ArgStorage.clear();
+		for (uint32 i = 0; i < argCount; i++)
+		{
+			m_ArgStorage.push_back(m_Stack.back());
+			m_Stack.pop_back();
+		}
+
+		ExecuteModuleFunctionCall(moduleID, functionID, usesReturnValue);
+	} break;
+	case OpCode::NATIVE_CALL: {
+		const NativeFunctionDesc* function = (const NativeFunctionDesc*)ReadUInt64();
+		uint8 flags = ReadUInt8();
+
+		// Arguments were pushed last to first, so the first one is on top
+		NativeValue args[THALIS_NATIVE_MAX_PARAMETERS];
+		uint32 top = m_Stack.size() - 1;
+		for (uint32 i = 0; i < function->numParameters; i++)
+			args[i] = NativeCall::Unbox(m_Stack[top - i], function->parameterTypes[i]);
+
+		NativeValue result;
+		result.u = 0;
+		function->function(args, &result);
+
+		if (flags & NATIVE_CALL_REUSE_FIRST_ARG)
+		{
+			Value value = m_Stack[top];
+			m_Stack.resize(m_Stack.size() - function->numParameters);
+			if (!NativeCall::BoxInto(result, function->returnType, &value))
+				value = NativeCall::Box(result, function->returnType, m_StackAllocator);
+
+			m_Stack.push_back(value);
+		}
+		else
+		{
+			m_Stack.resize(m_Stack.size() - function->numParameters);
+			if ((flags & NATIVE_CALL_USES_RETURN_VALUE) && function->returnType != NativeType::VOID_T)
+				m_Stack.push_back(NativeCall::Box(result, function->returnType, m_StackAllocator));
+		}
+	} break;
+	case OpCode::YIELD: {
+		bool hasValue = ReadUInt8();
+		YieldCoroutine();
+
+		// The value is copied out, anything it points to has to outlive the next resume
+		if (hasValue)
+		{
+			Value value = m_Stack.back().Actual(); m_Stack.pop_back();
+			uint64 size = value.IsPointer() ? sizeof(void*) : m_Program->GetTypeSize(value.type);
+			m_RunningCoroutine->yieldValue.resize(size);
+			memcpy(m_RunningCoroutine->yieldValue.data(), value.data, size);
+		}
+		else
+		{
+			m_RunningCoroutine->yieldValue.clear();
+		}
+	} break;
+	case OpCode::STATIC_FUNCTION_CALL: {
+		uint16 classID = ReadUInt16();
+		uint16 functionID = ReadUInt16();
+		bool usesReturnValue = ReadUInt8();
+
+		Function* function = m_Program->GetClass(classID)->GetFunction(functionID);
+
+		CallFrame callFrame;
+		callFrame.basePointer = m_Stack.size();
+		callFrame.popThisStack = false;
+		callFrame.usesReturnValue = usesReturnValue;
+		callFrame.loopCount = m_LoopStack.size();
+		callFrame.function = function;
+
+		PushCallScope(callFrame.function);
+		callFrame.scopeCount = m_CurrentScope;
+
+		Frame* frame = m_FramePool.Acquire(function->numLocals);
+		AddFunctionArgsToFrame(frame, function);
+
+		callFrame.returnPC = m_ProgramCounter;
+
+		m_CallStack.push_back(callFrame);
+		m_FrameStack.push_back(frame);
+
+		m_ProgramCounter = function->pc;
+	} break;
+	case OpCode::RETURN: {
+		uint8 returnInfo = ReadUInt8();
+		Frame* frame = m_FrameStack.back(); m_FrameStack.pop_back();
+		CallFrame callFrame = m_CallStack.back(); m_CallStack.pop_back();
+		m_ProgramCounter = callFrame.returnPC;
+		
+		if (callFrame.popThisStack)
+			m_ThisStack.pop_back();
+
+		m_LoopStack.resize(callFrame.loopCount);
+
+		Value returnValue = Value::MakeNULL();
+		uint64 returnMarker = m_ReturnAllocator->GetMarker();
+		bool addToScope = false;
+		if (returnInfo == 1) //Returns value
+		{
+			if (callFrame.usesReturnValue)
+			{
+				returnValue = m_Stack.back().Actual();
+				if (returnValue.type == INVALID_ID)
+				{
+					// An untyped null takes the declared return type
+					const TypeInfo& returnType = callFrame.function->returnInfo;
+					returnValue = Value::MakePointer(returnType.type, returnType.pointerLevel, nullptr, m_ReturnAllocator);
+				}
+				else if (!returnValue.IsPrimitive() && !returnValue.IsPointer())
+				{
+					Class* cls = m_Program->GetClass(returnValue.type);
+					Function* copyConstructor = cls->GetCopyConstructor();
+					Value dst = Value::MakeObject(m_Program, returnValue.type, m_ReturnAllocator);
+					uint32 ccount = m_PendingCopyConstructors.size();
+					addToScope = true;
+					if (copyConstructor)
+					{
+						m_PendingCopyConstructors.push_back({ dst, returnValue, copyConstructor });
+					}
+					else
+					{
+						AddCopyConstructorRecursive(dst, returnValue);
+					}
+
+					ExecutePendingCopyConstructors(ccount);
+					returnValue = dst;
+				}
+				else
+				{
+					returnValue = returnValue.Clone(m_Program, m_ReturnAllocator);
+				}
+			}
+
+			m_Stack.pop_back();
+		}
+		else if (returnInfo == 2)//Returns reference
+		{
+			returnValue = m_Stack.back();
+			m_Stack.pop_back();
+		}
+
+		uint32 dcount = m_PendingDestructors.size();
+
+		uint64 freeMarker = m_ScopeStack[callFrame.scopeCount].marker;
+		for (int32 i = m_CurrentScope; i >= (int32)callFrame.scopeCount; i--)
+		{
+			ScopeInfo& scope = m_ScopeStack[i];
+			for (uint32 j = 0; j < scope.objects.size(); j++)
+			{
+				AddDestructorRecursive(scope.objects[j]);
+			}
+			scope.objects.clear();
+		}
+		m_CurrentScope = callFrame.scopeCount - 1;
+
+		ExecutePendingDestructors(dcount);
+
+		if (callFrame.function->name == "Shader")
+		{
+			uint32 bp = 0;
+		}
+
+		m_StackAllocator->FreeToMarker(freeMarker);
+
+		if (returnValue.type != INVALID_ID)
+		{
+			if(returnInfo == 2)
+			{
+				m_Stack.push_back(returnValue);
+			}
+			else
+			{
+				Value value = returnValue.Clone(m_Program, m_StackAllocator);
+				m_ReturnAllocator->FreeToMarker(returnMarker);
+				m_Stack.push_back(value);
+
+				if (addToScope)
+				{
+					m_ScopeStack[m_CurrentScope].objects.push_back(value);
+				}
+			}
+		}
+
+		m_FramePool.Release(frame);
+	} break;
+	case OpCode::MEMBER_FUNCTION_CALL: {
+		uint16 classID = ReadUInt16();
+		uint16 functionID = ReadUInt16();
+		bool usesReturnValue = ReadUInt8();
+
+		Class* cls = m_Program->GetClass(classID);
+		Function* function = cls->GetFunction(functionID);
+
+		Value objToCallFunctionOn = m_Stack.back(); m_Stack.pop_back();
+
+		CallFrame callFrame;
+		callFrame.basePointer = m_Stack.size();
+		callFrame.popThisStack = true;
+		callFrame.usesReturnValue = usesReturnValue;
+		callFrame.loopCount = m_LoopStack.size();
+		callFrame.function = function;
+
+		PushCallScope(callFrame.function);
+		callFrame.scopeCount = m_CurrentScope;
+
+		Frame* frame = m_FramePool.Acquire(function->numLocals);
+		AddFunctionArgsToFrame(frame, function);
+
+		callFrame.returnPC = m_ProgramCounter;
+
+		m_ThisStack.push_back(Value::MakePointer(classID, 1, objToCallFunctionOn.data, m_StackAllocator));
+
+		m_CallStack.push_back(callFrame);
+		m_FrameStack.push_back(frame);
+
+		m_ProgramCounter = function->pc;
+	} break;
+	case OpCode::VIRTUAL_FUNCTION_CALL: {
+		uint16 functionID = ReadUInt16();
+		bool usesReturnValue = ReadUInt8();
+
+		Value objToCallFunctionOn = m_Stack.back(); m_Stack.pop_back();
+		m_ThisStack.push_back(objToCallFunctionOn);
+
+		VTable* vtable = *(VTable**)((uint8*)objToCallFunctionOn.data - sizeof(VTable*));
+		Function* function = vtable->GetFunction(functionID);
+
+		CallFrame callFrame;
+		callFrame.basePointer = m_Stack.size();
+		callFrame.popThisStack = true;
+		callFrame.usesReturnValue = usesReturnValue;
+		callFrame.loopCount = m_LoopStack.size();
+		callFrame.function = function;
+
+		PushCallScope(callFrame.function);
+		callFrame.scopeCount = m_CurrentScope;
+
+		Frame* frame = m_FramePool.Acquire(function->numLocals);
+		AddFunctionArgsToFrame(frame, function);
+
+		callFrame.returnPC = m_ProgramCounter;
+
+		m_ThisStack.push_back(Value::MakePointer(objToCallFunctionOn.type, 1, objToCallFunctionOn.data, m_StackAllocator));
+
+		m_CallStack.push_back(callFrame);
+		m_FrameStack.push_back(frame);
+
+		m_ProgramCounter = function->pc;
+	} break;
+	case OpCode::CONSTRUCTOR_CALL: {
+		uint16 type = ReadUInt16();
+		uint16 functionID = ReadUInt16();
+
+		Value object = Value::MakeObject(m_Program, type, m_StackAllocator);
+		m_ScopeStack[m_CurrentScope].objects.push_back(object);
+
+		uint32 ccount = m_PendingConstructors.size();
+		AddConstructorRecursive(object);
+		ExecutePendingConstructors(ccount);
+
+		Class* cls = m_Program->GetClass(type);
+		Function* function = cls->GetFunction(functionID);
+
+		CallFrame callFrame;
+		callFrame.basePointer = m_Stack.size();
+		callFrame.popThisStack = true;
+		callFrame.usesReturnValue = false;
+		callFrame.loopCount = m_LoopStack.size();
+		callFrame.function = function;
+
+		PushCallScope(callFrame.function);
+		callFrame.scopeCount = m_CurrentScope;
+
+		Frame* frame = m_FramePool.Acquire(function->numLocals);
+		AddFunctionArgsToFrame(frame, function);
+
+		callFrame.returnPC = m_ProgramCounter;
+
+		m_ThisStack.push_back(Value::MakePointer(type, 1, object.data, m_StackAllocator));
+
+		m_CallStack.push_back(callFrame);
+		m_FrameStack.push_back(frame);
+
+		m_ProgramCounter = function->pc;
+
+		m_Stack.push_back(object);
+	} break;
+	case OpCode::ADDRESS_OF: {
+		Value value = m_Stack.back();
+		m_Stack.pop_back();
+		Value pointer = Value::MakePointer(value.type, value.pointerLevel + 1, value.data, m_StackAllocator);
+		m_Stack.push_back(pointer);
+	} break;
+	case OpCode::DEREFERENCE: {
+		Value pointer = m_Stack.back();
+		m_Stack.pop_back();
+		Value value = pointer.Dereference();
+		m_Stack.push_back(value);
+	} break;
+	case OpCode::ADD: {
+		uint16 functionID = ReadUInt16();
+		Value rhs = m_Stack.back(); m_Stack.pop_back();
+		Value lhs = m_Stack.back(); m_Stack.pop_back();
+		if (lhs.IsPointer())
+		{
+			Value val = lhs;
+			val.data = (uint8*)lhs.data + rhs.GetUInt64() * m_Program->GetTypeSize(lhs.type);
+			m_Stack.push_back(val);
+		}
+		else if (functionID != INVALID_ID)
+		{
+			Class* cls = m_Program->GetClass(lhs.type);
+			Function* function = cls->GetFunction(functionID);
+			ExecuteArithmaticFunction(lhs, rhs, function);
+		}
+		else
+		{
+			Value value = lhs.Add(rhs, m_StackAllocator);
+			m_Stack.push_back(value);
+		}
+	} break;
+	case OpCode::SUBTRACT: {
+		uint16 functionID = ReadUInt16();
+		Value rhs = m_Stack.back(); m_Stack.pop_back();
+		Value lhs = m_Stack.back(); m_Stack.pop_back();
+		if (lhs.IsPointer())
+		{
+			Value val = lhs;
+			val.data = (uint8*)lhs.data - rhs.GetUInt64() * m_Program->GetTypeSize(lhs.type);
+			m_Stack.push_back(val);
+		}
+		else if (functionID != INVALID_ID)
+		{
+			Class* cls = m_Program->GetClass(lhs.type);
+			Function* function = cls->GetFunction(functionID);
+			ExecuteArithmaticFunction(lhs, rhs, function);
+		}
+		else
+		{
+			Value value = lhs.Sub(rhs, m_StackAllocator);
+			m_Stack.push_back(value);
+		}
+	} break;
+	case OpCode::MULTIPLY: {
+		uint16 functionID = ReadUInt16();
+		Value rhs = m_Stack.back(); m_Stack.pop_back();
+		Value lhs = m_Stack.back(); m_Stack.pop_back();
+		if (functionID != INVALID_ID)
+		{
+			Class* cls = m_Program->GetClass(lhs.type);
+			Function* function = cls->GetFunction(functionID);
+			ExecuteArithmaticFunction(lhs, rhs, function);
+		}
+		else
+		{
+			Value value = lhs.Mul(rhs, m_StackAllocator);
+			m_Stack.push_back(value);
+		}
+	} break;
+	case OpCode::DIVIDE: {
+		uint16 functionID = ReadUInt16();
+		Value rhs = m_Stack.back(); m_Stack.pop_back();
+		Value lhs = m_Stack.back(); m_Stack.pop_back();
+		if (functionID != INVALID_ID)
+		{
+			Class* cls = m_Program->GetClass(lhs.type);
+			Function* function = cls->GetFunction(functionID);
+			ExecuteArithmaticFunction(lhs, rhs, function);
+		}
+		else
+		{
+			Value value = lhs.Div(rhs, m_StackAllocator);
+			m_Stack.push_back(value);
+		}
+	} break;
+	case OpCode::MOD: {
+		uint16 functionID = ReadUInt16();
+		Value rhs = m_Stack.back(); m_Stack.pop_back();
+		Value lhs = m_Stack.back(); m_Stack.pop_back();
+		if (functionID != INVALID_ID)
+		{
+			Class* cls = m_Program->GetClass(lhs.type);
+			Function* function = cls->GetFunction(functionID);
+			ExecuteArithmaticFunction(lhs, rhs, function);
+		}
+		else
+		{
+			Value value = lhs.Mod(rhs, m_StackAllocator);
+			m_Stack.push_back(value);
+		}
+	} break;
+	case OpCode::LESS: {
+		uint16 functionID = ReadUInt16();
+		Value rhs = m_Stack.back(); m_Stack.pop_back();
+		Value lhs = m_Stack.back(); m_Stack.pop_back();
+		if (functionID != INVALID_ID)
+		{
+			Class* cls = m_Program->GetClass(lhs.type);
+			Function* function = cls->GetFunction(functionID);
+			ExecuteArithmaticFunction(lhs, rhs, function);
+		}
+		else
+		{
+			Value value = lhs.LessThan(rhs, m_StackAllocator);
+			m_Stack.push_back(value);
+		}
+	} break;
+	case OpCode::GREATER: {
+		uint16 functionID = ReadUInt16();
+		Value rhs = m_Stack.back(); m_Stack.pop_back();
+		Value lhs = m_Stack.back(); m_Stack.pop_back();
+		if (functionID != INVALID_ID)
+		{
+			Class* cls = m_Program->GetClass(lhs.type);
+			Function* function = cls->GetFunction(functionID);
+			ExecuteArithmaticFunction(lhs, rhs, function);
+		}
+		else
+		{
+			Value value = lhs.GreaterThan(rhs, m_StackAllocator);
+			m_Stack.push_back(value);
+		}
+	} break;
+	case OpCode::LESS_EQUAL: {
+		uint16 functionID = ReadUInt16();
+		Value rhs = m_Stack.back(); m_Stack.pop_back();
+		Value lhs = m_Stack.back(); m_Stack.pop_back();
+		if (functionID != INVALID_ID)
+		{
+			Class* cls = m_Program->GetClass(lhs.type);
+			Function* function = cls->GetFunction(functionID);
+			ExecuteArithmaticFunction(lhs, rhs, function);
+		}
+		else
+		{
+			Value value = lhs.LessThanOrEqual(rhs, m_StackAllocator);
+			m_Stack.push_back(value);
+		}
+	} break;
+	case OpCode::GREATER_EQUAL: {
+		uint16 functionID = ReadUInt16();
+		Value rhs = m_Stack.back(); m_Stack.pop_back();
+		Value lhs = m_Stack.back(); m_Stack.pop_back();
+		if (functionID != INVALID_ID)
+		{
+			Class* cls = m_Program->GetClass(lhs.type);
+			Function* function = cls->GetFunction(functionID);
+			ExecuteArithmaticFunction(lhs, rhs, function);
+		}
+		else
+		{
+			Value value = lhs.GreaterThanOrEqual(rhs, m_StackAllocator);
+			m_Stack.push_back(value);
+		}
+	} break;
+	case OpCode::EQUALS: {
+		uint16 functionID = ReadUInt16();
+		Value rhs = m_Stack.back(); m_Stack.pop_back();
+		Value lhs = m_Stack.back(); m_Stack.pop_back();
+		if (functionID != INVALID_ID)
+		{
+			Class* cls = m_Program->GetClass(lhs.type);
+			Function* function = cls->GetFunction(functionID);
+			ExecuteArithmaticFunction(lhs, rhs, function);
+		}
+		else
+		{
+			Value value = lhs.Equals(rhs, m_StackAllocator);
+			m_Stack.push_back(value);
+		}
+	} break;
+	case OpCode::NOT_EQUALS: {
+		uint16 functionID = ReadUInt16();
+		Value rhs = m_Stack.back(); m_Stack.pop_back();
+		Value lhs = m_Stack.back(); m_Stack.pop_back();
+		if (functionID != INVALID_ID)
+		{
+			Class* cls = m_Program->GetClass(lhs.type);
+			Function* function = cls->GetFunction(functionID);
+			ExecuteArithmaticFunction(lhs, rhs, function);
+		}
+		else
+		{
+			Value value = lhs.NotEquals(rhs, m_StackAllocator);
+			m_Stack.push_back(value);
+		}
+	} break;
+	case OpCode::LOGICAL_AND: {
+		uint16 functionID = ReadUInt16();
+		Value rhs = m_Stack.back(); m_Stack.pop_back();
+		Value lhs = m_Stack.back(); m_Stack.pop_back();
+		Value value = lhs.LogicalAnd(rhs, m_StackAllocator);
+		m_Stack.push_back(value);
+	} break;
+	case OpCode::LOGICAL_OR: {
+		uint16 functionID = ReadUInt16();
+		Value rhs = m_Stack.back(); m_Stack.pop_back();
+		Value lhs = m_Stack.back(); m_Stack.pop_back();
+		Value value = lhs.LogicalOr(rhs, m_StackAllocator);
+		m_Stack.push_back(value);
+	} break;
+	case OpCode::PUSH_SCOPE: {
+		PushScope();
+	} break;
+	case OpCode::POP_MARKER_SCOPE: {
+		// The compiler found no objects in this scope, fall back to a full pop if one was added anyway
+		if (m_ScopeStack[m_CurrentScope].objects.empty())
+		{
+			m_StackAllocator->FreeToMarker(m_ScopeStack[m_CurrentScope].marker);
+			m_CurrentScope--;
+			break;
+		}
+	} [[fallthrough]];
+	case OpCode::POP_SCOPE: {
+		// Destructors can grow the scope stack, so nothing may hold on to the scope while they run
+		ScopeInfo& scope = m_ScopeStack[m_CurrentScope];
+		uint64 marker = scope.marker;
+		uint32 dcount = m_PendingDestructors.size();
+		for (uint32 i = 0; i < scope.objects.size(); i++)
+		{
+			AddDestructorRecursive(scope.objects[i]);
+		}
+		scope.objects.clear();
+		ExecutePendingDestructors(dcount);
+
+		m_StackAllocator->FreeToMarker(marker);
+		m_CurrentScope--;
+	} break;
+	case OpCode::PUSH_LOOP: {
+		LoopFrame loop;
+		loop.startPC = ReadUInt32();
+		loop.endPC = ReadUInt32();
+		loop.scopeCount = m_CurrentScope + ReadUInt8();
+		m_LoopStack.push_back(loop);
+	} break;
+	case OpCode::POP_LOOP: {
+		m_LoopStack.pop_back();
+	} break;
+	case OpCode::UNARY_UPDATE: {
+		uint8 type = ReadUInt8();
+		bool pushToStack = ReadUInt8();
+		switch (type)
+		{
+		case 0: { //Pre-inc
+			Value value = m_Stack.back();
+			value.Increment();
+			if (!pushToStack)
+				m_Stack.pop_back();
+		} break;
+		case 1: { //Pre-dec
+			Value value = m_Stack.back();
+			value.Decrement();
+			if (!pushToStack)
+				m_Stack.pop_back();
+		} break;
+		case 2: { //Post-inc
+			Value value = m_Stack.back(); m_Stack.pop_back();
+			Value clone = pushToStack ? value.Clone(m_Program, m_StackAllocator) : Value::MakeNULL();
+			value.Increment();
+			if (pushToStack)
+				m_Stack.push_back(clone);
+		} break;
+		case 3: { //Post-dec
+			Value value = m_Stack.back(); m_Stack.pop_back();
+			Value clone = pushToStack ? value.Clone(m_Program, m_StackAllocator) : Value::MakeNULL();
+			value.Decrement();
+			if (pushToStack)
+				m_Stack.push_back(clone);
+		} break;
+		}
+	} break;
+	case OpCode::BREAK: {
+		LoopFrame loop = m_LoopStack.back();
+		UnwindScopes(loop.scopeCount);
+		m_ProgramCounter = loop.endPC;
+	} break;
+	case OpCode::CONTINUE: {
+		LoopFrame loop = m_LoopStack.back();
+		UnwindScopes(loop.scopeCount);
+		m_ProgramCounter = loop.startPC;
+	} break;
+	case OpCode::NEW:
+	case OpCode::NEW_IN_ARENA: {
+		uint16 type = ReadUInt16();
+		uint16 functionID = ReadUInt16();
+		Allocator* allocator = opcode == OpCode::NEW_IN_ARENA ? (Allocator*)PopArena() : m_HeapAllocator;
+		Value object = Value::MakeObject(m_Program, type, allocator);
+		Value pointer = Value::MakePointer(type, 1, object.data, m_StackAllocator);
+
+		uint32 ccount = m_PendingConstructors.size();
+		AddConstructorRecursive(object);
+		ExecutePendingConstructors(ccount);
+
+		if (functionID != INVALID_ID)
+		{
+			Function* function = m_Program->GetClass(type)->GetFunction(functionID);
+
+			CallFrame callFrame;
+			callFrame.basePointer = m_Stack.size();
+			callFrame.popThisStack = true;
+			callFrame.usesReturnValue = false;
+			callFrame.loopCount = m_LoopStack.size();
+			callFrame.function = function;
+
+			PushCallScope(callFrame.function);
+			callFrame.scopeCount = m_CurrentScope;
+
+			Frame* frame = m_FramePool.Acquire(function->numLocals);
+			AddFunctionArgsToFrame(frame, function);
+
+			callFrame.returnPC = m_ProgramCounter;
+
+			m_ThisStack.push_back(pointer);
+
+			m_CallStack.push_back(callFrame);
+			m_FrameStack.push_back(frame);
+
+			m_ProgramCounter = function->pc;
+		}
+
+		m_Stack.push_back(pointer);
+	} break;
+	case OpCode::NEW_ARRAY:
+	case OpCode::NEW_ARRAY_IN_ARENA: {
+		uint16 type = ReadUInt16();
+		uint8 pointerLevel = ReadUInt8();
+		Allocator* allocator = opcode == OpCode::NEW_ARRAY_IN_ARENA ? (Allocator*)PopArena() : m_HeapAllocator;
+		uint32 size = m_Stack.back().Actual().GetUInt32();
+		m_Stack.pop_back();
+
+		Value array = Value::MakeArray(m_Program, type, pointerLevel, &size, 1, allocator);
+
+		if (!Value::IsPrimitiveType(type))
+		{
+			uint32 ccount = m_PendingConstructors.size();
+			uint64 typeSize = m_Program->GetTypeSize(type);
+			for (uint32 i = 0; i < size; i++)
+			{
+				Value element;
+				element.type = type;
+				element.pointerLevel = pointerLevel;
+				element.isReference = false;
+				element.isArray = false;
+				element.data = (uint8*)array.data + i * typeSize;
+
+				AddConstructorRecursive(element, true);
+			}
+
+			ExecutePendingConstructors(ccount);
+		}
+
+		Value pointer = Value::MakePointer(type, pointerLevel + 1, array.data, m_StackAllocator);
+		//pointer.isArray = true;
+		m_Stack.push_back(pointer);
+	} break;
+	case OpCode::DELETE: {
+		Value object = m_Stack.back();
+		m_Stack.pop_back();
+
+		object = object.Dereference();
+
+		uint32 dcount = m_PendingDestructors.size();
+		AddDestructorRecursive(object);
+		ExecutePendingDestructors(dcount);
+
+		// The header size depends on the alignment of the dynamic type, which the VTable knows
+		VTable* vtable = *(VTable**)((uint8*)object.data - sizeof(VTable*));
+		Class* cls = m_Program->GetClass(vtable ? vtable->classID : object.type);
+		m_HeapAllocator->Free((uint8*)object.data - cls->GetObjectHeaderSize());
+	} break;
+	case OpCode::DELETE_ARRAY: {
+		Value heapArray = m_Stack.back().Dereference();
+		m_Stack.pop_back();
+
+		ArrayHeader* arrayHeader = (ArrayHeader*)((uint8*)heapArray.data - sizeof(ArrayHeader));
+		if (arrayHeader->elementPointerLevel == 0)
+		{
+			uint32 dcount = m_PendingDestructors.size();
+			uint64 typeSize = m_Program->GetTypeSize(heapArray.type);
+			uint32 numElements = 1;
+			for (uint32 i = 0; i < arrayHeader->numDimensions; i++)
+				numElements *= arrayHeader->dimensions[i];
+
+			for (uint32 i = 0; i < numElements; i++)
+			{
+				Value element;
+				element.type = heapArray.type;
+				element.isArray = false;
+				element.pointerLevel = 0;
+				element.data = (uint8*)heapArray.data + (typeSize * i);
+				AddDestructorRecursive(element);
+			}
+
+			ExecutePendingDestructors(dcount);
+		}
+
+		m_HeapAllocator->Free((uint8*)heapArray.data - Value::GetArrayHeaderSize(m_Program, heapArray.type, arrayHeader->elementPointerLevel));
+	} break;
+	case OpCode::CAST: {
+		uint16 targetType = ReadUInt16();
+		uint8 targetPointerLevel = ReadUInt8();
+		Value value = m_Stack.back();
+		m_Stack.pop_back();
+
+		value = value.CastTo(m_Program, targetType, targetPointerLevel, m_StackAllocator);
+		m_Stack.push_back(value);
+	} break;
+	case OpCode::NEGATE: {
+		Value value = m_Stack.back();
+		m_Stack.pop_back();
+		value = value.Negate(m_StackAllocator);
+		m_Stack.push_back(value);
+	} break;
+	case OpCode::INVERT: {
+		Value value = m_Stack.back();
+		m_Stack.pop_back();
+		value = value.Invert(m_StackAllocator);
+		m_Stack.push_back(value);
+	} break;
+	case OpCode::STRLEN: {
+		Value value = m_Stack.back();
+		m_Stack.pop_back();
+		uint32 length = strlen(value.GetCString());
+		m_Stack.push_back(Value::MakeUInt32(length, m_StackAllocator));
+	} break;
+	case OpCode::FIELD_INFO: {
+		uint16 type = ReadUInt16();
+		FieldQuery query = (FieldQuery)ReadUInt8();
+		uint32 index = m_Stack.back().Actual().GetUInt32();
+		m_Stack.pop_back();
+
+		Class* cls = m_Program->GetClass(type);
+		if (index >= cls->GetFieldCount())
+			throw std::runtime_error("Field index " + std::to_string(index) + " out of range for " + cls->GetName());
+
+		// Array fields report their elements only, the ArrayHeader stays with the object
+		const ClassField& field = cls->GetField(index);
+		uint64 headerSize = field.numDimensions > 0 ? sizeof(ArrayHeader) : 0;
+		uint64 result = query == FieldQuery::OFFSET ? field.offset : field.size - headerSize;
+		m_Stack.push_back(Value::MakeUInt64(result, m_StackAllocator));
+	} break;
+	case OpCode::PLUS_EQUALS: {
+		Value increment = m_Stack.back();
+		m_Stack.pop_back();
+		Value value = m_Stack.back();
+		m_Stack.pop_back();
+		value.PlusEquals(increment);
+	} break;
+	case OpCode::MINUS_EQUALS: {
+		Value increment = m_Stack.back();
+		m_Stack.pop_back();
+		Value value = m_Stack.back();
+		m_Stack.pop_back();
+		value.MinusEquals(increment);
+	} break;
+	case OpCode::TIMES_EQUALS: {
+		Value increment = m_Stack.back();
+		m_Stack.pop_back();
+		Value value = m_Stack.back();
+		m_Stack.pop_back();
+		value.TimesEquals(increment);
+	} break;
+	case OpCode::DIVIDE_EQUALS: {
+		Value increment = m_Stack.back();
+		m_Stack.pop_back();
+		Value value = m_Stack.back();
+		m_Stack.pop_back();
+		value.DivideEquals(increment);
+	} break;
+	case OpCode::INT_TO_STR: {
+		Value value = m_Stack.back();
+		m_Stack.pop_back();
+		Value str = Value::MakeCStr(std::to_string(value.GetInt64()), m_StackAllocator);
+		str = Value::MakePointer((uint16)ValueType::CHAR, 1, str.data, m_StackAllocator);
+		m_Stack.push_back(str);
+	} break;
+	case OpCode::BREAK_POINT: {
+		uint32 bp = 0;
+	} break;
+	case OpCode::STR_TO_INT: {
+		Value strValue = m_Stack.back();
+		m_Stack.pop_back();
+		Value intValue = Value::MakeInt64(std::atoi((char*)*(void**)strValue.data), m_StackAllocator);
+		m_Stack.push_back(intValue);
+	} break;
+	}
+}
+
+void ExecutionContext::ExecuteModuleFunctionCall(uint16 moduleID, uint16 function, bool usesReturnValue)
+{
+	Value value = Value::MakeNULL();
+	switch (moduleID)
+	{
+	case IO_MODULE_ID: value = IOModule::CallFunction(this, function, m_ArgStorage); break;
+	case MATH_MODULE_ID: value = MathModule::CallFunction(this, function, m_ArgStorage); break;
+	case WINDOW_MODULE_ID: value = WindowModule::CallFunction(this, function, m_ArgStorage); break;
+	case GL_MODULE_ID: value = GLModule::CallFunction(this, function, m_ArgStorage); break;
+	case FS_MODULE_ID: value = FSModule::CallFunction(this, function, m_ArgStorage); break;
+	case MEM_MODULE_ID: value = MemModule::CallFunction(this, function, m_ArgStorage); break;
+	case TIME_MODULE_ID: value = TimeModule::CallFunction(this, function, m_ArgStorage); break;
+	case JOB_MODULE_ID: value = JobModule::CallFunction(this, function, m_ArgStorage); break;
+	case CHAN_MODULE_ID: value = ChanModule::CallFunction(this, function, m_ArgStorage); break;
+	case HOST_MODULE_ID: value = HostModule::CallFunction(this, function, m_ArgStorage); break;
+	case CO_MODULE_ID: value = CoModule::CallFunction(this, function, m_ArgStorage); break;
+	case SCHED_MODULE_ID: value = SchedModule::CallFunction(this, function, m_ArgStorage); break;
+	default: value = m_Program->GetPlugin(moduleID)->CallFunction(this, function, m_ArgStorage); break;
+	}
+
+	if (value.type != INVALID_ID && usesReturnValue)
+		m_Stack.push_back(value);
+}
+
+void ExecutionContext::ExecuteModuleConstant(uint16 moduleID, uint16 constant)
+{
+	switch (moduleID)
+	{
+	case IO_MODULE_ID: m_Stack.push_back(IOModule::Constant(this, constant)); break;
+	case MATH_MODULE_ID: m_Stack.push_back(MathModule::Constant(this, constant)); break;
+	case WINDOW_MODULE_ID: m_Stack.push_back(WindowModule::Constant(this, constant)); break;
+	case GL_MODULE_ID: m_Stack.push_back(GLModule::Constant(this, constant)); break;
+	case FS_MODULE_ID: m_Stack.push_back(FSModule::Constant(this, constant)); break;
+	case MEM_MODULE_ID: m_Stack.push_back(MemModule::Constant(this, constant)); break;
+	case TIME_MODULE_ID: m_Stack.push_back(TimeModule::Constant(this, constant)); break;
+	case JOB_MODULE_ID: m_Stack.push_back(JobModule::Constant(this, constant)); break;
+	case CHAN_MODULE_ID: m_Stack.push_back(ChanModule::Constant(this, constant)); break;
+	case HOST_MODULE_ID: m_Stack.push_back(HostModule::Constant(this, constant)); break;
+	case CO_MODULE_ID: m_Stack.push_back(CoModule::Constant(this, constant)); break;
+	case SCHED_MODULE_ID: m_Stack.push_back(SchedModule::Constant(this, constant)); break;
+	default: m_Stack.push_back(m_Program->GetPlugin(moduleID)->Constant(this, constant)); break;
+	}
+}
+
+void ExecutionContext::ExecuteAssignFunction(const Value& dstValue, const Value& assignValue, Function* function)
+{
+	CallFrame callFrame;
+	callFrame.basePointer = m_Stack.size();
+	callFrame.popThisStack = true;
+	callFrame.usesReturnValue = false;
+	callFrame.loopCount = m_LoopStack.size();
+	callFrame.function = function;
+
+	PushCallScope(callFrame.function);
+	callFrame.scopeCount = m_CurrentScope;
+
+	m_Stack.push_back(assignValue);
+	Frame* frame = m_FramePool.Acquire(function->numLocals);
+	AddFunctionArgsToFrame(frame, function);
+
+	callFrame.returnPC = m_ProgramCounter;
+
+	m_ThisStack.push_back(Value::MakePointer(dstValue.type, 1, dstValue.data, m_StackAllocator));
+
+	m_CallStack.push_back(callFrame);
+	m_FrameStack.push_back(frame);
+
+	m_ProgramCounter = function->pc;
+
+	m_InlineCallDepth++;
+	while (m_ProgramCounter != callFrame.returnPC)
+	{
+		OpCode innerOpCode = ReadOPCode();
+
+		if (innerOpCode == OpCode::UNARY_UPDATE)
+		{
+			uint32 bp = 0;
+		}
+
+		if (innerOpCode == OpCode::END) break;
+		ExecuteOpCode(innerOpCode);
+	}
+	m_InlineCallDepth--;
+}
+
+void ExecutionContext::ExecuteArithmaticFunction(const Value& lhs, const Value& rhs, Function* function)
+{
+	CallFrame callFrame;
+	callFrame.basePointer = m_Stack.size();
+	callFrame.popThisStack = true;
+	callFrame.usesReturnValue = true;
+	callFrame.loopCount = m_LoopStack.size();
+	callFrame.function = function;
+
+	PushCallScope(callFrame.function);
+	callFrame.scopeCount = m_CurrentScope;
+
+	m_Stack.push_back(rhs);
+	Frame* frame = m_FramePool.Acquire(function->numLocals);
+	AddFunctionArgsToFrame(frame, function);
+	callFrame.returnPC = m_ProgramCounter;
+
+	m_ThisStack.push_back(Value::MakePointer(lhs.type, 1, lhs.data, m_StackAllocator));
+
+	uint32 callStackSize = m_CallStack.size();
+	m_CallStack.push_back(callFrame);
+	m_FrameStack.push_back(frame);
+
+	m_ProgramCounter = function->pc;
+
+	// Run to the return here so a yield in the operator sees the raised call depth
+	m_InlineCallDepth++;
+	while (m_CallStack.size() > callStackSize)
+		ExecuteOpCode(ReadOPCode());
+	m_InlineCallDepth--;
+}
+
+void ExecutionContext::ExecuteCastFunction(const Value& dstValue, const Value& srcValue, Function* function)
+{
+	CallFrame callFrame;
+	callFrame.basePointer = m_Stack.size();
+	callFrame.popThisStack = true;
+	callFrame.usesReturnValue = false;
+	callFrame.loopCount = m_LoopStack.size();
+	callFrame.function = function;
+
+	PushCallScope(callFrame.function);
+	callFrame.scopeCount = m_CurrentScope;
+
+	m_Stack.push_back(srcValue);
+	Frame* frame = m_FramePool.Acquire(function->numLocals);
+	AddFunctionArgsToFrame(frame, function, false);
+
+	callFrame.returnPC = m_ProgramCounter;
+
+	m_ThisStack.push_back(Value::MakePointer(dstValue.type, 1, dstValue.data, m_StackAllocator));
+
+	m_CallStack.push_back(callFrame);
+	m_FrameStack.push_back(frame);
+
+	m_ProgramCounter = function->pc;
+
+	m_InlineCallDepth++;
+	while (m_ProgramCounter != callFrame.returnPC)
+	{
+		OpCode innerOpCode = ReadOPCode();
+		if (innerOpCode == OpCode::END) break;
+		ExecuteOpCode(innerOpCode);
+	}
+	m_InlineCallDepth--;
+}
+
+void ExecutionContext::UnwindScopes(int32 scope)
+{
+	if (m_CurrentScope <= scope)
+		return;
+
+	uint32 dcount = m_PendingDestructors.size();
+	for (int32 i = m_CurrentScope; i > scope; i--)
+	{
+		ScopeInfo& info = m_ScopeStack[i];
+		for (uint32 j = 0; j < info.objects.size(); j++)
+			AddDestructorRecursive(info.objects[j]);
+
+		info.objects.clear();
+	}
+	ExecutePendingDestructors(dcount);
+
+	m_StackAllocator->FreeToMarker(m_ScopeStack[scope + 1].marker);
+	m_CurrentScope = scope;
+}
+
+BumpAllocator* ExecutionContext::PopArena()
+{
+	uint32 arenaID = m_Stack.back().Actual().GetUInt32();
+	m_Stack.pop_back();
+
+	BumpAllocator* arena = MemModule::GetArena(this, arenaID);
+	if (!arena)
+		throw std::runtime_error("new with an invalid arena " + std::to_string(arenaID));
+
+	return arena;
+}
+
+void ExecutionContext::ThrowCallDepthExceeded(Function* function)
+{
+	throw std::runtime_error("Maximum call depth of " + std::to_string(m_MaxCallDepth) + " exceeded calling " + function->name);
+}
+
+void ExecutionContext::AddFunctionArgsToFrame(Frame* frame, Function* function, bool readCastFunctionID)
+{
+	for (int32 i = function->parameters.size() - 1; i >= 0; i--)
+	{
+		uint16 castFunctionID = INVALID_ID;
+		if (readCastFunctionID)
+			castFunctionID = ReadUInt16();
+
+		const FunctionParameter& param = function->parameters[i];
+		Value arg = m_Stack.back(); m_Stack.pop_back();
+
+		if (castFunctionID != INVALID_ID)
+		{
+			Class* toClass = m_Program->GetClass(param.type.type);
+			Function* castFunction = toClass->GetFunction(castFunctionID);
+			Value original = arg;
+			arg = Value::MakeObject(m_Program, param.type.type, m_StackAllocator);
+			m_ScopeStack[m_CurrentScope].objects.push_back(arg);
+			ExecuteCastFunction(arg, original, castFunction);
+		}
+
+		if (!param.isReference)
+		{
+			if (!Value::IsPrimitiveType(param.type.type) && param.type.pointerLevel == 0)
+			{
+				Value original = arg;
+				Class* cls = m_Program->GetClass(param.type.type);
+				Function* copyConstructor = cls->GetCopyConstructor();
+				arg = Value::MakeObject(m_Program, arg.type, m_StackAllocator);
+				ExecuteAssignFunction(arg, original, copyConstructor);
+			}
+			else
+			{
+				arg = arg.Clone(m_Program, m_StackAllocator);
+			}
+		}
+		
+		if (arg.type != param.type.type)
+		{
+			if (arg.isReference)
+			{
+				throw std::runtime_error("Reference type mismatch");
+			}
+			else
+			{
+				arg = arg.CastTo(m_Program, param.type.type, param.type.pointerLevel, m_StackAllocator);
+			}
+		}
+
+		frame->DeclareLocal(param.variableID, arg);
+	}
+}
+
+void ExecutionContext::AddDestructorRecursive(const Value& value)
+{
+	if (value.IsPrimitive() || value.IsPointer())
+		return;
+
+	Class* cls = m_Program->GetClass(value.type);
+	if (!cls)
+		return;
+
+	const std::vector<ClassField>& members = cls->GetMemberFields();
+	for (int32 i = (int32)members.size() - 1; i >= 0; i--)
+	{
+		const ClassField& field = members[i];
+
+		if (Value::IsPrimitiveType(field.type.type) || field.type.pointerLevel > 0)
+			continue;
+
+		if (field.numDimensions > 0)
+		{
+			uint64 typeSize = m_Program->GetTypeSize(field.type.type);
+			uint32 numElements = 1;
+			for (uint32 j = 0; j < field.numDimensions; j++)
+				numElements *= field.dimensions[j].first;
+
+			uint8* data = (uint8*)value.data + field.offset;
+			for (uint32 j = 0; j < numElements; j++)
+			{
+				Value element;
+				element.type = field.type.type;
+				element.pointerLevel = 0;
+				element.data = data + j * typeSize;
+
+				AddDestructorRecursive(element);
+			}
+		}
+		else
+		{
+			Value member;
+			member.type = field.type.type;
+			member.pointerLevel = 0;
+			member.data = (uint8*)value.data + field.offset;
+
+			AddDestructorRecursive(member);
+		}
+	}
+
+	m_PendingDestructors.push_back(value);
+}
+
+void ExecutionContext::ExecutePendingDestructors(uint32 offset)
+{
+	if (offset == m_PendingDestructors.size()) return;
+
+	for (uint32 i = offset; i < m_PendingDestructors.size(); i++)
+	{
+		const Value& object = m_PendingDestructors[i];
+		Class* cls = m_Program->GetClass(object.type);
+		Function* destructor = cls->GetDestructor();
+		if (!destructor)
+			continue;
+
+		CallFrame callFrame;
+		callFrame.basePointer = m_Stack.size();
+		callFrame.popThisStack = true;
+		callFrame.usesReturnValue = false;
+		callFrame.loopCount = m_LoopStack.size();
+		callFrame.function = destructor;
+
+		PushCallScope(callFrame.function);
+		callFrame.scopeCount = m_CurrentScope;
+
+		Frame* frame = m_FramePool.Acquire(destructor->numLocals);
+		AddFunctionArgsToFrame(frame, destructor);
+
+		callFrame.returnPC = m_ProgramCounter;
+
+		m_ThisStack.push_back(Value::MakePointer(object.type, 1, object.data, m_StackAllocator));
+
+		m_CallStack.push_back(callFrame);
+		m_FrameStack.push_back(frame);
+
+		m_ProgramCounter = destructor->pc;
+
+		m_InlineCallDepth++;
+		while (m_ProgramCounter != callFrame.returnPC)
+		{
+			OpCode innerOpCode = ReadOPCode();
+			if (innerOpCode == OpCode::END) break;
+			ExecuteOpCode(innerOpCode);
+		}
+		m_InlineCallDepth--;
+	}
+
+	m_PendingDestructors.resize(offset);
+}
+
+void ExecutionContext::AddConstructorRecursive(const Value& value, bool addValue)
+{
+	if (value.IsPrimitive() || value.IsPointer())
+		return;
+
+	Class* cls = m_Program->GetClass(value.type);
+	if (!cls)
+		return;
+
+	const std::vector<ClassField>& members = cls->GetMemberFields();
+	for (int32 i = (int32)members.size() - 1; i >= 0; i--)
+	{
+		const ClassField& field = members[i];
+
+		if (Value::IsPrimitiveType(field.type.type) || field.type.pointerLevel > 0)
+			continue;
+
+		if (field.numDimensions > 0)
+		{
+			uint64 typeSize = m_Program->GetTypeSize(field.type.type);
+			uint32 numElements = 1;
+			for (uint32 j = 0; j < field.numDimensions; j++)
+				numElements *= field.dimensions[j].first;
+
+			uint8* data = (uint8*)value.data + field.offset;
+			for (uint32 j = 0; j < numElements; j++)
+			{
+				Value element;
+				element.type = field.type.type;
+				element.pointerLevel = 0;
+				element.data = data + j * typeSize;
+
+				AddConstructorRecursive(element, true);
+			}
+		}
+		else
+		{
+			Value member;
+			member.type = field.type.type;
+			member.pointerLevel = 0;
+			member.data = (uint8*)value.data + field.offset;
+
+			AddConstructorRecursive(member, true);
+		}
+	}
+
+	if (cls->HasDefaultConstructor() && addValue)
+		m_PendingConstructors.push_back(std::make_pair(value, cls->GetDefaultConstructor()));
+}
+
+void ExecutionContext::ExecutePendingConstructors(uint32 offset)
+{
+	if (offset == m_PendingConstructors.size()) return;
+
+	for (uint32 i = offset; i < m_PendingConstructors.size(); i++)
+	{
+		const Value& object = m_PendingConstructors[i].first;
+		Function* constructor = m_PendingConstructors[i].second;
+
+		CallFrame callFrame;
+		callFrame.basePointer = m_Stack.size();
+		callFrame.popThisStack = true;
+		callFrame.usesReturnValue = false;
+		callFrame.loopCount = m_LoopStack.size();
+		callFrame.function = constructor;
+
+		PushCallScope(callFrame.function);
+		callFrame.scopeCount = m_CurrentScope;
+
+		Frame* frame = m_FramePool.Acquire(constructor->numLocals);
+
+		callFrame.returnPC = m_ProgramCounter;
+
+		m_ThisStack.push_back(Value::MakePointer(object.type, 1, object.data, m_StackAllocator));
+
+		m_CallStack.push_back(callFrame);
+		m_FrameStack.push_back(frame);
+
+		m_ProgramCounter = constructor->pc;
+
+		m_InlineCallDepth++;
+		while (m_ProgramCounter != callFrame.returnPC)
+		{
+			OpCode innerOpCode = ReadOPCode();
+			if (innerOpCode == OpCode::END) break;
+			ExecuteOpCode(innerOpCode);
+		}
+		m_InlineCallDepth--;
+	}
+
+	m_PendingConstructors.resize(offset);
+}
+
+void ExecutionContext::AddCopyConstructorRecursive(const Value& dst, const Value& src)
+{
+	Class* cls = m_Program->GetClass(dst.type);
+	const std::vector<ClassField>& members = cls->GetMemberFields();
+	for (uint32 i = 0; i < members.size(); i++)
+	{
+		const TypeInfo& memberType = members[i].type;
+		uint64 memberOffset = members[i].offset;
+		if (Value::IsPrimitiveType(memberType.type) || memberType.pointerLevel > 0)
+			continue;
+
+		Value dstMember = Value::MakeNULL(memberType.type, 0);
+		Value srcMember = Value::MakeNULL(memberType.type, 0);
+
+		dstMember.data = (uint8*)dst.data + memberOffset;
+		srcMember.data = (uint8*)src.data + memberOffset;
+
+		Class* memberClass = m_Program->GetClass(memberType.type);
+		Function* copyConstructor = memberClass->GetCopyConstructor();
+		if (copyConstructor)
+		{
+			m_PendingCopyConstructors.push_back({ dstMember, srcMember, copyConstructor });
+		}
+		else
+		{
+			AddCopyConstructorRecursive(dstMember, srcMember);
+		}
+	}
+}
+
+void ExecutionContext::ExecutePendingCopyConstructors(uint32 offset)
+{
+	for (uint32 i = offset; i < m_PendingCopyConstructors.size(); i++)
+	{
+		const PendingCopyConstructor& cc = m_PendingCopyConstructors[i];
+		const Value& dst = cc.dst;
+		const Value& src = cc.src;
+		Function* function = cc.constructor;
+
+		m_Stack.push_back(src);
+
+		CallFrame callFrame;
+		callFrame.basePointer = m_Stack.size();
+		callFrame.popThisStack = true;
+		callFrame.usesReturnValue = false;
+		callFrame.loopCount = m_LoopStack.size();
+		callFrame.function = function;
+
+		PushCallScope(callFrame.function);
+		callFrame.scopeCount = m_CurrentScope;
+
+		Frame* frame = m_FramePool.Acquire(function->numLocals);
+		AddFunctionArgsToFrame(frame, function, false);
+
+		callFrame.returnPC = m_ProgramCounter;
+
+		m_ThisStack.push_back(Value::MakePointer(dst.type, 1, dst.data, m_StackAllocator));
+
+		m_CallStack.push_back(callFrame);
+		m_FrameStack.push_back(frame);
+
+		m_ProgramCounter = function->pc;
+
+		m_InlineCallDepth++;
+		while (m_ProgramCounter != callFrame.returnPC)
+		{
+			OpCode innerOpCode = ReadOPCode();
+			if (innerOpCode == OpCode::END) break;
+			ExecuteOpCode(innerOpCode);
+		}
+		m_InlineCallDepth--;
+	}
+
+	m_PendingCopyConstructors.resize(offset);
+}
+
+uint64 ExecutionContext::ReadUInt64()
+{
+	uint64* value = (uint64*)&m_Code[m_ProgramCounter];
+	m_ProgramCounter += sizeof(uint64);
+	return *value;
+}
+
+uint32 ExecutionContext::ReadUInt32()
+{
+	uint32* value = (uint32*)&m_Code[m_ProgramCounter];
+	m_ProgramCounter += sizeof(uint32);
+	return *value;
+}
+
+uint16 ExecutionContext::ReadUInt16()
+{
+	uint16* value = (uint16*)&m_Code[m_ProgramCounter];
+	m_ProgramCounter += sizeof(uint16);
+	return *value;
+}
+
+uint8 ExecutionContext::ReadUInt8()
+{
+	return m_Code[m_ProgramCounter++];
+}
+
+int8 ExecutionContext::ReadInt8()
+{
+	return static_cast<int8>(m_Code[m_ProgramCounter++]);
+}
+
+int16 ExecutionContext::ReadInt16()
+{
+	int16* value = (int16*)&m_Code[m_ProgramCounter];
+	m_ProgramCounter += sizeof(int16);
+	return *value;
+}
+
+int32 ExecutionContext::ReadInt32()
+{
+	int32* value = (int32*)&m_Code[m_ProgramCounter];
+	m_ProgramCounter += sizeof(int32);
+	return *value;
+}
+
+int64 ExecutionContext::ReadInt64()
+{
+	int64* value = (int64*)&m_Code[m_ProgramCounter];
+	m_ProgramCounter += sizeof(int64);
+	return *value;
+}
+
+real32 ExecutionContext::ReadReal32()
+{
+	real32* value = (real32*)&m_Code[m_ProgramCounter];
+	m_ProgramCounter += sizeof(real32);
+	return *value;
+}
+
+real64 ExecutionContext::ReadReal64()
+{
+	real64* value = (real64*)&m_Code[m_ProgramCounter];
+	m_ProgramCounter += sizeof(real64);
+	return *value;
+}
+
+OpCode ExecutionContext::ReadOPCode()
+{
+	return (OpCode)m_Code[m_ProgramCounter++];
+}
+
+uint64 ExecutionContext::ReadVarUInt()
+{
+	uint8 byte = m_Code[m_ProgramCounter++];
+	if (byte < 0x80)
+		return byte;
+
+	uint64 value = byte & 0x7F;
+	uint32 shift = 7;
+	do
+	{
+		byte = m_Code[m_ProgramCounter++];
+		value |= (uint64)(byte & 0x7F) << shift;
+		shift += 7;
+	} while (byte & 0x80);
+
+	return value;
+}
+
+int64 ExecutionContext::ReadVarInt()
+{
+	uint64 value = ReadVarUInt();
+	return (int64)(value >> 1) ^ -(int64)(value & 1);
+}
+
+char* ExecutionContext::ReadCStr()
+{
+	char* value = *(char**)&m_Code[m_ProgramCounter];
+	m_ProgramCounter += sizeof(char*);
+	return value;
+}
+
+
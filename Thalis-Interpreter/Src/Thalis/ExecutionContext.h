@@ -0,0 +1,216 @@
+#pragma once
+
+#include <vector>
+
+#include "Program.h"
+#include "FramePool.h"
+#include "Modules/FSModule.h"
+#include "Modules/MemModule.h"
+#include "Modules/TimeModule.h"
+#include "Modules/CoModule.h"
+#include "Modules/SchedModule.h"
+
+struct CallFrame
+{
+	uint32 returnPC;      // Where to continue after function returns
+	uint32 basePointer;   // Stack index where this function's locals begin
+	bool usesReturnValue;
+	bool popThisStack;
+	uint32 loopCount;
+	uint32 scopeCount;
+	Function* function;
+};
+
+struct ScopeInfo
+{
+	uint64 marker;
+	std::vector<Value> objects;
+};
+
+struct LoopFrame
+{
+	uint32 startPC;
+	uint32 endPC;
+	uint32 scopeCount; // Scope the loop body runs in, break/continue unwind down to it
+};
+
+struct PendingCopyConstructor
+{
+	Value dst;
+	Value src;
+	Function* constructor;
+};
+
+// Everything a running script mutates: the value and call stacks, the allocators and the
+// state of the modules. The Program is only read, so any number of contexts can execute
+// the same Program at once, one per thread. Static fields live in the Program and are shared.
+class OpCodeHistogram;
+class JobSystem;
+struct Coroutine;
+class ExecutionContext
+{
+public:
+	ExecutionContext(Program* program);
+	~ExecutionContext();
+
+	void Execute(uint32 pc);
+
+	// Calls a static function from native code and runs it to completion. The returned value
+	// lives on the stack allocator, it stays valid until the caller frees past its marker.
+	// Module functions may call back into scripts this way, the call reuses this context's stacks.
+	Value CallFunction(Function* function, const std::vector<Value>& args);
+	Value CallMemberFunction(Function* function, uint16 classID, void* object, const std::vector<Value>& args);
+
+	// Calls a reference created with &Class.Function, object is only used for member functions
+	Value CallFunctionReference(uint32 reference, const std::vector<Value>& args, void* object = nullptr);
+
+	// Coroutines run on this context's stacks with their own stack allocator, see Coroutine.h.
+	// Resuming runs until the next yield and returns false once the function has returned.
+	Coroutine* CreateCoroutine(Function* function, uint16 classID = INVALID_ID, void* object = nullptr);
+	bool ResumeCoroutine(Coroutine* coroutine);
+	void DestroyCoroutine(Coroutine* coroutine);
+
+	// Suspends the running coroutine once the current instruction completes
+	void YieldCoroutine();
+	inline Coroutine* GetRunningCoroutine() const { return m_RunningCoroutine; }
+
+	inline Program* GetProgram() const { return m_Program; }
+	inline SegmentedBumpAllocator* GetStackAllocator() const { return m_StackAllocator; }
+	inline HeapAllocator* GetHeapAllocator() const { return m_HeapAllocator; }
+
+	inline uint32 GetStackSize() const { return m_Stack.size(); }
+	inline uint32 GetScopeStackSize() const { return m_CurrentScope + 1; }
+	inline uint32 GetLoopStackSize() const { return m_LoopStack.size(); }
+	inline uint32 GetMaxCallStackSize() const { return m_MaxCallStackSize; }
+
+	inline void SetMaxCallDepth(uint32 depth) { m_MaxCallDepth = depth; }
+	inline uint32 GetMaxCallDepth() const { return m_MaxCallDepth; }
+
+	inline Frame* GetFrame(uint32 frameIndex) { return m_FrameStack[frameIndex]; }
+
+	inline Value StackBack() const { return m_Stack.back(); }
+
+	// The job system is created on first use and shared with the worker contexts it creates
+	JobSystem* GetJobSystem();
+	void SetJobWorker(JobSystem* jobSystem, uint32 workerIndex);
+	inline int32 GetJobWorkerIndex() const { return m_JobWorkerIndex; }
+	inline void SetNumJobWorkers(uint32 numWorkers) { m_NumJobWorkers = numWorkers; }
+	inline void SetRestrictStaticsInJobs(bool restrict) { m_RestrictStaticsInJobs = restrict; }
+
+	// While set, reading or writing a static variable is a runtime error
+	inline void SetStaticAccessRestricted(bool restricted) { m_StaticAccessRestricted = restricted; }
+	inline bool IsStaticAccessRestricted() const { return m_StaticAccessRestricted; }
+
+	inline FSModuleState* GetFSModuleState() { return &m_FSModuleState; }
+	inline MemModuleState* GetMemModuleState() { return &m_MemModuleState; }
+	inline TimeModuleState* GetTimeModuleState() { return &m_TimeModuleState; }
+	inline CoModuleState* GetCoModuleState() { return &m_CoModuleState; }
+	inline SchedModuleState* GetSchedModuleState() { return &m_SchedModuleState; }
+
+	void EnableOpCodeHistogram();
+	void PrintOpCodeHistogram(uint32 maxEntries) const;
+private:
+	void ExecuteOpCode(OpCode opcode);
+	Value RunFunction(Function* function, const std::vector<Value>& args, const Value* thisValue);
+	void ExecuteModuleFunctionCall(uint16 moduleID, uint16 functionID, bool usesReturnValue);
+	void ExecuteModuleConstant(uint16 moduleID, uint16 constant);
+	void ExecuteAssignFunction(const Value& dstValue, const Value& assignValue, Function* function);
+	void ExecuteArithmaticFunction(const Value& lhs, const Value& rhs, Function* function);
+	void ExecuteCastFunction(const Value& dstValue, const Value& srcValue, Function* function);
+
+	void AddFunctionArgsToFrame(Frame* frame, Function* function, bool readCastFunctionID = true);
+	void AddDestructorRecursive(const Value& value);
+	void ExecutePendingDestructors(uint32 offset);
+	void AddConstructorRecursive(const Value& value, bool addValue = false);
+	void ExecutePendingConstructors(uint32 offset);
+	void AddCopyConstructorRecursive(const Value& dst, const Value& src);
+	void ExecutePendingCopyConstructors(uint32 offset);
+	void UnwindScopes(int32 scope);
+	BumpAllocator* PopArena();
+
+	inline void PushScope()
+	{
+		m_CurrentScope++;
+		if ((uint32)m_CurrentScope == m_ScopeStack.size())
+			m_ScopeStack.emplace_back();
+
+		m_ScopeStack[m_CurrentScope].marker = m_StackAllocator->GetMarker();
+	}
+
+	// Every call runs in its own scope, this is where recursion depth is checked
+	inline void PushCallScope(Function* function)
+	{
+		if (m_CallStack.size() >= m_MaxCallDepth)
+			ThrowCallDepthExceeded(function);
+
+		if (m_CallStack.size() >= m_MaxCallStackSize)
+			m_MaxCallStackSize = m_CallStack.size() + 1;
+
+		PushScope();
+	}
+
+	void ThrowCallDepthExceeded(Function* function);
+	void FreeCoroutineStack(Coroutine* coroutine);
+
+	uint64 ReadUInt64();
+	uint32 ReadUInt32();
+	uint16 ReadUInt16();
+	uint8 ReadUInt8();
+	int8 ReadInt8();
+	int16 ReadInt16();
+	int32 ReadInt32();
+	int64 ReadInt64();
+	real32 ReadReal32();
+	real64 ReadReal64();
+	OpCode ReadOPCode();
+	uint64 ReadVarUInt();
+	int64 ReadVarInt();
+	char* ReadCStr();
+private:
+	Program* m_Program;
+	const uint8* m_Code;
+	uint32 m_ProgramCounter;
+
+	std::vector<Value> m_Stack;
+	std::vector<Value> m_ArgStorage;
+	std::vector<std::vector<Value>> m_SavedArgStorage; // Module args of every native call waiting on a callback or coroutine
+	uint32 m_CallbackDepth;
+	uint32 m_InlineCallDepth; // Calls run to completion by a nested loop, native callbacks, constructors, operators
+	Coroutine* m_RunningCoroutine;
+	bool m_YieldRequested;
+
+	FramePool m_FramePool;
+	std::vector<Frame*> m_FrameStack;
+	std::vector<CallFrame> m_CallStack;
+	uint32 m_MaxCallDepth;
+	uint32 m_MaxCallStackSize;
+	std::vector<ScopeInfo> m_ScopeStack;
+	int32 m_CurrentScope;
+	std::vector<LoopFrame> m_LoopStack;
+	std::vector<Value> m_ThisStack;
+
+	uint32 m_Dimensions[MAX_ARRAY_DIMENSIONS];
+
+	SegmentedBumpAllocator* m_StackAllocator;
+	HeapAllocator* m_HeapAllocator;
+	BumpAllocator* m_ReturnAllocator;
+
+	std::vector<Value> m_PendingDestructors;
+	std::vector<std::pair<Value, Function*>> m_PendingConstructors;
+	std::vector<PendingCopyConstructor> m_PendingCopyConstructors;
+
+	FSModuleState m_FSModuleState;
+	MemModuleState m_MemModuleState;
+	TimeModuleState m_TimeModuleState;
+	CoModuleState m_CoModuleState;
+	SchedModuleState m_SchedModuleState;
+
+	JobSystem* m_JobSystem;
+	bool m_OwnsJobSystem;
+	int32 m_JobWorkerIndex; // -1 unless this context belongs to a job worker thread
+	uint32 m_NumJobWorkers;
+	bool m_RestrictStaticsInJobs;
+	bool m_StaticAccessRestricted;
+
+	OpCodeHistogram* m_OpCodeHistogram;
+};
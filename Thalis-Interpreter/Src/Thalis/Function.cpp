@@ -2,10 +2,8 @@
 #include "Program.h"
 #include "ASTExpression.h"
 
-std::string Function::GenerateSignature() const
+std::string Function::GenerateSignature(Program* program) const
 {
-	Program* program = Program::GetCompiledProgram();
-
 	std::string signature = name + "-";
 
 	for (uint32 i = 0; i < parameters.size(); i++)
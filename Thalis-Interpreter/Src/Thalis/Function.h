@@ -29,6 +29,7 @@ struct Function
 	AccessModifier accessModifier;
 	bool isStatic;
 	bool isVirtual;
+	bool isGenerated; // Default copy constructor/assign function created by the parser
 	TypeInfo returnInfo;
 	bool returnsReference;
 	std::vector<FunctionParameter> parameters;
@@ -37,7 +38,8 @@ struct Function
 	uint16 numLocals;
 	std::string returnTemplateTypeName;
 
-	std::string GenerateSignature() const;
+	// Defaults to the program being compiled, executing code has to pass its own
+	std::string GenerateSignature(Program* program) const;
 
 	static std::string GenerateSignatureFromArgs(Program* program, const std::string& name, const std::vector<ASTExpression*>& args);
 };
\ No newline at end of file
@@ -0,0 +1,242 @@
+#include "Host.h"
+#include "Parser.h"
+#include "Program.h"
+#include "ExecutionContext.h"
+#include "Class.h"
+#include <chrono>
+
+static thread_local std::string t_LastError;
+
+Host::Host()
+{
+}
+
+Host::~Host()
+{
+	for (uint32 i = 0; i < m_Programs.size(); i++)
+	{
+		if (m_Programs[i])
+			Release(i + 1);
+	}
+}
+
+void Host::RegisterFunction(const std::string& name, HostFunction function, TypeInfo returnInfo)
+{
+	HostFunctionInfo info;
+	info.name = name;
+	info.function = function;
+	info.returnInfo = returnInfo;
+	m_Functions.push_back(info);
+}
+
+uint32 Host::Compile(const std::string& path)
+{
+	auto compileStart = std::chrono::high_resolution_clock::now();
+
+	Program* program = new Program();
+	program->SetHostFunctions(m_Functions);
+
+	Parser parser(program);
+	parser.SetPrintErrors(false);
+	if (!parser.Parse(path))
+	{
+		t_LastError = parser.GetErrors().front();
+		for (uint32 i = 1; i < parser.GetErrors().size(); i++)
+			t_LastError += "\n" + parser.GetErrors()[i];
+
+		delete program;
+		return 0;
+	}
+
+	try
+	{
+		program->BuildVTables();
+		program->Resolve();
+		program->EmitCode();
+
+		// No entry function, executing the program only runs the static initializers
+		uint32 pc = program->GetCodeSize();
+		program->WriteOPCode(OpCode::END);
+		program->PrepareForExecution(pc);
+	}
+	catch (const std::runtime_error& error)
+	{
+		t_LastError = error.what();
+		delete program;
+		return 0;
+	}
+
+	CompiledProgram* compiled = new CompiledProgram();
+	compiled->program = program;
+	compiled->context = new ExecutionContext(program);
+	compiled->numUsers = 0;
+	compiled->stats = {};
+	compiled->stats.parsedBytes = parser.GetParsedBytes();
+	compiled->stats.codeSize = program->GetCodeSize();
+
+	// Statics are initialized once, the same context then runs every Call
+	try
+	{
+		compiled->context->Execute(program->GetEntryPC());
+	}
+	catch (const std::runtime_error& error)
+	{
+		t_LastError = error.what();
+		delete compiled->context;
+		delete program;
+		delete compiled;
+		return 0;
+	}
+
+	compiled->stats.compileSeconds = std::chrono::duration<real64>(std::chrono::high_resolution_clock::now() - compileStart).count();
+
+	std::lock_guard<std::mutex> lock(m_ProgramMutex);
+	m_Programs.push_back(compiled);
+	return m_Programs.size();
+}
+
+void Host::Release(uint32 program)
+{
+	CompiledProgram* compiled;
+	{
+		std::unique_lock<std::mutex> lock(m_ProgramMutex);
+		if (program == 0 || program > m_Programs.size() || !m_Programs[program - 1])
+			return;
+
+		// New calls no longer find the program, the ones in flight finish first
+		compiled = m_Programs[program - 1];
+		m_Programs[program - 1] = nullptr;
+		m_ProgramReleased.wait(lock, [compiled]() { return compiled->numUsers == 0; });
+	}
+
+	delete compiled->context;
+	delete compiled->program;
+	delete compiled;
+}
+
+bool Host::Call(uint32 program, const std::string& function, const std::vector<Value>& args, Value* result, Allocator* resultAllocator)
+{
+	CompiledProgram* compiled = AcquireProgram(program);
+	if (!compiled)
+	{
+		t_LastError = "Invalid program handle " + std::to_string(program);
+		return false;
+	}
+
+	Function* target = FindFunction(compiled->program, function, args);
+	if (!target)
+	{
+		ReleaseProgram(compiled);
+		return false;
+	}
+
+	std::unique_lock<std::mutex> callLock(compiled->callMutex);
+	ExecutionContext* context = compiled->context;
+	SegmentedBumpAllocator* stackAllocator = context->GetStackAllocator();
+	HeapAllocator* heapAllocator = context->GetHeapAllocator();
+	uint64 marker = stackAllocator->GetMarker();
+	uint64 numAllocs = heapAllocator->GetNumAllocs();
+	uint64 numFrees = heapAllocator->GetNumFrees();
+
+	bool succeeded = true;
+	try
+	{
+		Value returnValue = context->CallFunction(target, args);
+		if (result)
+		{
+			*result = returnValue.type != INVALID_ID && resultAllocator ? returnValue.Clone(compiled->program, resultAllocator) : Value::MakeNULL();
+		}
+	}
+	catch (const std::runtime_error& error)
+	{
+		t_LastError = error.what();
+		succeeded = false;
+	}
+
+	stackAllocator->FreeToMarker(marker);
+	{
+		std::lock_guard<std::mutex> lock(compiled->mutex);
+		HostStats& stats = compiled->stats;
+		stats.numCalls++;
+		if (!succeeded)
+			stats.numFailedCalls++;
+
+		stats.maxStackUsage = std::max(stats.maxStackUsage, stackAllocator->GetMaxUsage());
+		stats.maxCallDepth = std::max(stats.maxCallDepth, context->GetMaxCallStackSize());
+		stats.numHeapAllocs += heapAllocator->GetNumAllocs() - numAllocs;
+		stats.numHeapFrees += heapAllocator->GetNumFrees() - numFrees;
+	}
+	callLock.unlock();
+
+	ReleaseProgram(compiled);
+	return succeeded;
+}
+
+bool Host::GetStats(uint32 program, HostStats* stats)
+{
+	CompiledProgram* compiled = AcquireProgram(program);
+	if (!compiled)
+		return false;
+
+	{
+		std::lock_guard<std::mutex> lock(compiled->mutex);
+		*stats = compiled->stats;
+	}
+
+	ReleaseProgram(compiled);
+	return true;
+}
+
+const std::string& Host::GetLastError() const
+{
+	return t_LastError;
+}
+
+Host::CompiledProgram* Host::AcquireProgram(uint32 program)
+{
+	std::lock_guard<std::mutex> lock(m_ProgramMutex);
+	if (program == 0 || program > m_Programs.size() || !m_Programs[program - 1])
+		return nullptr;
+
+	CompiledProgram* compiled = m_Programs[program - 1];
+	compiled->numUsers++;
+	return compiled;
+}
+
+void Host::ReleaseProgram(CompiledProgram* compiled)
+{
+	std::lock_guard<std::mutex> lock(m_ProgramMutex);
+	compiled->numUsers--;
+	if (compiled->numUsers == 0)
+		m_ProgramReleased.notify_all();
+}
+
+Function* Host::FindFunction(Program* program, const std::string& name, const std::vector<Value>& args)
+{
+	size_t dotPos = name.find('.');
+	Class* cls = dotPos != std::string::npos ? program->GetClassByName(name.substr(0, dotPos)) : nullptr;
+	if (!cls)
+	{
+		t_LastError = "No class for " + name + ", functions are named as Class.Function";
+		return nullptr;
+	}
+
+	std::string signature = name.substr(dotPos + 1) + "-";
+	for (uint32 i = 0; i < args.size(); i++)
+	{
+		signature += program->GetTypeName(args[i].type);
+		if (args[i].pointerLevel > 0)
+			signature += std::to_string(args[i].pointerLevel);
+		if (i + 1 < args.size())
+			signature += "_";
+	}
+
+	Function* function = cls->FindFunctionBySignature(signature, program);
+	if (!function || !function->isStatic)
+	{
+		t_LastError = "No static function matching " + signature + " in " + cls->GetName();
+		return nullptr;
+	}
+
+	return function;
+}
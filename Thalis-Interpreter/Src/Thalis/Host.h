@@ -0,0 +1,78 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+#include "Value.h"
+#include "TypeInfo.h"
+#include "Modules/HostModule.h"
+
+class Program;
+class ExecutionContext;
+struct Function;
+
+struct HostStats
+{
+	real64 compileSeconds;
+	uint64 parsedBytes;
+	uint32 codeSize;
+	uint64 numCalls;
+	uint64 numFailedCalls;
+	uint64 maxStackUsage;
+	uint32 maxCallDepth;
+	uint64 numHeapAllocs;
+	uint64 numHeapFrees;
+};
+
+// Entry point for applications embedding the interpreter. A script is compiled once into a
+// handle and can then be called any number of times, from any number of threads. The calls
+// into one program share its statics, so they run one at a time on the program's context and
+// statics persist between them. Calls into different programs run in parallel.
+// Errors are reported through GetLastError, which is kept per thread.
+class Host
+{
+public:
+	Host();
+	~Host();
+
+	// Only affects programs compiled afterwards
+	void RegisterFunction(const std::string& name, HostFunction function, TypeInfo returnInfo);
+
+	// Returns 0 if the script does not compile. Compiling is not thread safe, calling is.
+	uint32 Compile(const std::string& path);
+	// Waits for the calls in flight to return, so it must not be called from one of the program's
+	// host functions. Calls made afterwards fail.
+	void Release(uint32 program);
+
+	// Calls the static function "Class.Function" with args. A return value is cloned into
+	// resultAllocator, everything else the call allocated is gone once it returns. A host
+	// function must not call into the program that is running it, the call would wait on itself.
+	bool Call(uint32 program, const std::string& function, const std::vector<Value>& args,
+		Value* result = nullptr, Allocator* resultAllocator = nullptr);
+
+	bool GetStats(uint32 program, HostStats* stats);
+	const std::string& GetLastError() const;
+private:
+	struct CompiledProgram
+	{
+		Program* program;
+		ExecutionContext* context;
+		std::mutex callMutex; // Held for the whole call
+		std::mutex mutex;     // Guards stats
+		uint32 numUsers;      // Calls and GetStats still using the program, guarded by m_ProgramMutex
+		HostStats stats;
+	};
+
+	// Release waits until every AcquireProgram got its ReleaseProgram
+	CompiledProgram* AcquireProgram(uint32 program);
+	void ReleaseProgram(CompiledProgram* compiled);
+	Function* FindFunction(Program* program, const std::string& name, const std::vector<Value>& args);
+private:
+	std::vector<HostFunctionInfo> m_Functions;
+
+	std::mutex m_ProgramMutex;
+	std::condition_variable m_ProgramReleased;
+	std::vector<CompiledProgram*> m_Programs;
+};
@@ -0,0 +1,196 @@
+#include "JobSystem.h"
+#include "ExecutionContext.h"
+
+JobSystem::JobSystem(Program* program, uint32 numWorkers, bool restrictStatics)
+{
+	m_Program = program;
+	m_RestrictStatics = restrictStatics;
+	m_Running = true;
+	m_QueuedJobs = 0;
+	m_NextWorker = 0;
+
+	for (uint32 i = 0; i < numWorkers; i++)
+	{
+		Worker* worker = new Worker();
+		worker->context = new ExecutionContext(program);
+		worker->context->SetJobWorker(this, i);
+		m_Workers.push_back(worker);
+	}
+
+	for (uint32 i = 0; i < numWorkers; i++)
+		m_Workers[i]->thread = std::thread(&JobSystem::WorkerLoop, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_SleepMutex);
+		m_Running = false;
+	}
+	m_WakeCondition.notify_all();
+
+	for (uint32 i = 0; i < m_Workers.size(); i++)
+	{
+		m_Workers[i]->thread.join();
+		delete m_Workers[i]->context;
+		delete m_Workers[i];
+	}
+
+	for (uint32 i = 0; i < m_Handles.size(); i++)
+		delete m_Handles[i];
+}
+
+void JobSystem::Submit(ExecutionContext* context, const Job& job)
+{
+	// Workers keep what they spawn, everyone else spreads jobs round robin
+	int32 workerIndex = context->GetJobSystem() == this ? context->GetJobWorkerIndex() : -1;
+	uint32 target = workerIndex >= 0 ? workerIndex : m_NextWorker++ % m_Workers.size();
+
+	// Counted before it is queued so a thief can never take it while the count is still zero
+	{
+		std::lock_guard<std::mutex> lock(m_SleepMutex);
+		m_QueuedJobs++;
+	}
+
+	Worker* worker = m_Workers[target];
+	{
+		std::lock_guard<std::mutex> lock(worker->mutex);
+		worker->jobs.push_back(job);
+	}
+	m_WakeCondition.notify_one();
+}
+
+void JobSystem::Wait(ExecutionContext* context, JobGroup* group)
+{
+	int32 workerIndex = context->GetJobSystem() == this ? context->GetJobWorkerIndex() : -1;
+	while (group->remaining.load() > 0)
+	{
+		Job job;
+		if (TakeJob(workerIndex, &job))
+			RunJob(context, job);
+		else
+			std::this_thread::yield();
+	}
+}
+
+uint32 JobSystem::CreateHandle(JobGroup* group)
+{
+	std::lock_guard<std::mutex> lock(m_HandleMutex);
+	if (!m_FreeHandles.empty())
+	{
+		uint32 handle = m_FreeHandles.back();
+		m_FreeHandles.pop_back();
+		m_Handles[handle - 1] = group;
+		return handle;
+	}
+
+	m_Handles.push_back(group);
+	return m_Handles.size();
+}
+
+JobGroup* JobSystem::GetGroup(uint32 handle)
+{
+	std::lock_guard<std::mutex> lock(m_HandleMutex);
+	if (handle == 0 || handle > m_Handles.size())
+		return nullptr;
+
+	return m_Handles[handle - 1];
+}
+
+void JobSystem::ReleaseHandle(uint32 handle)
+{
+	std::lock_guard<std::mutex> lock(m_HandleMutex);
+	delete m_Handles[handle - 1];
+	m_Handles[handle - 1] = nullptr;
+	m_FreeHandles.push_back(handle);
+}
+
+void JobSystem::WorkerLoop(uint32 index)
+{
+	ExecutionContext* context = m_Workers[index]->context;
+	while (m_Running)
+	{
+		Job job;
+		if (TakeJob(index, &job))
+		{
+			RunJob(context, job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_SleepMutex);
+		m_WakeCondition.wait(lock, [this]() { return m_QueuedJobs.load() > 0 || !m_Running; });
+	}
+}
+
+bool JobSystem::TakeJob(int32 workerIndex, Job* job)
+{
+	if (workerIndex >= 0)
+	{
+		Worker* worker = m_Workers[workerIndex];
+		std::lock_guard<std::mutex> lock(worker->mutex);
+		if (!worker->jobs.empty())
+		{
+			*job = worker->jobs.back();
+			worker->jobs.pop_back();
+			m_QueuedJobs--;
+			return true;
+		}
+	}
+
+	uint32 start = workerIndex >= 0 ? workerIndex + 1 : 0;
+	for (uint32 i = 0; i < m_Workers.size(); i++)
+	{
+		Worker* victim = m_Workers[(start + i) % m_Workers.size()];
+		std::lock_guard<std::mutex> lock(victim->mutex);
+		if (!victim->jobs.empty())
+		{
+			*job = victim->jobs.front();
+			victim->jobs.pop_front();
+			m_QueuedJobs--;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void JobSystem::RunJob(ExecutionContext* context, const Job& job)
+{
+	bool staticsRestricted = context->IsStaticAccessRestricted();
+	context->SetStaticAccessRestricted(m_RestrictStatics);
+
+	SegmentedBumpAllocator* stackAllocator = context->GetStackAllocator();
+	uint64 jobMarker = stackAllocator->GetMarker();
+	try
+	{
+		if (job.indexed)
+		{
+			std::vector<Value> args(1);
+			for (uint32 i = job.begin; i < job.end; i++)
+			{
+				uint64 marker = stackAllocator->GetMarker();
+				args[0] = Value::MakeUInt32(i, stackAllocator);
+				context->CallFunction(job.function, args);
+				stackAllocator->FreeToMarker(marker);
+			}
+		}
+		else
+		{
+			uint64 marker = stackAllocator->GetMarker();
+			context->CallFunction(job.function, std::vector<Value>());
+			stackAllocator->FreeToMarker(marker);
+		}
+	}
+	catch (const std::runtime_error& error)
+	{
+		// The failed call returned without freeing what it took from the worker's stack
+		stackAllocator->FreeToMarker(jobMarker);
+
+		std::lock_guard<std::mutex> lock(job.group->errorMutex);
+		if (job.group->error.empty())
+			job.group->error = error.what();
+	}
+
+	context->SetStaticAccessRestricted(staticsRestricted);
+	job.group->remaining--;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+
+#include "Common.h"
+
+class Program;
+class ExecutionContext;
+struct Function;
+
+// Jobs submitted together, waiting on the group returns once every one of them ran
+struct JobGroup
+{
+	std::atomic<uint32> remaining;
+	std::mutex errorMutex;
+	std::string error; // First runtime error thrown by one of the jobs
+};
+
+struct Job
+{
+	Function* function;
+	uint32 begin;
+	uint32 end; // Indexed jobs call function once for every index in [begin, end)
+	bool indexed;
+	JobGroup* group;
+};
+
+// Work-stealing scheduler with one ExecutionContext per worker thread. A worker pops jobs
+// from the back of its own deque and steals from the front of the others once it runs dry.
+// Threads waiting on a group run queued jobs in their own context instead of blocking.
+class JobSystem
+{
+public:
+	JobSystem(Program* program, uint32 numWorkers, bool restrictStatics);
+	~JobSystem();
+
+	void Submit(ExecutionContext* context, const Job& job);
+	void Wait(ExecutionContext* context, JobGroup* group);
+
+	// Scripts refer to submitted groups by handle, 0 is never a valid handle
+	uint32 CreateHandle(JobGroup* group);
+	JobGroup* GetGroup(uint32 handle);
+	void ReleaseHandle(uint32 handle);
+
+	inline uint32 GetNumWorkers() const { return m_Workers.size(); }
+private:
+	struct Worker
+	{
+		std::thread thread;
+		std::deque<Job> jobs;
+		std::mutex mutex;
+		ExecutionContext* context;
+	};
+
+	void WorkerLoop(uint32 index);
+	bool TakeJob(int32 workerIndex, Job* job);
+	void RunJob(ExecutionContext* context, const Job& job);
+private:
+	Program* m_Program;
+	bool m_RestrictStatics;
+	std::vector<Worker*> m_Workers;
+	std::atomic<bool> m_Running;
+	std::atomic<uint32> m_QueuedJobs;
+	std::atomic<uint32> m_NextWorker;
+	std::mutex m_SleepMutex;
+	std::condition_variable m_WakeCondition;
+
+	std::mutex m_HandleMutex;
+	std::vector<JobGroup*> m_Handles;
+	std::vector<uint32> m_FreeHandles;
+};
@@ -1,38 +1,127 @@
 #include "Parser.h"
 #include "Program.h"
+#include "ExecutionContext.h"
 #include "Class.h"
 #include "Memory/Memory.h"
+#include <chrono>
 
-int main()
+int main(int argc, char** argv)
 {
+	const char* scriptPath = "Main.tls";
+	bool printOpCodeHistogram = false;
+	bool printPaddingReport = false;
+	bool packAllClasses = false;
+	bool restrictStaticsInJobs = false;
+	int32 numJobWorkers = -1;
+	int32 numParseThreads = -1;
+	uint32 maxCallDepth = DEFAULT_MAX_CALL_DEPTH;
+	uint64 stackSegmentSize = Memory::KBToBytes(DEFAULT_STACK_SEGMENT_SIZE_KB);
+	uint64 stackCapacity = Memory::MBToBytes(DEFAULT_STACK_CAPACITY_MB);
+	for (int32 i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-histogram") == 0)
+			printOpCodeHistogram = true;
+		else if (strcmp(argv[i], "-padding-report") == 0)
+			printPaddingReport = true;
+		else if (strcmp(argv[i], "-pack-classes") == 0)
+			packAllClasses = true;
+		else if (strcmp(argv[i], "-max-call-depth") == 0 && (i + 1) < argc)
+			maxCallDepth = (uint32)atoi(argv[++i]);
+		else if (strcmp(argv[i], "-stack-segment-kb") == 0 && (i + 1) < argc)
+			stackSegmentSize = Memory::KBToBytes(atoi(argv[++i]));
+		else if (strcmp(argv[i], "-stack-capacity-mb") == 0 && (i + 1) < argc)
+			stackCapacity = Memory::MBToBytes(atoi(argv[++i]));
+		else if (strcmp(argv[i], "-job-workers") == 0 && (i + 1) < argc)
+			numJobWorkers = std::max(atoi(argv[++i]), 1);
+		else if (strcmp(argv[i], "-parse-threads") == 0 && (i + 1) < argc)
+			numParseThreads = std::max(atoi(argv[++i]), 1);
+		else if (strcmp(argv[i], "-job-restrict-statics") == 0)
+			restrictStaticsInJobs = true;
+		else if (argv[i][0] != '-')
+			scriptPath = argv[i];
+	}
+
 	Program program;
+	program.SetPackAllClasses(packAllClasses);
+
+	auto parseStart = std::chrono::high_resolution_clock::now();
 	Parser parser(&program);
-	parser.Parse("Main.tls");
+	if (numParseThreads > 0)
+		parser.SetNumThreads(numParseThreads);
+	if (!parser.Parse(scriptPath))
+		return 1;
+	real64 parseSeconds = std::chrono::duration<real64>(std::chrono::high_resolution_clock::now() - parseStart).count();
+
 	program.BuildVTables();
 	program.Resolve();
 	program.EmitCode();
+	if (printPaddingReport)
+		program.PrintPaddingReport();
+
+	// The AST is released before execution, so its statistics are taken now
+	uint32 numASTNodes = program.GetNumCreatedExpressions();
+	uint64 astSize = program.GetASTAllocator()->GetMaxUsage();
 
 	uint32 pc = program.GetCodeSize();
 	uint16 mainClassID = program.GetClassIDWithMainFunction();
 	std::vector<ASTExpression*> args;
 	std::vector<uint16> castFunctionIDs;
-	program.AddStaticFunctionCallCommand(mainClassID, program.GetClass(mainClassID)->GetFunctionID("Main", args, castFunctionIDs), false);
+	program.AddStaticFunctionCallCommand(mainClassID, program.GetClass(mainClassID)->GetFunctionID(&program, "Main", args, castFunctionIDs), false);
 	program.WriteOPCode(OpCode::END);
-	program.ExecuteProgram(pc);
+	program.PrepareForExecution(pc);
+
+	ExecutionContext context(&program);
+	context.SetMaxCallDepth(maxCallDepth);
+	context.SetRestrictStaticsInJobs(restrictStaticsInJobs);
+	if (numJobWorkers > 0)
+		context.SetNumJobWorkers(numJobWorkers);
+	context.GetStackAllocator()->SetSegmentSize(stackSegmentSize);
+	context.GetStackAllocator()->SetCapacity(stackCapacity);
+	if (printOpCodeHistogram)
+		context.EnableOpCodeHistogram();
+
+	try
+	{
+		context.Execute(program.GetEntryPC());
+	}
+	catch (const std::runtime_error& error)
+	{
+		std::cout << "Runtime error: " << error.what() << std::endl;
+	}
 
-	HeapAllocator* heapAllocator = program.GetHeapAllocator();
-	Allocator* stackAllocator = program.GetStackAllocator();
+	HeapAllocator* heapAllocator = context.GetHeapAllocator();
+	SegmentedBumpAllocator* stackAllocator = context.GetStackAllocator();
 	Allocator* initAllocator = program.GetInitializationAllocator();
 
+	std::cout << "Parsed " << Memory::BytesToKB(parser.GetParsedBytes()) << "KB in " << parseSeconds * 1000.0 << "ms (" <<
+		Memory::BytesToMB(parser.GetParsedBytes()) / parseSeconds << "MB/s)" << std::endl;
+	std::cout << "AST nodes: " << numASTNodes << " (" << Memory::BytesToKB(astSize) << "KB)" << std::endl;
+	std::cout << "Parser scopes: " << parser.GetNumScopes() << std::endl;
+	std::cout << "Resident memory after compile: " << Memory::BytesToMB(program.GetCompiledResidentSize()) << "MB" << std::endl;
+	std::cout << "Resident memory after teardown: " << Memory::BytesToMB(program.GetExecutionResidentSize()) << "MB" << std::endl;
 	std::cout << "Max initialization usage: " << Memory::BytesToKB(initAllocator->GetMaxUsage()) << "KB" << std::endl;
 	std::cout << "Max stack usage: " << Memory::BytesToKB(stackAllocator->GetMaxUsage()) << "KB" << std::endl;
+	for (uint32 i = 0; i < stackAllocator->GetNumSegments(); i++)
+	{
+		std::cout << "  Stack segment " << i << ": " << Memory::BytesToKB(stackAllocator->GetSegmentMaxUsage(i)) << "KB of " <<
+			Memory::BytesToKB(stackAllocator->GetSegmentCapacity(i)) << "KB" << std::endl;
+	}
 	std::cout << "Num heap allocations: " << heapAllocator->GetNumAllocs() << std::endl;
 	std::cout << "Num heap frees: " << heapAllocator->GetNumFrees() << std::endl;
-	std::cout << "Stack size: " << program.GetStackSize() << std::endl;
-	std::cout << "Scope stack size: " << program.GetScopeStackSize() << std::endl;
-	std::cout << "Loop stack size: " << program.GetLoopStackSize() << std::endl;
+	std::cout << "Stack size: " << context.GetStackSize() << std::endl;
+	std::cout << "Scope stack size: " << context.GetScopeStackSize() << std::endl;
+	std::cout << "Max call depth: " << context.GetMaxCallStackSize() << std::endl;
+	std::cout << "Loop stack size: " << context.GetLoopStackSize() << std::endl;
 	std::cout << "Code size: " << program.GetCodeSize() << std::endl;
+	const SchedModuleState* schedState = context.GetSchedModuleState();
+	if (schedState->frameCount > 0)
+	{
+		std::cout << "Frames: " << schedState->frameCount << " (p50 " << SchedModule::GetFrameTimePercentile(schedState, 50.0) << "ms, p99 " <<
+			SchedModule::GetFrameTimePercentile(schedState, 99.0) << "ms, max " << SchedModule::GetFrameTimePercentile(schedState, 100.0) << "ms)" << std::endl;
+	}
 	program.PrintClassCodeSizes();
+	if (printOpCodeHistogram)
+		context.PrintOpCodeHistogram(20);
 
-	while (true);
+	return 0;
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "BumpAllocator.h"
 #include <cstdlib>
 #include <algorithm>
+#include <stdexcept>
 
 BumpAllocator::BumpAllocator(uint64 size) :
 	m_Size(size),
@@ -44,6 +45,9 @@ void* BumpAllocator::AllocAligned(uint64 size, uint64 alignment)
 
 void* BumpAllocator::Alloc(uint64 size)
 {
+    if (m_Offset + size > m_Size)
+        throw std::runtime_error("BumpAllocator out of memory");
+
     uint8* data = m_Data + m_Offset;
     m_Offset += size;
     m_MaxUsage = std::max(m_Offset, m_MaxUsage);
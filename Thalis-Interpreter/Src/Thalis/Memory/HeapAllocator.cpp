@@ -4,15 +4,14 @@
 void* HeapAllocator::AllocAligned(uint64 size, uint64 alignment)
 {
 	m_NumAllocs++;
-	void* data = malloc(size);
+	void* data = Memory::AlignedAlloc(size, alignment);
 	return data;
 }
 
 void* HeapAllocator::Alloc(uint64 size)
 {
-	m_NumAllocs++;
-	void* data = malloc(size);
-	return data;
+	// Aligned too, so every block can be released with the same Free
+	return AllocAligned(size, alignof(std::max_align_t));
 }
 
 void HeapAllocator::Free()
@@ -31,7 +30,7 @@ void HeapAllocator::Free(void* data)
 		return;
 
 	m_NumFrees++;
-	free(data);
+	Memory::AlignedFree(data);
 }
 
 uint64 HeapAllocator::GetNumAllocs() const
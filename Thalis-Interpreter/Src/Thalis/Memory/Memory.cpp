@@ -1,11 +1,25 @@
 #include "Memory.h"
 #include <malloc.h>
+#include <cstddef>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <cstdio>
+#include <unistd.h>
+#endif
 
 void* Memory::AlignedAlloc(uint64 size, uint64 alignment)
 {
 #if defined(_MSC_VER)
     return _aligned_malloc(size, alignment);
 #else
+    // malloc already aligns to max_align_t and is cheaper than aligned_alloc
+    if (alignment <= alignof(std::max_align_t))
+        return malloc(size);
+
     return aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
 #endif
 }
@@ -18,3 +32,27 @@ void Memory::AlignedFree(void* data)
     free(data);
 #endif
 }
+
+uint64 Memory::GetResidentSetSize()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+
+    return counters.WorkingSetSize;
+#else
+    FILE* file = fopen("/proc/self/statm", "r");
+    if (!file)
+        return 0;
+
+    unsigned long long size = 0;
+    unsigned long long resident = 0;
+    int32 read = fscanf(file, "%llu %llu", &size, &resident);
+    fclose(file);
+    if (read != 2)
+        return 0;
+
+    return resident * (uint64)sysconf(_SC_PAGESIZE);
+#endif
+}
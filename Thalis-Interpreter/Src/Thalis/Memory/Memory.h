@@ -11,6 +11,12 @@ public:
 	inline static real32 BytesToKB(uint64 numBytes) { return (real32)numBytes / 1024.0f; }
 	inline static real32 BytesToMB(uint64 numBytes) { return (real32)numBytes / (1024.0f * 1024.0f); }
 
+	// alignment must be a power of two
+	inline static uint64 AlignUp(uint64 value, uint64 alignment) { return (value + alignment - 1) & ~(alignment - 1); }
+
 	static void* AlignedAlloc(uint64 size, uint64 alignment);
 	static void AlignedFree(void* data);
+
+	// Physical memory currently used by the process, 0 when it can't be queried
+	static uint64 GetResidentSetSize();
 };
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "SegmentedBumpAllocator.h"
+#include <cstdlib>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+SegmentedBumpAllocator::SegmentedBumpAllocator(uint64 segmentSize, uint64 capacity) :
+	m_Current(0),
+	m_Offset(0),
+	m_SegmentSize(segmentSize),
+	m_Capacity(capacity),
+	m_Reserved(0),
+	m_ReleasedMaxUsage(0)
+{
+	AddSegment(segmentSize);
+}
+
+void* SegmentedBumpAllocator::AllocAligned(uint64 size, uint64 alignment)
+{
+	if (alignment == 0) alignment = 1;
+
+	Segment& segment = m_Segments[m_Current];
+	uintptr_t currentAddress = reinterpret_cast<uintptr_t>(segment.data) + m_Offset;
+	uintptr_t alignedAddress = (currentAddress + (alignment - 1)) & ~(alignment - 1);
+	uint64 totalSize = size + (alignedAddress - currentAddress);
+
+	if (m_Offset + totalSize > segment.size)
+		return AllocInNextSegment(size, alignment);
+
+	m_Offset += totalSize;
+	segment.maxUsage = std::max(m_Offset, segment.maxUsage);
+	return reinterpret_cast<void*>(alignedAddress);
+}
+
+void* SegmentedBumpAllocator::Alloc(uint64 size)
+{
+	Segment& segment = m_Segments[m_Current];
+	if (m_Offset + size > segment.size)
+		return AllocInNextSegment(size, 1);
+
+	uint8* data = segment.data + m_Offset;
+	m_Offset += size;
+	segment.maxUsage = std::max(m_Offset, segment.maxUsage);
+	return data;
+}
+
+void* SegmentedBumpAllocator::AllocInNextSegment(uint64 size, uint64 alignment)
+{
+	// The rest of the current segment is skipped, markers stay ordered because every segment starts where the previous one ends
+	uint64 required = size + alignment - 1;
+	uint32 next = m_Current + 1;
+	if (next == m_Segments.size() || m_Segments[next].size < required)
+	{
+		ReleaseSegments(next);
+		AddSegment(std::max(m_SegmentSize, required));
+	}
+
+	m_Current = next;
+	m_Offset = 0;
+	return AllocAligned(size, alignment);
+}
+
+void SegmentedBumpAllocator::AddSegment(uint64 size)
+{
+	if (m_Reserved + size > m_Capacity)
+		throw std::runtime_error("Stack allocator exceeded its capacity of " + std::to_string(m_Capacity) + " bytes");
+
+	Segment segment;
+	segment.data = (uint8*)malloc(size);
+	segment.size = size;
+	segment.base = m_Segments.empty() ? 0 : m_Segments.back().base + m_Segments.back().size;
+	segment.maxUsage = 0;
+
+	m_Segments.push_back(segment);
+	m_Reserved += size;
+}
+
+void SegmentedBumpAllocator::ReleaseSegments(uint32 first)
+{
+	for (uint32 i = first; i < m_Segments.size(); i++)
+	{
+		const Segment& segment = m_Segments[i];
+		m_ReleasedMaxUsage = std::max(segment.base + segment.maxUsage, m_ReleasedMaxUsage);
+		m_Reserved -= segment.size;
+		free(segment.data);
+	}
+
+	m_Segments.resize(first);
+}
+
+void SegmentedBumpAllocator::SetSegmentSize(uint64 segmentSize)
+{
+	m_SegmentSize = segmentSize;
+
+	// Nothing is allocated yet, so the first segment can still be replaced
+	if (GetMarker() == 0)
+	{
+		ReleaseSegments(0);
+		AddSegment(segmentSize);
+	}
+}
+
+void SegmentedBumpAllocator::Free()
+{
+	m_Current = 0;
+	m_Offset = 0;
+}
+
+uint64 SegmentedBumpAllocator::GetMaxUsage() const
+{
+	uint64 maxUsage = m_ReleasedMaxUsage;
+	for (uint32 i = 0; i < m_Segments.size(); i++)
+	{
+		if (m_Segments[i].maxUsage > 0)
+			maxUsage = std::max(m_Segments[i].base + m_Segments[i].maxUsage, maxUsage);
+	}
+
+	return maxUsage;
+}
+
+uint64 SegmentedBumpAllocator::GetMarker() const
+{
+	return m_Segments[m_Current].base + m_Offset;
+}
+
+void SegmentedBumpAllocator::FreeToMarker(uint64 marker)
+{
+	assert(marker <= GetMarker() && "FreeToMarker(): marker beyond current offset!");
+	while (marker < m_Segments[m_Current].base)
+		m_Current--;
+
+	m_Offset = marker - m_Segments[m_Current].base;
+}
+
+void SegmentedBumpAllocator::Destroy()
+{
+	ReleaseSegments(0);
+	m_Current = 0;
+	m_Offset = 0;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+#include "Allocator.h"
+
+// Bump allocator that grows by appending segments instead of overrunning a fixed block.
+// Markers are offsets into the range spanned by all segments laid end to end, so
+// GetMarker/FreeToMarker work across segment boundaries. Segments that are freed
+// are kept and reused the next time the allocator grows past them.
+class SegmentedBumpAllocator : public Allocator
+{
+public:
+	SegmentedBumpAllocator(uint64 segmentSize, uint64 capacity);
+	virtual void* AllocAligned(uint64 size, uint64 alignment) override;
+	virtual void* Alloc(uint64 size) override;
+	virtual void Free() override;
+	virtual void Free(void* data) override {}
+
+	virtual uint64 GetMaxUsage() const override;
+
+	virtual uint64 GetMarker() const override;
+	virtual void FreeToMarker(uint64 marker) override;
+
+	virtual void Destroy() override;
+
+	void SetSegmentSize(uint64 segmentSize);
+	inline void SetCapacity(uint64 capacity) { m_Capacity = capacity; }
+	inline uint64 GetSegmentSize() const { return m_SegmentSize; }
+	inline uint64 GetCapacity() const { return m_Capacity; }
+
+	inline uint32 GetNumSegments() const { return m_Segments.size(); }
+	inline uint64 GetSegmentCapacity(uint32 index) const { return m_Segments[index].size; }
+	inline uint64 GetSegmentMaxUsage(uint32 index) const { return m_Segments[index].maxUsage; }
+private:
+	struct Segment
+	{
+		uint8* data;
+		uint64 size;
+		uint64 base; // Marker of the first byte in this segment
+		uint64 maxUsage;
+	};
+
+	void* AllocInNextSegment(uint64 size, uint64 alignment);
+	void AddSegment(uint64 size);
+	void ReleaseSegments(uint32 first);
+private:
+	std::vector<Segment> m_Segments;
+	uint32 m_Current;
+	uint64 m_Offset; // Offset into the current segment
+	uint64 m_SegmentSize;
+	uint64 m_Capacity;
+	uint64 m_Reserved;
+	uint64 m_ReleasedMaxUsage;
+};
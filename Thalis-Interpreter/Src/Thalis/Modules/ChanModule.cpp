@@ -0,0 +1,145 @@
+#include "ChanModule.h"
+#include "../ExecutionContext.h"
+#include "../Channel.h"
+#include <thread>
+
+bool ChanModule::Init()
+{
+	return true;
+}
+
+Value ChanModule::CallFunction(ExecutionContext* context, uint16 function, const std::vector<Value>& args)
+{
+	ChanModuleState* state = context->GetProgram()->GetChanModuleState();
+	switch ((ChanModuleFunction)function)
+	{
+	case ChanModuleFunction::CREATE_SPSC:
+	case ChanModuleFunction::CREATE_MPMC: {
+		uint32 elementSize = args[0].GetUInt32();
+		uint32 capacity = args[1].GetUInt32();
+		if (elementSize == 0 || capacity == 0)
+			throw std::runtime_error("Chan.Create needs a non zero element size and capacity");
+
+		ChannelKind kind = (ChanModuleFunction)function == ChanModuleFunction::CREATE_SPSC ? ChannelKind::SPSC : ChannelKind::MPMC;
+
+		std::lock_guard<std::mutex> lock(state->mutex);
+		for (uint32 i = 0; i < CHAN_MODULE_MAX_CHANNELS; i++)
+		{
+			if (state->channels[i].load() == nullptr)
+			{
+				state->channels[i] = new Channel(kind, elementSize, capacity);
+				return Value::MakeUInt32(i + 1, context->GetStackAllocator());
+			}
+		}
+
+		throw std::runtime_error("Too many channels, at most " + std::to_string(CHAN_MODULE_MAX_CHANNELS) + " can be open");
+	} break;
+	case ChanModuleFunction::DESTROY: {
+		uint32 channelID = args[0].GetUInt32();
+		Channel* channel = nullptr;
+
+		std::lock_guard<std::mutex> lock(state->mutex);
+		if (channelID != 0 && channelID <= CHAN_MODULE_MAX_CHANNELS)
+			channel = state->channels[channelID - 1].exchange(nullptr);
+
+		if (!channel)
+			throw std::runtime_error("Invalid channel " + std::to_string(channelID));
+
+		// Calls that got the channel before it was unpublished still have to leave it
+		channel->Close();
+		while (state->users[channelID - 1].load() != 0)
+			std::this_thread::yield();
+
+		delete channel;
+	} break;
+	case ChanModuleFunction::TRY_SEND: {
+		uint32 channelID = args[0].GetUInt32();
+		Channel* channel = AcquireChannel(context, channelID);
+		bool sent = channel->TrySend(*(void**)args[1].data);
+		ReleaseChannel(context, channelID);
+		return Value::MakeBool(sent, context->GetStackAllocator());
+	} break;
+	case ChanModuleFunction::TRY_RECV: {
+		uint32 channelID = args[0].GetUInt32();
+		Channel* channel = AcquireChannel(context, channelID);
+		bool received = channel->TryRecv(*(void**)args[1].data);
+		ReleaseChannel(context, channelID);
+		return Value::MakeBool(received, context->GetStackAllocator());
+	} break;
+	case ChanModuleFunction::SEND: {
+		uint32 channelID = args[0].GetUInt32();
+		Channel* channel = AcquireChannel(context, channelID);
+		bool sent = channel->Send(*(void**)args[1].data);
+		ReleaseChannel(context, channelID);
+		if (!sent)
+			throw std::runtime_error("Channel " + std::to_string(channelID) + " was destroyed during Chan.Send");
+	} break;
+	case ChanModuleFunction::RECV: {
+		uint32 channelID = args[0].GetUInt32();
+		Channel* channel = AcquireChannel(context, channelID);
+		bool received = channel->Recv(*(void**)args[1].data);
+		ReleaseChannel(context, channelID);
+		if (!received)
+			throw std::runtime_error("Channel " + std::to_string(channelID) + " was destroyed during Chan.Recv");
+	} break;
+	}
+
+	return Value::MakeNULL();
+}
+
+Value ChanModule::Constant(ExecutionContext* context, uint16 constant)
+{
+	return Value::MakeNULL();
+}
+
+TypeInfo ChanModule::GetFunctionReturnInfo(uint16 function)
+{
+	switch ((ChanModuleFunction)function)
+	{
+	case ChanModuleFunction::CREATE_SPSC: return TypeInfo((uint16)ValueType::UINT32, 0);
+	case ChanModuleFunction::CREATE_MPMC: return TypeInfo((uint16)ValueType::UINT32, 0);
+	case ChanModuleFunction::TRY_SEND: return TypeInfo((uint16)ValueType::BOOL, 0);
+	case ChanModuleFunction::TRY_RECV: return TypeInfo((uint16)ValueType::BOOL, 0);
+	}
+
+	return TypeInfo((uint16)ValueType::VOID_T, 0);
+}
+
+TypeInfo ChanModule::GetConstantTypeInfo(uint16 constant)
+{
+	return TypeInfo(INVALID_ID, 0);
+}
+
+void ChanModule::DestroyChannels(Program* program)
+{
+	ChanModuleState* state = program->GetChanModuleState();
+	for (uint32 i = 0; i < CHAN_MODULE_MAX_CHANNELS; i++)
+	{
+		delete state->channels[i].load();
+		state->channels[i] = nullptr;
+	}
+}
+
+Channel* ChanModule::AcquireChannel(ExecutionContext* context, uint32 channelID)
+{
+	if (channelID == 0 || channelID > CHAN_MODULE_MAX_CHANNELS)
+		throw std::runtime_error("Invalid channel " + std::to_string(channelID));
+
+	// Counted before the channel is read, Chan.Destroy unpublishes first and then waits for the count,
+	// so either the channel is seen as gone here or Chan.Destroy waits for this call
+	ChanModuleState* state = context->GetProgram()->GetChanModuleState();
+	state->users[channelID - 1].fetch_add(1);
+	Channel* channel = state->channels[channelID - 1].load();
+	if (!channel)
+	{
+		ReleaseChannel(context, channelID);
+		throw std::runtime_error("Invalid channel " + std::to_string(channelID));
+	}
+
+	return channel;
+}
+
+void ChanModule::ReleaseChannel(ExecutionContext* context, uint32 channelID)
+{
+	context->GetProgram()->GetChanModuleState()->users[channelID - 1].fetch_sub(1);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "../Value.h"
+#include "../TypeInfo.h"
+#include <vector>
+#include <atomic>
+#include <mutex>
+
+enum class ChanModuleConstant : uint16
+{
+
+};
+
+enum class ChanModuleFunction : uint16
+{
+	CREATE_SPSC, CREATE_MPMC, DESTROY,
+	TRY_SEND, TRY_RECV, SEND, RECV
+};
+
+#define CHAN_MODULE_MAX_CHANNELS 64
+
+class Channel;
+
+// Channels connect contexts running the same Program, so they live with the Program rather
+// than the context. Scripts refer to them by ID, 0 is never a valid channel. Every call into a
+// channel is counted in users, Chan.Destroy unpublishes the channel, closes it so blocked
+// calls return and only deletes it once the count dropped to 0.
+struct ChanModuleState
+{
+	std::atomic<Channel*> channels[CHAN_MODULE_MAX_CHANNELS] = {};
+	std::atomic<uint32> users[CHAN_MODULE_MAX_CHANNELS] = {};
+	std::mutex mutex; // Held while creating and destroying channels
+};
+
+class ExecutionContext;
+class Program;
+class ChanModule
+{
+public:
+	static bool Init();
+	static Value CallFunction(ExecutionContext* context, uint16 function, const std::vector<Value>& args);
+	static Value Constant(ExecutionContext* context, uint16 constant);
+
+	static TypeInfo GetFunctionReturnInfo(uint16 function);
+	static TypeInfo GetConstantTypeInfo(uint16 constant);
+
+	static void DestroyChannels(Program* program);
+private:
+	// Every AcquireChannel is paired with a ReleaseChannel once the call into the channel returned
+	static Channel* AcquireChannel(ExecutionContext* context, uint32 channelID);
+	static void ReleaseChannel(ExecutionContext* context, uint32 channelID);
+};
@@ -0,0 +1,191 @@
+#include "CoModule.h"
+#include "../ExecutionContext.h"
+#include "../Coroutine.h"
+
+bool CoModule::Init()
+{
+	return true;
+}
+
+Value CoModule::CallFunction(ExecutionContext* context, uint16 function, const std::vector<Value>& args)
+{
+	CoModuleState* state = context->GetCoModuleState();
+	switch ((CoModuleFunction)function)
+	{
+	case CoModuleFunction::START:
+	case CoModuleFunction::SPAWN: {
+		uint16 classID;
+		Function* coroutineFunction = context->GetProgram()->GetFunctionFromReference(args[0].GetUInt32(), &classID);
+		if (!coroutineFunction || !coroutineFunction->parameters.empty())
+			throw std::runtime_error("Co.Start and Co.Spawn need &Class.Function of a function taking no arguments");
+
+		void* object = nullptr;
+		if (!coroutineFunction->isStatic)
+		{
+			object = args.size() > 1 ? *(void**)args[1].data : nullptr;
+			if (!object)
+				throw std::runtime_error("Coroutine " + coroutineFunction->name + " is a member function and needs an object");
+		}
+
+		uint32 handle = state->scheduler.Allocate();
+		uint32 slot = state->scheduler.GetSlot(handle);
+		if (slot >= state->coroutines.size())
+			state->coroutines.resize(slot + 1, nullptr);
+
+		Coroutine* coroutine = context->CreateCoroutine(coroutineFunction, classID, object);
+		state->coroutines[slot] = coroutine;
+
+		if ((CoModuleFunction)function == CoModuleFunction::SPAWN)
+		{
+			coroutine->detached = true;
+			state->scheduler.Schedule(handle, state->scheduler.GetTime());
+			return Value::MakeNULL();
+		}
+
+		return Value::MakeUInt32(handle, context->GetStackAllocator());
+	} break;
+	case CoModuleFunction::RESUME: {
+		Coroutine* coroutine = GetCoroutine(context, args[0].GetUInt32());
+		bool alive = context->ResumeCoroutine(coroutine);
+		return Value::MakeBool(alive, context->GetStackAllocator());
+	} break;
+	case CoModuleFunction::IS_DONE: {
+		Coroutine* coroutine = GetCoroutine(context, args[0].GetUInt32());
+		return Value::MakeBool(coroutine->finished, context->GetStackAllocator());
+	} break;
+	case CoModuleFunction::VALUE: {
+		// Points into the coroutine, it is overwritten by the next yield
+		Coroutine* coroutine = GetCoroutine(context, args[0].GetUInt32());
+		void* data = coroutine->yieldValue.empty() ? nullptr : coroutine->yieldValue.data();
+		return Value::MakePointer((uint16)ValueType::VOID_T, 1, data, context->GetStackAllocator());
+	} break;
+	case CoModuleFunction::VALUE_SIZE: {
+		// 0 if the last yield had no value
+		Coroutine* coroutine = GetCoroutine(context, args[0].GetUInt32());
+		return Value::MakeUInt32(coroutine->yieldValue.size(), context->GetStackAllocator());
+	} break;
+	case CoModuleFunction::DESTROY: {
+		uint32 handle = args[0].GetUInt32();
+		GetCoroutine(context, handle);
+		Release(context, handle);
+	} break;
+	case CoModuleFunction::SCHEDULE: {
+		uint32 handle = args[0].GetUInt32();
+		GetCoroutine(context, handle);
+		state->scheduler.Schedule(handle, state->scheduler.GetTime() + args[1].GetReal64());
+	} break;
+	case CoModuleFunction::SLEEP: {
+		Coroutine* coroutine = context->GetRunningCoroutine();
+		if (!coroutine)
+			throw std::runtime_error("Co.Sleep called outside of a coroutine");
+
+		coroutine->wakeTime = state->scheduler.GetTime() + args[0].GetReal64();
+		context->YieldCoroutine();
+	} break;
+	case CoModuleFunction::UPDATE: {
+		uint32 resumed = state->scheduler.Update(context, args[0].GetReal64(), ResumeScheduled);
+		return Value::MakeUInt32(resumed, context->GetStackAllocator());
+	} break;
+	case CoModuleFunction::TIME: {
+		return Value::MakeReal64(state->scheduler.GetTime(), context->GetStackAllocator());
+	} break;
+	}
+
+	return Value::MakeNULL();
+}
+
+Value CoModule::Constant(ExecutionContext* context, uint16 constant)
+{
+	return Value::MakeNULL();
+}
+
+TypeInfo CoModule::GetFunctionReturnInfo(uint16 function)
+{
+	switch ((CoModuleFunction)function)
+	{
+	case CoModuleFunction::START: return TypeInfo((uint16)ValueType::UINT32, 0);
+	case CoModuleFunction::RESUME: return TypeInfo((uint16)ValueType::BOOL, 0);
+	case CoModuleFunction::IS_DONE: return TypeInfo((uint16)ValueType::BOOL, 0);
+	case CoModuleFunction::VALUE: return TypeInfo((uint16)ValueType::VOID_T, 1);
+	case CoModuleFunction::VALUE_SIZE: return TypeInfo((uint16)ValueType::UINT32, 0);
+	case CoModuleFunction::UPDATE: return TypeInfo((uint16)ValueType::UINT32, 0);
+	case CoModuleFunction::TIME: return TypeInfo((uint16)ValueType::REAL64, 0);
+	}
+
+	return TypeInfo((uint16)ValueType::VOID_T, 0);
+}
+
+TypeInfo CoModule::GetConstantTypeInfo(uint16 constant)
+{
+	return TypeInfo(INVALID_ID, 0);
+}
+
+void CoModule::DestroyCoroutines(ExecutionContext* context)
+{
+	CoModuleState* state = context->GetCoModuleState();
+	for (uint32 i = 0; i < state->coroutines.size(); i++)
+	{
+		// The context is going away, suspended coroutines are dropped without running destructors
+		Coroutine* coroutine = state->coroutines[i];
+		if (coroutine)
+		{
+			coroutine->finished = true;
+			context->DestroyCoroutine(coroutine);
+		}
+	}
+
+	state->coroutines.clear();
+	state->scheduler.Clear();
+}
+
+Coroutine* CoModule::GetCoroutine(ExecutionContext* context, uint32 handle)
+{
+	CoModuleState* state = context->GetCoModuleState();
+	uint32 slot = state->scheduler.GetSlot(handle);
+	if (slot == UINT32_MAX || !state->coroutines[slot])
+		throw std::runtime_error("Invalid coroutine handle " + std::to_string(handle));
+
+	return state->coroutines[slot];
+}
+
+void CoModule::Release(ExecutionContext* context, uint32 handle)
+{
+	CoModuleState* state = context->GetCoModuleState();
+	uint32 slot = state->scheduler.GetSlot(handle);
+	context->DestroyCoroutine(state->coroutines[slot]);
+	state->coroutines[slot] = nullptr;
+	state->scheduler.Release(handle);
+}
+
+void CoModule::ResumeScheduled(ExecutionContext* context, uint32 handle, real64 wakeTime)
+{
+	CoModuleState* state = context->GetCoModuleState();
+	Coroutine* coroutine = state->coroutines[state->scheduler.GetSlot(handle)];
+
+	// Yielding without Co.Sleep wakes up on the next update
+	coroutine->wakeTime = state->scheduler.GetTime();
+	bool alive;
+	try
+	{
+		alive = context->ResumeCoroutine(coroutine);
+	}
+	catch (...)
+	{
+		// The failed coroutine is finished, even if it scheduled itself again
+		state->scheduler.Unschedule(handle);
+		if (coroutine->detached)
+			Release(context, handle);
+		throw;
+	}
+
+	if (!alive)
+	{
+		state->scheduler.Unschedule(handle);
+		if (coroutine->detached)
+			Release(context, handle);
+	}
+	else if (!state->scheduler.IsScheduled(handle))
+	{
+		state->scheduler.Schedule(handle, coroutine->wakeTime);
+	}
+}
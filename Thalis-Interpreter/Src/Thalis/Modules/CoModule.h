@@ -0,0 +1,45 @@
+#pragma once
+
+#include "../Value.h"
+#include "../TypeInfo.h"
+#include "../Scheduler.h"
+#include <vector>
+
+enum class CoModuleConstant : uint16
+{
+
+};
+
+enum class CoModuleFunction : uint16
+{
+	START, SPAWN, RESUME, IS_DONE, VALUE, VALUE_SIZE, DESTROY,
+	SCHEDULE, SLEEP, UPDATE, TIME
+};
+
+struct Coroutine;
+
+// Coroutines are scheduler handles, Co.Schedule and Co.Spawn put them on the scheduler and
+// Co.Update resumes the due ones
+struct CoModuleState
+{
+	Scheduler scheduler;
+	std::vector<Coroutine*> coroutines; // Indexed by scheduler slot, nullptr when the slot is free
+};
+
+class ExecutionContext;
+class CoModule
+{
+public:
+	static bool Init();
+	static Value CallFunction(ExecutionContext* context, uint16 function, const std::vector<Value>& args);
+	static Value Constant(ExecutionContext* context, uint16 constant);
+
+	static TypeInfo GetFunctionReturnInfo(uint16 function);
+	static TypeInfo GetConstantTypeInfo(uint16 constant);
+
+	static void DestroyCoroutines(ExecutionContext* context);
+private:
+	static Coroutine* GetCoroutine(ExecutionContext* context, uint32 handle);
+	static void Release(ExecutionContext* context, uint32 handle);
+	static void ResumeScheduled(ExecutionContext* context, uint32 handle, real64 wakeTime);
+};
@@ -1,19 +1,14 @@
 #include "FSModule.h"
-#include "../Program.h"
-#include <fstream>
-
-static std::ifstream g_OpenFiles[16];
-static std::vector<uint32> g_FreeFileIDs;
-static uint32 g_NexFileID = 1;
-
+#include "../ExecutionContext.h"
 
 bool FSModule::Init()
 {
     return true;
 }
 
-Value FSModule::CallFunction(Program* program, uint16 function, const std::vector<Value>& args)
+Value FSModule::CallFunction(ExecutionContext* context, uint16 function, const std::vector<Value>& args)
 {
+    FSModuleState* state = context->GetFSModuleState();
     switch ((FSModuleFunction)function)
     {
     case FSModuleFunction::READ_TEXT_FILE: {
@@ -24,13 +19,13 @@ Value FSModule::CallFunction(Program* program, uint16 function, const std::vecto
         fseek(file, 0, SEEK_END);
         uint64 size = ftell(file);
         fseek(file, 0, SEEK_SET);
-        uint8* data = (uint8*)program->GetHeapAllocator()->Alloc(size + 1);
+        uint8* data = (uint8*)context->GetHeapAllocator()->Alloc(size + 1);
         char* characters = (char*)(data);
         fread(characters, 1, size, file);
         characters[size] = 0;
         fclose(file);
 
-        Value pointer = Value::MakePointer((uint16)ValueType::CHAR, 1, characters, program->GetStackAllocator());
+        Value pointer = Value::MakePointer((uint16)ValueType::CHAR, 1, characters, context->GetStackAllocator());
         return pointer;
     } break;
     case FSModuleFunction::READ_BINARY_FILE: {
@@ -41,11 +36,11 @@ Value FSModule::CallFunction(Program* program, uint16 function, const std::vecto
         fseek(file, 0, SEEK_END);
         uint64 size = ftell(file);
         fseek(file, 0, SEEK_SET);
-        uint8* bytes = (uint8*)program->GetHeapAllocator()->Alloc(size);
+        uint8* bytes = (uint8*)context->GetHeapAllocator()->Alloc(size);
         fread(bytes, 1, size, file);
         fclose(file);
 
-        Value data = Value::MakePointer((uint16)ValueType::UINT8, 1, bytes, program->GetStackAllocator());
+        Value data = Value::MakePointer((uint16)ValueType::UINT8, 1, bytes, context->GetStackAllocator());
         return data;
     } break;
     case FSModuleFunction::OPEN_FILE: {
@@ -54,47 +49,47 @@ Value FSModule::CallFunction(Program* program, uint16 function, const std::vecto
         std::string relPath = lastSlashIndex == -1 ? "" : path.substr(0, lastSlashIndex + 1);
 
         uint32 fileID;
-        if (!g_FreeFileIDs.empty())
+        if (!state->freeFileIDs.empty())
         {
-            fileID = g_FreeFileIDs.back();
-            g_FreeFileIDs.pop_back();
+            fileID = state->freeFileIDs.back();
+            state->freeFileIDs.pop_back();
         }
         else
         {
-            fileID = g_NexFileID++;
+            fileID = state->nextFileID++;
         }
 
-        g_OpenFiles[fileID - 1].open(path.c_str());
+        state->openFiles[fileID - 1].open(path.c_str());
 
-        if (!g_OpenFiles[fileID - 1].good())
+        if (!state->openFiles[fileID - 1].good())
         {
-            g_FreeFileIDs.push_back(fileID);
-            return Value::MakeUInt32(0, program->GetStackAllocator());
+            state->freeFileIDs.push_back(fileID);
+            return Value::MakeUInt32(0, context->GetStackAllocator());
         }
 
-        return Value::MakeUInt32(fileID, program->GetStackAllocator());
+        return Value::MakeUInt32(fileID, context->GetStackAllocator());
     } break;
     case FSModuleFunction::CLOSE_FILE: {
         uint32 fileID = args[0].GetUInt32();
-        g_OpenFiles[fileID - 1].close();
-        g_FreeFileIDs.push_back(fileID);
+        state->openFiles[fileID - 1].close();
+        state->freeFileIDs.push_back(fileID);
         return Value::MakeNULL();
     } break;
     case FSModuleFunction::READ_LINE: {
         uint32 fileID = args[0].GetUInt32();
         char* _Str = (char*)*(void**)args[1].data;
         std::streamsize _Count = args[2].GetUInt64();
-        if (!g_OpenFiles[fileID - 1].getline(_Str, _Count))
-            return Value::MakeBool(false, program->GetStackAllocator());
+        if (!state->openFiles[fileID - 1].getline(_Str, _Count))
+            return Value::MakeBool(false, context->GetStackAllocator());
 
-        return Value::MakeBool(true, program->GetStackAllocator());
+        return Value::MakeBool(true, context->GetStackAllocator());
     } break;
     }
 
     return Value::MakeNULL();
 }
 
-Value FSModule::Constant(Program* program, uint16 constant)
+Value FSModule::Constant(ExecutionContext* context, uint16 constant)
 {
     return Value::MakeNULL();
 }
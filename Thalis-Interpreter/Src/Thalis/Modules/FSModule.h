@@ -3,6 +3,7 @@
 #include "../Value.h"
 #include "../TypeInfo.h"
 #include <vector>
+#include <fstream>
 
 enum class FSModuleConstant
 {
@@ -16,13 +17,22 @@ enum class FSModuleFunction
 	READ_LINE
 };
 
-class Program;
+#define FS_MODULE_MAX_OPEN_FILES 16
+
+struct FSModuleState
+{
+	std::ifstream openFiles[FS_MODULE_MAX_OPEN_FILES];
+	std::vector<uint32> freeFileIDs;
+	uint32 nextFileID = 1;
+};
+
+class ExecutionContext;
 class FSModule
 {
 public:
 	static bool Init();
-	static Value CallFunction(Program* program, uint16 function, const std::vector<Value>& args);
-	static Value Constant(Program* program, uint16 constant);
+	static Value CallFunction(ExecutionContext* context, uint16 function, const std::vector<Value>& args);
+	static Value Constant(ExecutionContext* context, uint16 constant);
 
 	static TypeInfo GetFunctionReturnInfo(uint16 function);
 	static TypeInfo GetConstantTypeInfo(uint16 constant);
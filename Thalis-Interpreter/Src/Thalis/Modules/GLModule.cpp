@@ -1,6 +1,6 @@
 #include "GLModule.h"
 
-#include "../Program.h"
+#include "../ExecutionContext.h"
 #include "../Window.h"
 #ifdef TLS_PLATFORM_WINDOWS
 #include "../Platform/Windows/Win32Window.h"
@@ -19,7 +19,7 @@ bool GLModule::Init()
     return true;
 }
 
-Value GLModule::CallFunction(Program* program, uint16 function, const std::vector<Value>& args)
+Value GLModule::CallFunction(ExecutionContext* context, uint16 function, const std::vector<Value>& args)
 {
     switch ((GLModuleFunction)function)
     {
@@ -30,18 +30,18 @@ Value GLModule::CallFunction(Program* program, uint16 function, const std::vecto
         g_Context = wglCreateContext(hdc);
         if (!wglMakeCurrent(hdc, g_Context))
         {
-            return Value::MakeBool(false, program->GetStackAllocator());
+            return Value::MakeBool(false, context->GetStackAllocator());
         }
 #endif
 
         if (glewInit() != GLEW_OK)
         {
-            return Value::MakeBool(false, program->GetStackAllocator());
+            return Value::MakeBool(false, context->GetStackAllocator());
         }
 
         wglSwapIntervalEXT(0);
 
-        return Value::MakeBool(true, program->GetStackAllocator());
+        return Value::MakeBool(true, context->GetStackAllocator());
     }
                                    // ------------------------------
                                    // Buffer Objects
@@ -49,7 +49,7 @@ Value GLModule::CallFunction(Program* program, uint16 function, const std::vecto
     case GLModuleFunction::TGL_GEN_BUFFERS: {
         GLuint id = 0;
         glGenBuffers(1, &id);
-        return Value::MakeUInt32((int32_t)id, program->GetStackAllocator());
+        return Value::MakeUInt32((int32_t)id, context->GetStackAllocator());
     }
 
     case GLModuleFunction::TGL_DELETE_BUFFERS: {
@@ -87,13 +87,13 @@ Value GLModule::CallFunction(Program* program, uint16 function, const std::vecto
         GLenum target = (GLenum)args[0].GetInt32();
         GLenum access = (GLuint)args[1].GetInt32();
         void* data = glMapBuffer(target, access);
-        return Value::MakePointer((uint16)ValueType::VOID_T, 1, data, program->GetStackAllocator());
+        return Value::MakePointer((uint16)ValueType::VOID_T, 1, data, context->GetStackAllocator());
     }
 
     case GLModuleFunction::TGL_UNMAP_BUFFER: {
         GLenum target = (GLenum)args[0].GetInt32();
         GLboolean res = glUnmapBuffer(target);
-        return Value::MakeBool(res == GL_TRUE, program->GetStackAllocator());
+        return Value::MakeBool(res == GL_TRUE, context->GetStackAllocator());
     }
                                            // ------------------------------
                                            // Vertex Arrays
@@ -101,7 +101,7 @@ Value GLModule::CallFunction(Program* program, uint16 function, const std::vecto
     case GLModuleFunction::TGL_GEN_VERTEX_ARRAYS: {
         GLuint id = 0;
         glGenVertexArrays(1, &id);
-        return Value::MakeUInt32((int32_t)id, program->GetStackAllocator());
+        return Value::MakeUInt32((int32_t)id, context->GetStackAllocator());
     }
 
     case GLModuleFunction::TGL_DELETE_VERTEX_ARRAYS: {
@@ -345,7 +345,7 @@ Value GLModule::CallFunction(Program* program, uint16 function, const std::vecto
     case GLModuleFunction::TGL_GEN_FRAMEBUFFERS: {
         GLuint id = 0;
         glGenFramebuffers(1, &id);
-        return Value::MakeUInt32((int32_t)id, program->GetStackAllocator());
+        return Value::MakeUInt32((int32_t)id, context->GetStackAllocator());
     }
 
     case GLModuleFunction::TGL_DELETE_FRAMEBUFFERS: {
@@ -402,13 +402,13 @@ Value GLModule::CallFunction(Program* program, uint16 function, const std::vecto
     case GLModuleFunction::TGL_CHECK_FRAMEBUFFER_STATUS: {
         GLenum target = (GLenum)args[0].GetInt32();
         GLenum status = glCheckFramebufferStatus(target);
-        return Value::MakeInt32((int32_t)status, program->GetStackAllocator());
+        return Value::MakeInt32((int32_t)status, context->GetStackAllocator());
     }
 
     case GLModuleFunction::TGL_GEN_RENDERBUFFERS: {
         GLuint id = 0;
         glGenRenderbuffers(1, &id);
-        return Value::MakeUInt32((int32_t)id, program->GetStackAllocator());
+        return Value::MakeUInt32((int32_t)id, context->GetStackAllocator());
     }
 
     case GLModuleFunction::TGL_DELETE_RENDERBUFFERS: {
@@ -475,7 +475,7 @@ Value GLModule::CallFunction(Program* program, uint16 function, const std::vecto
         void* pixels;
         glReadPixels(x, y, width, height, format, type, pixels);
 
-        return Value::MakePointer((uint16)ValueType::VOID_T, 1, pixels, program->GetStackAllocator());
+        return Value::MakePointer((uint16)ValueType::VOID_T, 1, pixels, context->GetStackAllocator());
     }
 
                                           // ------------------------------
@@ -484,7 +484,7 @@ Value GLModule::CallFunction(Program* program, uint16 function, const std::vecto
     case GLModuleFunction::TGL_CREATE_SHADER: {
         GLenum type = (GLenum)args[0].GetInt32();
         GLuint s = glCreateShader(type);
-        return Value::MakeUInt32(s, program->GetStackAllocator());
+        return Value::MakeUInt32(s, context->GetStackAllocator());
     }
 
     case GLModuleFunction::TGL_SHADER_SOURCE: {
@@ -508,7 +508,7 @@ Value GLModule::CallFunction(Program* program, uint16 function, const std::vecto
 
     case GLModuleFunction::TGL_CREATE_PROGRAM: {
         GLuint p = glCreateProgram();
-        return Value::MakeUInt32((int32_t)p, program->GetStackAllocator());
+        return Value::MakeUInt32((int32_t)p, context->GetStackAllocator());
     }
 
     case GLModuleFunction::TGL_ATTACH_SHADER: {
@@ -554,7 +554,7 @@ Value GLModule::CallFunction(Program* program, uint16 function, const std::vecto
         GLenum pname = (GLenum)args[1].GetInt32();
         GLint value = 0;
         glGetShaderiv(shader, pname, &value);
-        return Value::MakeInt32(value, program->GetStackAllocator());
+        return Value::MakeInt32(value, context->GetStackAllocator());
     }
 
     case GLModuleFunction::TGL_GET_SHADER_INFO_LOG: {
@@ -572,7 +572,7 @@ Value GLModule::CallFunction(Program* program, uint16 function, const std::vecto
         GLenum pname = (GLenum)args[1].GetInt32();
         GLint value = 0;
         glGetProgramiv(prog, pname, &value);
-        return Value::MakeInt32(value, program->GetStackAllocator());
+        return Value::MakeInt32(value, context->GetStackAllocator());
     }
 
     case GLModuleFunction::TGL_GET_PROGRAM_INFO_LOG: {
@@ -633,14 +633,14 @@ Value GLModule::CallFunction(Program* program, uint16 function, const std::vecto
         GLuint prog = (GLuint)args[0].GetInt32();
         const char* name = args[1].GetCString();
         GLint loc = glGetUniformLocation(prog, name);
-        return Value::MakeInt32(loc, program->GetStackAllocator());
+        return Value::MakeInt32(loc, context->GetStackAllocator());
     }
 
     case GLModuleFunction::TGL_GET_ATTRIB_LOCATION: {
         GLuint prog = (GLuint)args[0].GetInt32();
         const char* name = args[1].GetCString();
         GLint loc = glGetAttribLocation(prog, name);
-        return Value::MakeInt32(loc, program->GetStackAllocator());
+        return Value::MakeInt32(loc, context->GetStackAllocator());
     }
 
     case GLModuleFunction::TGL_UNIFORM_1I: {
@@ -732,7 +732,7 @@ Value GLModule::CallFunction(Program* program, uint16 function, const std::vecto
         GLuint prog = (GLuint)args[0].GetInt32();
         const char* name = args[1].GetCString();
         GLuint idx = glGetUniformBlockIndex(prog, name);
-        return Value::MakeInt32((int32_t)idx, program->GetStackAllocator());
+        return Value::MakeInt32((int32_t)idx, context->GetStackAllocator());
     }
 
     case GLModuleFunction::TGL_UNIFORM_BLOCK_BINDING: {
@@ -762,7 +762,7 @@ Value GLModule::CallFunction(Program* program, uint16 function, const std::vecto
     case GLModuleFunction::TGL_GEN_TEXTURES: {
         GLuint id = 0;
         glGenTextures(1, &id);
-        return Value::MakeUInt32((int32_t)id, program->GetStackAllocator());
+        return Value::MakeUInt32((int32_t)id, context->GetStackAllocator());
     }
 
     case GLModuleFunction::TGL_DELETE_TEXTURES: {
@@ -956,7 +956,7 @@ Value GLModule::CallFunction(Program* program, uint16 function, const std::vecto
     case GLModuleFunction::TGL_GEN_QUERIES: {
         GLuint id = 0;
         glGenQueries(1, &id);
-        return Value::MakeUInt32((int32_t)id, program->GetStackAllocator());
+        return Value::MakeUInt32((int32_t)id, context->GetStackAllocator());
     }
 
     case GLModuleFunction::TGL_DELETE_QUERIES: {
@@ -983,7 +983,7 @@ Value GLModule::CallFunction(Program* program, uint16 function, const std::vecto
         GLenum pname = (GLenum)args[1].GetInt32();
         GLuint params = 0;
         glGetQueryObjectuiv(id, pname, &params);
-        return Value::MakeInt32((int32_t)params, program->GetStackAllocator());
+        return Value::MakeInt32((int32_t)params, context->GetStackAllocator());
     }
 
     case GLModuleFunction::TGL_GET_QUERY_OBJECTI64V:
@@ -1007,7 +1007,7 @@ Value GLModule::CallFunction(Program* program, uint16 function, const std::vecto
         // returns GLsync (opaque pointer)  TODO: represent as int/ptr in Value
         GLsync sync = glFenceSync(condition, flags);
         // Represent as int64 pointer value for now:
-        return Value::MakeInt64((int64_t)(uintptr_t)sync, program->GetStackAllocator());
+        return Value::MakeInt64((int64_t)(uintptr_t)sync, context->GetStackAllocator());
     }
 
     case GLModuleFunction::TGL_DELETE_SYNC: {
@@ -1019,7 +1019,7 @@ Value GLModule::CallFunction(Program* program, uint16 function, const std::vecto
     case GLModuleFunction::TGL_IS_SYNC: {
         GLsync sync = (GLsync)(uintptr_t)args[0].GetInt64();
         GLboolean res = glIsSync(sync);
-        return Value::MakeBool(res == GL_TRUE, program->GetStackAllocator());
+        return Value::MakeBool(res == GL_TRUE, context->GetStackAllocator());
     }
 
     case GLModuleFunction::TGL_CLIENT_WAIT_SYNC: {
@@ -1028,7 +1028,7 @@ Value GLModule::CallFunction(Program* program, uint16 function, const std::vecto
         GLuint64 timeout = (GLuint64)args[2].GetInt64();
         // returns GLbitfield or enum status  return as int32
         GLint res = (GLint)glClientWaitSync(sync, flags, timeout);
-        return Value::MakeInt32(res, program->GetStackAllocator());
+        return Value::MakeInt32(res, context->GetStackAllocator());
     }
 
     case GLModuleFunction::TGL_WAIT_SYNC: {
@@ -1067,7 +1067,7 @@ Value GLModule::CallFunction(Program* program, uint16 function, const std::vecto
     case GLModuleFunction::TGL_IS_ENABLED: {
         GLenum cap = (GLenum)args[0].GetInt32();
         GLboolean r = glIsEnabled(cap);
-        return Value::MakeBool(r == GL_TRUE, program->GetStackAllocator());
+        return Value::MakeBool(r == GL_TRUE, context->GetStackAllocator());
     }
 
     case GLModuleFunction::TGL_DEPTH_FUNC: {
@@ -1173,7 +1173,7 @@ Value GLModule::CallFunction(Program* program, uint16 function, const std::vecto
     case GLModuleFunction::TGL_GEN_SAMPLERS: {
         GLuint id = 0;
         glGenSamplers(1, &id);
-        return Value::MakeInt32((int32_t)id, program->GetStackAllocator());
+        return Value::MakeInt32((int32_t)id, context->GetStackAllocator());
     }
 
     case GLModuleFunction::TGL_DELETE_SAMPLERS: {
@@ -1273,7 +1273,7 @@ Value GLModule::CallFunction(Program* program, uint16 function, const std::vecto
         GLenum pname = (GLenum)args[1].GetInt32();
         GLint param = 0;
         glGetVertexAttribiv(index, pname, &param);
-        return Value::MakeInt32(param, program->GetStackAllocator());
+        return Value::MakeInt32(param, context->GetStackAllocator());
     }
 
     case GLModuleFunction::TGL_GET_VERTEX_ATTRIB_POINTERV: {
@@ -1286,7 +1286,7 @@ Value GLModule::CallFunction(Program* program, uint16 function, const std::vecto
         GLenum pname = (GLenum)args[1].GetInt32();
         GLint64 value = 0;
         glGetBufferParameteri64v(target, pname, &value);
-        return Value::MakeInt64((int64_t)value, program->GetStackAllocator());
+        return Value::MakeInt64((int64_t)value, context->GetStackAllocator());
     }
 
                                                        // ------------------------------
@@ -1297,218 +1297,217 @@ Value GLModule::CallFunction(Program* program, uint16 function, const std::vecto
     } // switch
 }
 
-Value GLModule::Constant(Program* program, uint16 constant)
+Value GLModule::Constant(ExecutionContext* context, uint16 constant)
 {
     switch ((GLModuleConstant)constant)
     {
         // Basic values
-    case GLModuleConstant::TGL_ZERO: return Value::MakeInt32(GL_ZERO, program->GetStackAllocator());
-    case GLModuleConstant::TGL_ONE: return Value::MakeInt32(GL_ONE, program->GetStackAllocator());
-    case GLModuleConstant::TGL_FALSE: return Value::MakeInt32(GL_FALSE, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TRUE: return Value::MakeInt32(GL_TRUE, program->GetStackAllocator());
-
-    case GLModuleConstant::TGL_UNSIGNED_BYTE: return Value::MakeInt32(GL_UNSIGNED_BYTE, program->GetStackAllocator());
-    case GLModuleConstant::TGL_UNSIGNED_SHORT: return Value::MakeInt32(GL_UNSIGNED_SHORT, program->GetStackAllocator());
-    case GLModuleConstant::TGL_UNSIGNED_INT: return Value::MakeInt32(GL_UNSIGNED_INT, program->GetStackAllocator());
-    case GLModuleConstant::TGL_UNSIGNED_INT_24_8: return Value::MakeInt32(GL_UNSIGNED_INT_24_8, program->GetStackAllocator());
-    case GLModuleConstant::TGL_UNSIGNED_INT_2_10_10_10_REV: return Value::MakeInt32(GL_UNSIGNED_INT_2_10_10_10_REV, program->GetStackAllocator());
-    case GLModuleConstant::TGL_FLOAT: return Value::MakeInt32(GL_FLOAT, program->GetStackAllocator());
-    case GLModuleConstant::TGL_HALF_FLOAT: return Value::MakeInt32(GL_HALF_FLOAT, program->GetStackAllocator());
-    case GLModuleConstant::TGL_INT: return Value::MakeInt32(GL_INT, program->GetStackAllocator());
-    case GLModuleConstant::TGL_SHORT: return Value::MakeInt32(GL_SHORT, program->GetStackAllocator());
-    case GLModuleConstant::TGL_BYTE: return Value::MakeInt32(GL_BYTE, program->GetStackAllocator());
-    case GLModuleConstant::TGL_UNSIGNED_BYTE_3_3_2: return Value::MakeInt32(GL_UNSIGNED_BYTE_3_3_2, program->GetStackAllocator());
-    case GLModuleConstant::TGL_UNSIGNED_BYTE_2_3_3_REV: return Value::MakeInt32(GL_UNSIGNED_BYTE_2_3_3_REV, program->GetStackAllocator());
+    case GLModuleConstant::TGL_ZERO: return Value::MakeInt32(GL_ZERO, context->GetStackAllocator());
+    case GLModuleConstant::TGL_ONE: return Value::MakeInt32(GL_ONE, context->GetStackAllocator());
+    case GLModuleConstant::TGL_FALSE: return Value::MakeInt32(GL_FALSE, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TRUE: return Value::MakeInt32(GL_TRUE, context->GetStackAllocator());
+
+    case GLModuleConstant::TGL_UNSIGNED_BYTE: return Value::MakeInt32(GL_UNSIGNED_BYTE, context->GetStackAllocator());
+    case GLModuleConstant::TGL_UNSIGNED_SHORT: return Value::MakeInt32(GL_UNSIGNED_SHORT, context->GetStackAllocator());
+    case GLModuleConstant::TGL_UNSIGNED_INT: return Value::MakeInt32(GL_UNSIGNED_INT, context->GetStackAllocator());
+    case GLModuleConstant::TGL_UNSIGNED_INT_24_8: return Value::MakeInt32(GL_UNSIGNED_INT_24_8, context->GetStackAllocator());
+    case GLModuleConstant::TGL_UNSIGNED_INT_2_10_10_10_REV: return Value::MakeInt32(GL_UNSIGNED_INT_2_10_10_10_REV, context->GetStackAllocator());
+    case GLModuleConstant::TGL_FLOAT: return Value::MakeInt32(GL_FLOAT, context->GetStackAllocator());
+    case GLModuleConstant::TGL_HALF_FLOAT: return Value::MakeInt32(GL_HALF_FLOAT, context->GetStackAllocator());
+    case GLModuleConstant::TGL_INT: return Value::MakeInt32(GL_INT, context->GetStackAllocator());
+    case GLModuleConstant::TGL_SHORT: return Value::MakeInt32(GL_SHORT, context->GetStackAllocator());
+    case GLModuleConstant::TGL_BYTE: return Value::MakeInt32(GL_BYTE, context->GetStackAllocator());
+    case GLModuleConstant::TGL_UNSIGNED_BYTE_3_3_2: return Value::MakeInt32(GL_UNSIGNED_BYTE_3_3_2, context->GetStackAllocator());
+    case GLModuleConstant::TGL_UNSIGNED_BYTE_2_3_3_REV: return Value::MakeInt32(GL_UNSIGNED_BYTE_2_3_3_REV, context->GetStackAllocator());
 
         // Primitives / modes
-    case GLModuleConstant::TGL_POINTS: return Value::MakeInt32(GL_POINTS, program->GetStackAllocator());
-    case GLModuleConstant::TGL_LINES: return Value::MakeInt32(GL_LINES, program->GetStackAllocator());
-    case GLModuleConstant::TGL_LINE_LOOP: return Value::MakeInt32(GL_LINE_LOOP, program->GetStackAllocator());
-    case GLModuleConstant::TGL_LINE_STRIP: return Value::MakeInt32(GL_LINE_STRIP, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TRIANGLES: return Value::MakeInt32(GL_TRIANGLES, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TRIANGLE_STRIP: return Value::MakeInt32(GL_TRIANGLE_STRIP, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TRIANGLE_FAN: return Value::MakeInt32(GL_TRIANGLE_FAN, program->GetStackAllocator());
-    case GLModuleConstant::TGL_LINES_ADJACENCY: return Value::MakeInt32(GL_LINES_ADJACENCY, program->GetStackAllocator());
-    case GLModuleConstant::TGL_LINE_STRIP_ADJACENCY: return Value::MakeInt32(GL_LINE_STRIP_ADJACENCY, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TRIANGLES_ADJACENCY: return Value::MakeInt32(GL_TRIANGLES_ADJACENCY, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TRIANGLE_STRIP_ADJACENCY: return Value::MakeInt32(GL_TRIANGLE_STRIP_ADJACENCY, program->GetStackAllocator());
-    case GLModuleConstant::TGL_PATCHES: return Value::MakeInt32(GL_PATCHES, program->GetStackAllocator());
+    case GLModuleConstant::TGL_POINTS: return Value::MakeInt32(GL_POINTS, context->GetStackAllocator());
+    case GLModuleConstant::TGL_LINES: return Value::MakeInt32(GL_LINES, context->GetStackAllocator());
+    case GLModuleConstant::TGL_LINE_LOOP: return Value::MakeInt32(GL_LINE_LOOP, context->GetStackAllocator());
+    case GLModuleConstant::TGL_LINE_STRIP: return Value::MakeInt32(GL_LINE_STRIP, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TRIANGLES: return Value::MakeInt32(GL_TRIANGLES, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TRIANGLE_STRIP: return Value::MakeInt32(GL_TRIANGLE_STRIP, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TRIANGLE_FAN: return Value::MakeInt32(GL_TRIANGLE_FAN, context->GetStackAllocator());
+    case GLModuleConstant::TGL_LINES_ADJACENCY: return Value::MakeInt32(GL_LINES_ADJACENCY, context->GetStackAllocator());
+    case GLModuleConstant::TGL_LINE_STRIP_ADJACENCY: return Value::MakeInt32(GL_LINE_STRIP_ADJACENCY, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TRIANGLES_ADJACENCY: return Value::MakeInt32(GL_TRIANGLES_ADJACENCY, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TRIANGLE_STRIP_ADJACENCY: return Value::MakeInt32(GL_TRIANGLE_STRIP_ADJACENCY, context->GetStackAllocator());
+    case GLModuleConstant::TGL_PATCHES: return Value::MakeInt32(GL_PATCHES, context->GetStackAllocator());
 
         // Buffer binding targets
-    case GLModuleConstant::TGL_ARRAY_BUFFER: return Value::MakeInt32(GL_ARRAY_BUFFER, program->GetStackAllocator());
-    case GLModuleConstant::TGL_ELEMENT_ARRAY_BUFFER: return Value::MakeInt32(GL_ELEMENT_ARRAY_BUFFER, program->GetStackAllocator());
-    case GLModuleConstant::TGL_COPY_READ_BUFFER: return Value::MakeInt32(GL_COPY_READ_BUFFER, program->GetStackAllocator());
-    case GLModuleConstant::TGL_COPY_WRITE_BUFFER: return Value::MakeInt32(GL_COPY_WRITE_BUFFER, program->GetStackAllocator());
-    case GLModuleConstant::TGL_PIXEL_PACK_BUFFER: return Value::MakeInt32(GL_PIXEL_PACK_BUFFER, program->GetStackAllocator());
-    case GLModuleConstant::TGL_PIXEL_UNPACK_BUFFER: return Value::MakeInt32(GL_PIXEL_UNPACK_BUFFER, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TRANSFORM_FEEDBACK_BUFFER: return Value::MakeInt32(GL_TRANSFORM_FEEDBACK_BUFFER, program->GetStackAllocator());
-    case GLModuleConstant::TGL_UNIFORM_BUFFER: return Value::MakeInt32(GL_UNIFORM_BUFFER, program->GetStackAllocator());
-    case GLModuleConstant::TGL_SHADER_STORAGE_BUFFER: return Value::MakeInt32(GL_SHADER_STORAGE_BUFFER, program->GetStackAllocator());
-    case GLModuleConstant::TGL_DISPATCH_INDIRECT_BUFFER: return Value::MakeInt32(GL_DISPATCH_INDIRECT_BUFFER, program->GetStackAllocator());
-    case GLModuleConstant::TGL_DRAW_INDIRECT_BUFFER: return Value::MakeInt32(GL_DRAW_INDIRECT_BUFFER, program->GetStackAllocator());
-    case GLModuleConstant::TGL_ATOMIC_COUNTER_BUFFER: return Value::MakeInt32(GL_ATOMIC_COUNTER_BUFFER, program->GetStackAllocator());
-    case GLModuleConstant::TGL_QUERY_BUFFER: return Value::MakeInt32(GL_QUERY_BUFFER, program->GetStackAllocator());
+    case GLModuleConstant::TGL_ARRAY_BUFFER: return Value::MakeInt32(GL_ARRAY_BUFFER, context->GetStackAllocator());
+    case GLModuleConstant::TGL_ELEMENT_ARRAY_BUFFER: return Value::MakeInt32(GL_ELEMENT_ARRAY_BUFFER, context->GetStackAllocator());
+    case GLModuleConstant::TGL_COPY_READ_BUFFER: return Value::MakeInt32(GL_COPY_READ_BUFFER, context->GetStackAllocator());
+    case GLModuleConstant::TGL_COPY_WRITE_BUFFER: return Value::MakeInt32(GL_COPY_WRITE_BUFFER, context->GetStackAllocator());
+    case GLModuleConstant::TGL_PIXEL_PACK_BUFFER: return Value::MakeInt32(GL_PIXEL_PACK_BUFFER, context->GetStackAllocator());
+    case GLModuleConstant::TGL_PIXEL_UNPACK_BUFFER: return Value::MakeInt32(GL_PIXEL_UNPACK_BUFFER, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TRANSFORM_FEEDBACK_BUFFER: return Value::MakeInt32(GL_TRANSFORM_FEEDBACK_BUFFER, context->GetStackAllocator());
+    case GLModuleConstant::TGL_UNIFORM_BUFFER: return Value::MakeInt32(GL_UNIFORM_BUFFER, context->GetStackAllocator());
+    case GLModuleConstant::TGL_SHADER_STORAGE_BUFFER: return Value::MakeInt32(GL_SHADER_STORAGE_BUFFER, context->GetStackAllocator());
+    case GLModuleConstant::TGL_DISPATCH_INDIRECT_BUFFER: return Value::MakeInt32(GL_DISPATCH_INDIRECT_BUFFER, context->GetStackAllocator());
+    case GLModuleConstant::TGL_DRAW_INDIRECT_BUFFER: return Value::MakeInt32(GL_DRAW_INDIRECT_BUFFER, context->GetStackAllocator());
+    case GLModuleConstant::TGL_ATOMIC_COUNTER_BUFFER: return Value::MakeInt32(GL_ATOMIC_COUNTER_BUFFER, context->GetStackAllocator());
+    case GLModuleConstant::TGL_QUERY_BUFFER: return Value::MakeInt32(GL_QUERY_BUFFER, context->GetStackAllocator());
 
         // Usage hints
-    case GLModuleConstant::TGL_STATIC_DRAW: return Value::MakeInt32(GL_STATIC_DRAW, program->GetStackAllocator());
-    case GLModuleConstant::TGL_DYNAMIC_DRAW: return Value::MakeInt32(GL_DYNAMIC_DRAW, program->GetStackAllocator());
-    case GLModuleConstant::TGL_STREAM_DRAW: return Value::MakeInt32(GL_STREAM_DRAW, program->GetStackAllocator());
-    case GLModuleConstant::TGL_STATIC_READ: return Value::MakeInt32(GL_STATIC_READ, program->GetStackAllocator());
-    case GLModuleConstant::TGL_DYNAMIC_READ: return Value::MakeInt32(GL_DYNAMIC_READ, program->GetStackAllocator());
-    case GLModuleConstant::TGL_STREAM_READ: return Value::MakeInt32(GL_STREAM_READ, program->GetStackAllocator());
-    case GLModuleConstant::TGL_STATIC_COPY: return Value::MakeInt32(GL_STATIC_COPY, program->GetStackAllocator());
-    case GLModuleConstant::TGL_DYNAMIC_COPY: return Value::MakeInt32(GL_DYNAMIC_COPY, program->GetStackAllocator());
-    case GLModuleConstant::TGL_STREAM_COPY: return Value::MakeInt32(GL_STREAM_COPY, program->GetStackAllocator());
-    case GLModuleConstant::TGL_READ_ONLY: return Value::MakeInt32(GL_READ_ONLY, program->GetStackAllocator());
-    case GLModuleConstant::TGL_WRITE_ONLY: return Value::MakeInt32(GL_WRITE_ONLY, program->GetStackAllocator());
-    case GLModuleConstant::TGL_READ_WRITE: return Value::MakeInt32(GL_READ_WRITE, program->GetStackAllocator());
+    case GLModuleConstant::TGL_STATIC_DRAW: return Value::MakeInt32(GL_STATIC_DRAW, context->GetStackAllocator());
+    case GLModuleConstant::TGL_DYNAMIC_DRAW: return Value::MakeInt32(GL_DYNAMIC_DRAW, context->GetStackAllocator());
+    case GLModuleConstant::TGL_STREAM_DRAW: return Value::MakeInt32(GL_STREAM_DRAW, context->GetStackAllocator());
+    case GLModuleConstant::TGL_STATIC_READ: return Value::MakeInt32(GL_STATIC_READ, context->GetStackAllocator());
+    case GLModuleConstant::TGL_DYNAMIC_READ: return Value::MakeInt32(GL_DYNAMIC_READ, context->GetStackAllocator());
+    case GLModuleConstant::TGL_STREAM_READ: return Value::MakeInt32(GL_STREAM_READ, context->GetStackAllocator());
+    case GLModuleConstant::TGL_STATIC_COPY: return Value::MakeInt32(GL_STATIC_COPY, context->GetStackAllocator());
+    case GLModuleConstant::TGL_DYNAMIC_COPY: return Value::MakeInt32(GL_DYNAMIC_COPY, context->GetStackAllocator());
+    case GLModuleConstant::TGL_STREAM_COPY: return Value::MakeInt32(GL_STREAM_COPY, context->GetStackAllocator());
+    case GLModuleConstant::TGL_READ_ONLY: return Value::MakeInt32(GL_READ_ONLY, context->GetStackAllocator());
+    case GLModuleConstant::TGL_WRITE_ONLY: return Value::MakeInt32(GL_WRITE_ONLY, context->GetStackAllocator());
+    case GLModuleConstant::TGL_READ_WRITE: return Value::MakeInt32(GL_READ_WRITE, context->GetStackAllocator());
 
         // Texture targets / types
-    case GLModuleConstant::TGL_TEXTURE_1D: return Value::MakeInt32(GL_TEXTURE_1D, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE_2D: return Value::MakeInt32(GL_TEXTURE_2D, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE_3D: return Value::MakeInt32(GL_TEXTURE_3D, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE_1D_ARRAY: return Value::MakeInt32(GL_TEXTURE_1D_ARRAY, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE_2D_ARRAY: return Value::MakeInt32(GL_TEXTURE_2D_ARRAY, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE_RECTANGLE: return Value::MakeInt32(GL_TEXTURE_RECTANGLE, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE_CUBE_MAP: return Value::MakeInt32(GL_TEXTURE_CUBE_MAP, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE_CUBE_MAP_ARRAY: return Value::MakeInt32(GL_TEXTURE_CUBE_MAP_ARRAY, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE_BUFFER: return Value::MakeInt32(GL_TEXTURE_BUFFER, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE_2D_MULTISAMPLE: return Value::MakeInt32(GL_TEXTURE_2D_MULTISAMPLE, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE_2D_MULTISAMPLE_ARRAY: return Value::MakeInt32(GL_TEXTURE_2D_MULTISAMPLE_ARRAY, program->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE_1D: return Value::MakeInt32(GL_TEXTURE_1D, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE_2D: return Value::MakeInt32(GL_TEXTURE_2D, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE_3D: return Value::MakeInt32(GL_TEXTURE_3D, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE_1D_ARRAY: return Value::MakeInt32(GL_TEXTURE_1D_ARRAY, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE_2D_ARRAY: return Value::MakeInt32(GL_TEXTURE_2D_ARRAY, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE_RECTANGLE: return Value::MakeInt32(GL_TEXTURE_RECTANGLE, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE_CUBE_MAP: return Value::MakeInt32(GL_TEXTURE_CUBE_MAP, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE_CUBE_MAP_ARRAY: return Value::MakeInt32(GL_TEXTURE_CUBE_MAP_ARRAY, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE_BUFFER: return Value::MakeInt32(GL_TEXTURE_BUFFER, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE_2D_MULTISAMPLE: return Value::MakeInt32(GL_TEXTURE_2D_MULTISAMPLE, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE_2D_MULTISAMPLE_ARRAY: return Value::MakeInt32(GL_TEXTURE_2D_MULTISAMPLE_ARRAY, context->GetStackAllocator());
 
         // Texture filtering / wrapping
-    case GLModuleConstant::TGL_NEAREST: return Value::MakeInt32(GL_NEAREST, program->GetStackAllocator());
-    case GLModuleConstant::TGL_LINEAR: return Value::MakeInt32(GL_LINEAR, program->GetStackAllocator());
-    case GLModuleConstant::TGL_NEAREST_MIPMAP_NEAREST: return Value::MakeInt32(GL_NEAREST_MIPMAP_NEAREST, program->GetStackAllocator());
-    case GLModuleConstant::TGL_LINEAR_MIPMAP_NEAREST: return Value::MakeInt32(GL_LINEAR_MIPMAP_NEAREST, program->GetStackAllocator());
-    case GLModuleConstant::TGL_NEAREST_MIPMAP_LINEAR: return Value::MakeInt32(GL_NEAREST_MIPMAP_LINEAR, program->GetStackAllocator());
-    case GLModuleConstant::TGL_LINEAR_MIPMAP_LINEAR: return Value::MakeInt32(GL_LINEAR_MIPMAP_LINEAR, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE_MAG_FILTER: return Value::MakeInt32(GL_TEXTURE_MAG_FILTER, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE_MIN_FILTER: return Value::MakeInt32(GL_TEXTURE_MIN_FILTER, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE_WRAP_S: return Value::MakeInt32(GL_TEXTURE_WRAP_S, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE_WRAP_T: return Value::MakeInt32(GL_TEXTURE_WRAP_T, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE_WRAP_R: return Value::MakeInt32(GL_TEXTURE_WRAP_R, program->GetStackAllocator());
-    case GLModuleConstant::TGL_REPEAT: return Value::MakeInt32(GL_REPEAT, program->GetStackAllocator());
-    case GLModuleConstant::TGL_CLAMP_TO_EDGE: return Value::MakeInt32(GL_CLAMP_TO_EDGE, program->GetStackAllocator());
-    case GLModuleConstant::TGL_MIRRORED_REPEAT: return Value::MakeInt32(GL_MIRRORED_REPEAT, program->GetStackAllocator());
-    case GLModuleConstant::TGL_CLAMP_TO_BORDER: return Value::MakeInt32(GL_CLAMP_TO_BORDER, program->GetStackAllocator());
+    case GLModuleConstant::TGL_NEAREST: return Value::MakeInt32(GL_NEAREST, context->GetStackAllocator());
+    case GLModuleConstant::TGL_LINEAR: return Value::MakeInt32(GL_LINEAR, context->GetStackAllocator());
+    case GLModuleConstant::TGL_NEAREST_MIPMAP_NEAREST: return Value::MakeInt32(GL_NEAREST_MIPMAP_NEAREST, context->GetStackAllocator());
+    case GLModuleConstant::TGL_LINEAR_MIPMAP_NEAREST: return Value::MakeInt32(GL_LINEAR_MIPMAP_NEAREST, context->GetStackAllocator());
+    case GLModuleConstant::TGL_NEAREST_MIPMAP_LINEAR: return Value::MakeInt32(GL_NEAREST_MIPMAP_LINEAR, context->GetStackAllocator());
+    case GLModuleConstant::TGL_LINEAR_MIPMAP_LINEAR: return Value::MakeInt32(GL_LINEAR_MIPMAP_LINEAR, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE_MAG_FILTER: return Value::MakeInt32(GL_TEXTURE_MAG_FILTER, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE_MIN_FILTER: return Value::MakeInt32(GL_TEXTURE_MIN_FILTER, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE_WRAP_S: return Value::MakeInt32(GL_TEXTURE_WRAP_S, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE_WRAP_T: return Value::MakeInt32(GL_TEXTURE_WRAP_T, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE_WRAP_R: return Value::MakeInt32(GL_TEXTURE_WRAP_R, context->GetStackAllocator());
+    case GLModuleConstant::TGL_REPEAT: return Value::MakeInt32(GL_REPEAT, context->GetStackAllocator());
+    case GLModuleConstant::TGL_CLAMP_TO_EDGE: return Value::MakeInt32(GL_CLAMP_TO_EDGE, context->GetStackAllocator());
+    case GLModuleConstant::TGL_MIRRORED_REPEAT: return Value::MakeInt32(GL_MIRRORED_REPEAT, context->GetStackAllocator());
+    case GLModuleConstant::TGL_CLAMP_TO_BORDER: return Value::MakeInt32(GL_CLAMP_TO_BORDER, context->GetStackAllocator());
 
         // Shader types
-    case GLModuleConstant::TGL_VERTEX_SHADER: return Value::MakeInt32(GL_VERTEX_SHADER, program->GetStackAllocator());
-    case GLModuleConstant::TGL_FRAGMENT_SHADER: return Value::MakeInt32(GL_FRAGMENT_SHADER, program->GetStackAllocator());
-    case GLModuleConstant::TGL_GEOMETRY_SHADER: return Value::MakeInt32(GL_GEOMETRY_SHADER, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TESS_CONTROL_SHADER: return Value::MakeInt32(GL_TESS_CONTROL_SHADER, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TESS_EVALUATION_SHADER: return Value::MakeInt32(GL_TESS_EVALUATION_SHADER, program->GetStackAllocator());
-    case GLModuleConstant::TGL_COMPUTE_SHADER: return Value::MakeInt32(GL_COMPUTE_SHADER, program->GetStackAllocator());
-    case GLModuleConstant::TGL_COMPILE_STATUS: return Value::MakeInt32(GL_COMPILE_STATUS, program->GetStackAllocator());
-    case GLModuleConstant::TGL_LINK_STATUS: return Value::MakeInt32(GL_LINK_STATUS, program->GetStackAllocator());
+    case GLModuleConstant::TGL_VERTEX_SHADER: return Value::MakeInt32(GL_VERTEX_SHADER, context->GetStackAllocator());
+    case GLModuleConstant::TGL_FRAGMENT_SHADER: return Value::MakeInt32(GL_FRAGMENT_SHADER, context->GetStackAllocator());
+    case GLModuleConstant::TGL_GEOMETRY_SHADER: return Value::MakeInt32(GL_GEOMETRY_SHADER, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TESS_CONTROL_SHADER: return Value::MakeInt32(GL_TESS_CONTROL_SHADER, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TESS_EVALUATION_SHADER: return Value::MakeInt32(GL_TESS_EVALUATION_SHADER, context->GetStackAllocator());
+    case GLModuleConstant::TGL_COMPUTE_SHADER: return Value::MakeInt32(GL_COMPUTE_SHADER, context->GetStackAllocator());
+    case GLModuleConstant::TGL_COMPILE_STATUS: return Value::MakeInt32(GL_COMPILE_STATUS, context->GetStackAllocator());
+    case GLModuleConstant::TGL_LINK_STATUS: return Value::MakeInt32(GL_LINK_STATUS, context->GetStackAllocator());
 
         // Framebuffer attachments
-    case GLModuleConstant::TGL_FRAMEBUFFER: return Value::MakeInt32(GL_FRAMEBUFFER, program->GetStackAllocator());
-    case GLModuleConstant::TGL_READ_FRAMEBUFFER: return Value::MakeInt32(GL_READ_FRAMEBUFFER, program->GetStackAllocator());
-    case GLModuleConstant::TGL_DRAW_FRAMEBUFFER: return Value::MakeInt32(GL_DRAW_FRAMEBUFFER, program->GetStackAllocator());
-    case GLModuleConstant::TGL_RENDERBUFFER: return Value::MakeInt32(GL_RENDERBUFFER, program->GetStackAllocator());
-    case GLModuleConstant::TGL_COLOR_ATTACHMENT0: return Value::MakeInt32(GL_COLOR_ATTACHMENT0, program->GetStackAllocator());
-    case GLModuleConstant::TGL_DEPTH_ATTACHMENT: return Value::MakeInt32(GL_DEPTH_ATTACHMENT, program->GetStackAllocator());
-    case GLModuleConstant::TGL_STENCIL_ATTACHMENT: return Value::MakeInt32(GL_STENCIL_ATTACHMENT, program->GetStackAllocator());
-    case GLModuleConstant::TGL_DEPTH_STENCIL_ATTACHMENT: return Value::MakeInt32(GL_DEPTH_STENCIL_ATTACHMENT, program->GetStackAllocator());
-    case GLModuleConstant::TGL_FRAMEBUFFER_COMPLETE: return Value::MakeInt32(GL_FRAMEBUFFER_COMPLETE, program->GetStackAllocator());
+    case GLModuleConstant::TGL_FRAMEBUFFER: return Value::MakeInt32(GL_FRAMEBUFFER, context->GetStackAllocator());
+    case GLModuleConstant::TGL_READ_FRAMEBUFFER: return Value::MakeInt32(GL_READ_FRAMEBUFFER, context->GetStackAllocator());
+    case GLModuleConstant::TGL_DRAW_FRAMEBUFFER: return Value::MakeInt32(GL_DRAW_FRAMEBUFFER, context->GetStackAllocator());
+    case GLModuleConstant::TGL_RENDERBUFFER: return Value::MakeInt32(GL_RENDERBUFFER, context->GetStackAllocator());
+    case GLModuleConstant::TGL_COLOR_ATTACHMENT0: return Value::MakeInt32(GL_COLOR_ATTACHMENT0, context->GetStackAllocator());
+    case GLModuleConstant::TGL_DEPTH_ATTACHMENT: return Value::MakeInt32(GL_DEPTH_ATTACHMENT, context->GetStackAllocator());
+    case GLModuleConstant::TGL_STENCIL_ATTACHMENT: return Value::MakeInt32(GL_STENCIL_ATTACHMENT, context->GetStackAllocator());
+    case GLModuleConstant::TGL_DEPTH_STENCIL_ATTACHMENT: return Value::MakeInt32(GL_DEPTH_STENCIL_ATTACHMENT, context->GetStackAllocator());
+    case GLModuleConstant::TGL_FRAMEBUFFER_COMPLETE: return Value::MakeInt32(GL_FRAMEBUFFER_COMPLETE, context->GetStackAllocator());
 
         // Render states
-    case GLModuleConstant::TGL_BLEND: return Value::MakeInt32(GL_BLEND, program->GetStackAllocator());
-    case GLModuleConstant::TGL_DEPTH_TEST: return Value::MakeInt32(GL_DEPTH_TEST, program->GetStackAllocator());
-    case GLModuleConstant::TGL_CULL_FACE: return Value::MakeInt32(GL_CULL_FACE, program->GetStackAllocator());
-    case GLModuleConstant::TGL_SCISSOR_TEST: return Value::MakeInt32(GL_SCISSOR_TEST, program->GetStackAllocator());
-    case GLModuleConstant::TGL_STENCIL_TEST: return Value::MakeInt32(GL_STENCIL_TEST, program->GetStackAllocator());
+    case GLModuleConstant::TGL_BLEND: return Value::MakeInt32(GL_BLEND, context->GetStackAllocator());
+    case GLModuleConstant::TGL_DEPTH_TEST: return Value::MakeInt32(GL_DEPTH_TEST, context->GetStackAllocator());
+    case GLModuleConstant::TGL_CULL_FACE: return Value::MakeInt32(GL_CULL_FACE, context->GetStackAllocator());
+    case GLModuleConstant::TGL_SCISSOR_TEST: return Value::MakeInt32(GL_SCISSOR_TEST, context->GetStackAllocator());
+    case GLModuleConstant::TGL_STENCIL_TEST: return Value::MakeInt32(GL_STENCIL_TEST, context->GetStackAllocator());
 
         // Blend / depth / stencil equations
-    case GLModuleConstant::TGL_FUNC_ADD: return Value::MakeInt32(GL_FUNC_ADD, program->GetStackAllocator());
-    case GLModuleConstant::TGL_FUNC_SUBTRACT: return Value::MakeInt32(GL_FUNC_SUBTRACT, program->GetStackAllocator());
-    case GLModuleConstant::TGL_FUNC_REVERSE_SUBTRACT: return Value::MakeInt32(GL_FUNC_REVERSE_SUBTRACT, program->GetStackAllocator());
-    case GLModuleConstant::TGL_ONE_MINUS_SRC_ALPHA: return Value::MakeInt32(GL_ONE_MINUS_SRC_ALPHA, program->GetStackAllocator());
-    case GLModuleConstant::TGL_ONE_MINUS_DST_ALPHA: return Value::MakeInt32(GL_ONE_MINUS_DST_ALPHA, program->GetStackAllocator());
-    case GLModuleConstant::TGL_ONE_MINUS_SRC_COLOR: return Value::MakeInt32(GL_ONE_MINUS_SRC_COLOR, program->GetStackAllocator());
-    case GLModuleConstant::TGL_ONE_MINUS_DST_COLOR: return Value::MakeInt32(GL_ONE_MINUS_DST_COLOR, program->GetStackAllocator());
+    case GLModuleConstant::TGL_FUNC_ADD: return Value::MakeInt32(GL_FUNC_ADD, context->GetStackAllocator());
+    case GLModuleConstant::TGL_FUNC_SUBTRACT: return Value::MakeInt32(GL_FUNC_SUBTRACT, context->GetStackAllocator());
+    case GLModuleConstant::TGL_FUNC_REVERSE_SUBTRACT: return Value::MakeInt32(GL_FUNC_REVERSE_SUBTRACT, context->GetStackAllocator());
+    case GLModuleConstant::TGL_ONE_MINUS_SRC_ALPHA: return Value::MakeInt32(GL_ONE_MINUS_SRC_ALPHA, context->GetStackAllocator());
+    case GLModuleConstant::TGL_ONE_MINUS_DST_ALPHA: return Value::MakeInt32(GL_ONE_MINUS_DST_ALPHA, context->GetStackAllocator());
+    case GLModuleConstant::TGL_ONE_MINUS_SRC_COLOR: return Value::MakeInt32(GL_ONE_MINUS_SRC_COLOR, context->GetStackAllocator());
+    case GLModuleConstant::TGL_ONE_MINUS_DST_COLOR: return Value::MakeInt32(GL_ONE_MINUS_DST_COLOR, context->GetStackAllocator());
 
         // Debug output
-    case GLModuleConstant::TGL_DEBUG_OUTPUT: return Value::MakeInt32(GL_DEBUG_OUTPUT, program->GetStackAllocator());
-    case GLModuleConstant::TGL_DEBUG_OUTPUT_SYNCHRONOUS: return Value::MakeInt32(GL_DEBUG_OUTPUT_SYNCHRONOUS, program->GetStackAllocator());
-    case GLModuleConstant::TGL_DEBUG_SOURCE_API: return Value::MakeInt32(GL_DEBUG_SOURCE_API, program->GetStackAllocator());
-    case GLModuleConstant::TGL_DEBUG_SOURCE_SHADER_COMPILER: return Value::MakeInt32(GL_DEBUG_SOURCE_SHADER_COMPILER, program->GetStackAllocator());
-    case GLModuleConstant::TGL_DEBUG_TYPE_ERROR: return Value::MakeInt32(GL_DEBUG_TYPE_ERROR, program->GetStackAllocator());
-    case GLModuleConstant::TGL_DEBUG_SEVERITY_HIGH: return Value::MakeInt32(GL_DEBUG_SEVERITY_HIGH, program->GetStackAllocator());
-    case GLModuleConstant::TGL_DEBUG_SEVERITY_MEDIUM: return Value::MakeInt32(GL_DEBUG_SEVERITY_MEDIUM, program->GetStackAllocator());
-    case GLModuleConstant::TGL_DEBUG_SEVERITY_LOW: return Value::MakeInt32(GL_DEBUG_SEVERITY_LOW, program->GetStackAllocator());
-    case GLModuleConstant::TGL_DEBUG_SEVERITY_NOTIFICATION: return Value::MakeInt32(GL_DEBUG_SEVERITY_NOTIFICATION, program->GetStackAllocator());
-
-    case GLModuleConstant::TGL_COLOR_BUFFER_BIT: return Value::MakeInt32(GL_COLOR_BUFFER_BIT, program->GetStackAllocator());
-    case GLModuleConstant::TGL_DEPTH_BUFFER_BIT: return Value::MakeInt32(GL_DEPTH_BUFFER_BIT, program->GetStackAllocator());
-    case GLModuleConstant::TGL_STENCIL_BUFFER_BIT: return Value::MakeInt32(GL_STENCIL_BUFFER_BIT, program->GetStackAllocator());
-
-    case GLModuleConstant::TGL_CW: return Value::MakeInt32(GL_CW, program->GetStackAllocator());
-    case GLModuleConstant::TGL_CCW: return Value::MakeInt32(GL_CCW, program->GetStackAllocator());
-
-    case GLModuleConstant::TGL_R8: return Value::MakeInt32(GL_R8, program->GetStackAllocator());
-    case GLModuleConstant::TGL_R16: return Value::MakeInt32(GL_R16, program->GetStackAllocator());
-    case GLModuleConstant::TGL_RG8: return Value::MakeInt32(GL_RG8, program->GetStackAllocator());
-    case GLModuleConstant::TGL_RG16: return Value::MakeInt32(GL_RG16, program->GetStackAllocator());
-    case GLModuleConstant::TGL_R16F: return Value::MakeInt32(GL_R16F, program->GetStackAllocator());
-    case GLModuleConstant::TGL_R32F: return Value::MakeInt32(GL_R32F, program->GetStackAllocator());
-    case GLModuleConstant::TGL_RG16F: return Value::MakeInt32(GL_RG16F, program->GetStackAllocator());
-    case GLModuleConstant::TGL_RG32F: return Value::MakeInt32(GL_RG32F, program->GetStackAllocator());
-    case GLModuleConstant::TGL_RGBA8: return Value::MakeInt32(GL_RGBA8, program->GetStackAllocator());
-    case GLModuleConstant::TGL_RGBA16: return Value::MakeInt32(GL_RGBA16, program->GetStackAllocator());
-    case GLModuleConstant::TGL_RGBA16F: return Value::MakeInt32(GL_RGBA16F, program->GetStackAllocator());
-    case GLModuleConstant::TGL_RGBA32F: return Value::MakeInt32(GL_RGBA32F, program->GetStackAllocator());
-    case GLModuleConstant::TGL_SRGB8_ALPHA8: return Value::MakeInt32(GL_SRGB8_ALPHA8, program->GetStackAllocator());
-    case GLModuleConstant::TGL_DEPTH_COMPONENT16: return Value::MakeInt32(GL_DEPTH_COMPONENT16, program->GetStackAllocator());
-    case GLModuleConstant::TGL_DEPTH_COMPONENT24: return Value::MakeInt32(GL_DEPTH_COMPONENT24, program->GetStackAllocator());
-    case GLModuleConstant::TGL_DEPTH_COMPONENT32F: return Value::MakeInt32(GL_DEPTH_COMPONENT32F, program->GetStackAllocator());
-    case GLModuleConstant::TGL_DEPTH24_STENCIL8: return Value::MakeInt32(GL_DEPTH24_STENCIL8, program->GetStackAllocator());
-    case GLModuleConstant::TGL_DEPTH32F_STENCIL8: return Value::MakeInt32(GL_DEPTH32F_STENCIL8, program->GetStackAllocator());
-
-    case GLModuleConstant::TGL_RGBA:    return Value::MakeInt32(GL_RGBA, program->GetStackAllocator());
-
-    case GLModuleConstant::TGL_TEXTURE0: return Value::MakeInt32(GL_TEXTURE0, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE1: return Value::MakeInt32(GL_TEXTURE1, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE2: return Value::MakeInt32(GL_TEXTURE2, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE3: return Value::MakeInt32(GL_TEXTURE3, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE4: return Value::MakeInt32(GL_TEXTURE4, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE5: return Value::MakeInt32(GL_TEXTURE5, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE6: return Value::MakeInt32(GL_TEXTURE6, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE7: return Value::MakeInt32(GL_TEXTURE7, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE8: return Value::MakeInt32(GL_TEXTURE8, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE9: return Value::MakeInt32(GL_TEXTURE9, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE10: return Value::MakeInt32(GL_TEXTURE10, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE11: return Value::MakeInt32(GL_TEXTURE11, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE12: return Value::MakeInt32(GL_TEXTURE12, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE13: return Value::MakeInt32(GL_TEXTURE13, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE14: return Value::MakeInt32(GL_TEXTURE14, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE15: return Value::MakeInt32(GL_TEXTURE15, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE16: return Value::MakeInt32(GL_TEXTURE16, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE17: return Value::MakeInt32(GL_TEXTURE17, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE18: return Value::MakeInt32(GL_TEXTURE18, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE19: return Value::MakeInt32(GL_TEXTURE19, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE20: return Value::MakeInt32(GL_TEXTURE20, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE21: return Value::MakeInt32(GL_TEXTURE21, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE22: return Value::MakeInt32(GL_TEXTURE22, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE23: return Value::MakeInt32(GL_TEXTURE23, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE24: return Value::MakeInt32(GL_TEXTURE24, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE25: return Value::MakeInt32(GL_TEXTURE25, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE26: return Value::MakeInt32(GL_TEXTURE26, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE27: return Value::MakeInt32(GL_TEXTURE27, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE28: return Value::MakeInt32(GL_TEXTURE28, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE29: return Value::MakeInt32(GL_TEXTURE29, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE30: return Value::MakeInt32(GL_TEXTURE30, program->GetStackAllocator());
-    case GLModuleConstant::TGL_TEXTURE31: return Value::MakeInt32(GL_TEXTURE31, program->GetStackAllocator());
+    case GLModuleConstant::TGL_DEBUG_OUTPUT: return Value::MakeInt32(GL_DEBUG_OUTPUT, context->GetStackAllocator());
+    case GLModuleConstant::TGL_DEBUG_OUTPUT_SYNCHRONOUS: return Value::MakeInt32(GL_DEBUG_OUTPUT_SYNCHRONOUS, context->GetStackAllocator());
+    case GLModuleConstant::TGL_DEBUG_SOURCE_API: return Value::MakeInt32(GL_DEBUG_SOURCE_API, context->GetStackAllocator());
+    case GLModuleConstant::TGL_DEBUG_SOURCE_SHADER_COMPILER: return Value::MakeInt32(GL_DEBUG_SOURCE_SHADER_COMPILER, context->GetStackAllocator());
+    case GLModuleConstant::TGL_DEBUG_TYPE_ERROR: return Value::MakeInt32(GL_DEBUG_TYPE_ERROR, context->GetStackAllocator());
+    case GLModuleConstant::TGL_DEBUG_SEVERITY_HIGH: return Value::MakeInt32(GL_DEBUG_SEVERITY_HIGH, context->GetStackAllocator());
+    case GLModuleConstant::TGL_DEBUG_SEVERITY_MEDIUM: return Value::MakeInt32(GL_DEBUG_SEVERITY_MEDIUM, context->GetStackAllocator());
+    case GLModuleConstant::TGL_DEBUG_SEVERITY_LOW: return Value::MakeInt32(GL_DEBUG_SEVERITY_LOW, context->GetStackAllocator());
+    case GLModuleConstant::TGL_DEBUG_SEVERITY_NOTIFICATION: return Value::MakeInt32(GL_DEBUG_SEVERITY_NOTIFICATION, context->GetStackAllocator());
+
+    case GLModuleConstant::TGL_COLOR_BUFFER_BIT: return Value::MakeInt32(GL_COLOR_BUFFER_BIT, context->GetStackAllocator());
+    case GLModuleConstant::TGL_DEPTH_BUFFER_BIT: return Value::MakeInt32(GL_DEPTH_BUFFER_BIT, context->GetStackAllocator());
+    case GLModuleConstant::TGL_STENCIL_BUFFER_BIT: return Value::MakeInt32(GL_STENCIL_BUFFER_BIT, context->GetStackAllocator());
+
+    case GLModuleConstant::TGL_CW: return Value::MakeInt32(GL_CW, context->GetStackAllocator());
+    case GLModuleConstant::TGL_CCW: return Value::MakeInt32(GL_CCW, context->GetStackAllocator());
+
+    case GLModuleConstant::TGL_R8: return Value::MakeInt32(GL_R8, context->GetStackAllocator());
+    case GLModuleConstant::TGL_R16: return Value::MakeInt32(GL_R16, context->GetStackAllocator());
+    case GLModuleConstant::TGL_RG8: return Value::MakeInt32(GL_RG8, context->GetStackAllocator());
+    case GLModuleConstant::TGL_RG16: return Value::MakeInt32(GL_RG16, context->GetStackAllocator());
+    case GLModuleConstant::TGL_R16F: return Value::MakeInt32(GL_R16F, context->GetStackAllocator());
+    case GLModuleConstant::TGL_R32F: return Value::MakeInt32(GL_R32F, context->GetStackAllocator());
+    case GLModuleConstant::TGL_RG16F: return Value::MakeInt32(GL_RG16F, context->GetStackAllocator());
+    case GLModuleConstant::TGL_RG32F: return Value::MakeInt32(GL_RG32F, context->GetStackAllocator());
+    case GLModuleConstant::TGL_RGBA8: return Value::MakeInt32(GL_RGBA8, context->GetStackAllocator());
+    case GLModuleConstant::TGL_RGBA16: return Value::MakeInt32(GL_RGBA16, context->GetStackAllocator());
+    case GLModuleConstant::TGL_RGBA16F: return Value::MakeInt32(GL_RGBA16F, context->GetStackAllocator());
+    case GLModuleConstant::TGL_RGBA32F: return Value::MakeInt32(GL_RGBA32F, context->GetStackAllocator());
+    case GLModuleConstant::TGL_SRGB8_ALPHA8: return Value::MakeInt32(GL_SRGB8_ALPHA8, context->GetStackAllocator());
+    case GLModuleConstant::TGL_DEPTH_COMPONENT16: return Value::MakeInt32(GL_DEPTH_COMPONENT16, context->GetStackAllocator());
+    case GLModuleConstant::TGL_DEPTH_COMPONENT24: return Value::MakeInt32(GL_DEPTH_COMPONENT24, context->GetStackAllocator());
+    case GLModuleConstant::TGL_DEPTH_COMPONENT32F: return Value::MakeInt32(GL_DEPTH_COMPONENT32F, context->GetStackAllocator());
+    case GLModuleConstant::TGL_DEPTH24_STENCIL8: return Value::MakeInt32(GL_DEPTH24_STENCIL8, context->GetStackAllocator());
+    case GLModuleConstant::TGL_DEPTH32F_STENCIL8: return Value::MakeInt32(GL_DEPTH32F_STENCIL8, context->GetStackAllocator());
+
+    case GLModuleConstant::TGL_RGBA:    return Value::MakeInt32(GL_RGBA, context->GetStackAllocator());
+
+    case GLModuleConstant::TGL_TEXTURE0: return Value::MakeInt32(GL_TEXTURE0, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE1: return Value::MakeInt32(GL_TEXTURE1, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE2: return Value::MakeInt32(GL_TEXTURE2, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE3: return Value::MakeInt32(GL_TEXTURE3, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE4: return Value::MakeInt32(GL_TEXTURE4, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE5: return Value::MakeInt32(GL_TEXTURE5, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE6: return Value::MakeInt32(GL_TEXTURE6, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE7: return Value::MakeInt32(GL_TEXTURE7, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE8: return Value::MakeInt32(GL_TEXTURE8, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE9: return Value::MakeInt32(GL_TEXTURE9, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE10: return Value::MakeInt32(GL_TEXTURE10, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE11: return Value::MakeInt32(GL_TEXTURE11, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE12: return Value::MakeInt32(GL_TEXTURE12, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE13: return Value::MakeInt32(GL_TEXTURE13, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE14: return Value::MakeInt32(GL_TEXTURE14, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE15: return Value::MakeInt32(GL_TEXTURE15, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE16: return Value::MakeInt32(GL_TEXTURE16, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE17: return Value::MakeInt32(GL_TEXTURE17, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE18: return Value::MakeInt32(GL_TEXTURE18, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE19: return Value::MakeInt32(GL_TEXTURE19, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE20: return Value::MakeInt32(GL_TEXTURE20, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE21: return Value::MakeInt32(GL_TEXTURE21, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE22: return Value::MakeInt32(GL_TEXTURE22, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE23: return Value::MakeInt32(GL_TEXTURE23, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE24: return Value::MakeInt32(GL_TEXTURE24, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE25: return Value::MakeInt32(GL_TEXTURE25, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE26: return Value::MakeInt32(GL_TEXTURE26, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE27: return Value::MakeInt32(GL_TEXTURE27, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE28: return Value::MakeInt32(GL_TEXTURE28, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE29: return Value::MakeInt32(GL_TEXTURE29, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE30: return Value::MakeInt32(GL_TEXTURE30, context->GetStackAllocator());
+    case GLModuleConstant::TGL_TEXTURE31: return Value::MakeInt32(GL_TEXTURE31, context->GetStackAllocator());
     default:
-        return Value::MakeInt32(0, program->GetStackAllocator());
+        return Value::MakeInt32(0, context->GetStackAllocator());
     }
 }
 
 TypeInfo GLModule::GetFunctionReturnInfo(uint16 function)
 {
-    Program* program = Program::GetCompiledProgram();
     switch ((GLModuleFunction)function)
     {
     case GLModuleFunction::TGL_INIT: return { (uint16)ValueType::BOOL, 0 };
@@ -0,0 +1,27 @@
+#include "HostModule.h"
+#include "../ExecutionContext.h"
+
+bool HostModule::Init()
+{
+	return true;
+}
+
+Value HostModule::CallFunction(ExecutionContext* context, uint16 function, const std::vector<Value>& args)
+{
+	return context->GetProgram()->GetHostFunction(function).function(context, args);
+}
+
+Value HostModule::Constant(ExecutionContext* context, uint16 constant)
+{
+	return Value::MakeNULL();
+}
+
+TypeInfo HostModule::GetFunctionReturnInfo(Program* program, uint16 function)
+{
+	return program->GetHostFunction(function).returnInfo;
+}
+
+TypeInfo HostModule::GetConstantTypeInfo(uint16 constant)
+{
+	return TypeInfo(INVALID_ID, 0);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "../Value.h"
+#include "../TypeInfo.h"
+#include <vector>
+#include <string>
+
+enum class HostModuleConstant : uint16
+{
+
+};
+
+class ExecutionContext;
+class Program;
+
+// Registered by the embedding application, scripts call them as Host.<name>(...)
+typedef Value (*HostFunction)(ExecutionContext* context, const std::vector<Value>& args);
+
+struct HostFunctionInfo
+{
+	std::string name;
+	HostFunction function;
+	TypeInfo returnInfo;
+};
+
+class HostModule
+{
+public:
+	static bool Init();
+	static Value CallFunction(ExecutionContext* context, uint16 function, const std::vector<Value>& args);
+	static Value Constant(ExecutionContext* context, uint16 constant);
+
+	static TypeInfo GetFunctionReturnInfo(Program* program, uint16 function);
+	static TypeInfo GetConstantTypeInfo(uint16 constant);
+};
@@ -6,7 +6,7 @@ bool IOModule::Init()
 	return true;
 }
 
-Value IOModule::CallFunction(Program* program, uint16 function, const std::vector<Value>& args)
+Value IOModule::CallFunction(ExecutionContext* context, uint16 function, const std::vector<Value>& args)
 {
 	switch ((IOModuleFunction)function)
 	{
@@ -24,7 +24,7 @@ Value IOModule::CallFunction(Program* program, uint16 function, const std::vecto
 	return Value::MakeNULL();
 }
 
-Value IOModule::Constant(Program* program, uint16 constant)
+Value IOModule::Constant(ExecutionContext* context, uint16 constant)
 {
 	return Value::MakeNULL();
 }
@@ -15,13 +15,13 @@ enum class IOModuleFunction : uint16
 	PRINTLN,
 };
 
-class Program;
+class ExecutionContext;
 class IOModule
 {
 public:
 	static bool Init();
-	static Value CallFunction(Program* program, uint16 function, const std::vector<Value>& args);
-	static Value Constant(Program* program, uint16 constant);
+	static Value CallFunction(ExecutionContext* context, uint16 function, const std::vector<Value>& args);
+	static Value Constant(ExecutionContext* context, uint16 constant);
 
 	static TypeInfo GetFunctionReturnInfo(uint16 function);
 	static TypeInfo GetConstantTypeInfo(uint16 constant);
@@ -0,0 +1,130 @@
+#include "JobModule.h"
+#include "../ExecutionContext.h"
+#include "../JobSystem.h"
+#include "../Class.h"
+
+bool JobModule::Init()
+{
+	return true;
+}
+
+Value JobModule::CallFunction(ExecutionContext* context, uint16 function, const std::vector<Value>& args)
+{
+	switch ((JobModuleFunction)function)
+	{
+	case JobModuleFunction::SUBMIT: {
+		JobSystem* jobSystem = context->GetJobSystem();
+
+		Function* jobFunction = FindJobFunction(context, args[0], false);
+
+		JobGroup* group = new JobGroup();
+		group->remaining = 1;
+
+		Job job;
+		job.function = jobFunction;
+		job.begin = 0;
+		job.end = 1;
+		job.indexed = false;
+		job.group = group;
+
+		uint32 handle = jobSystem->CreateHandle(group);
+		jobSystem->Submit(context, job);
+		return Value::MakeUInt32(handle, context->GetStackAllocator());
+	} break;
+	case JobModuleFunction::WAIT: {
+		JobSystem* jobSystem = context->GetJobSystem();
+		uint32 handle = args[0].GetUInt32();
+		JobGroup* group = jobSystem->GetGroup(handle);
+		if (!group)
+			throw std::runtime_error("Job.Wait called with invalid handle " + std::to_string(handle));
+
+		jobSystem->Wait(context, group);
+		std::string error = group->error;
+		jobSystem->ReleaseHandle(handle);
+
+		if (!error.empty())
+			throw std::runtime_error("Job failed: " + error);
+	} break;
+	case JobModuleFunction::PARALLEL_FOR: {
+		JobSystem* jobSystem = context->GetJobSystem();
+		uint32 count = args[0].GetUInt32();
+		uint32 batchSize = std::max(args[1].GetUInt32(), 1u);
+		Function* jobFunction = FindJobFunction(context, args[2], true);
+
+		JobGroup group;
+		group.remaining = (count + batchSize - 1) / batchSize;
+
+		for (uint32 begin = 0; begin < count; begin += batchSize)
+		{
+			Job job;
+			job.function = jobFunction;
+			job.begin = begin;
+			job.end = std::min(begin + batchSize, count);
+			job.indexed = true;
+			job.group = &group;
+			jobSystem->Submit(context, job);
+		}
+
+		jobSystem->Wait(context, &group);
+		if (!group.error.empty())
+			throw std::runtime_error("Job failed: " + group.error);
+	} break;
+	case JobModuleFunction::WORKER_COUNT: {
+		return Value::MakeUInt32(context->GetJobSystem()->GetNumWorkers(), context->GetStackAllocator());
+	} break;
+	}
+
+	return Value::MakeNULL();
+}
+
+Value JobModule::Constant(ExecutionContext* context, uint16 constant)
+{
+	return Value::MakeNULL();
+}
+
+TypeInfo JobModule::GetFunctionReturnInfo(uint16 function)
+{
+	switch ((JobModuleFunction)function)
+	{
+	case JobModuleFunction::SUBMIT: return TypeInfo((uint16)ValueType::UINT32, 0);
+	case JobModuleFunction::WORKER_COUNT: return TypeInfo((uint16)ValueType::UINT32, 0);
+	}
+
+	return TypeInfo((uint16)ValueType::VOID_T, 0);
+}
+
+TypeInfo JobModule::GetConstantTypeInfo(uint16 constant)
+{
+	return TypeInfo(INVALID_ID, 0);
+}
+
+Function* JobModule::FindJobFunction(ExecutionContext* context, const Value& functionValue, bool indexed)
+{
+	if (!functionValue.IsPointer())
+	{
+		Function* function = context->GetProgram()->GetFunctionFromReference(functionValue.GetUInt32());
+		if (!function)
+			throw std::runtime_error("Invalid job function reference");
+
+		bool takesIndex = function->parameters.size() == 1 && function->parameters[0].type.type == (uint16)ValueType::UINT32 &&
+			function->parameters[0].type.pointerLevel == 0;
+		if (!function->isStatic || (indexed ? !takesIndex : !function->parameters.empty()))
+			throw std::runtime_error("Job function " + function->name + " has to be a static function taking " + (indexed ? "(uint32 index)" : "no arguments"));
+
+		return function;
+	}
+
+	std::string name = functionValue.GetString();
+	size_t dotPos = name.find('.');
+	Class* cls = dotPos != std::string::npos ? context->GetProgram()->GetClassByName(name.substr(0, dotPos)) : nullptr;
+	if (!cls)
+		throw std::runtime_error("Job function " + name + " has to be given as Class.Function");
+
+	// ParallelFor passes the index, Submit passes nothing
+	std::string signature = name.substr(dotPos + 1) + (indexed ? "-uint32" : "-");
+	Function* function = cls->FindFunctionBySignature(signature, context->GetProgram());
+	if (!function || !function->isStatic)
+		throw std::runtime_error("Job function " + name + " has to be a static function taking " + (indexed ? "(uint32 index)" : "no arguments"));
+
+	return function;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "../Value.h"
+#include "../TypeInfo.h"
+#include <vector>
+
+enum class JobModuleConstant : uint16
+{
+
+};
+
+enum class JobModuleFunction : uint16
+{
+	SUBMIT, WAIT, PARALLEL_FOR, WORKER_COUNT
+};
+
+class ExecutionContext;
+struct Function;
+class JobModule
+{
+public:
+	static bool Init();
+	static Value CallFunction(ExecutionContext* context, uint16 function, const std::vector<Value>& args);
+	static Value Constant(ExecutionContext* context, uint16 constant);
+
+	static TypeInfo GetFunctionReturnInfo(uint16 function);
+	static TypeInfo GetConstantTypeInfo(uint16 constant);
+private:
+	// Jobs name their function as "Class.Function" or pass &Class.Function, it has to be static
+	static Function* FindJobFunction(ExecutionContext* context, const Value& function, bool indexed);
+};
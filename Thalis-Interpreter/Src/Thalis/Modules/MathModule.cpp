@@ -1,5 +1,5 @@
 #include "MathModule.h"
-#include "../Program.h"
+#include "../ExecutionContext.h"
 
 #define MATH_PI 3.141592653589793
 #define MATH_E 2.718281828459045
@@ -13,66 +13,148 @@ static real64 LogBase(real64 x, real64 base)
     return std::log(x) / std::log(base);
 }
 
+#define MATH_NATIVE_REAL64(Name, Expr) static void Name(const NativeValue* args, NativeValue* result) { result->f64 = (Expr); }
+
+MATH_NATIVE_REAL64(NativeCos, cos(args[0].f64))
+MATH_NATIVE_REAL64(NativeSin, sin(args[0].f64))
+MATH_NATIVE_REAL64(NativeTan, tan(args[0].f64))
+MATH_NATIVE_REAL64(NativeACos, acos(args[0].f64))
+MATH_NATIVE_REAL64(NativeASin, asin(args[0].f64))
+MATH_NATIVE_REAL64(NativeATan, atan(args[0].f64))
+MATH_NATIVE_REAL64(NativeATan2, atan2(args[0].f64, args[1].f64))
+MATH_NATIVE_REAL64(NativeCosh, cosh(args[0].f64))
+MATH_NATIVE_REAL64(NativeSinh, sinh(args[0].f64))
+MATH_NATIVE_REAL64(NativeTanh, tanh(args[0].f64))
+MATH_NATIVE_REAL64(NativeACosh, acosh(args[0].f64))
+MATH_NATIVE_REAL64(NativeASinh, asinh(args[0].f64))
+MATH_NATIVE_REAL64(NativeATanh, atanh(args[0].f64))
+MATH_NATIVE_REAL64(NativeDegToRad, args[0].f64 * (MATH_PI / 180.0))
+MATH_NATIVE_REAL64(NativeRadToDeg, args[0].f64 * (180.0 / MATH_PI))
+MATH_NATIVE_REAL64(NativeFloor, floor(args[0].f64))
+MATH_NATIVE_REAL64(NativeCeil, ceil(args[0].f64))
+MATH_NATIVE_REAL64(NativeRound, round(args[0].f64))
+MATH_NATIVE_REAL64(NativeMin, fmin(args[0].f64, args[1].f64))
+MATH_NATIVE_REAL64(NativeMax, fmax(args[0].f64, args[1].f64))
+MATH_NATIVE_REAL64(NativeClamp, MATH_CLAMP(args[0].f64, args[1].f64, args[2].f64))
+MATH_NATIVE_REAL64(NativeLerp, MATH_LERP(args[0].f64, args[1].f64, args[2].f64))
+MATH_NATIVE_REAL64(NativeAbs, abs(args[0].f64))
+MATH_NATIVE_REAL64(NativeSqrt, sqrt(args[0].f64))
+MATH_NATIVE_REAL64(NativePow, pow(args[0].f64, args[1].f64))
+MATH_NATIVE_REAL64(NativeExp, exp(args[0].f64))
+MATH_NATIVE_REAL64(NativeLog, log(args[0].f64))
+MATH_NATIVE_REAL64(NativeLog10, log10(args[0].f64))
+MATH_NATIVE_REAL64(NativeLog2, log2(args[0].f64))
+MATH_NATIVE_REAL64(NativeMod, fmod(args[0].f64, args[1].f64))
+
+static void NativeModf(const NativeValue* args, NativeValue* result)
+{
+    result->f32 = fmodf(args[0].f32, args[1].f32);
+}
+
+#define R64 NativeType::REAL64
+#define R32 NativeType::REAL32
+
+// Indexed by MathModuleFunction. Log with a base takes two arguments and goes through CallFunction.
+static const NativeFunctionDesc s_NativeFunctions[] =
+{
+    { "Cos", NativeCos, R64, 1, { R64 } },
+    { "Sin", NativeSin, R64, 1, { R64 } },
+    { "Tan", NativeTan, R64, 1, { R64 } },
+    { "ACos", NativeACos, R64, 1, { R64 } },
+    { "ASin", NativeASin, R64, 1, { R64 } },
+    { "ATan", NativeATan, R64, 1, { R64 } },
+    { "ATan2", NativeATan2, R64, 2, { R64, R64 } },
+    { "Cosh", NativeCosh, R64, 1, { R64 } },
+    { "Sinh", NativeSinh, R64, 1, { R64 } },
+    { "Tanh", NativeTanh, R64, 1, { R64 } },
+    { "ACosh", NativeACosh, R64, 1, { R64 } },
+    { "ASinh", NativeASinh, R64, 1, { R64 } },
+    { "ATanh", NativeATanh, R64, 1, { R64 } },
+    { "DegToRad", NativeDegToRad, R64, 1, { R64 } },
+    { "RadToDeg", NativeRadToDeg, R64, 1, { R64 } },
+    { "Floor", NativeFloor, R64, 1, { R64 } },
+    { "Ceil", NativeCeil, R64, 1, { R64 } },
+    { "Round", NativeRound, R64, 1, { R64 } },
+    { "Min", NativeMin, R64, 2, { R64, R64 } },
+    { "Max", NativeMax, R64, 2, { R64, R64 } },
+    { "Clamp", NativeClamp, R64, 3, { R64, R64, R64 } },
+    { "Lerp", NativeLerp, R64, 3, { R64, R64, R64 } },
+    { "Abs", NativeAbs, R64, 1, { R64 } },
+    { "Sqrt", NativeSqrt, R64, 1, { R64 } },
+    { "Pow", NativePow, R64, 2, { R64, R64 } },
+    { "Exp", NativeExp, R64, 1, { R64 } },
+    { "Log", NativeLog, R64, 1, { R64 } },
+    { "Log10", NativeLog10, R64, 1, { R64 } },
+    { "Log2", NativeLog2, R64, 1, { R64 } },
+    { "Modf", NativeModf, R32, 2, { R32, R32 } },
+    { "Mod", NativeMod, R64, 2, { R64, R64 } },
+};
+
+#undef R64
+#undef R32
+
+static_assert(sizeof(s_NativeFunctions) / sizeof(s_NativeFunctions[0]) == (uint32)MathModuleFunction::MOD + 1, "Every MathModuleFunction needs a native entry");
+
 bool MathModule::Init()
 {
     return true;
 }
 
-Value MathModule::CallFunction(Program* program, uint16 function, const std::vector<Value>& args)
+Value MathModule::CallFunction(ExecutionContext* context, uint16 function, const std::vector<Value>& args)
 {
     switch ((MathModuleFunction)function)
     {
-    case MathModuleFunction::COS: return Value::MakeReal64(cos(args[0].GetReal64()), program->GetStackAllocator());
-    case MathModuleFunction::SIN: return Value::MakeReal64(sin(args[0].GetReal64()), program->GetStackAllocator());
-    case MathModuleFunction::TAN: return Value::MakeReal64(tan(args[0].GetReal64()), program->GetStackAllocator());
-
-    case MathModuleFunction::ACOS: return Value::MakeReal64(acos(args[0].GetReal64()), program->GetStackAllocator());
-    case MathModuleFunction::ASIN: return Value::MakeReal64(asin(args[0].GetReal64()), program->GetStackAllocator());
-    case MathModuleFunction::ATAN: return Value::MakeReal64(atan(args[0].GetReal64()), program->GetStackAllocator());
-    case MathModuleFunction::ATAN2: return Value::MakeReal64(atan2(args[0].GetReal64(), args[1].GetReal64()), program->GetStackAllocator());
-
-    case MathModuleFunction::COSH: return Value::MakeReal64(cosh(args[0].GetReal64()), program->GetStackAllocator());
-    case MathModuleFunction::SINH: return Value::MakeReal64(sinh(args[0].GetReal64()), program->GetStackAllocator());
-    case MathModuleFunction::TANH: return Value::MakeReal64(tanh(args[0].GetReal64()), program->GetStackAllocator());
-
-    case MathModuleFunction::ACOSH: return Value::MakeReal64(acosh(args[0].GetReal64()), program->GetStackAllocator());
-    case MathModuleFunction::ASINH: return Value::MakeReal64(asinh(args[0].GetReal64()), program->GetStackAllocator());
-    case MathModuleFunction::ATANH: return Value::MakeReal64(atanh(args[0].GetReal64()), program->GetStackAllocator());
-
-    case MathModuleFunction::DEGTORAD: return Value::MakeReal64(args[0].GetReal64() * (MATH_PI / 180.0), program->GetStackAllocator());
-    case MathModuleFunction::RADTODEG: return Value::MakeReal64(args[0].GetReal64() * (180.0 / MATH_PI), program->GetStackAllocator());
-
-    case MathModuleFunction::FLOOR: return Value::MakeReal64(floor(args[0].GetReal64()), program->GetStackAllocator());
-    case MathModuleFunction::CEIL: return Value::MakeReal64(ceil(args[0].GetReal64()), program->GetStackAllocator());
-    case MathModuleFunction::ROUND: return Value::MakeReal64(round(args[0].GetReal64()), program->GetStackAllocator());
-
-    case MathModuleFunction::MIN: return Value::MakeReal64(fmin(args[0].GetReal64(), args[1].GetReal64()), program->GetStackAllocator());
-    case MathModuleFunction::MAX: return Value::MakeReal64(fmax(args[0].GetReal64(), args[1].GetReal64()), program->GetStackAllocator());
-    case MathModuleFunction::CLAMP: return Value::MakeReal64(MATH_CLAMP(args[0].GetReal64(), args[1].GetReal64(), args[2].GetReal64()), program->GetStackAllocator());
-    case MathModuleFunction::LERP: return Value::MakeReal64(MATH_LERP(args[0].GetReal64(), args[1].GetReal64(), args[2].GetReal64()), program->GetStackAllocator());
-
-    case MathModuleFunction::ABS: return Value::MakeReal64(abs(args[0].GetReal64()), program->GetStackAllocator());
-    case MathModuleFunction::SQRT: return Value::MakeReal64(sqrt(args[0].GetReal64()), program->GetStackAllocator());
-    case MathModuleFunction::POW: return Value::MakeReal64(pow(args[0].GetReal64(), args[1].GetReal64()), program->GetStackAllocator());
-    case MathModuleFunction::EXP: return Value::MakeReal64(exp(args[0].GetReal64()), program->GetStackAllocator());
-    case MathModuleFunction::LOG: return  args.size() == 1 ? Value::MakeReal64(log(args[0].GetReal64()), program->GetStackAllocator()) : Value::MakeReal64(LogBase(args[0].GetReal64(), args[1].GetReal64()), program->GetStackAllocator());
-    case MathModuleFunction::LOG10: return Value::MakeReal64(log10(args[0].GetReal64()), program->GetStackAllocator());
-    case MathModuleFunction::LOG2: return Value::MakeReal64(log2(args[0].GetReal64()), program->GetStackAllocator());
-
-    case MathModuleFunction::MOD: return Value::MakeReal64(fmod(args[0].GetReal64(), args[1].GetReal64()), program->GetStackAllocator());
-    case MathModuleFunction::MODF: return Value::MakeReal32(fmodf(args[0].GetReal32(), args[1].GetReal32()), program->GetStackAllocator());
+    case MathModuleFunction::COS: return Value::MakeReal64(cos(args[0].GetReal64()), context->GetStackAllocator());
+    case MathModuleFunction::SIN: return Value::MakeReal64(sin(args[0].GetReal64()), context->GetStackAllocator());
+    case MathModuleFunction::TAN: return Value::MakeReal64(tan(args[0].GetReal64()), context->GetStackAllocator());
+
+    case MathModuleFunction::ACOS: return Value::MakeReal64(acos(args[0].GetReal64()), context->GetStackAllocator());
+    case MathModuleFunction::ASIN: return Value::MakeReal64(asin(args[0].GetReal64()), context->GetStackAllocator());
+    case MathModuleFunction::ATAN: return Value::MakeReal64(atan(args[0].GetReal64()), context->GetStackAllocator());
+    case MathModuleFunction::ATAN2: return Value::MakeReal64(atan2(args[0].GetReal64(), args[1].GetReal64()), context->GetStackAllocator());
+
+    case MathModuleFunction::COSH: return Value::MakeReal64(cosh(args[0].GetReal64()), context->GetStackAllocator());
+    case MathModuleFunction::SINH: return Value::MakeReal64(sinh(args[0].GetReal64()), context->GetStackAllocator());
+    case MathModuleFunction::TANH: return Value::MakeReal64(tanh(args[0].GetReal64()), context->GetStackAllocator());
+
+    case MathModuleFunction::ACOSH: return Value::MakeReal64(acosh(args[0].GetReal64()), context->GetStackAllocator());
+    case MathModuleFunction::ASINH: return Value::MakeReal64(asinh(args[0].GetReal64()), context->GetStackAllocator());
+    case MathModuleFunction::ATANH: return Value::MakeReal64(atanh(args[0].GetReal64()), context->GetStackAllocator());
+
+    case MathModuleFunction::DEGTORAD: return Value::MakeReal64(args[0].GetReal64() * (MATH_PI / 180.0), context->GetStackAllocator());
+    case MathModuleFunction::RADTODEG: return Value::MakeReal64(args[0].GetReal64() * (180.0 / MATH_PI), context->GetStackAllocator());
+
+    case MathModuleFunction::FLOOR: return Value::MakeReal64(floor(args[0].GetReal64()), context->GetStackAllocator());
+    case MathModuleFunction::CEIL: return Value::MakeReal64(ceil(args[0].GetReal64()), context->GetStackAllocator());
+    case MathModuleFunction::ROUND: return Value::MakeReal64(round(args[0].GetReal64()), context->GetStackAllocator());
+
+    case MathModuleFunction::MIN: return Value::MakeReal64(fmin(args[0].GetReal64(), args[1].GetReal64()), context->GetStackAllocator());
+    case MathModuleFunction::MAX: return Value::MakeReal64(fmax(args[0].GetReal64(), args[1].GetReal64()), context->GetStackAllocator());
+    case MathModuleFunction::CLAMP: return Value::MakeReal64(MATH_CLAMP(args[0].GetReal64(), args[1].GetReal64(), args[2].GetReal64()), context->GetStackAllocator());
+    case MathModuleFunction::LERP: return Value::MakeReal64(MATH_LERP(args[0].GetReal64(), args[1].GetReal64(), args[2].GetReal64()), context->GetStackAllocator());
+
+    case MathModuleFunction::ABS: return Value::MakeReal64(abs(args[0].GetReal64()), context->GetStackAllocator());
+    case MathModuleFunction::SQRT: return Value::MakeReal64(sqrt(args[0].GetReal64()), context->GetStackAllocator());
+    case MathModuleFunction::POW: return Value::MakeReal64(pow(args[0].GetReal64(), args[1].GetReal64()), context->GetStackAllocator());
+    case MathModuleFunction::EXP: return Value::MakeReal64(exp(args[0].GetReal64()), context->GetStackAllocator());
+    case MathModuleFunction::LOG: return  args.size() == 1 ? Value::MakeReal64(log(args[0].GetReal64()), context->GetStackAllocator()) : Value::MakeReal64(LogBase(args[0].GetReal64(), args[1].GetReal64()), context->GetStackAllocator());
+    case MathModuleFunction::LOG10: return Value::MakeReal64(log10(args[0].GetReal64()), context->GetStackAllocator());
+    case MathModuleFunction::LOG2: return Value::MakeReal64(log2(args[0].GetReal64()), context->GetStackAllocator());
+
+    case MathModuleFunction::MOD: return Value::MakeReal64(fmod(args[0].GetReal64(), args[1].GetReal64()), context->GetStackAllocator());
+    case MathModuleFunction::MODF: return Value::MakeReal32(fmodf(args[0].GetReal32(), args[1].GetReal32()), context->GetStackAllocator());
     default:
         throw std::runtime_error("Invalid MathModule Function");
     }
 }
 
-Value MathModule::Constant(Program* program, uint16 constant)
+Value MathModule::Constant(ExecutionContext* context, uint16 constant)
 {
     switch ((MathModuleConstant)constant)
     {
-    case MathModuleConstant::PI: return Value::MakeReal64(MATH_PI, program->GetStackAllocator());
-    case MathModuleConstant::E: return Value::MakeReal64(MATH_E, program->GetStackAllocator());;
-    case MathModuleConstant::TAU: return Value::MakeReal64(MATH_TAU, program->GetStackAllocator());;
+    case MathModuleConstant::PI: return Value::MakeReal64(MATH_PI, context->GetStackAllocator());
+    case MathModuleConstant::E: return Value::MakeReal64(MATH_E, context->GetStackAllocator());;
+    case MathModuleConstant::TAU: return Value::MakeReal64(MATH_TAU, context->GetStackAllocator());;
     }
 
     return Value::MakeNULL();
@@ -117,7 +199,9 @@ TypeInfo MathModule::GetFunctionReturnInfo(uint16 function)
     case MathModuleFunction::EXP:
     case MathModuleFunction::LOG:
     case MathModuleFunction::LOG10:
-    case MathModuleFunction::LOG2:  return { (uint16)ValueType::REAL64, 0 };
+    case MathModuleFunction::LOG2:
+    case MathModuleFunction::MOD:  return { (uint16)ValueType::REAL64, 0 };
+    case MathModuleFunction::MODF: return { (uint16)ValueType::REAL32, 0 };
     default:
         throw std::runtime_error("Invalid MathModule Function");
     }
@@ -133,4 +217,9 @@ TypeInfo MathModule::GetConstantTypeInfo(uint16 constant)
     }
 
     return TypeInfo(INVALID_ID, 0);
+}
+
+const NativeFunctionDesc* MathModule::GetNativeFunction(uint16 function)
+{
+    return &s_NativeFunctions[function];
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "../TypeInfo.h"
 #include "../Value.h"
+#include "../NativeFunction.h"
 #include <vector>
 
 enum class MathModuleConstant
@@ -20,14 +21,16 @@ enum class MathModuleFunction //TODO: Add random
 	MODF, MOD,
 };
 
-class Program;
+class ExecutionContext;
 class MathModule
 {
 public:
 	static bool Init();
-	static Value CallFunction(Program* program, uint16 function, const std::vector<Value>& args);
-	static Value Constant(Program* program, uint16 constant);
+	static Value CallFunction(ExecutionContext* context, uint16 function, const std::vector<Value>& args);
+	static Value Constant(ExecutionContext* context, uint16 constant);
 
 	static TypeInfo GetFunctionReturnInfo(uint16 function);
 	static TypeInfo GetConstantTypeInfo(uint16 constant);
+
+	static const NativeFunctionDesc* GetNativeFunction(uint16 function);
 };
\ No newline at end of file
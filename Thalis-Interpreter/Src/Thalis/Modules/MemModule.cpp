@@ -1,13 +1,15 @@
 #include "MemModule.h"
-#include "../Program.h"
+#include "../ExecutionContext.h"
+#include <algorithm>
 
 bool MemModule::Init()
 {
 	return true;
 }
 
-Value MemModule::CallFunction(Program* program, uint16 function, const std::vector<Value>& args)
+Value MemModule::CallFunction(ExecutionContext* context, uint16 function, const std::vector<Value>& args)
 {
+	MemModuleState* state = context->GetMemModuleState();
 	switch ((MemModuleFunction)function)
 	{
 	case MemModuleFunction::COPY: {
@@ -20,12 +22,12 @@ Value MemModule::CallFunction(Program* program, uint16 function, const std::vect
 	} break;
 	case MemModuleFunction::ALLOC: {
 		uint64 size = args[0].GetUInt64();
-		void* data = program->GetHeapAllocator()->Alloc(size);
-		return Value::MakePointer((uint16)ValueType::VOID_T, 1, data, program->GetStackAllocator());
+		void* data = context->GetHeapAllocator()->Alloc(size);
+		return Value::MakePointer((uint16)ValueType::VOID_T, 1, data, context->GetStackAllocator());
 	} break;
 	case MemModuleFunction::FREE: {
 		void* data = *(void**)args[0].data;
-		program->GetHeapAllocator()->Free(data);
+		context->GetHeapAllocator()->Free(data);
 		return Value::MakeNULL();
 	} break;
 	case MemModuleFunction::SET: {
@@ -35,22 +37,140 @@ Value MemModule::CallFunction(Program* program, uint16 function, const std::vect
 		memset(data, value, size);
 		return Value::MakeNULL();
 	} break;
+	case MemModuleFunction::ARENA_CREATE: {
+		uint64 size = args[0].GetUInt64();
+		BumpAllocator* arena = new BumpAllocator(size);
+
+		uint32 arenaID;
+		if (!state->freeArenaIDs.empty())
+		{
+			arenaID = state->freeArenaIDs.back();
+			state->freeArenaIDs.pop_back();
+			state->arenas[arenaID - 1] = arena;
+		}
+		else
+		{
+			state->arenas.push_back(arena);
+			arenaID = state->arenas.size();
+		}
+
+		return Value::MakeUInt32(arenaID, context->GetStackAllocator());
+	} break;
+	case MemModuleFunction::ARENA_ALLOC: {
+		BumpAllocator* arena = GetArena(context, args[0].GetUInt32());
+		uint64 size = args[1].GetUInt64();
+		uint64 alignment = args[2].GetUInt64();
+		if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+			throw std::runtime_error("Mem.ArenaAlloc needs a power of two alignment, got " + std::to_string(alignment));
+
+		void* data = arena ? arena->AllocAligned(size, alignment) : nullptr;
+		return Value::MakePointer((uint16)ValueType::VOID_T, 1, data, context->GetStackAllocator());
+	} break;
+	case MemModuleFunction::ARENA_RESET: {
+		BumpAllocator* arena = GetArena(context, args[0].GetUInt32());
+		if (arena)
+			arena->Free();
+		return Value::MakeNULL();
+	} break;
+	case MemModuleFunction::ARENA_DESTROY: {
+		uint32 arenaID = args[0].GetUInt32();
+		BumpAllocator* arena = GetArena(context, arenaID);
+		if (arena)
+		{
+			arena->Destroy();
+			delete arena;
+			state->arenas[arenaID - 1] = nullptr;
+			state->freeArenaIDs.push_back(arenaID);
+		}
+		return Value::MakeNULL();
+	} break;
+	case MemModuleFunction::SORT: {
+		uint8* data = *(uint8**)args[0].data;
+		uint64 count = args[1].GetUInt64();
+		uint64 size = args[2].GetUInt64();
+		Sort(context, data, count, size, args[3].GetUInt32());
+		return Value::MakeNULL();
+	} break;
 	}
 
 	return Value::MakeNULL();
 }
 
-Value MemModule::Constant(Program* program, uint16 constant)
+Value MemModule::Constant(ExecutionContext* context, uint16 constant)
 {
 	return Value::MakeNULL();
 }
 
 TypeInfo MemModule::GetFunctionReturnInfo(uint16 function)
 {
+	switch ((MemModuleFunction)function)
+	{
+	case MemModuleFunction::ARENA_CREATE: return TypeInfo((uint16)ValueType::UINT32, 0);
+	case MemModuleFunction::ARENA_ALLOC: return TypeInfo((uint16)ValueType::VOID_T, 1);
+	}
+
 	return TypeInfo((uint16)ValueType::VOID_T, 0);
 }
 
 TypeInfo MemModule::GetConstantTypeInfo(uint16 constant)
 {
 	return TypeInfo(INVALID_ID, 0);
+}
+
+BumpAllocator* MemModule::GetArena(ExecutionContext* context, uint32 arenaID)
+{
+	const MemModuleState* state = context->GetMemModuleState();
+	if (arenaID == 0 || arenaID > state->arenas.size())
+		return nullptr;
+
+	return state->arenas[arenaID - 1];
+}
+
+void MemModule::DestroyArenas(ExecutionContext* context)
+{
+	MemModuleState* state = context->GetMemModuleState();
+	for (uint32 i = 0; i < state->arenas.size(); i++)
+	{
+		if (state->arenas[i])
+		{
+			state->arenas[i]->Destroy();
+			delete state->arenas[i];
+		}
+	}
+
+	state->arenas.clear();
+	state->freeArenaIDs.clear();
+}
+
+void MemModule::Sort(ExecutionContext* context, uint8* data, uint64 count, uint64 size, uint32 less)
+{
+	Function* function = context->GetProgram()->GetFunctionFromReference(less);
+	if (!function || !function->isStatic || function->parameters.size() != 2 || function->parameters[0].type.pointerLevel == 0)
+		throw std::runtime_error("Mem.Sort needs &Class.Function of a static function taking two element pointers");
+
+	// The comparator sorts an index permutation, elements are moved once at the end.
+	// stable_sort stays in bounds even if the script's ordering is inconsistent.
+	TypeInfo elementType = function->parameters[0].type;
+	SegmentedBumpAllocator* allocator = context->GetStackAllocator();
+	std::vector<Value> compareArgs(2);
+
+	std::vector<uint64> order(count);
+	for (uint64 i = 0; i < count; i++)
+		order[i] = i;
+
+	std::stable_sort(order.begin(), order.end(), [&](uint64 a, uint64 b)
+	{
+		uint64 marker = allocator->GetMarker();
+		compareArgs[0] = Value::MakePointer(elementType.type, elementType.pointerLevel, data + a * size, allocator);
+		compareArgs[1] = Value::MakePointer(elementType.type, elementType.pointerLevel, data + b * size, allocator);
+		bool result = context->CallFunction(function, compareArgs).GetBool();
+		allocator->FreeToMarker(marker);
+		return result;
+	});
+
+	std::vector<uint8> sorted(count * size);
+	for (uint64 i = 0; i < count; i++)
+		memcpy(&sorted[i * size], data + order[i] * size, size);
+
+	memcpy(data, sorted.data(), count * size);
 }
\ No newline at end of file
@@ -11,17 +11,34 @@ enum class MemModuleConstant : uint16
 
 enum class MemModuleFunction : uint16
 {
-	COPY, ALLOC, FREE, SET
+	COPY, ALLOC, FREE, SET,
+	ARENA_CREATE, ARENA_ALLOC, ARENA_RESET, ARENA_DESTROY,
+	SORT
 };
 
-class Program;
+class BumpAllocator;
+
+// Arenas are handed to scripts as IDs, 0 is never a valid arena
+struct MemModuleState
+{
+	std::vector<BumpAllocator*> arenas;
+	std::vector<uint32> freeArenaIDs;
+};
+
+class ExecutionContext;
 class MemModule
 {
 public:
 	static bool Init();
-	static Value CallFunction(Program* program, uint16 function, const std::vector<Value>& args);
-	static Value Constant(Program* program, uint16 constant);
+	static Value CallFunction(ExecutionContext* context, uint16 function, const std::vector<Value>& args);
+	static Value Constant(ExecutionContext* context, uint16 constant);
 
 	static TypeInfo GetFunctionReturnInfo(uint16 function);
 	static TypeInfo GetConstantTypeInfo(uint16 constant);
+
+	static BumpAllocator* GetArena(ExecutionContext* context, uint32 arenaID);
+	static void DestroyArenas(ExecutionContext* context);
+private:
+	// Orders count elements of size bytes with a script function Less(T* a, T* b) passed as &Class.Function
+	static void Sort(ExecutionContext* context, uint8* data, uint64 count, uint64 size, uint32 less);
 };
@@ -6,8 +6,15 @@
 #include "FSModule.h"
 #include "MemModule.h"
 #include "TimeModule.h"
+#include "JobModule.h"
+#include "ChanModule.h"
+#include "HostModule.h"
+#include "CoModule.h"
+#include "SchedModule.h"
+#include "../PluginModule.h"
+#include "../Program.h"
 
-TypeInfo Module::GetFunctionReturnInfo(uint16 moduleID, uint16 function)
+TypeInfo Module::GetFunctionReturnInfo(Program* program, uint16 moduleID, uint16 function)
 {
     switch (moduleID)
     {
@@ -18,10 +25,16 @@ TypeInfo Module::GetFunctionReturnInfo(uint16 moduleID, uint16 function)
     case FS_MODULE_ID: return FSModule::GetFunctionReturnInfo(function);
     case MEM_MODULE_ID: return MemModule::GetFunctionReturnInfo(function);
     case TIME_MODULE_ID: return TimeModule::GetFunctionReturnInfo(function);
+    case JOB_MODULE_ID: return JobModule::GetFunctionReturnInfo(function);
+    case CHAN_MODULE_ID: return ChanModule::GetFunctionReturnInfo(function);
+    case HOST_MODULE_ID: return HostModule::GetFunctionReturnInfo(program, function);
+    case CO_MODULE_ID: return CoModule::GetFunctionReturnInfo(function);
+    case SCHED_MODULE_ID: return SchedModule::GetFunctionReturnInfo(function);
+    default: return program->GetPlugin(moduleID)->GetFunctionReturnInfo(function);
     }
 }
 
-TypeInfo Module::GetConstantTypeInfo(uint16 moduleID, uint16 constant)
+TypeInfo Module::GetConstantTypeInfo(Program* program, uint16 moduleID, uint16 constant)
 {
     switch (moduleID)
     {
@@ -32,5 +45,24 @@ TypeInfo Module::GetConstantTypeInfo(uint16 moduleID, uint16 constant)
     case FS_MODULE_ID: return FSModule::GetConstantTypeInfo(constant);
     case MEM_MODULE_ID: return MemModule::GetConstantTypeInfo(constant);
     case TIME_MODULE_ID: return TimeModule::GetConstantTypeInfo(constant);
+    case JOB_MODULE_ID: return JobModule::GetConstantTypeInfo(constant);
+    case CHAN_MODULE_ID: return ChanModule::GetConstantTypeInfo(constant);
+    case HOST_MODULE_ID: return HostModule::GetConstantTypeInfo(constant);
+    case CO_MODULE_ID: return CoModule::GetConstantTypeInfo(constant);
+    case SCHED_MODULE_ID: return SchedModule::GetConstantTypeInfo(constant);
+    default: return program->GetPlugin(moduleID)->GetConstantTypeInfo(constant);
     }
 }
+
+const NativeFunctionDesc* Module::GetNativeFunction(Program* program, uint16 moduleID, uint16 function)
+{
+    if (moduleID >= PLUGIN_MODULE_ID_BASE)
+        return program->GetPlugin(moduleID)->GetFunctionDesc(function);
+
+    switch (moduleID)
+    {
+    case MATH_MODULE_ID: return MathModule::GetNativeFunction(function);
+    }
+
+    return nullptr;
+}
\ No newline at end of file
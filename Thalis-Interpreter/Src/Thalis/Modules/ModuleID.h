@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../TypeInfo.h"
+#include "../NativeFunction.h"
 
 #define IO_MODULE_ID		0
 #define MATH_MODULE_ID		1
@@ -9,10 +10,22 @@
 #define FS_MODULE_ID		4
 #define MEM_MODULE_ID		5
 #define TIME_MODULE_ID		6
+#define JOB_MODULE_ID		7
+#define CHAN_MODULE_ID		8
+#define HOST_MODULE_ID		9
+#define CO_MODULE_ID		10
+#define SCHED_MODULE_ID		11
 
+// Native plug-ins are numbered from here on in the order they were imported
+#define PLUGIN_MODULE_ID_BASE	64
+
+class Program;
 class Module
 {
 public:
-	static TypeInfo GetFunctionReturnInfo(uint16 moduleID, uint16 function);
-	static TypeInfo GetConstantTypeInfo(uint16 moduleID, uint16 constant);
+	static TypeInfo GetFunctionReturnInfo(Program* program, uint16 moduleID, uint16 function);
+	static TypeInfo GetConstantTypeInfo(Program* program, uint16 moduleID, uint16 constant);
+
+	// Functions with a fixed signature are emitted as NATIVE_CALL, nullptr if it has to go through the module
+	static const NativeFunctionDesc* GetNativeFunction(Program* program, uint16 moduleID, uint16 function);
 };
\ No newline at end of file
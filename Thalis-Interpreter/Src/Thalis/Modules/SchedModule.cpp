@@ -0,0 +1,234 @@
+#include "SchedModule.h"
+#include "../ExecutionContext.h"
+#include <algorithm>
+#include <thread>
+
+#if defined(_WIN32)
+#include <windows.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+
+bool SchedModule::Init()
+{
+#if defined(_WIN32)
+	// Sleeps are rounded up to the system tick otherwise, which is 15.6ms by default
+	timeBeginPeriod(1);
+#endif
+	return true;
+}
+
+Value SchedModule::CallFunction(ExecutionContext* context, uint16 function, const std::vector<Value>& args)
+{
+	SchedModuleState* state = context->GetSchedModuleState();
+	switch ((SchedModuleFunction)function)
+	{
+	case SchedModuleFunction::AFTER: {
+		uint32 handle = AddTimer(context, args, args[0].GetReal64(), false);
+		return Value::MakeUInt32(handle, context->GetStackAllocator());
+	} break;
+	case SchedModuleFunction::EVERY: {
+		uint32 handle = AddTimer(context, args, args[0].GetReal64(), true);
+		return Value::MakeUInt32(handle, context->GetStackAllocator());
+	} break;
+	case SchedModuleFunction::CANCEL: {
+		uint32 handle = args[0].GetUInt32();
+		bool pending = state->scheduler.IsScheduled(handle);
+		if (pending)
+			state->scheduler.Release(handle);
+
+		return Value::MakeBool(pending, context->GetStackAllocator());
+	} break;
+	case SchedModuleFunction::UPDATE: {
+		uint32 fired = state->scheduler.Update(context, args[0].GetReal64(), FireTimer);
+		return Value::MakeUInt32(fired, context->GetStackAllocator());
+	} break;
+	case SchedModuleFunction::TIME: {
+		return Value::MakeReal64(state->scheduler.GetTime(), context->GetStackAllocator());
+	} break;
+	case SchedModuleFunction::SET_TARGET_RATE: {
+		real64 rate = args[0].GetReal64();
+		state->targetFrameTime = rate > 0.0 ? 1.0 / rate : 0.0;
+		if (state->frameStarted)
+			state->nextDeadline = state->lastFrame + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<real64>(state->targetFrameTime));
+	} break;
+	case SchedModuleFunction::FRAME: {
+		real64 dt = Frame(state);
+		return Value::MakeReal64(dt, context->GetStackAllocator());
+	} break;
+	case SchedModuleFunction::FRAME_TIME: {
+		real64 frameTime = GetFrameTimePercentile(state, args[0].GetReal64());
+		return Value::MakeReal64(frameTime, context->GetStackAllocator());
+	} break;
+	case SchedModuleFunction::FRAME_COUNT: {
+		return Value::MakeUInt64(state->frameCount, context->GetStackAllocator());
+	} break;
+	case SchedModuleFunction::RESET_FRAME_STATS: {
+		state->frameTimes.clear();
+		state->frameTimeIndex = 0;
+		state->frameCount = 0;
+	} break;
+	}
+
+	return Value::MakeNULL();
+}
+
+Value SchedModule::Constant(ExecutionContext* context, uint16 constant)
+{
+	return Value::MakeNULL();
+}
+
+TypeInfo SchedModule::GetFunctionReturnInfo(uint16 function)
+{
+	switch ((SchedModuleFunction)function)
+	{
+	case SchedModuleFunction::AFTER: return TypeInfo((uint16)ValueType::UINT32, 0);
+	case SchedModuleFunction::EVERY: return TypeInfo((uint16)ValueType::UINT32, 0);
+	case SchedModuleFunction::CANCEL: return TypeInfo((uint16)ValueType::BOOL, 0);
+	case SchedModuleFunction::UPDATE: return TypeInfo((uint16)ValueType::UINT32, 0);
+	case SchedModuleFunction::TIME: return TypeInfo((uint16)ValueType::REAL64, 0);
+	case SchedModuleFunction::FRAME: return TypeInfo((uint16)ValueType::REAL64, 0);
+	case SchedModuleFunction::FRAME_TIME: return TypeInfo((uint16)ValueType::REAL64, 0);
+	case SchedModuleFunction::FRAME_COUNT: return TypeInfo((uint16)ValueType::UINT64, 0);
+	}
+
+	return TypeInfo((uint16)ValueType::VOID_T, 0);
+}
+
+TypeInfo SchedModule::GetConstantTypeInfo(uint16 constant)
+{
+	return TypeInfo(INVALID_ID, 0);
+}
+
+real64 SchedModule::GetFrameTimePercentile(const SchedModuleState* state, real64 percent)
+{
+	if (state->frameTimes.empty())
+		return 0.0;
+
+	std::vector<real32> frameTimes = state->frameTimes;
+	uint32 count = frameTimes.size();
+	int64 index = (int64)std::ceil(std::clamp(percent, 0.0, 100.0) / 100.0 * count) - 1;
+	index = std::clamp<int64>(index, 0, count - 1);
+	std::nth_element(frameTimes.begin(), frameTimes.begin() + index, frameTimes.end());
+	return frameTimes[index] * 1000.0;
+}
+
+uint32 SchedModule::AddTimer(ExecutionContext* context, const std::vector<Value>& args, real64 delay, bool periodic)
+{
+	SchedModuleState* state = context->GetSchedModuleState();
+	uint32 reference = args[1].GetUInt32();
+	Function* callback = context->GetProgram()->GetFunctionFromReference(reference);
+	if (!callback || !callback->parameters.empty())
+		throw std::runtime_error("Sched.After and Sched.Every need &Class.Function of a function taking no arguments");
+
+	if (periodic && delay <= 0.0)
+		throw std::runtime_error("Sched.Every needs a period above 0");
+
+	void* object = nullptr;
+	if (!callback->isStatic)
+	{
+		object = args.size() > 2 ? *(void**)args[2].data : nullptr;
+		if (!object)
+			throw std::runtime_error("Timer callback " + callback->name + " is a member function and needs an object");
+	}
+
+	uint32 handle = state->scheduler.Allocate();
+	uint32 slot = state->scheduler.GetSlot(handle);
+	if (slot >= state->timers.size())
+		state->timers.resize(slot + 1);
+
+	Timer& timer = state->timers[slot];
+	timer.function = reference;
+	timer.object = object;
+	timer.period = periodic ? delay : 0.0;
+
+	state->scheduler.Schedule(handle, state->scheduler.GetTime() + delay);
+	return handle;
+}
+
+void SchedModule::FireTimer(ExecutionContext* context, uint32 handle, real64 fireTime)
+{
+	SchedModuleState* state = context->GetSchedModuleState();
+	Timer timer = state->timers[state->scheduler.GetSlot(handle)];
+
+	// Rescheduled before the call so the callback can cancel its own timer, missed periods are skipped
+	if (timer.period > 0.0)
+	{
+		real64 time = state->scheduler.GetTime();
+		real64 nextFireTime = fireTime + timer.period;
+		if (nextFireTime <= time)
+			nextFireTime = time + timer.period;
+
+		state->scheduler.Schedule(handle, nextFireTime);
+	}
+	else
+	{
+		state->scheduler.Release(handle);
+	}
+
+	context->CallFunctionReference(timer.function, {}, timer.object);
+}
+
+real64 SchedModule::Frame(SchedModuleState* state)
+{
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	std::chrono::steady_clock::duration targetFrameTime = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<real64>(state->targetFrameTime));
+	if (!state->frameStarted)
+	{
+		state->frameStarted = true;
+		state->lastFrame = now;
+		state->nextDeadline = now + targetFrameTime;
+		return state->targetFrameTime;
+	}
+
+	if (state->targetFrameTime > 0.0)
+	{
+		SleepUntil(state, state->nextDeadline);
+		now = std::chrono::steady_clock::now();
+
+		// More than a frame behind, start over instead of catching up with a burst of short frames
+		state->nextDeadline += targetFrameTime;
+		if (state->nextDeadline <= now)
+			state->nextDeadline = now + targetFrameTime;
+	}
+
+	real64 dt = std::chrono::duration<real64>(now - state->lastFrame).count();
+	state->lastFrame = now;
+
+	if (state->frameTimes.size() < SCHED_FRAME_HISTORY)
+	{
+		state->frameTimes.push_back(dt);
+	}
+	else
+	{
+		state->frameTimes[state->frameTimeIndex] = dt;
+		state->frameTimeIndex = (state->frameTimeIndex + 1) % SCHED_FRAME_HISTORY;
+	}
+	state->frameCount++;
+
+	return dt;
+}
+
+void SchedModule::SleepUntil(SchedModuleState* state, std::chrono::steady_clock::time_point deadline)
+{
+	// Sleeps 1ms at a time while the remaining time is above what a sleep is expected to take
+	// (mean plus one standard deviation of the measured sleeps), the rest is spun with yields
+	while (true)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		real64 remaining = std::chrono::duration<real64>(deadline - start).count();
+		if (remaining <= state->sleepEstimate)
+			break;
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		real64 observed = std::chrono::duration<real64>(std::chrono::steady_clock::now() - start).count();
+
+		state->sleepCount++;
+		real64 delta = observed - state->sleepMean;
+		state->sleepMean += delta / state->sleepCount;
+		state->sleepM2 += delta * (observed - state->sleepMean);
+		state->sleepEstimate = state->sleepMean + std::sqrt(state->sleepM2 / (state->sleepCount - 1));
+	}
+
+	while (std::chrono::steady_clock::now() < deadline)
+		std::this_thread::yield();
+}
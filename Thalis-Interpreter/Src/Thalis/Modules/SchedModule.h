@@ -0,0 +1,71 @@
+#pragma once
+
+#include "../Value.h"
+#include "../TypeInfo.h"
+#include "../Scheduler.h"
+#include <vector>
+#include <chrono>
+
+#define SCHED_FRAME_HISTORY 1024
+
+enum class SchedModuleConstant : uint16
+{
+
+};
+
+enum class SchedModuleFunction : uint16
+{
+	AFTER, EVERY, CANCEL, UPDATE, TIME,
+	SET_TARGET_RATE, FRAME, FRAME_TIME, FRAME_COUNT, RESET_FRAME_STATS
+};
+
+struct Timer
+{
+	uint32 function; // Function reference, &Class.Function
+	void* object;    // Only set for member functions
+	real64 period;   // 0 for timers that fire once
+};
+
+// Timers are scheduler handles, a timer is pending as long as its handle is scheduled and
+// fires on Sched.Update, which advances the scheduler clock by dt. Sched.Frame paces the loop
+// to the target rate and keeps the last SCHED_FRAME_HISTORY frame times.
+struct SchedModuleState
+{
+	Scheduler scheduler;
+	std::vector<Timer> timers; // Indexed by scheduler slot
+
+	real64 targetFrameTime = 0.0; // Seconds, 0 runs unpaced
+	bool frameStarted = false;
+	std::chrono::steady_clock::time_point lastFrame;
+	std::chrono::steady_clock::time_point nextDeadline;
+
+	// Running estimate of how long a 1ms sleep really takes, the rest of a wait is spun
+	real64 sleepEstimate = 0.005;
+	real64 sleepMean = 0.005;
+	real64 sleepM2 = 0.0;
+	uint64 sleepCount = 1;
+
+	std::vector<real32> frameTimes;
+	uint32 frameTimeIndex = 0;
+	uint64 frameCount = 0;
+};
+
+class ExecutionContext;
+class SchedModule
+{
+public:
+	static bool Init();
+	static Value CallFunction(ExecutionContext* context, uint16 function, const std::vector<Value>& args);
+	static Value Constant(ExecutionContext* context, uint16 constant);
+
+	static TypeInfo GetFunctionReturnInfo(uint16 function);
+	static TypeInfo GetConstantTypeInfo(uint16 constant);
+
+	// Frame time in milliseconds below which percent of the recorded frames fall, 100 is the slowest frame
+	static real64 GetFrameTimePercentile(const SchedModuleState* state, real64 percent);
+private:
+	static uint32 AddTimer(ExecutionContext* context, const std::vector<Value>& args, real64 delay, bool periodic);
+	static void FireTimer(ExecutionContext* context, uint32 handle, real64 fireTime);
+	static real64 Frame(SchedModuleState* state);
+	static void SleepUntil(SchedModuleState* state, std::chrono::steady_clock::time_point deadline);
+};
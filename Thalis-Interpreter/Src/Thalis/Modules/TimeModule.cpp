@@ -1,43 +1,40 @@
 #include "TimeModule.h"
-#include "../Program.h"
-
-#include <chrono>
-
-static std::chrono::high_resolution_clock::time_point g_BeginTime;
+#include "../ExecutionContext.h"
 
 bool TimeModule::Init()
 {
 	return true;
 }
 
-Value TimeModule::CallFunction(Program* program, uint16 function, const std::vector<Value>& args)
+Value TimeModule::CallFunction(ExecutionContext* context, uint16 function, const std::vector<Value>& args)
 {
+	const TimeModuleState* state = context->GetTimeModuleState();
 	switch ((TimeModuleFunction)function)
 	{
 	case TimeModuleFunction::GET_MILLI: {
 		std::chrono::high_resolution_clock::time_point now = std::chrono::high_resolution_clock::now();
-		uint64 milli = std::chrono::duration_cast<std::chrono::milliseconds>(now - g_BeginTime).count();
-		return Value::MakeUInt64(milli, program->GetStackAllocator());
+		uint64 milli = std::chrono::duration_cast<std::chrono::milliseconds>(now - state->beginTime).count();
+		return Value::MakeUInt64(milli, context->GetStackAllocator());
 	} break;
 	case TimeModuleFunction::GET_MICRO: {
 		std::chrono::high_resolution_clock::time_point now = std::chrono::high_resolution_clock::now();
-		uint64 micro = std::chrono::duration_cast<std::chrono::microseconds>(now - g_BeginTime).count();
-		return Value::MakeUInt64(micro, program->GetStackAllocator());
+		uint64 micro = std::chrono::duration_cast<std::chrono::microseconds>(now - state->beginTime).count();
+		return Value::MakeUInt64(micro, context->GetStackAllocator());
 	} break;
 	case TimeModuleFunction::GET_NANO: {
 		std::chrono::high_resolution_clock::time_point now = std::chrono::high_resolution_clock::now();
-		uint64 nano = std::chrono::duration_cast<std::chrono::nanoseconds>(now - g_BeginTime).count();
-		return Value::MakeUInt64(nano, program->GetStackAllocator());
+		uint64 nano = std::chrono::duration_cast<std::chrono::nanoseconds>(now - state->beginTime).count();
+		return Value::MakeUInt64(nano, context->GetStackAllocator());
 	} break;
 	}
 }
 
-void TimeModule::SetBeginTime()
+void TimeModule::SetBeginTime(ExecutionContext* context)
 {
-	g_BeginTime = std::chrono::high_resolution_clock::now();
+	context->GetTimeModuleState()->beginTime = std::chrono::high_resolution_clock::now();
 }
 
-Value TimeModule::Constant(Program* program, uint16 constant)
+Value TimeModule::Constant(ExecutionContext* context, uint16 constant)
 {
 	return Value::MakeNULL();
 }
@@ -3,6 +3,7 @@
 #include "../Value.h"
 #include "../TypeInfo.h"
 #include <vector>
+#include <chrono>
 
 enum class TimeModuleConstant : uint16
 {
@@ -14,16 +15,21 @@ enum class TimeModuleFunction : uint16
 	GET_MILLI, GET_MICRO, GET_NANO,
 };
 
-class Program;
+struct TimeModuleState
+{
+	std::chrono::high_resolution_clock::time_point beginTime;
+};
+
+class ExecutionContext;
 class TimeModule
 {
 public:
 	static bool Init();
-	static Value CallFunction(Program* program, uint16 function, const std::vector<Value>& args);
-	static Value Constant(Program* program, uint16 constant);
+	static Value CallFunction(ExecutionContext* context, uint16 function, const std::vector<Value>& args);
+	static Value Constant(ExecutionContext* context, uint16 constant);
 
 	static TypeInfo GetFunctionReturnInfo(uint16 function);
 	static TypeInfo GetConstantTypeInfo(uint16 constant);
 
-	static void SetBeginTime();
+	static void SetBeginTime(ExecutionContext* context);
 };
\ No newline at end of file
@@ -1,5 +1,5 @@
 #include "WindowModule.h"
-#include "../Program.h"
+#include "../ExecutionContext.h"
 
 #include "../Window.h"
 
@@ -8,15 +8,15 @@ bool WindowModule::Init()
     return true;
 }
 
-Value WindowModule::CallFunction(Program* program, uint16 function, const std::vector<Value>& args)
+Value WindowModule::CallFunction(ExecutionContext* context, uint16 function, const std::vector<Value>& args)
 {
     switch ((WindowModuleFunction)function)
     {
-    case WindowModuleFunction::CREATE: return Value::MakeUInt32(Window::TLSCreateWindow(args[0].GetString(), args[1].GetUInt32(), args[2].GetUInt32()), program->GetStackAllocator());
+    case WindowModuleFunction::CREATE: return Value::MakeUInt32(Window::TLSCreateWindow(args[0].GetString(), args[1].GetUInt32(), args[2].GetUInt32()), context->GetStackAllocator());
     case WindowModuleFunction::DESTROY: Window::GetWindow(args[0].GetUInt32())->Destroy(); break;
     case WindowModuleFunction::UPDATE: Window::GetWindow(args[0].GetUInt32())->Update(); break;
     case WindowModuleFunction::PRESENT: Window::GetWindow(args[0].GetUInt32())->Present(); break;
-    case WindowModuleFunction::CHECK_FOR_EVENT: return Value::MakeBool(Window::GetWindow(args[0].GetUInt32())->CheckForEvent((WindowEventType)args[1].GetUInt32()), program->GetStackAllocator());
+    case WindowModuleFunction::CHECK_FOR_EVENT: return Value::MakeBool(Window::GetWindow(args[0].GetUInt32())->CheckForEvent((WindowEventType)args[1].GetUInt32()), context->GetStackAllocator());
     case WindowModuleFunction::GET_SIZE: {
 
         Window* window = Window::GetWindow(args[0].GetUInt32());
@@ -35,13 +35,13 @@ Value WindowModule::CallFunction(Program* program, uint16 function, const std::v
     return Value::MakeNULL();
 }
 
-Value WindowModule::Constant(Program* program, uint16 constant)
+Value WindowModule::Constant(ExecutionContext* context, uint16 constant)
 {
     switch ((WindowModuleConstant)constant)
     {
-    case WindowModuleConstant::CB_CREATE: return Value::MakeUInt32((uint32)WindowEventType::CREATE, program->GetStackAllocator());
-    case WindowModuleConstant::CB_CLOSE: return Value::MakeUInt32((uint32)WindowEventType::CLOSE, program->GetStackAllocator());
-    case WindowModuleConstant::CB_RESIZE: return Value::MakeUInt32((uint32)WindowEventType::RESIZE, program->GetStackAllocator());
+    case WindowModuleConstant::CB_CREATE: return Value::MakeUInt32((uint32)WindowEventType::CREATE, context->GetStackAllocator());
+    case WindowModuleConstant::CB_CLOSE: return Value::MakeUInt32((uint32)WindowEventType::CLOSE, context->GetStackAllocator());
+    case WindowModuleConstant::CB_RESIZE: return Value::MakeUInt32((uint32)WindowEventType::RESIZE, context->GetStackAllocator());
     }
 
     return Value::MakeNULL();
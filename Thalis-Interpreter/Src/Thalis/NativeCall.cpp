@@ -0,0 +1,48 @@
+#include "NativeCall.h"
+
+TypeInfo NativeCall::ToTypeInfo(NativeType type)
+{
+	switch (type)
+	{
+	case NativeType::VOID_T: return TypeInfo((uint16)ValueType::VOID_T, 0);
+	case NativeType::BOOL: return TypeInfo((uint16)ValueType::BOOL, 0);
+	case NativeType::CHAR: return TypeInfo((uint16)ValueType::CHAR, 0);
+	case NativeType::UINT8: return TypeInfo((uint16)ValueType::UINT8, 0);
+	case NativeType::UINT16: return TypeInfo((uint16)ValueType::UINT16, 0);
+	case NativeType::UINT32: return TypeInfo((uint16)ValueType::UINT32, 0);
+	case NativeType::UINT64: return TypeInfo((uint16)ValueType::UINT64, 0);
+	case NativeType::INT8: return TypeInfo((uint16)ValueType::INT8, 0);
+	case NativeType::INT16: return TypeInfo((uint16)ValueType::INT16, 0);
+	case NativeType::INT32: return TypeInfo((uint16)ValueType::INT32, 0);
+	case NativeType::INT64: return TypeInfo((uint16)ValueType::INT64, 0);
+	case NativeType::REAL32: return TypeInfo((uint16)ValueType::REAL32, 0);
+	case NativeType::REAL64: return TypeInfo((uint16)ValueType::REAL64, 0);
+	case NativeType::STRING: return TypeInfo((uint16)ValueType::CHAR, 1);
+	case NativeType::POINTER: return TypeInfo((uint16)ValueType::VOID_T, 1);
+	}
+
+	return TypeInfo(INVALID_ID, 0);
+}
+
+Value NativeCall::Box(const NativeValue& value, NativeType type, Allocator* allocator)
+{
+	switch (type)
+	{
+	case NativeType::BOOL: return Value::MakeBool(value.b, allocator);
+	case NativeType::CHAR: return Value::MakeChar(value.c, allocator);
+	case NativeType::UINT8: return Value::MakeUInt8((uint8)value.u, allocator);
+	case NativeType::UINT16: return Value::MakeUInt16((uint16)value.u, allocator);
+	case NativeType::UINT32: return Value::MakeUInt32((uint32)value.u, allocator);
+	case NativeType::UINT64: return Value::MakeUInt64(value.u, allocator);
+	case NativeType::INT8: return Value::MakeInt8((int8)value.i, allocator);
+	case NativeType::INT16: return Value::MakeInt16((int16)value.i, allocator);
+	case NativeType::INT32: return Value::MakeInt32((int32)value.i, allocator);
+	case NativeType::INT64: return Value::MakeInt64(value.i, allocator);
+	case NativeType::REAL32: return Value::MakeReal32(value.f32, allocator);
+	case NativeType::REAL64: return Value::MakeReal64(value.f64, allocator);
+	case NativeType::STRING: return Value::MakePointer((uint16)ValueType::CHAR, 1, (void*)value.str, allocator);
+	case NativeType::POINTER: return Value::MakePointer((uint16)ValueType::VOID_T, 1, value.ptr, allocator);
+	}
+
+	return Value::MakeNULL();
+}
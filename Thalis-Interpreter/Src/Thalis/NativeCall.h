@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Value.h"
+#include "TypeInfo.h"
+#include "NativeFunction.h"
+
+// Conversions between the interpreter's boxed Values and the unboxed NativeValues
+// native functions take and return
+class NativeCall
+{
+public:
+	static TypeInfo ToTypeInfo(NativeType type);
+	static Value Box(const NativeValue& value, NativeType type, Allocator* allocator);
+
+	inline static NativeValue Unbox(const Value& value, NativeType type)
+	{
+		NativeValue result;
+		result.u = 0;
+		switch (type)
+		{
+		case NativeType::BOOL: result.b = value.GetBool(); break;
+		case NativeType::CHAR: result.c = value.GetChar(); break;
+		case NativeType::UINT8:
+		case NativeType::UINT16:
+		case NativeType::UINT32:
+		case NativeType::UINT64: result.u = value.GetUInt64(); break;
+		case NativeType::INT8:
+		case NativeType::INT16:
+		case NativeType::INT32:
+		case NativeType::INT64: result.i = value.GetInt64(); break;
+		case NativeType::REAL32: result.f32 = value.GetReal32(); break;
+		case NativeType::REAL64: result.f64 = value.GetReal64(); break;
+		case NativeType::STRING: result.str = value.GetCString(); break;
+		case NativeType::POINTER: result.ptr = *(void**)value.data; break;
+		}
+
+		return result;
+	}
+
+	// Writes the result over a value of the same primitive type nothing else refers to, false if the types differ
+	inline static bool BoxInto(const NativeValue& value, NativeType type, Value* dst)
+	{
+		if (dst->pointerLevel != 0 || dst->isArray || dst->isReference)
+			return false;
+
+		switch (type)
+		{
+		case NativeType::BOOL: if (dst->type != (uint16)ValueType::BOOL) return false; *(bool*)dst->data = value.b; return true;
+		case NativeType::CHAR: if (dst->type != (uint16)ValueType::CHAR) return false; *(char*)dst->data = value.c; return true;
+		case NativeType::UINT32: if (dst->type != (uint16)ValueType::UINT32) return false; *(uint32*)dst->data = (uint32)value.u; return true;
+		case NativeType::UINT64: if (dst->type != (uint16)ValueType::UINT64) return false; *(uint64*)dst->data = value.u; return true;
+		case NativeType::INT32: if (dst->type != (uint16)ValueType::INT32) return false; *(int32*)dst->data = (int32)value.i; return true;
+		case NativeType::INT64: if (dst->type != (uint16)ValueType::INT64) return false; *(int64*)dst->data = value.i; return true;
+		case NativeType::REAL32: if (dst->type != (uint16)ValueType::REAL32) return false; *(real32*)dst->data = value.f32; return true;
+		case NativeType::REAL64: if (dst->type != (uint16)ValueType::REAL64) return false; *(real64*)dst->data = value.f64; return true;
+		default: return false;
+		}
+	}
+};
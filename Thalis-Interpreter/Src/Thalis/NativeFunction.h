@@ -0,0 +1,49 @@
+#pragma once
+
+// Signature of functions the interpreter calls directly, without going through the module
+// switches. Built-in modules and plug-ins describe their fast functions with these types.
+
+#include <stdint.h>
+
+#define THALIS_NATIVE_MAX_PARAMETERS 8
+
+enum class NativeType : uint16_t
+{
+	VOID_T, BOOL, CHAR,
+	UINT8, UINT16, UINT32, UINT64,
+	INT8, INT16, INT32, INT64,
+	REAL32, REAL64,
+	STRING,  // const char*
+	POINTER  // void*
+};
+
+// Arguments arrive unboxed in the member matching their declared type
+union NativeValue
+{
+	bool b;
+	char c;
+	uint64_t u;
+	int64_t i;
+	float f32;
+	double f64;
+	const char* str;
+	void* ptr;
+};
+
+typedef void (*NativeFunction)(const NativeValue* args, NativeValue* result);
+
+struct NativeFunctionDesc
+{
+	const char* name;
+	NativeFunction function;
+	NativeType returnType;
+	uint32_t numParameters;
+	NativeType parameterTypes[THALIS_NATIVE_MAX_PARAMETERS];
+};
+
+struct NativeConstantDesc
+{
+	const char* name;
+	NativeType type;
+	NativeValue value;
+};
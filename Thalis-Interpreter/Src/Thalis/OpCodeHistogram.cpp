@@ -0,0 +1,104 @@
+#include "OpCodeHistogram.h"
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+
+static const char* g_OpCodeNames[] =
+{
+	"PUSH_UINT8", "PUSH_UINT16", "PUSH_UINT32", "PUSH_UINT64", "PUSH_INT8", "PUSH_INT16", "PUSH_INT32",
+	"PUSH_INT64", "PUSH_INT32_SMALL", "PUSH_REAL32", "PUSH_REAL64", "PUSH_CHAR", "PUSH_BOOL", "PUSH_CSTR",
+	"PUSH_LOCAL", "PUSH_TYPED_NULL", "PUSH_INDEXED", "PUSH_STATIC_VARIABLE", "PUSH_MEMBER", "PUSH_THIS",
+	"PUSH_UNTYPED_NULL", "PUSH_SCOPE", "POP_SCOPE", "POP_MARKER_SCOPE", "PUSH_LOOP", "POP_LOOP",
+	"DECLARE_UINT8", "DECLARE_UINT16", "DECLARE_UINT32", "DECLARE_UINT64", "DECLARE_INT8", "DECLARE_INT16",
+	"DECLARE_INT32", "DECLARE_INT64", "DECLARE_REAL32", "DECLARE_REAL64", "DECLARE_CHAR", "DECLARE_BOOL",
+	"DECLARE_POINTER", "DECLARE_STACK_ARRAY", "DECLARE_OBJECT_WITH_CONSTRUCTOR",
+	"DECLARE_OBJECT_WITH_ASSIGN", "DECLARE_REFERENCE", "ADD", "SUBTRACT", "MULTIPLY", "DIVIDE", "MOD",
+	"LESS", "GREATER", "LESS_EQUAL", "GREATER_EQUAL", "EQUALS", "NOT_EQUALS", "UNARY_UPDATE", "NOT",
+	"NEGATE", "LOGICAL_OR", "LOGICAL_AND", "PLUS_EQUALS", "MINUS_EQUALS", "TIMES_EQUALS", "DIVIDE_EQUALS",
+	"INVERT", "BREAK", "CONTINUE", "ADDRESS_OF", "DEREFERENCE", "CAST", "SET", "MODULE_CONSTANT",
+	"MEMBER_FUNCTION_CALL", "CONSTRUCTOR_CALL", "VIRTUAL_FUNCTION_CALL", "MODULE_FUNCTION_CALL",
+	"STATIC_FUNCTION_CALL", "RETURN", "NEW", "NEW_ARRAY", "NEW_IN_ARENA", "NEW_ARRAY_IN_ARENA", "STRLEN",
+	"INT_TO_STR", "STR_TO_INT", "FIELD_INFO", "DELETE", "DELETE_ARRAY", "JUMP", "JUMP_IF_FALSE",
+	"BREAK_POINT", "PUSH_THIS_MEMBER", "PUSH_LOCAL_MEMBER", "PUSH_LOCAL_POINTER_MEMBER",
+	"LESS_LOCAL_CONST_JUMP_IF_FALSE", "NATIVE_CALL", "YIELD", "END"
+};
+
+static_assert(sizeof(g_OpCodeNames) / sizeof(g_OpCodeNames[0]) == (uint32)OpCode::END + 1, "Every OpCode needs a name");
+
+const char* OpCodeToString(OpCode opcode)
+{
+	if ((uint32)opcode > (uint32)OpCode::END)
+		return "UNKNOWN";
+
+	return g_OpCodeNames[(uint32)opcode];
+}
+
+OpCodeHistogram::OpCodeHistogram() :
+	m_Window(0), m_WindowSize(0)
+{
+	memset(m_Counts, 0, sizeof(m_Counts));
+}
+
+bool OpCodeHistogram::BreaksSequence(OpCode opcode)
+{
+	switch (opcode)
+	{
+	case OpCode::JUMP:
+	case OpCode::JUMP_IF_FALSE:
+	case OpCode::LESS_LOCAL_CONST_JUMP_IF_FALSE:
+	case OpCode::BREAK:
+	case OpCode::CONTINUE:
+	case OpCode::RETURN:
+	case OpCode::MEMBER_FUNCTION_CALL:
+	case OpCode::CONSTRUCTOR_CALL:
+	case OpCode::VIRTUAL_FUNCTION_CALL:
+	case OpCode::STATIC_FUNCTION_CALL:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void OpCodeHistogram::Print(uint32 maxEntries) const
+{
+	uint64 total = 0;
+	std::vector<std::pair<uint64, uint32>> singles;
+	for (uint32 i = 0; i < 256; i++)
+	{
+		total += m_Counts[i];
+		if (m_Counts[i] > 0)
+			singles.push_back({ m_Counts[i], i });
+	}
+
+	std::sort(singles.begin(), singles.end(), std::greater<std::pair<uint64, uint32>>());
+
+	std::cout << "Dispatched opcodes: " << total << std::endl;
+	for (uint32 i = 0; i < singles.size() && i < maxEntries; i++)
+	{
+		std::cout << std::setw(12) << singles[i].first << " " << std::fixed << std::setprecision(2) << std::setw(6)
+			<< (100.0 * singles[i].first / total) << "%  " << OpCodeToString((OpCode)singles[i].second) << std::endl;
+	}
+
+	for (uint32 length = 2; length <= OPCODE_HISTOGRAM_MAX_SEQUENCE; length++)
+	{
+		const std::unordered_map<uint32, uint64>& counts = m_SequenceCounts[length - 2];
+		std::vector<std::pair<uint64, uint32>> sequences;
+		sequences.reserve(counts.size());
+		for (const auto& it : counts)
+			sequences.push_back({ it.second, it.first });
+
+		std::sort(sequences.begin(), sequences.end(), std::greater<std::pair<uint64, uint32>>());
+
+		std::cout << "Top " << length << "-opcode sequences:" << std::endl;
+		for (uint32 i = 0; i < sequences.size() && i < maxEntries; i++)
+		{
+			std::cout << std::setw(12) << sequences[i].first << "  ";
+			for (int32 j = length - 1; j >= 0; j--)
+			{
+				std::cout << OpCodeToString((OpCode)((sequences[i].second >> (j * 8)) & 0xFF));
+				if (j > 0) std::cout << " + ";
+			}
+			std::cout << std::endl;
+		}
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <unordered_map>
+#include "Program.h"
+
+#define OPCODE_HISTOGRAM_MAX_SEQUENCE 4
+
+const char* OpCodeToString(OpCode opcode);
+
+// Counts executed opcodes and the opcode sequences they form. A sequence is broken
+// after any opcode that transfers control, so only statically adjacent opcodes
+// (candidates for superinstructions) are counted together.
+class OpCodeHistogram
+{
+public:
+	OpCodeHistogram();
+
+	inline void Record(OpCode opcode)
+	{
+		uint8 code = (uint8)opcode;
+		m_Counts[code]++;
+
+		m_Window = (m_Window << 8) | code;
+		if (m_WindowSize < OPCODE_HISTOGRAM_MAX_SEQUENCE)
+			m_WindowSize++;
+
+		for (uint32 i = 2; i <= m_WindowSize; i++)
+			m_SequenceCounts[i - 2][m_Window & SequenceMask(i)]++;
+
+		if (BreaksSequence(opcode))
+			m_WindowSize = 0;
+	}
+
+	void Print(uint32 maxEntries) const;
+private:
+	static inline uint32 SequenceMask(uint32 length) { return length >= 4 ? UINT32_MAX : (1u << (length * 8)) - 1; }
+	static bool BreaksSequence(OpCode opcode);
+private:
+	uint64 m_Counts[256];
+	std::unordered_map<uint32, uint64> m_SequenceCounts[OPCODE_HISTOGRAM_MAX_SEQUENCE - 1];
+	uint32 m_Window;
+	uint32 m_WindowSize;
+};
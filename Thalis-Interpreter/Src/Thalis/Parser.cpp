@@ -3,6 +3,7 @@
 #include "Tokenizer.h"
 #include "Class.h"
 #include "ASTExpression.h"
+#include "Memory/Memory.h"
 #include <iostream>
 #include "Modules/IOModule.h"
 #include "Modules/ModuleID.h"
@@ -12,35 +13,92 @@
 #include "Modules/FSModule.h"
 #include "Modules/MemModule.h"
 #include "Modules/TimeModule.h"
+#include "Modules/JobModule.h"
+#include "Modules/ChanModule.h"
+#include "Modules/CoModule.h"
+#include "Modules/SchedModule.h"
+#include "Modules/HostModule.h"
+#include "PluginModule.h"
+#include "SourceLoader.h"
 #include <unordered_set>
 #include <filesystem>
+#include <thread>
 
-#define COMPILE_ERROR(Line, Column, Msg, Ret) { std::cout << Line << "(" << Column << ") " << Msg << std::endl; return Ret; } 
+#define COMPILE_ERROR(Line, Column, Msg, Ret) { ReportError(Line, Column, Msg); return Ret; } 
 
 Parser::Parser(Program* program) :
 	m_Program(program),
+	m_NumScopes(0),
+	m_ParsedBytes(0),
+	m_PrintErrors(true),
+	m_NumThreads(std::max(std::thread::hardware_concurrency(), 1u)),
+	m_Sources(nullptr),
 	m_CurrentFunctionReturnsReference(false)
 {
+	m_ScopeAllocator = new SegmentedBumpAllocator(Memory::KBToBytes(SCOPE_SEGMENT_SIZE_KB), UINT64_MAX);
 }
 
-static char* ReadFileIntoMemoryNullTerminate(const char* path)
+Parser::~Parser()
 {
-	FILE* file = fopen(path, "rb");
-	fseek(file, 0, SEEK_END);
-	size_t fileSize = ftell(file);
-	fseek(file, 0, SEEK_SET);
-	char* fileContents = (char*)malloc(fileSize + 1);
-	fread(fileContents, 1, fileSize, file);
-	fileContents[fileSize] = 0;
-	fclose(file);
-	return fileContents;
+	m_ScopeAllocator->Destroy();
+	delete m_ScopeAllocator;
 }
 
-void Parser::Parse(const std::string& path)
+bool Parser::Parse(const std::string& path)
 {
-	char* contents = ReadFileIntoMemoryNullTerminate(path.c_str());
+	// Reading and tokenizing runs ahead on all threads, classes are still registered in import order
+	SourceLoader sources(m_NumThreads);
+	sources.Load(path);
+
+	m_Sources = &sources;
+	bool result = ParseFile(path);
+	m_Sources = nullptr;
+
+	CheckDeferredMembers();
+	return result && m_Errors.empty();
+}
+
+void Parser::CheckDeferredMembers()
+{
+	for (uint32 i = 0; i < m_FieldIndexChecks.size(); i++)
+	{
+		const DeferredMemberCheck& check = m_FieldIndexChecks[i];
+		Class* cls = m_Program->GetClass(check.classID);
+		if (cls->GetFieldIndex(check.name) == INVALID_ID)
+			ReportError(check.line, check.column, cls->GetName() + " has no field " + check.name);
+	}
+	m_FieldIndexChecks.clear();
+
+	// A reference names a single function, there is no argument list to pick an overload with
+	for (uint32 i = 0; i < m_FunctionReferenceChecks.size(); i++)
+	{
+		const DeferredMemberCheck& check = m_FunctionReferenceChecks[i];
+		Class* cls = m_Program->GetClass(check.classID);
+		uint32 numFunctions = cls->GetNumFunctionsNamed(check.name);
+		if (numFunctions == 0)
+			ReportError(check.line, check.column, cls->GetName() + " has no function " + check.name);
+		else if (numFunctions > 1)
+			ReportError(check.line, check.column, cls->GetName() + "." + check.name + " is overloaded and cannot be referenced");
+	}
+	m_FunctionReferenceChecks.clear();
+}
+
+bool Parser::ParseFile(const std::string& path)
+{
+	SourceFile* source = m_Sources->Find(path);
+	if (!source)
+	{
+		m_Errors.push_back("Could not open " + path);
+		if (m_PrintErrors)
+			std::cout << m_Errors.back() << std::endl;
+
+		return false;
+	}
+
+	m_ParsedBytes += source->size;
 	Tokenizer tokenizer;
-	tokenizer.at = contents;
+	tokenizer.at = source->contents;
+	tokenizer.tokens = source->tokens.data();
 
 	Token token = tokenizer.GetToken();
 
@@ -58,7 +116,34 @@ void Parser::Parse(const std::string& path)
 		token = tokenizer.GetToken();
 	}
 
-	free(contents);
+	return m_Errors.empty();
+}
+
+void Parser::ReportError(uint32 line, uint32 column, const std::string& message)
+{
+	m_Errors.push_back(std::to_string(line) + "(" + std::to_string(column) + ") " + message);
+	if (m_PrintErrors)
+		std::cout << m_Errors.back() << std::endl;
+}
+
+Scope* Parser::PushScope(Scope* parent)
+{
+	m_ScopeMarkers.push_back(m_ScopeAllocator->GetMarker());
+
+	void* memory = m_ScopeAllocator->AllocAligned(sizeof(Scope), alignof(Scope));
+	Scope* scope = new (memory) Scope(parent);
+	m_ScopeStack.push_back(scope);
+	m_NumScopes++;
+	return scope;
+}
+
+void Parser::PopScope()
+{
+	m_ScopeStack.back()->~Scope();
+	m_ScopeStack.pop_back();
+
+	m_ScopeAllocator->FreeToMarker(m_ScopeMarkers.back());
+	m_ScopeMarkers.pop_back();
 }
 
 bool Parser::ParseImport(Tokenizer* tokenizer)
@@ -81,15 +166,28 @@ bool Parser::ParseImport(Tokenizer* tokenizer)
 		else if (builtInModule == "FS") { m_Program->AddModule("FS", FS_MODULE_ID); FSModule::Init(); }
 		else if (builtInModule == "Mem") { m_Program->AddModule("Mem", MEM_MODULE_ID); MemModule::Init(); }
 		else if (builtInModule == "Time") { m_Program->AddModule("Time", TIME_MODULE_ID); TimeModule::Init(); }
+		else if (builtInModule == "Job") { m_Program->AddModule("Job", JOB_MODULE_ID); JobModule::Init(); }
+		else if (builtInModule == "Chan") { m_Program->AddModule("Chan", CHAN_MODULE_ID); ChanModule::Init(); }
+		else if (builtInModule == "Host") { m_Program->AddModule("Host", HOST_MODULE_ID); HostModule::Init(); }
+		else if (builtInModule == "Co") { m_Program->AddModule("Co", CO_MODULE_ID); CoModule::Init(); }
+		else if (builtInModule == "Sched") { m_Program->AddModule("Sched", SCHED_MODULE_ID); SchedModule::Init(); }
+		else if (!ImportPlugin(token, builtInModule, PluginModule::GetSearchPaths(builtInModule)))
+			return false;
 
 		tokenizer->Expect(TokenTypeT::SEMICOLON);
 	}
 	else if (token.type == TokenTypeT::STRING_LITERAL) //User defined module
 	{
 		std::string path(token.text, token.length);
-		if (!WasFileAlreadyParsed(path))
+		std::string extension = std::filesystem::path(path).extension().generic_string();
+		if (extension == ".so" || extension == ".dll" || extension == ".dylib") //Native plug-in, named by its descriptor
 		{
-			Parse(path);
+			if (!ImportPlugin(token, "", { path }))
+				return false;
+		}
+		else if (!WasFileAlreadyParsed(path))
+		{
+			ParseFile(path);
 			m_ParsedFiles.push_back(std::filesystem::absolute(path).generic_string());
 		}
 	}
@@ -97,6 +195,42 @@ bool Parser::ParseImport(Tokenizer* tokenizer)
 	return true;
 }
 
+bool Parser::ImportPlugin(const Token& token, const std::string& moduleName, const std::vector<std::string>& paths)
+{
+	std::string error;
+	PluginModule* plugin = nullptr;
+	for (uint32 i = 0; i < paths.size() && !plugin; i++)
+	{
+		if (std::filesystem::exists(paths[i]))
+			plugin = PluginModule::Load(std::filesystem::absolute(paths[i]).string(), &error);
+	}
+
+	if (!plugin)
+		COMPILE_ERROR(token.line, token.column, error.empty() ? "Unknown module " + moduleName : error, false);
+
+	std::string name = moduleName.empty() ? plugin->GetName() : moduleName;
+	if (m_Program->GetModuleID(name) != INVALID_ID)
+	{
+		delete plugin;
+		return true;
+	}
+
+	m_Program->AddModule(name, m_Program->AddPlugin(plugin));
+	return true;
+}
+
+static bool HasStaticField(Class* cls, const std::string& name)
+{
+	const std::vector<ClassField>& fields = cls->GetStaticFields();
+	for (uint32 i = 0; i < fields.size(); i++)
+	{
+		if (fields[i].name == name)
+			return true;
+	}
+
+	return false;
+}
+
 static void SkipStatement(Tokenizer* tokenizer)
 {
 	int braceDepth = 0;
@@ -130,6 +264,8 @@ bool Parser::ParseClass(Tokenizer* tokenizer)
 	TemplateDefinition templateDefinition;
 	Token arrowToken = tokenizer->PeekToken();
 	Class* baseClass = nullptr;
+	uint64 requestedAlignment = 0;
+	bool packed = false;
 	while (arrowToken.type == TokenTypeT::ARROW)
 	{
 		tokenizer->Expect(TokenTypeT::ARROW);
@@ -183,6 +319,15 @@ bool Parser::ParseClass(Tokenizer* tokenizer)
 			Token closeBracket = tokenizer->GetToken();
 			if (closeBracket.type != TokenTypeT::CLOSE_BRACKET) return false;
 		}
+		else if (classExtensionToken.type == TokenTypeT::ALIGN)
+		{
+			requestedAlignment = ParseAlignment(tokenizer);
+			if (requestedAlignment == 0) return false;
+		}
+		else if (classExtensionToken.type == TokenTypeT::PACKED)
+		{
+			packed = true;
+		}
 
 		arrowToken = tokenizer->PeekToken();
 	}
@@ -193,21 +338,21 @@ bool Parser::ParseClass(Tokenizer* tokenizer)
 	Class* cls = new Class(className, baseClass);
 	uint16 id = m_Program->AddClass(cls);
 	cls->SetTemplateDefinition(templateDefinition);
+	cls->SetRequestedAlignment(requestedAlignment);
+	cls->SetPacked(packed);
 	//------------------------------------------------------------
 	// Pass 1: Parse all class variables (fields + static)
 	//------------------------------------------------------------
 	{
 		Token savePos = openBrace; // remember where we started
 
-		uint64 memberOffset = 0;
-		uint64 staticOffset = 0;
 		while (true)
 		{
 			Token t = tokenizer->PeekToken();
 			if (t.type == TokenTypeT::CLOSE_BRACE || t.type == TokenTypeT::END)
 				break;
 
-			if (ParseClassVariable(tokenizer, cls, &memberOffset, &staticOffset))
+			if (ParseClassVariable(tokenizer, cls))
 				continue;
 
 			// Skip over functions or anything we don't understand
@@ -216,8 +361,7 @@ bool Parser::ParseClass(Tokenizer* tokenizer)
 
 		// rewind tokenizer to start of class body for second pass
 		tokenizer->SetPeek(savePos);
-		cls->SetSize(memberOffset);
-		cls->SetStaticDataSize(staticOffset);
+		cls->ComputeLayout(m_Program);
 	}
 
 	//------------------------------------------------------------
@@ -242,17 +386,29 @@ bool Parser::ParseClass(Tokenizer* tokenizer)
 
 	if (!cls->HasCopyConstructor())
 	{
-		cls->AddFunction(GenerateDefaultCopyFunction(cls, className));
+		cls->AddFunction(m_Program, GenerateDefaultCopyFunction(cls, className));
 	}
 
 	if (!cls->HasAssignSTFunction())
 	{
-		cls->AddFunction(GenerateDefaultCopyFunction(cls, "operator="));
+		cls->AddFunction(m_Program, GenerateDefaultCopyFunction(cls, "operator="));
 	}
 
 	return true;
 }
 
+static bool IsTemplateIntegerParameter(Class* cls, const std::string& name)
+{
+	const TemplateDefinition& definition = cls->GetTemplateDefinition();
+	for (uint32 i = 0; i < definition.parameters.size(); i++)
+	{
+		if (definition.parameters[i].type == TemplateParameterType::INT && definition.parameters[i].name == name)
+			return true;
+	}
+
+	return false;
+}
+
 static AccessModifier ParseAccessModifier(Tokenizer* tokenizer)
 {
 	Token accessModifier = tokenizer->PeekToken();
@@ -415,8 +571,7 @@ bool Parser::ParseFunction(Tokenizer* tokenizer, Class* cls)
 		m_Program->SetClassWithMainFunction(m_Program->GetClassID(m_CurrentClassName));
 	}
 
-	Scope* functionScope = new Scope();
-	m_ScopeStack.push_back(functionScope);
+	Scope* functionScope = PushScope(nullptr);
 
 	if (tokenizer->Expect(TokenTypeT::OPEN_PAREN, &t))
 	{
@@ -536,18 +691,41 @@ bool Parser::ParseFunction(Tokenizer* tokenizer, Class* cls)
 	}
 
 	function->numLocals = functionScope->GetNumLocals();
+	PopScope();
 
-	m_ScopeStack.pop_back();
-	delete functionScope;
-
-	cls->AddFunction(function);
+	cls->AddFunction(m_Program, function);
 	return true;
 }
 
-bool Parser::ParseClassVariable(Tokenizer* tokenizer, Class* cls, uint64* memberOffset, uint64* staticOffset)
+uint64 Parser::ParseAlignment(Tokenizer* tokenizer)
+{
+	Token openBracket;
+	if (tokenizer->Expect(TokenTypeT::OPEN_BRACKET, &openBracket)) COMPILE_ERROR(openBracket.line, openBracket.column, "Expected '[' after align", 0);
+
+	Token alignmentToken;
+	if (tokenizer->Expect(TokenTypeT::NUMBER_LITERAL, &alignmentToken)) COMPILE_ERROR(alignmentToken.line, alignmentToken.column, "Expected alignment in bytes", 0);
+
+	uint64 alignment = std::stoull(std::string(alignmentToken.text, alignmentToken.length));
+	if (alignment == 0 || (alignment & (alignment - 1)) != 0) COMPILE_ERROR(alignmentToken.line, alignmentToken.column, "Alignment must be a power of two", 0);
+
+	Token closeBracket;
+	if (tokenizer->Expect(TokenTypeT::CLOSE_BRACKET, &closeBracket)) COMPILE_ERROR(closeBracket.line, closeBracket.column, "Expected ']' after alignment", 0);
+
+	return alignment;
+}
+
+bool Parser::ParseClassVariable(Tokenizer* tokenizer, Class* cls)
 {
 	AccessModifier accessModifier = ParseAccessModifier(tokenizer);
 
+	uint64 alignment = 0;
+	if (tokenizer->PeekToken().type == TokenTypeT::ALIGN)
+	{
+		tokenizer->Expect(TokenTypeT::ALIGN);
+		alignment = ParseAlignment(tokenizer);
+		if (alignment == 0) return false;
+	}
+
 	bool isStatic = false;
 	if (tokenizer->PeekToken().type == TokenTypeT::STATIC)
 	{
@@ -633,23 +811,9 @@ bool Parser::ParseClassVariable(Tokenizer* tokenizer, Class* cls, uint64* member
 	if (tokenizer->Expect(TokenTypeT::SEMICOLON)) return false;
 
 	if (isStatic)
-	{
-		uint64 finalOffset = *staticOffset;
-		if (!arrayDimensions.empty())
-			finalOffset += sizeof(ArrayHeader);
-
-		cls->AddStaticField(name, type, pointerLevel, finalOffset, typeSize, arrayDimensions, initializeExpr);
-		*staticOffset += typeSize;
-	}
+		cls->AddStaticField(name, type, pointerLevel, typeSize, alignment, arrayDimensions, initializeExpr);
 	else
-	{
-		uint64 finalOffset = *memberOffset;
-		if (!arrayDimensions.empty())
-			finalOffset += sizeof(ArrayHeader);
-
-		cls->AddMemberField(name, type, pointerLevel, finalOffset, typeSize, arrayDimensions, templateTypeName, command);
-		*memberOffset += typeSize;
-	}
+		cls->AddMemberField(name, type, pointerLevel, typeSize, alignment, arrayDimensions, templateTypeName, command);
 
 	return true;
 }
@@ -730,7 +894,7 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 			if (next.type == TokenTypeT::SEMICOLON)
 			{
 				std::vector<ASTExpression*> argExprs(0);
-				ASTExpressionDeclareObjectWithConstructor* declareObjectExpr = new ASTExpressionDeclareObjectWithConstructor(type, argExprs, slot, templateTypeName);
+				ASTExpressionDeclareObjectWithConstructor* declareObjectExpr = new (m_Program) ASTExpressionDeclareObjectWithConstructor(type, argExprs, slot, templateTypeName);
 				function->body.push_back(declareObjectExpr);
 				return true;
 			}
@@ -739,7 +903,7 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 				std::vector<ASTExpression*> argExprs;
 				ParseArguments(tokenizer, argExprs);
 				if (tokenizer->Expect(TokenTypeT::SEMICOLON)) return false;
-				ASTExpressionDeclareObjectWithConstructor* declareObjectExpr = new ASTExpressionDeclareObjectWithConstructor(type, argExprs, slot, templateTypeName);
+				ASTExpressionDeclareObjectWithConstructor* declareObjectExpr = new (m_Program) ASTExpressionDeclareObjectWithConstructor(type, argExprs, slot, templateTypeName);
 				function->body.push_back(declareObjectExpr);
 				return true;
 			}
@@ -747,7 +911,7 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 			{
 				ASTExpression* assignExpr = ParseExpression(tokenizer);
 				if (tokenizer->Expect(TokenTypeT::SEMICOLON)) return false;
-				ASTExpressionDeclareObjectWithAssign* declareObjectExpr = new ASTExpressionDeclareObjectWithAssign(type, slot, assignExpr, templateTypeName);
+				ASTExpressionDeclareObjectWithAssign* declareObjectExpr = new (m_Program) ASTExpressionDeclareObjectWithAssign(type, slot, assignExpr, templateTypeName);
 				function->body.push_back(declareObjectExpr);
 				return true;
 			}
@@ -816,7 +980,7 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 
 				if (tokenizer->Expect(TokenTypeT::SEMICOLON, &peek)) COMPILE_ERROR(peek.line, peek.column, "Expected ';' in array declaration", false);
 
-				ASTExpressionStackArrayDeclare* declareArrayExpr = new ASTExpressionStackArrayDeclare(type, pointerLevel, slot, arrayDimensions, initializeExprs, templateTypeName);
+				ASTExpressionStackArrayDeclare* declareArrayExpr = new (m_Program) ASTExpressionStackArrayDeclare(type, pointerLevel, slot, arrayDimensions, initializeExprs, templateTypeName);
 				function->body.push_back(declareArrayExpr);
 				return true;
 			}
@@ -828,13 +992,13 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 			if (isReference)
 			{
 				if (assignExpr == nullptr) COMPILE_ERROR(next.line, next.column, "Declared reference requires an assign value", false);
-				ASTExpressionDeclareReference* declareReferenceExpr = new ASTExpressionDeclareReference(type, pointerLevel, assignExpr, slot, templateTypeName);
+				ASTExpressionDeclareReference* declareReferenceExpr = new (m_Program) ASTExpressionDeclareReference(type, pointerLevel, assignExpr, slot, templateTypeName);
 				function->body.push_back(declareReferenceExpr);
 				return true;
 			}
 			else
 			{
-				ASTExpressionDeclarePointer* declarePointerExpr = new ASTExpressionDeclarePointer(type, pointerLevel, slot, assignExpr, templateTypeName);
+				ASTExpressionDeclarePointer* declarePointerExpr = new (m_Program) ASTExpressionDeclarePointer(type, pointerLevel, slot, assignExpr, templateTypeName);
 				function->body.push_back(declarePointerExpr);
 				return true;
 			}
@@ -870,7 +1034,7 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 			Token semicolon;
 			if (tokenizer->Expect(TokenTypeT::SEMICOLON, &semicolon)) COMPILE_ERROR(semicolon.line, semicolon.column, "Expected ';' after reference declaration", false);
 
-			ASTExpressionDeclareReference* declareReferenceExpr = new ASTExpressionDeclareReference(type, 0, assignExpr, slot, templateTypeName);
+			ASTExpressionDeclareReference* declareReferenceExpr = new (m_Program) ASTExpressionDeclareReference(type, 0, assignExpr, slot, templateTypeName);
 			function->body.push_back(declareReferenceExpr);
 			return true;
 		}
@@ -933,27 +1097,27 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 
 			if (isReference)
 			{
-				ASTExpressionDeclareReference* declareReferenceExpr = new ASTExpressionDeclareReference(classID, pointerLevel, assignExpr, slot, "", command);
+				ASTExpressionDeclareReference* declareReferenceExpr = new (m_Program) ASTExpressionDeclareReference(classID, pointerLevel, assignExpr, slot, "", command);
 				function->body.push_back(declareReferenceExpr);
 				return true;
 			}
 
 			if (pointerLevel > 0)
 			{
-				ASTExpressionDeclarePointer* declarePointerExpr = new ASTExpressionDeclarePointer(classID, pointerLevel, slot, assignExpr, "", command);
+				ASTExpressionDeclarePointer* declarePointerExpr = new (m_Program) ASTExpressionDeclarePointer(classID, pointerLevel, slot, assignExpr, "", command);
 				function->body.push_back(declarePointerExpr);
 				return true;
 			}
 
 			if (assignExpr != nullptr)
 			{
-				ASTExpressionDeclareObjectWithAssign* declareObjExpr = new ASTExpressionDeclareObjectWithAssign(classID, slot, assignExpr, "", command);
+				ASTExpressionDeclareObjectWithAssign* declareObjExpr = new (m_Program) ASTExpressionDeclareObjectWithAssign(classID, slot, assignExpr, "", command);
 				function->body.push_back(declareObjExpr);
 				return true;
 			}
 			else
 			{
-				ASTExpressionDeclareObjectWithConstructor* declareObjExpr = new ASTExpressionDeclareObjectWithConstructor(classID, argExprs, slot, "", command);
+				ASTExpressionDeclareObjectWithConstructor* declareObjExpr = new (m_Program) ASTExpressionDeclareObjectWithConstructor(classID, argExprs, slot, "", command);
 				function->body.push_back(declareObjExpr);
 				return true;
 			}
@@ -962,6 +1126,9 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 		{
 			tokenizer->SetPeek(t);
 			ASTExpression* expr = ParseExpression(tokenizer);
+			if (!expr)
+				return false;
+
 			if(expr->setIsStatement)
 				expr->isStatement = true;
 			tokenizer->Expect(TokenTypeT::SEMICOLON);
@@ -971,7 +1138,7 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 	}
 	else if (t.type == TokenTypeT::BREAKPOINT)
 	{
-		ASTExpressionBreakPoint* breakPointExpr = new ASTExpressionBreakPoint();
+		ASTExpressionBreakPoint* breakPointExpr = new (m_Program) ASTExpressionBreakPoint();
 		if (tokenizer->Expect(TokenTypeT::SEMICOLON, &t)) COMPILE_ERROR(t.line, t.length, "Expected ';' after breakpoint", false);
 		function->body.push_back(breakPointExpr);
 		return true;
@@ -992,8 +1159,7 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 		{
 			tokenizer->Expect(TokenTypeT::OPEN_BRACE);
 			pushIfScope = true;
-			Scope* scope = new Scope(m_ScopeStack.back());
-			m_ScopeStack.push_back(scope);
+			PushScope(m_ScopeStack.back());
 			while (true)
 			{
 				Token peekBody = tokenizer->PeekToken();
@@ -1004,8 +1170,7 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 				ifExprs.push_back(statement);
 			}
 
-			delete scope;
-			m_ScopeStack.pop_back();
+			PopScope();
 		}
 		else
 		{
@@ -1026,8 +1191,7 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 			{
 				tokenizer->GetToken();
 				pushElseScope = true;
-				Scope* scope = new Scope(m_ScopeStack.back());
-				m_ScopeStack.push_back(scope);
+				PushScope(m_ScopeStack.back());
 				while (true)
 				{
 					Token peekBody = tokenizer->PeekToken();
@@ -1038,8 +1202,7 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 					elseExprs.push_back(statement);
 				}
 
-				delete scope;
-				m_ScopeStack.pop_back();
+				PopScope();
 			}
 			else
 			{
@@ -1050,7 +1213,7 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 			}
 		}
 
-		ASTExpressionIfElse* ifElseExpr = new ASTExpressionIfElse(conditionExpr, pushIfScope, pushElseScope, ifExprs, elseExprs);
+		ASTExpressionIfElse* ifElseExpr = new (m_Program) ASTExpressionIfElse(conditionExpr, pushIfScope, pushElseScope, ifExprs, elseExprs);
 		function->body.push_back(ifElseExpr);
 		return true;
 	}
@@ -1096,8 +1259,7 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 		Token brace = tokenizer->PeekToken();
 		if (brace.type == TokenTypeT::OPEN_BRACE)
 		{
-			Scope* forScope = new Scope(m_ScopeStack.back());
-			m_ScopeStack.push_back(forScope);
+			PushScope(m_ScopeStack.back());
 
 			tokenizer->Expect(TokenTypeT::OPEN_BRACE);
 			while (true)
@@ -1110,8 +1272,7 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 				body.push_back(statement);
 			}
 
-			delete forScope;
-			m_ScopeStack.pop_back();
+			PopScope();
 		}
 		else
 		{
@@ -1121,7 +1282,7 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 			body.push_back(statement);
 		}
 
-		ASTExpressionFor* forExpr = new ASTExpressionFor(declareExpr, conditionExpr, incrementExpr, body);
+		ASTExpressionFor* forExpr = new (m_Program) ASTExpressionFor(declareExpr, conditionExpr, incrementExpr, body);
 		function->body.push_back(forExpr);
 		return true;
 	}
@@ -1138,8 +1299,7 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 		{
 			tokenizer->Expect(TokenTypeT::OPEN_BRACE);
 
-			Scope* scope = new Scope(m_ScopeStack.back());
-			m_ScopeStack.push_back(scope);
+			PushScope(m_ScopeStack.back());
 
 			while (true)
 			{
@@ -1151,8 +1311,7 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 				body.push_back(statement);
 			}
 
-			delete scope;
-			m_ScopeStack.pop_back();
+			PopScope();
 		}
 		else
 		{
@@ -1162,7 +1321,7 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 			body.push_back(statement);
 		}
 
-		ASTExpressionWhile* whileExpr = new ASTExpressionWhile(conditionExpr, body);
+		ASTExpressionWhile* whileExpr = new (m_Program) ASTExpressionWhile(conditionExpr, body);
 		function->body.push_back(whileExpr);
 		return true;
 	}
@@ -1170,7 +1329,7 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 	{
 		Token semicolon;
 		if (tokenizer->Expect(TokenTypeT::SEMICOLON, &semicolon)) COMPILE_ERROR(semicolon.line, semicolon.column, "Expected '{' after break", false);
-		ASTExpressionBreak* breakExpr = new ASTExpressionBreak();
+		ASTExpressionBreak* breakExpr = new (m_Program) ASTExpressionBreak();
 		function->body.push_back(breakExpr);
 		return true;
 	}
@@ -1178,7 +1337,7 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 	{
 		Token semicolon;
 		if (tokenizer->Expect(TokenTypeT::SEMICOLON, &semicolon)) COMPILE_ERROR(semicolon.line, semicolon.column, "Expected '{' after break", false);
-		ASTExpressionContinue* continueExpr = new ASTExpressionContinue();
+		ASTExpressionContinue* continueExpr = new (m_Program) ASTExpressionContinue();
 		function->body.push_back(continueExpr);
 		return true;
 	}
@@ -1188,7 +1347,7 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 		if (peek.type == TokenTypeT::SEMICOLON)
 		{
 			tokenizer->Expect(TokenTypeT::SEMICOLON);
-			ASTExpression* returnExpr = new ASTExpressionReturn(nullptr);
+			ASTExpression* returnExpr = new (m_Program) ASTExpressionReturn(nullptr);
 			function->body.push_back(returnExpr);
 			return true;
 		}
@@ -1197,11 +1356,23 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 			ASTExpression* expr = ParseExpression(tokenizer);
 			Token semicolon;
 			if (tokenizer->Expect(TokenTypeT::SEMICOLON, &semicolon)) COMPILE_ERROR(semicolon.line, semicolon.column, "Expected ';' after return expression", false);
-			ASTExpressionReturn* returnExpr = new ASTExpressionReturn(expr, m_CurrentFunctionReturnsReference);
+			ASTExpressionReturn* returnExpr = new (m_Program) ASTExpressionReturn(expr, m_CurrentFunctionReturnsReference);
 			function->body.push_back(returnExpr);
 			return true;
 		}
 	}
+	else if (t.type == TokenTypeT::YIELD)
+	{
+		ASTExpression* expr = nullptr;
+		if (tokenizer->PeekToken().type != TokenTypeT::SEMICOLON)
+			expr = ParseExpression(tokenizer);
+
+		Token semicolon;
+		if (tokenizer->Expect(TokenTypeT::SEMICOLON, &semicolon)) COMPILE_ERROR(semicolon.line, semicolon.column, "Expected ';' after yield", false);
+		ASTExpressionYield* yieldExpr = new (m_Program) ASTExpressionYield(expr);
+		function->body.push_back(yieldExpr);
+		return true;
+	}
 	else if (t.type == TokenTypeT::DELETE_T)
 	{
 		Token peek = tokenizer->PeekToken();
@@ -1217,7 +1388,7 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 		Token semicolon;
 		if (tokenizer->Expect(TokenTypeT::SEMICOLON, &semicolon)) COMPILE_ERROR(semicolon.line, semicolon.column, "Expected ';' after delete expression", false);
 		
-		ASTExpressionDelete* deleteExpr = new ASTExpressionDelete(expr, deleteArray);
+		ASTExpressionDelete* deleteExpr = new (m_Program) ASTExpressionDelete(expr, deleteArray);
 		function->body.push_back(deleteExpr);
 		return true;
 	}
@@ -1335,7 +1506,7 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 			Token semicolon;
 			if (tokenizer->Expect(TokenTypeT::SEMICOLON, &semicolon)) COMPILE_ERROR(semicolon.line, semicolon.column, "Expected ';' after array declaration", nullptr);
 
-			ASTExpressionStackArrayDeclare* arrayDeclare = new ASTExpressionStackArrayDeclare((uint16)primitiveType, pointerLevel, slot, dimensions, initializeExprs, "");
+			ASTExpressionStackArrayDeclare* arrayDeclare = new (m_Program) ASTExpressionStackArrayDeclare((uint16)primitiveType, pointerLevel, slot, dimensions, initializeExprs, "");
 			function->body.push_back(arrayDeclare);
 			return true;
 		}
@@ -1359,19 +1530,19 @@ bool Parser::ParseStatement(Function* function, Tokenizer* tokenizer)
 
 		if (isReference)
 		{
-			ASTExpressionDeclareReference* declareReferenceExpr = new ASTExpressionDeclareReference((uint16)primitiveType, pointerLevel, assignExpr, slot, "");
+			ASTExpressionDeclareReference* declareReferenceExpr = new (m_Program) ASTExpressionDeclareReference((uint16)primitiveType, pointerLevel, assignExpr, slot, "");
 			function->body.push_back(declareReferenceExpr);
 			return true;
 		}
 		else if (pointerLevel > 0)
 		{
-			ASTExpressionDeclarePointer* declarePointerExpr = new ASTExpressionDeclarePointer((uint16)primitiveType, pointerLevel, slot, assignExpr, "");
+			ASTExpressionDeclarePointer* declarePointerExpr = new (m_Program) ASTExpressionDeclarePointer((uint16)primitiveType, pointerLevel, slot, assignExpr, "");
 			function->body.push_back(declarePointerExpr);
 			return true;
 		}
 		else
 		{
-			ASTExpressionDeclarePrimitive* declarePrimitiveExpr = new ASTExpressionDeclarePrimitive(primitiveType, slot, assignExpr);
+			ASTExpressionDeclarePrimitive* declarePrimitiveExpr = new (m_Program) ASTExpressionDeclarePrimitive(primitiveType, slot, assignExpr);
 			function->body.push_back(declarePrimitiveExpr);
 			return true;
 		}
@@ -1396,37 +1567,55 @@ ASTExpression* Parser::ParseUnary(Tokenizer* tokenizer)
 	case TokenTypeT::ASTERISK: { // dereference
 		tokenizer->Expect(TokenTypeT::ASTERISK);
 		ASTExpression* expr = ParseExpression(tokenizer);
-		ASTExpressionDereference* dereferenceExpr = new ASTExpressionDereference(expr);
+		ASTExpressionDereference* dereferenceExpr = new (m_Program) ASTExpressionDereference(expr);
 		return dereferenceExpr;
 	} break;
 	case TokenTypeT::AND: { // address-of
 		tokenizer->Expect(TokenTypeT::AND);
+
+		// &Class.Function takes a function reference instead of an address
+		Tokenizer start = *tokenizer;
+		Token className = tokenizer->GetToken();
+		if (className.type == TokenTypeT::IDENTIFIER && tokenizer->GetToken().type == TokenTypeT::DOT)
+		{
+			uint16 classID = m_Program->GetClassID(std::string(className.text, className.length));
+			Token memberName = tokenizer->GetToken();
+			std::string functionName(memberName.text, memberName.length);
+			if (classID != INVALID_ID && memberName.type == TokenTypeT::IDENTIFIER && tokenizer->PeekToken().type != TokenTypeT::OPEN_PAREN &&
+				!HasStaticField(m_Program->GetClass(classID), functionName))
+			{
+				m_FunctionReferenceChecks.push_back({ classID, functionName, memberName.line, memberName.column });
+				return new (m_Program) ASTExpressionFunctionReference(classID, functionName);
+			}
+		}
+		*tokenizer = start;
+
 		ASTExpression* expr = ParseExpression(tokenizer);
-		ASTExpressionAddressOf* addressOfExpr = new ASTExpressionAddressOf(expr);
+		ASTExpressionAddressOf* addressOfExpr = new (m_Program) ASTExpressionAddressOf(expr);
 		return addressOfExpr;
 	} break;
 	case TokenTypeT::PLUS_PLUS: {
 		tokenizer->Expect(TokenTypeT::PLUS_PLUS);
 		ASTExpression* expr = ParseExpression(tokenizer);
-		ASTExpressionUnaryUpdate* unaryExpr = new ASTExpressionUnaryUpdate(expr, ASTUnaryUpdateOp::PRE_INC);
+		ASTExpressionUnaryUpdate* unaryExpr = new (m_Program) ASTExpressionUnaryUpdate(expr, ASTUnaryUpdateOp::PRE_INC);
 		return unaryExpr;
 	} break;
 	case TokenTypeT::MINUS_MINUS: {
 		tokenizer->Expect(TokenTypeT::MINUS_MINUS);
 		ASTExpression* expr = ParseExpression(tokenizer);
-		ASTExpressionUnaryUpdate* unaryExpr = new ASTExpressionUnaryUpdate(expr, ASTUnaryUpdateOp::PRE_DEC);
+		ASTExpressionUnaryUpdate* unaryExpr = new (m_Program) ASTExpressionUnaryUpdate(expr, ASTUnaryUpdateOp::PRE_DEC);
 		return unaryExpr;
 	} break;
 	case TokenTypeT::NOT: { // logical not
 		tokenizer->Expect(TokenTypeT::NOT);
 		ASTExpression* expr = ParseExpression(tokenizer);
-		ASTExpressionInvert* invertExpr = new ASTExpressionInvert(expr);
+		ASTExpressionInvert* invertExpr = new (m_Program) ASTExpressionInvert(expr);
 		return invertExpr;
 	} break;
 	case TokenTypeT::MINUS: { // unary negation
 		tokenizer->Expect(TokenTypeT::MINUS);
 		ASTExpression* expr = ParseExpression(tokenizer);
-		ASTExpressionNegate* negateExpr = new ASTExpressionNegate(expr);
+		ASTExpressionNegate* negateExpr = new (m_Program) ASTExpressionNegate(expr);
 		return negateExpr;
 	} break;
 	case TokenTypeT::OPEN_PAREN: {
@@ -1461,7 +1650,7 @@ ASTExpression* Parser::ParseUnary(Tokenizer* tokenizer)
 		if (tokenizer->Expect(TokenTypeT::CLOSE_PAREN, &closeParen)) COMPILE_ERROR(closeParen.line, closeParen.column, "Expected ')' in cast", nullptr);
 
 		ASTExpression* expr = ParseExpression(tokenizer);
-		ASTExpressionCast* castExpr = new ASTExpressionCast(expr, type, pointerLevel, templateTypeName);
+		ASTExpressionCast* castExpr = new (m_Program) ASTExpressionCast(expr, type, pointerLevel, templateTypeName);
 		return castExpr;
 	} break;
 	default:
@@ -1568,7 +1757,7 @@ ASTExpression* Parser::ParseBinaryOpRHS(int32 exprPrec, ASTExpression* lhs, Toke
 		default: return lhs; // shouldnt happen
 		}
 
-		lhs = new ASTExpressionBinary(lhs, rhs, opEnum);
+		lhs = new (m_Program) ASTExpressionBinary(lhs, rhs, opEnum);
 	}
 }
 
@@ -1583,48 +1772,48 @@ ASTExpression* Parser::ParsePostFix(Tokenizer* tokenizer)
 		if (tok.type == TokenTypeT::PLUS_PLUS)
 		{
 			tokenizer->GetToken();
-			ASTExpressionUnaryUpdate* unaryExpr = new ASTExpressionUnaryUpdate(expr, ASTUnaryUpdateOp::POST_INC);
+			ASTExpressionUnaryUpdate* unaryExpr = new (m_Program) ASTExpressionUnaryUpdate(expr, ASTUnaryUpdateOp::POST_INC);
 			return unaryExpr;
 		}
 		else if (tok.type == TokenTypeT::MINUS_MINUS)
 		{
 			tokenizer->GetToken();
-			ASTExpressionUnaryUpdate* unaryExpr = new ASTExpressionUnaryUpdate(expr, ASTUnaryUpdateOp::POST_DEC);
+			ASTExpressionUnaryUpdate* unaryExpr = new (m_Program) ASTExpressionUnaryUpdate(expr, ASTUnaryUpdateOp::POST_DEC);
 			return unaryExpr;
 		}
 		else if (tok.type == TokenTypeT::PLUS_EQUALS)
 		{
 			tokenizer->GetToken();
 			ASTExpression* amountExpr = ParseExpression(tokenizer);
-			ASTExpressionArithmaticEquals* aritmaticPlusEqualsExpr = new ASTExpressionArithmaticEquals(expr, amountExpr, Operator::ADD);
+			ASTExpressionArithmaticEquals* aritmaticPlusEqualsExpr = new (m_Program) ASTExpressionArithmaticEquals(expr, amountExpr, Operator::ADD);
 			return aritmaticPlusEqualsExpr;
 		}
 		else if (tok.type == TokenTypeT::MINUS_EQUALS)
 		{
 			tokenizer->GetToken();
 			ASTExpression* amountExpr = ParseExpression(tokenizer);
-			ASTExpressionArithmaticEquals* aritmaticMinusEqualsExpr = new ASTExpressionArithmaticEquals(expr, amountExpr, Operator::MINUS);
+			ASTExpressionArithmaticEquals* aritmaticMinusEqualsExpr = new (m_Program) ASTExpressionArithmaticEquals(expr, amountExpr, Operator::MINUS);
 			return aritmaticMinusEqualsExpr;
 		}
 		else if (tok.type == TokenTypeT::TIMES_EQUALS)
 		{
 			tokenizer->GetToken();
 			ASTExpression* amountExpr = ParseExpression(tokenizer);
-			ASTExpressionArithmaticEquals* aritmaticTimesEqualsExpr = new ASTExpressionArithmaticEquals(expr, amountExpr, Operator::MULTIPLY);
+			ASTExpressionArithmaticEquals* aritmaticTimesEqualsExpr = new (m_Program) ASTExpressionArithmaticEquals(expr, amountExpr, Operator::MULTIPLY);
 			return aritmaticTimesEqualsExpr;
 		}
 		else if (tok.type == TokenTypeT::DIVIDE_EQUALS)
 		{
 			tokenizer->GetToken();
 			ASTExpression* amountExpr = ParseExpression(tokenizer);
-			ASTExpressionArithmaticEquals* aritmaticDivideEqualsExpr = new ASTExpressionArithmaticEquals(expr, amountExpr, Operator::DIVIDE);
+			ASTExpressionArithmaticEquals* aritmaticDivideEqualsExpr = new (m_Program) ASTExpressionArithmaticEquals(expr, amountExpr, Operator::DIVIDE);
 			return aritmaticDivideEqualsExpr;
 		}
 		else if (tok.type == TokenTypeT::MOD_EQUALS)
 		{
 			tokenizer->GetToken();
 			ASTExpression* amountExpr = ParseExpression(tokenizer);
-			ASTExpressionArithmaticEquals* aritmaticPlusEqualsExpr = new ASTExpressionArithmaticEquals(expr, amountExpr, Operator::MOD);
+			ASTExpressionArithmaticEquals* aritmaticPlusEqualsExpr = new (m_Program) ASTExpressionArithmaticEquals(expr, amountExpr, Operator::MOD);
 			return aritmaticPlusEqualsExpr;
 		}
 		else
@@ -1645,12 +1834,12 @@ ASTExpression* Parser::ParsePrimary(Tokenizer* tokenizer)
 		std::string numStr(t.text, t.length);
 		if (numStr.find('.') != std::string::npos)
 		{
-			ASTExpressionLiteral* literalExpr = new ASTExpressionLiteral(Value::MakeReal64(std::stod(numStr), m_Program->GetInitializationAllocator()));
+			ASTExpressionLiteral* literalExpr = new (m_Program) ASTExpressionLiteral(Value::MakeReal64(std::stod(numStr), m_Program->GetInitializationAllocator()));
 			return literalExpr;
 		}
 		else
 		{
-			ASTExpressionLiteral* literalExpr = new ASTExpressionLiteral(Value::MakeInt64(std::stoll(numStr), m_Program->GetInitializationAllocator()));
+			ASTExpressionLiteral* literalExpr = new (m_Program) ASTExpressionLiteral(Value::MakeInt64(std::stoll(numStr), m_Program->GetInitializationAllocator()));
 			return literalExpr;
 		}
 	}
@@ -1674,7 +1863,7 @@ ASTExpression* Parser::ParsePrimary(Tokenizer* tokenizer)
 		}
 		Value literal = Value::MakeCStr(str, m_Program->GetHeapAllocator());
 		m_Program->AddToStringPool((char*)literal.data);
-		ASTExpressionLiteral* literalExpr = new ASTExpressionLiteral(literal);
+		ASTExpressionLiteral* literalExpr = new (m_Program) ASTExpressionLiteral(literal);
 		return literalExpr;
 	}
 	else if (t.type == TokenTypeT::CHAR_LITERAL)
@@ -1704,23 +1893,23 @@ ASTExpression* Parser::ParsePrimary(Tokenizer* tokenizer)
 			c = '?';
 		}
 
-		ASTExpressionLiteral* literalExpr = new ASTExpressionLiteral(Value::MakeChar(c, m_Program->GetInitializationAllocator()));
+		ASTExpressionLiteral* literalExpr = new (m_Program) ASTExpressionLiteral(Value::MakeChar(c, m_Program->GetInitializationAllocator()));
 
 		return literalExpr;
 	}
 	else if (t.type == TokenTypeT::TRUE_T)
 	{
-		ASTExpressionLiteral* literalExpr = new ASTExpressionLiteral(Value::MakeBool(true, m_Program->GetInitializationAllocator()));
+		ASTExpressionLiteral* literalExpr = new (m_Program) ASTExpressionLiteral(Value::MakeBool(true, m_Program->GetInitializationAllocator()));
 		return literalExpr;
 	}
 	else if (t.type == TokenTypeT::FALSE_T)
 	{
-		ASTExpressionLiteral* literalExpr = new ASTExpressionLiteral(Value::MakeBool(false, m_Program->GetInitializationAllocator()));
+		ASTExpressionLiteral* literalExpr = new (m_Program) ASTExpressionLiteral(Value::MakeBool(false, m_Program->GetInitializationAllocator()));
 		return literalExpr;
 	}
 	else if (t.type == TokenTypeT::NULLPTR)
 	{
-		ASTExpressionLiteral* literalExpr = new ASTExpressionLiteral(Value::MakeNULL());
+		ASTExpressionLiteral* literalExpr = new (m_Program) ASTExpressionLiteral(Value::MakeNULL());
 		return literalExpr;
 	}
 	else if (t.type == TokenTypeT::OPEN_PAREN)
@@ -1743,7 +1932,7 @@ ASTExpression* Parser::ParsePrimary(Tokenizer* tokenizer)
 				std::vector<std::pair<std::string, bool>> members;
 				bool functionCall = false;
 				ParseMembers(tokenizer, members, &functionCall);
-				expr = new ASTExpressionDereference(expr);
+				expr = new (m_Program) ASTExpressionDereference(expr);
 				expr = ParseExpressionChain(tokenizer, expr, members, functionCall);
 			}
 		}
@@ -1752,6 +1941,14 @@ ASTExpression* Parser::ParsePrimary(Tokenizer* tokenizer)
 	}
 	else if (t.type == TokenTypeT::NEW)
 	{
+		ASTExpression* arenaExpr = nullptr;
+		if (tokenizer->PeekToken().type == TokenTypeT::OPEN_PAREN) // new (arena) T
+		{
+			tokenizer->Expect(TokenTypeT::OPEN_PAREN);
+			arenaExpr = ParseExpression(tokenizer);
+			if (tokenizer->Expect(TokenTypeT::CLOSE_PAREN, &t)) COMPILE_ERROR(t.line, t.column, "Expected ')' after arena in 'new'", nullptr);
+		}
+
 		Token typeToken = tokenizer->GetToken();
 		if (typeToken.type != TokenTypeT::IDENTIFIER && !Tokenizer::IsTokenPrimitiveType(typeToken)) COMPILE_ERROR(typeToken.line, typeToken.column, "Expected identifier or primitive type after 'new'", nullptr);
 		uint16 type = ParseType(typeToken);
@@ -1780,7 +1977,7 @@ ASTExpression* Parser::ParsePrimary(Tokenizer* tokenizer)
 			ASTExpression* sizeExpr = ParseExpression(tokenizer);
 			tokenizer->Expect(TokenTypeT::CLOSE_BRACKET);
 
-			ASTExpressionNewArray* newArrayExpr = new ASTExpressionNewArray(type, pointerLevel, sizeExpr, templateTypeName);
+			ASTExpressionNewArray* newArrayExpr = new (m_Program) ASTExpressionNewArray(type, pointerLevel, sizeExpr, templateTypeName, arenaExpr);
 			return newArrayExpr;
 		}
 		else if (peek.type == TokenTypeT::OPEN_PAREN)
@@ -1788,7 +1985,7 @@ ASTExpression* Parser::ParsePrimary(Tokenizer* tokenizer)
 			tokenizer->Expect(TokenTypeT::OPEN_PAREN);
 			std::vector<ASTExpression*> argExprs;
 			ParseArguments(tokenizer, argExprs);
-			ASTExpressionNew* newExpr = new ASTExpressionNew(type, argExprs, templateTypeName);
+			ASTExpressionNew* newExpr = new (m_Program) ASTExpressionNew(type, argExprs, templateTypeName, arenaExpr);
 			return newExpr;
 		}
 		else
@@ -1801,12 +1998,16 @@ ASTExpression* Parser::ParsePrimary(Tokenizer* tokenizer)
 		if (tokenizer->Expect(TokenTypeT::OPEN_PAREN, &t)) COMPILE_ERROR(t.line, t.column, "Expected '(' after strlen", nullptr);
 		ASTExpression* expr = ParseExpression(tokenizer);
 		if (tokenizer->Expect(TokenTypeT::CLOSE_PAREN, &t)) COMPILE_ERROR(t.line, t.column, "Expected ')' after strlen expression", nullptr);
-		ASTExpressionStrlen* strlenExpr = new ASTExpressionStrlen(expr);
+		ASTExpressionStrlen* strlenExpr = new (m_Program) ASTExpressionStrlen(expr);
 		return strlenExpr;
 	}
-	else if (t.type == TokenTypeT::SIZE_OF)
+	else if (t.type == TokenTypeT::SIZE_OF || t.type == TokenTypeT::IS_TRIVIAL || t.type == TokenTypeT::FIELD_COUNT ||
+		t.type == TokenTypeT::FIELD_OFFSET || t.type == TokenTypeT::FIELD_SIZE)
 	{
-		if (tokenizer->Expect(TokenTypeT::OPEN_PAREN, &t)) COMPILE_ERROR(t.line, t.column, "Expected '(' after sizeof", nullptr);
+		TokenTypeT keywordType = t.type;
+		bool isTrivial = t.type == TokenTypeT::IS_TRIVIAL;
+		std::string keyword(t.text, t.length);
+		if (tokenizer->Expect(TokenTypeT::OPEN_PAREN, &t)) COMPILE_ERROR(t.line, t.column, "Expected '(' after " + keyword, nullptr);
 		Token typeToken = tokenizer->GetToken();
 		uint16 type = ParseType(typeToken);
 		uint8 pointerLevel = ParsePointerLevel(tokenizer);
@@ -1830,10 +2031,42 @@ ASTExpression* Parser::ParsePrimary(Tokenizer* tokenizer)
 				return nullptr;
 		}
 
-		if (tokenizer->Expect(TokenTypeT::CLOSE_PAREN, &t)) COMPILE_ERROR(t.line, t.column, "Expected ')' after sizeof expression", nullptr);
-		ASTExpressionSizeOfStatic* sizeofExpr = new ASTExpressionSizeOfStatic(type, pointerLevel > 0, templateTypeName);
+		ASTExpression* indexExpr = nullptr;
+		if (keywordType == TokenTypeT::FIELD_OFFSET || keywordType == TokenTypeT::FIELD_SIZE)
+		{
+			if (tokenizer->Expect(TokenTypeT::COMMA, &t)) COMPILE_ERROR(t.line, t.column, "Expected ',' and a field index after the type in " + keyword, nullptr);
+			indexExpr = ParseExpression(tokenizer);
+		}
+
+		if (tokenizer->Expect(TokenTypeT::CLOSE_PAREN, &t)) COMPILE_ERROR(t.line, t.column, "Expected ')' after " + keyword + " expression", nullptr);
+		if (isTrivial)
+			return new (m_Program) ASTExpressionIsTrivial(type, pointerLevel > 0, templateTypeName);
+
+		if (keywordType == TokenTypeT::FIELD_COUNT)
+			return new (m_Program) ASTExpressionFieldInfo(type, pointerLevel > 0, templateTypeName, FieldQuery::COUNT, nullptr);
+		if (keywordType == TokenTypeT::FIELD_OFFSET)
+			return new (m_Program) ASTExpressionFieldInfo(type, pointerLevel > 0, templateTypeName, FieldQuery::OFFSET, indexExpr);
+		if (keywordType == TokenTypeT::FIELD_SIZE)
+			return new (m_Program) ASTExpressionFieldInfo(type, pointerLevel > 0, templateTypeName, FieldQuery::SIZE, indexExpr);
+
+		ASTExpressionSizeOfStatic* sizeofExpr = new (m_Program) ASTExpressionSizeOfStatic(type, pointerLevel > 0, templateTypeName);
 		return sizeofExpr;
 	}
+	else if (t.type == TokenTypeT::FIELD_INDEX)
+	{
+		if (tokenizer->Expect(TokenTypeT::OPEN_PAREN, &t)) COMPILE_ERROR(t.line, t.column, "Expected '(' after fieldindex", nullptr);
+		Token typeToken = tokenizer->GetToken();
+		uint16 type = ParseType(typeToken);
+		if (type == INVALID_ID || Value::IsPrimitiveType(type)) COMPILE_ERROR(typeToken.line, typeToken.column, "fieldindex expects a class type", nullptr);
+		if (tokenizer->Expect(TokenTypeT::DOT, &t)) COMPILE_ERROR(t.line, t.column, "Expected '.' and a field name in fieldindex", nullptr);
+		Token memberToken;
+		if (tokenizer->Expect(TokenTypeT::IDENTIFIER, &memberToken)) COMPILE_ERROR(memberToken.line, memberToken.column, "Expected field name in fieldindex", nullptr);
+		if (tokenizer->Expect(TokenTypeT::CLOSE_PAREN, &t)) COMPILE_ERROR(t.line, t.column, "Expected ')' after fieldindex expression", nullptr);
+
+		std::string member(memberToken.text, memberToken.length);
+		m_FieldIndexChecks.push_back({ type, member, memberToken.line, memberToken.column });
+		return new (m_Program) ASTExpressionFieldIndex(type, member);
+	}
 	else if (t.type == TokenTypeT::OFFSETOF)
 	{
 		if (tokenizer->Expect(TokenTypeT::OPEN_PAREN)) return nullptr;
@@ -1847,7 +2080,7 @@ ASTExpression* Parser::ParsePrimary(Tokenizer* tokenizer)
 		std::vector<std::string> members;
 		members.push_back(std::string(memberToken.text, memberToken.length));
 
-		ASTExpressionOffsetOf* offsetofExpr = new ASTExpressionOffsetOf(type, members);
+		ASTExpressionOffsetOf* offsetofExpr = new (m_Program) ASTExpressionOffsetOf(type, members);
 		return offsetofExpr;
 	}
 	else if (t.type == TokenTypeT::INT_TO_STR)
@@ -1855,7 +2088,7 @@ ASTExpression* Parser::ParsePrimary(Tokenizer* tokenizer)
 		if (tokenizer->Expect(TokenTypeT::OPEN_PAREN)) COMPILE_ERROR(t.line, t.column, "Expected '(' after int_to_str", nullptr);;
 		ASTExpression* expr = ParseExpression(tokenizer);
 		if (tokenizer->Expect(TokenTypeT::CLOSE_PAREN, &t)) COMPILE_ERROR(t.line, t.column, "Expected ')' after int_to_str expression", nullptr);
-		ASTExpressionIntToStr* intToStrExpr = new ASTExpressionIntToStr(expr);
+		ASTExpressionIntToStr* intToStrExpr = new (m_Program) ASTExpressionIntToStr(expr);
 		return intToStrExpr;
 	}
 	else if (t.type == TokenTypeT::STR_TO_INT)
@@ -1863,7 +2096,7 @@ ASTExpression* Parser::ParsePrimary(Tokenizer* tokenizer)
 		if (tokenizer->Expect(TokenTypeT::OPEN_PAREN)) COMPILE_ERROR(t.line, t.column, "Expected '(' after str_to_int", nullptr);;
 		ASTExpression* expr = ParseExpression(tokenizer);
 		if (tokenizer->Expect(TokenTypeT::CLOSE_PAREN, &t)) COMPILE_ERROR(t.line, t.column, "Expected ')' after str_to_int expression", nullptr);
-		ASTExpressionStrToInt* strToIntExpr = new ASTExpressionStrToInt(expr);
+		ASTExpressionStrToInt* strToIntExpr = new (m_Program) ASTExpressionStrToInt(expr);
 		return strToIntExpr;
 	}
 	else if (t.type == TokenTypeT::IDENTIFIER || t.type == TokenTypeT::THIS)
@@ -1873,7 +2106,7 @@ ASTExpression* Parser::ParsePrimary(Tokenizer* tokenizer)
 		if (t.type == TokenTypeT::THIS && next.type != TokenTypeT::ARROW)
 		{
 			tokenizer->SetPeek(next);
-			ASTExpressionThis* thisExpr = new ASTExpressionThis(m_Program->GetClassID(m_CurrentClassName));
+			ASTExpressionThis* thisExpr = new (m_Program) ASTExpressionThis(m_Program->GetClassID(m_CurrentClassName));
 			return thisExpr;
 		}
 
@@ -1890,7 +2123,7 @@ ASTExpression* Parser::ParsePrimary(Tokenizer* tokenizer)
 			{
 				if (functionName == definition.parameters[i].name)
 				{
-					ASTExpressionConstructorCall* constructorCallExpr = new ASTExpressionConstructorCall((uint16)ValueType::TEMPLATE_TYPE, argExprs, functionName);
+					ASTExpressionConstructorCall* constructorCallExpr = new (m_Program) ASTExpressionConstructorCall((uint16)ValueType::TEMPLATE_TYPE, argExprs, functionName);
 					return constructorCallExpr;
 				}
 			}
@@ -1898,11 +2131,11 @@ ASTExpression* Parser::ParsePrimary(Tokenizer* tokenizer)
 			Class* constructorClass = m_Program->GetClassByName(functionName);
 			if (constructorClass)
 			{
-				ASTExpressionConstructorCall* constructorCallExpr = new ASTExpressionConstructorCall(m_Program->GetClassID(functionName), argExprs, "");
+				ASTExpressionConstructorCall* constructorCallExpr = new (m_Program) ASTExpressionConstructorCall(m_Program->GetClassID(functionName), argExprs, "");
 				return constructorCallExpr;
 			}
 
-			ASTExpressionStaticFunctionCall* functionCallExpr = new ASTExpressionStaticFunctionCall(classID, functionName, argExprs);
+			ASTExpressionStaticFunctionCall* functionCallExpr = new (m_Program) ASTExpressionStaticFunctionCall(classID, functionName, argExprs);
 			return functionCallExpr;
 		}
 		else if (next.type == TokenTypeT::DOT)
@@ -1942,15 +2175,15 @@ ASTExpression* Parser::ParsePrimary(Tokenizer* tokenizer)
 				
 				if (offset == UINT64_MAX)
 				{
-					ASTExpressionThis* thisExpr = new ASTExpressionThis(thisClassID);
-					ASTExpression* dereferenceThis = new ASTExpressionDereference(thisExpr);
-					ASTExpressionPushMember* pushMemberExpr = new ASTExpressionPushMember(dereferenceThis, members);
-					ASTExpressionSet* setExpr = new ASTExpressionSet(pushMemberExpr, assignExpr);
+					ASTExpressionThis* thisExpr = new (m_Program) ASTExpressionThis(thisClassID);
+					ASTExpression* dereferenceThis = new (m_Program) ASTExpressionDereference(thisExpr);
+					ASTExpressionPushMember* pushMemberExpr = new (m_Program) ASTExpressionPushMember(dereferenceThis, members);
+					ASTExpressionSet* setExpr = new (m_Program) ASTExpressionSet(pushMemberExpr, assignExpr);
 					return setExpr;
 				}
 
-				ASTExpressionStaticVariable* staticVariableExpr = new ASTExpressionStaticVariable(thisClassID, offset, typeInfo, isArray);
-				ASTExpressionSet* setExpr = new ASTExpressionSet(staticVariableExpr, assignExpr);
+				ASTExpressionStaticVariable* staticVariableExpr = new (m_Program) ASTExpressionStaticVariable(thisClassID, offset, typeInfo, isArray);
+				ASTExpressionSet* setExpr = new (m_Program) ASTExpressionSet(staticVariableExpr, assignExpr);
 				return setExpr;
 				
 			}
@@ -1958,8 +2191,8 @@ ASTExpression* Parser::ParsePrimary(Tokenizer* tokenizer)
 			{
 				ScopeLocalDeclaration declaration = m_ScopeStack.back()->GetDeclarationInfo(slot);;
 				
-				ASTExpressionPushLocal* localExpr = new ASTExpressionPushLocal(slot, declaration.type, declaration.templateTypeName, declaration.command);
-				ASTExpressionSet* setExpr = new ASTExpressionSet(localExpr, assignExpr);
+				ASTExpressionPushLocal* localExpr = new (m_Program) ASTExpressionPushLocal(slot, declaration.type, declaration.templateTypeName, declaration.command);
+				ASTExpressionSet* setExpr = new (m_Program) ASTExpressionSet(localExpr, assignExpr);
 				return setExpr;
 			}
 		}
@@ -1990,11 +2223,11 @@ ASTExpression* Parser::ParsePrimary(Tokenizer* tokenizer)
 				TypeInfo typeInfo;
 				bool isArray = false;
 				uint64 offset = cls->CalculateMemberOffset(m_Program, members, &typeInfo, &isArray);
-				ASTExpressionPushMember* pushMemberExpr = new ASTExpressionPushMember(new ASTExpressionDereference(new ASTExpressionThis(classID)), members);
-				ASTExpressionPushIndex* indexExpr = new ASTExpressionPushIndex(pushMemberExpr, indexExprs);
+				ASTExpressionPushMember* pushMemberExpr = new (m_Program) ASTExpressionPushMember(new (m_Program) ASTExpressionDereference(new (m_Program) ASTExpressionThis(classID)), members);
+				ASTExpressionPushIndex* indexExpr = new (m_Program) ASTExpressionPushIndex(pushMemberExpr, indexExprs);
 				if (assignExpr)
 				{
-					expr = new ASTExpressionSet(indexExpr, assignExpr);
+					expr = new (m_Program) ASTExpressionSet(indexExpr, assignExpr);
 				}
 				else
 				{
@@ -2003,11 +2236,11 @@ ASTExpression* Parser::ParsePrimary(Tokenizer* tokenizer)
 			}
 			else
 			{
-				ASTExpressionPushLocal* variableExpr = new ASTExpressionPushLocal(slot, declaration.type, declaration.templateTypeName, declaration.command);
-				ASTExpressionPushIndex* indexExpr = new ASTExpressionPushIndex(variableExpr, indexExprs);
+				ASTExpressionPushLocal* variableExpr = new (m_Program) ASTExpressionPushLocal(slot, declaration.type, declaration.templateTypeName, declaration.command);
+				ASTExpressionPushIndex* indexExpr = new (m_Program) ASTExpressionPushIndex(variableExpr, indexExprs);
 				if (assignExpr)
 				{
-					expr = new ASTExpressionSet(indexExpr, assignExpr);
+					expr = new (m_Program) ASTExpressionSet(indexExpr, assignExpr);
 				}
 				else
 				{
@@ -2045,25 +2278,28 @@ ASTExpression* Parser::ParsePrimary(Tokenizer* tokenizer)
 					members.push_back(variableName);
 					uint16 thisClassID = m_Program->GetClassID(m_CurrentClassName);
 					Class* cls = m_Program->GetClass(thisClassID);
+					if (IsTemplateIntegerParameter(cls, variableName))
+						return new (m_Program) ASTExpressionTemplateInteger(variableName);
+
 					TypeInfo staticTypeInfo;
 					bool isArray = false;
 					uint64 staticOffset = cls->CalculateStaticOffset(m_Program, members, &staticTypeInfo, &isArray);
 					if (staticOffset == UINT64_MAX)
 					{
-						ASTExpressionThis* thisExpr = new ASTExpressionThis(thisClassID);
-						ASTExpressionDereference* dereferenceThisExpr = new ASTExpressionDereference(thisExpr);
-						ASTExpressionPushMember* pushMemberExpr = new ASTExpressionPushMember(dereferenceThisExpr, members);
+						ASTExpressionThis* thisExpr = new (m_Program) ASTExpressionThis(thisClassID);
+						ASTExpressionDereference* dereferenceThisExpr = new (m_Program) ASTExpressionDereference(thisExpr);
+						ASTExpressionPushMember* pushMemberExpr = new (m_Program) ASTExpressionPushMember(dereferenceThisExpr, members);
 						return pushMemberExpr;
 					}
 					else
 					{
-						ASTExpressionStaticVariable* staticVariableExpr = new ASTExpressionStaticVariable(thisClassID, staticOffset, staticTypeInfo, isArray);
+						ASTExpressionStaticVariable* staticVariableExpr = new (m_Program) ASTExpressionStaticVariable(thisClassID, staticOffset, staticTypeInfo, isArray);
 						return staticVariableExpr;
 					}
 				}
 				else
 				{
-					ASTExpressionPushLocal* localExpr = new ASTExpressionPushLocal(slot, declaration.type, declaration.templateTypeName, declaration.command);
+					ASTExpressionPushLocal* localExpr = new (m_Program) ASTExpressionPushLocal(slot, declaration.type, declaration.templateTypeName, declaration.command);
 					return localExpr;
 				}
 			}
@@ -2095,7 +2331,7 @@ ASTExpression* Parser::ParsePrimary(Tokenizer* tokenizer)
 				type = (uint16)ValueType::TEMPLATE_TYPE;
 			}
 
-			ASTExpressionConstructorCall* constructorCallExpr = new ASTExpressionConstructorCall(type, argExprs, "", command);
+			ASTExpressionConstructorCall* constructorCallExpr = new (m_Program) ASTExpressionConstructorCall(type, argExprs, "", command);
 			return constructorCallExpr;
 		}
 		else
@@ -2111,25 +2347,28 @@ ASTExpression* Parser::ParsePrimary(Tokenizer* tokenizer)
 				members.push_back(variableName);
 				uint16 thisClassID = m_Program->GetClassID(m_CurrentClassName);
 				Class* cls = m_Program->GetClass(thisClassID);
+				if (IsTemplateIntegerParameter(cls, variableName))
+					return new (m_Program) ASTExpressionTemplateInteger(variableName);
+
 				TypeInfo staticTypeInfo;
 				bool isArray = false;
 				uint64 staticOffset = cls->CalculateStaticOffset(m_Program, members, &staticTypeInfo, &isArray);
 				if (staticOffset == UINT64_MAX)
 				{
-					ASTExpressionThis* thisExpr = new ASTExpressionThis(thisClassID);
-					ASTExpressionDereference* dereferenceThisExpr = new ASTExpressionDereference(thisExpr);
-					ASTExpressionPushMember* pushMemberExpr = new ASTExpressionPushMember(dereferenceThisExpr, members);
+					ASTExpressionThis* thisExpr = new (m_Program) ASTExpressionThis(thisClassID);
+					ASTExpressionDereference* dereferenceThisExpr = new (m_Program) ASTExpressionDereference(thisExpr);
+					ASTExpressionPushMember* pushMemberExpr = new (m_Program) ASTExpressionPushMember(dereferenceThisExpr, members);
 					return pushMemberExpr;
 				}
 				else
 				{
-					ASTExpressionStaticVariable* staticVariableExpr = new ASTExpressionStaticVariable(thisClassID, staticOffset, staticTypeInfo, isArray);
+					ASTExpressionStaticVariable* staticVariableExpr = new (m_Program) ASTExpressionStaticVariable(thisClassID, staticOffset, staticTypeInfo, isArray);
 					return staticVariableExpr;
 				}
 			}
 			else
 			{
-				ASTExpressionPushLocal* localExpr = new ASTExpressionPushLocal(slot, declaration.type, declaration.templateTypeName, declaration.command);
+				ASTExpressionPushLocal* localExpr = new (m_Program) ASTExpressionPushLocal(slot, declaration.type, declaration.templateTypeName, declaration.command);
 				return localExpr;
 			}
 		}
@@ -2251,12 +2490,29 @@ ASTExpression* Parser::ParseExpressionChain(Tokenizer* tokenizer, ASTExpression*
 			Token next = tokenizer->GetToken();
 			if (next.type == TokenTypeT::OPEN_PAREN)
 			{
+				if (moduleID == HOST_MODULE_ID && m_Program->GetHostFunctionID(identifier) == INVALID_ID)
+					COMPILE_ERROR(next.line, next.column, "Host function " + identifier + " was not registered", nullptr);
+
+				if (moduleID >= PLUGIN_MODULE_ID_BASE && m_Program->GetPlugin(moduleID)->FindFunction(identifier) == INVALID_ID)
+					COMPILE_ERROR(next.line, next.column, "Module " + memberName + " has no function " + identifier, nullptr);
+
 				std::vector<ASTExpression*> argExprs;
 				ParseArguments(tokenizer, argExprs);
+
+				if (moduleID >= PLUGIN_MODULE_ID_BASE)
+				{
+					PluginModule* plugin = m_Program->GetPlugin(moduleID);
+					uint32 numParameters = plugin->GetNumParameters(plugin->FindFunction(identifier));
+					if (argExprs.size() != numParameters)
+						COMPILE_ERROR(next.line, next.column, memberName + "." + identifier + " takes " + std::to_string(numParameters) + " arguments", nullptr);
+				}
 				chainExpr = MakeModuleFunctionCall(moduleID, memberName, identifier, argExprs);
 			}
 			else
 			{
+				if (moduleID >= PLUGIN_MODULE_ID_BASE && m_Program->GetPlugin(moduleID)->FindConstant(identifier) == INVALID_ID)
+					COMPILE_ERROR(next.line, next.column, "Module " + memberName + " has no constant " + identifier, nullptr);
+
 				chainExpr = MakeModuleConstant(moduleID, memberName, identifier);
 				tokenizer->SetPeek(peek);
 			}
@@ -2275,7 +2531,7 @@ ASTExpression* Parser::ParseExpressionChain(Tokenizer* tokenizer, ASTExpression*
 				std::string functionCall = members[++i].first;
 				
 
-				chainExpr = new ASTExpressionStaticFunctionCall(classID, functionCall, argExprs);
+				chainExpr = new (m_Program) ASTExpressionStaticFunctionCall(classID, functionCall, argExprs);
 				Token peek = tokenizer->PeekToken();
 				if (peek.type == TokenTypeT::DOT ||
 					peek.type == TokenTypeT::ARROW)
@@ -2301,10 +2557,10 @@ ASTExpression* Parser::ParseExpressionChain(Tokenizer* tokenizer, ASTExpression*
 					}
 				}
 
-				chainExpr = new ASTExpressionStaticVariable(classID, updatedMembers);
+				chainExpr = new (m_Program) ASTExpressionStaticVariable(classID, updatedMembers);
 				if (!arrayIndices.empty())
 				{
-					chainExpr = new ASTExpressionPushIndex(chainExpr, arrayIndices);
+					chainExpr = new (m_Program) ASTExpressionPushIndex(chainExpr, arrayIndices);
 				}
 				tokenizer->SetPeek(peek);
 			}
@@ -2316,8 +2572,8 @@ ASTExpression* Parser::ParseExpressionChain(Tokenizer* tokenizer, ASTExpression*
 		{
 			if (members[0].first == "this")
 			{
-				objExpr = new ASTExpressionThis(m_Program->GetClassID(m_CurrentClassName));
-				objExpr = new ASTExpressionDereference(objExpr);
+				objExpr = new (m_Program) ASTExpressionThis(m_Program->GetClassID(m_CurrentClassName));
+				objExpr = new (m_Program) ASTExpressionDereference(objExpr);
 			}
 			else
 			{
@@ -2334,23 +2590,23 @@ ASTExpression* Parser::ParseExpressionChain(Tokenizer* tokenizer, ASTExpression*
 					uint64 staticOffset = cls->CalculateStaticOffset(m_Program, membs, &typeInfo, &isArray);
 					if (staticOffset == UINT64_MAX)
 					{
-						ASTExpression* thisExpr = new ASTExpressionThis(classID);
-						thisExpr = new ASTExpressionDereference(thisExpr);
+						ASTExpression* thisExpr = new (m_Program) ASTExpressionThis(classID);
+						thisExpr = new (m_Program) ASTExpressionDereference(thisExpr);
 
-						objExpr = new ASTExpressionPushMember(thisExpr, membs);
+						objExpr = new (m_Program) ASTExpressionPushMember(thisExpr, membs);
 					}
 					else
 					{
-						ASTExpressionStaticVariable* staticVariableExpr = new ASTExpressionStaticVariable(classID, staticOffset, typeInfo, isArray);
+						ASTExpressionStaticVariable* staticVariableExpr = new (m_Program) ASTExpressionStaticVariable(classID, staticOffset, typeInfo, isArray);
 						objExpr = staticVariableExpr;
 					}
 				}
 				else
 				{
 					ScopeLocalDeclaration declaration = m_ScopeStack.back()->GetDeclarationInfo(slot);
-					objExpr = new ASTExpressionPushLocal(slot, declaration.type, declaration.templateTypeName, declaration.command);
+					objExpr = new (m_Program) ASTExpressionPushLocal(slot, declaration.type, declaration.templateTypeName, declaration.command);
 					if (members[0].second)
-						objExpr = new ASTExpressionDereference(objExpr);
+						objExpr = new (m_Program) ASTExpressionDereference(objExpr);
 				}
 			}
 			i++;
@@ -2358,6 +2614,10 @@ ASTExpression* Parser::ParseExpressionChain(Tokenizer* tokenizer, ASTExpression*
 		else
 		{
 			objExpr = chainExpr;
+
+			// A chain continued after a call or index keeps the arrow on its first member
+			if (i == 0 && members[0].second)
+				objExpr = new (m_Program) ASTExpressionDereference(objExpr);
 		}
 
 		std::vector<std::string> updatedMembers;
@@ -2378,14 +2638,14 @@ ASTExpression* Parser::ParseExpressionChain(Tokenizer* tokenizer, ASTExpression*
 		
 		
 		if (incremented)
-			chainExpr = new ASTExpressionPushMember(objExpr, updatedMembers);
+			chainExpr = new (m_Program) ASTExpressionPushMember(objExpr, updatedMembers);
 		else
 			chainExpr = objExpr;
 	}
 
 	if (!arrayIndices.empty())
 	{
-		chainExpr = new ASTExpressionPushIndex(chainExpr, arrayIndices);
+		chainExpr = new (m_Program) ASTExpressionPushIndex(chainExpr, arrayIndices);
 	}
 
 	peek = tokenizer->PeekToken();
@@ -2393,7 +2653,7 @@ ASTExpression* Parser::ParseExpressionChain(Tokenizer* tokenizer, ASTExpression*
 	{
 		tokenizer->Expect(TokenTypeT::EQUALS);
 		ASTExpression* assignExpr = ParseExpression(tokenizer);
-		ASTExpressionSet* setExpr = new ASTExpressionSet(chainExpr, assignExpr);
+		ASTExpressionSet* setExpr = new (m_Program) ASTExpressionSet(chainExpr, assignExpr);
 		return setExpr;
 	}
 	else if (peek.type == TokenTypeT::OPEN_PAREN)
@@ -2402,7 +2662,7 @@ ASTExpression* Parser::ParseExpressionChain(Tokenizer* tokenizer, ASTExpression*
 		std::vector<ASTExpression*> argExprs;
 		ParseArguments(tokenizer, argExprs);
 
-		ASTExpressionMemberFunctionCall* functionCallExpr = new ASTExpressionMemberFunctionCall(chainExpr, members.back().first, argExprs);
+		ASTExpressionMemberFunctionCall* functionCallExpr = new (m_Program) ASTExpressionMemberFunctionCall(chainExpr, members.back().first, argExprs);
 		peek = tokenizer->PeekToken();
 		chainExpr = functionCallExpr;
 		if (peek.type == TokenTypeT::DOT || peek.type == TokenTypeT::ARROW)
@@ -2417,7 +2677,7 @@ ASTExpression* Parser::ParseExpressionChain(Tokenizer* tokenizer, ASTExpression*
 			tokenizer->Expect(TokenTypeT::OPEN_BRACKET);
 			std::vector<ASTExpression*> subIndexExprs;
 			ParseArrayIndices(tokenizer, subIndexExprs);
-			chainExpr = new ASTExpressionPushIndex(chainExpr, subIndexExprs);
+			chainExpr = new (m_Program) ASTExpressionPushIndex(chainExpr, subIndexExprs);
 
 			peek = tokenizer->PeekToken();
 			if (peek.type == TokenTypeT::DOT || peek.type == TokenTypeT::ARROW)
@@ -2842,6 +3102,11 @@ ASTExpressionModuleFunctionCall* Parser::MakeModuleFunctionCall(uint16 moduleID,
 		else if (functionName == "Alloc") function = (uint32)MemModuleFunction::ALLOC;
 		else if (functionName == "Free") function = (uint32)MemModuleFunction::FREE;
 		else if (functionName == "Set") function = (uint32)MemModuleFunction::SET;
+		else if (functionName == "ArenaCreate") function = (uint32)MemModuleFunction::ARENA_CREATE;
+		else if (functionName == "ArenaAlloc") function = (uint32)MemModuleFunction::ARENA_ALLOC;
+		else if (functionName == "ArenaReset") function = (uint32)MemModuleFunction::ARENA_RESET;
+		else if (functionName == "ArenaDestroy") function = (uint32)MemModuleFunction::ARENA_DESTROY;
+		else if (functionName == "Sort") function = (uint32)MemModuleFunction::SORT;
 	}
 	else if (moduleName == "Time")
 	{
@@ -2849,8 +3114,60 @@ ASTExpressionModuleFunctionCall* Parser::MakeModuleFunctionCall(uint16 moduleID,
 		else if (functionName == "GetMicro") function = (uint32)TimeModuleFunction::GET_MICRO;
 		else if (functionName == "GetNano") function = (uint32)TimeModuleFunction::GET_NANO;
 	}
+	else if (moduleName == "Job")
+	{
+		if (functionName == "Submit") function = (uint32)JobModuleFunction::SUBMIT;
+		else if (functionName == "Wait") function = (uint32)JobModuleFunction::WAIT;
+		else if (functionName == "ParallelFor") function = (uint32)JobModuleFunction::PARALLEL_FOR;
+		else if (functionName == "WorkerCount") function = (uint32)JobModuleFunction::WORKER_COUNT;
+	}
+	else if (moduleName == "Chan")
+	{
+		if (functionName == "CreateSPSC") function = (uint32)ChanModuleFunction::CREATE_SPSC;
+		else if (functionName == "CreateMPMC") function = (uint32)ChanModuleFunction::CREATE_MPMC;
+		else if (functionName == "Destroy") function = (uint32)ChanModuleFunction::DESTROY;
+		else if (functionName == "TrySend") function = (uint32)ChanModuleFunction::TRY_SEND;
+		else if (functionName == "TryRecv") function = (uint32)ChanModuleFunction::TRY_RECV;
+		else if (functionName == "Send") function = (uint32)ChanModuleFunction::SEND;
+		else if (functionName == "Recv") function = (uint32)ChanModuleFunction::RECV;
+	}
+	else if (moduleName == "Host")
+	{
+		function = m_Program->GetHostFunctionID(functionName);
+	}
+	else if (moduleName == "Co")
+	{
+		if (functionName == "Start") function = (uint32)CoModuleFunction::START;
+		else if (functionName == "Spawn") function = (uint32)CoModuleFunction::SPAWN;
+		else if (functionName == "Resume") function = (uint32)CoModuleFunction::RESUME;
+		else if (functionName == "IsDone") function = (uint32)CoModuleFunction::IS_DONE;
+		else if (functionName == "Value") function = (uint32)CoModuleFunction::VALUE;
+		else if (functionName == "ValueSize") function = (uint32)CoModuleFunction::VALUE_SIZE;
+		else if (functionName == "Destroy") function = (uint32)CoModuleFunction::DESTROY;
+		else if (functionName == "Schedule") function = (uint32)CoModuleFunction::SCHEDULE;
+		else if (functionName == "Sleep") function = (uint32)CoModuleFunction::SLEEP;
+		else if (functionName == "Update") function = (uint32)CoModuleFunction::UPDATE;
+		else if (functionName == "Time") function = (uint32)CoModuleFunction::TIME;
+	}
+	else if (moduleName == "Sched")
+	{
+		if (functionName == "After") function = (uint32)SchedModuleFunction::AFTER;
+		else if (functionName == "Every") function = (uint32)SchedModuleFunction::EVERY;
+		else if (functionName == "Cancel") function = (uint32)SchedModuleFunction::CANCEL;
+		else if (functionName == "Update") function = (uint32)SchedModuleFunction::UPDATE;
+		else if (functionName == "Time") function = (uint32)SchedModuleFunction::TIME;
+		else if (functionName == "SetTargetRate") function = (uint32)SchedModuleFunction::SET_TARGET_RATE;
+		else if (functionName == "Frame") function = (uint32)SchedModuleFunction::FRAME;
+		else if (functionName == "FrameTime") function = (uint32)SchedModuleFunction::FRAME_TIME;
+		else if (functionName == "FrameCount") function = (uint32)SchedModuleFunction::FRAME_COUNT;
+		else if (functionName == "ResetFrameStats") function = (uint32)SchedModuleFunction::RESET_FRAME_STATS;
+	}
+	else if (moduleID >= PLUGIN_MODULE_ID_BASE)
+	{
+		function = m_Program->GetPlugin(moduleID)->FindFunction(functionName);
+	}
 
-	return new ASTExpressionModuleFunctionCall(moduleID, function, args);
+	return new (m_Program) ASTExpressionModuleFunctionCall(moduleID, function, args);
 }
 
 ASTExpressionModuleConstant* Parser::MakeModuleConstant(uint16 moduleID, const std::string& moduleName, const std::string& variableName)
@@ -3194,8 +3511,32 @@ ASTExpressionModuleConstant* Parser::MakeModuleConstant(uint16 moduleID, const s
 	{
 
 	}
+	else if (moduleName == "Job")
+	{
+
+	}
+	else if (moduleName == "Chan")
+	{
+
+	}
+	else if (moduleName == "Host")
+	{
+
+	}
+	else if (moduleName == "Co")
+	{
 
-	return new ASTExpressionModuleConstant(moduleID, constant);
+	}
+	else if (moduleName == "Sched")
+	{
+
+	}
+	else if (moduleID >= PLUGIN_MODULE_ID_BASE)
+	{
+		constant = m_Program->GetPlugin(moduleID)->FindConstant(variableName);
+	}
+
+	return new (m_Program) ASTExpressionModuleConstant(moduleID, constant);
 }
 
 Function* Parser::GenerateDefaultCopyFunction(Class* cls, const std::string& name)
@@ -3204,6 +3545,7 @@ Function* Parser::GenerateDefaultCopyFunction(Class* cls, const std::string& nam
 	function->accessModifier = AccessModifier::PUBLIC;
 	function->isStatic = false;
 	function->isVirtual = false;
+	function->isGenerated = true;
 	function->name = name;
 	function->returnInfo = TypeInfo((uint16)ValueType::VOID_T, 0);
 	function->numLocals = 1;
@@ -3269,19 +3611,19 @@ Function* Parser::GenerateDefaultCopyFunction(Class* cls, const std::string& nam
 				function->numLocals++;
 			}
 
-			ASTExpression* thisMember = new ASTExpressionPushMember(new ASTExpressionDereference(new ASTExpressionThis(cls->GetID())), membs);
-			ASTExpression* otherMember = new ASTExpressionPushMember(new ASTExpressionPushLocal(parameter.variableID, parameter.type, "", parameter.instantiationCommand), membs);
+			ASTExpression* thisMember = new (m_Program) ASTExpressionPushMember(new (m_Program) ASTExpressionDereference(new (m_Program) ASTExpressionThis(cls->GetID())), membs);
+			ASTExpression* otherMember = new (m_Program) ASTExpressionPushMember(new (m_Program) ASTExpressionPushLocal(parameter.variableID, parameter.type, "", parameter.instantiationCommand), membs);
 
 			std::vector<ASTExpression*> indexExprs;
 			for (uint32 d = 0; d < member.numDimensions; d++)
 			{
-				indexExprs.push_back(new ASTExpressionPushLocal(indexLocals[d], TypeInfo((uint16)ValueType::UINT32, 0), ""));
+				indexExprs.push_back(new (m_Program) ASTExpressionPushLocal(indexLocals[d], TypeInfo((uint16)ValueType::UINT32, 0), ""));
 			}
 
-			thisMember = new ASTExpressionPushIndex(thisMember, indexExprs);
-			otherMember = new ASTExpressionPushIndex(otherMember, indexExprs);
+			thisMember = new (m_Program) ASTExpressionPushIndex(thisMember, indexExprs);
+			otherMember = new (m_Program) ASTExpressionPushIndex(otherMember, indexExprs);
 
-			ASTExpressionSet* innerAssign = new ASTExpressionSet(thisMember, otherMember);
+			ASTExpressionSet* innerAssign = new (m_Program) ASTExpressionSet(thisMember, otherMember);
 
 			ASTExpression* loopBody = innerAssign;
 
@@ -3289,28 +3631,34 @@ Function* Parser::GenerateDefaultCopyFunction(Class* cls, const std::string& nam
 			{
 				uint16 idx = indexLocals[dim];
 
-				ASTExpressionDeclarePrimitive* declareExpr = new ASTExpressionDeclarePrimitive(ValueType::UINT32, idx);
+				ASTExpressionDeclarePrimitive* declareExpr = new (m_Program) ASTExpressionDeclarePrimitive(ValueType::UINT32, idx);
+
+				ASTExpression* lengthExpr = nullptr;
+				if (member.dimensions[dim].second.empty())
+					lengthExpr = new (m_Program) ASTExpressionConstUInt32(member.dimensions[dim].first);
+				else
+					lengthExpr = new (m_Program) ASTExpressionTemplateInteger(member.dimensions[dim].second);
 
-				ASTExpressionBinary* condExpr = new ASTExpressionBinary(
-					new ASTExpressionPushLocal(idx, TypeInfo((uint16)ValueType::UINT32, 0), ""),
-					new ASTExpressionConstUInt32(member.dimensions[dim].first),
+				ASTExpressionBinary* condExpr = new (m_Program) ASTExpressionBinary(
+					new (m_Program) ASTExpressionPushLocal(idx, TypeInfo((uint16)ValueType::UINT32, 0), ""),
+					lengthExpr,
 					Operator::LESS);
 
-				ASTExpressionUnaryUpdate* incrExpr = new ASTExpressionUnaryUpdate(new ASTExpressionPushLocal(idx, TypeInfo((uint16)ValueType::UINT32, 0), ""), ASTUnaryUpdateOp::PRE_INC);
+				ASTExpressionUnaryUpdate* incrExpr = new (m_Program) ASTExpressionUnaryUpdate(new (m_Program) ASTExpressionPushLocal(idx, TypeInfo((uint16)ValueType::UINT32, 0), ""), ASTUnaryUpdateOp::PRE_INC);
 				incrExpr->isStatement = true;
 
 				std::vector<ASTExpression*> bodyBlock = { loopBody };
 
-				loopBody = new ASTExpressionFor(declareExpr, condExpr, incrExpr, bodyBlock);
+				loopBody = new (m_Program) ASTExpressionFor(declareExpr, condExpr, incrExpr, bodyBlock);
 			}
 
 			function->body.push_back(loopBody);
 		}
 		else
 		{
-			ASTExpressionPushMember* pushMemberExpr = new ASTExpressionPushMember(new ASTExpressionDereference(new ASTExpressionThis(cls->GetID())), membs); //Access this->member
-			ASTExpressionPushMember* pushParamExpr = new ASTExpressionPushMember(new ASTExpressionPushLocal(parameter.variableID, parameter.type, "", parameter.instantiationCommand), membs); //Access param.member
-			ASTExpressionSet* setExpr = new ASTExpressionSet(pushMemberExpr, pushParamExpr);
+			ASTExpressionPushMember* pushMemberExpr = new (m_Program) ASTExpressionPushMember(new (m_Program) ASTExpressionDereference(new (m_Program) ASTExpressionThis(cls->GetID())), membs); //Access this->member
+			ASTExpressionPushMember* pushParamExpr = new (m_Program) ASTExpressionPushMember(new (m_Program) ASTExpressionPushLocal(parameter.variableID, parameter.type, "", parameter.instantiationCommand), membs); //Access param.member
+			ASTExpressionSet* setExpr = new (m_Program) ASTExpressionSet(pushMemberExpr, pushParamExpr);
 			function->body.push_back(setExpr);
 		}
 	}
@@ -6,24 +6,58 @@
 #include "Tokenizer.h"
 #include "Function.h"
 #include "Template.h"
+#include "Memory/SegmentedBumpAllocator.h"
+
+#define SCOPE_SEGMENT_SIZE_KB 16
 
 class Program;
 class Class;
 class Scope;
+class SourceLoader;
 struct ASTExpression;
 struct ASTExpressionModuleFunctionCall;
 struct ASTExpressionModuleConstant;
+// A class member named in an expression, looked up once every class is parsed since it may be declared further down
+struct DeferredMemberCheck
+{
+	uint16 classID;
+	std::string name;
+	uint32 line;
+	uint32 column;
+};
+
 class Parser
 {
 public:
 	Parser(Program* program);
+	~Parser();
+
+	// Returns false if the file or one of its imports had errors
+	bool Parse(const std::string& path);
 
-	void Parse(const std::string& path);
+	inline uint64 GetParsedBytes() const { return m_ParsedBytes; }
+	inline uint32 GetNumScopes() const { return m_NumScopes; }
+
+	// Errors are printed as they are found unless the host collects them itself
+	inline void SetPrintErrors(bool printErrors) { m_PrintErrors = printErrors; }
+	inline const std::vector<std::string>& GetErrors() const { return m_Errors; }
+
+	// Threads reading and tokenizing the imported files, the parse itself stays on the calling thread
+	inline void SetNumThreads(uint32 numThreads) { m_NumThreads = numThreads; }
 private:
+	bool ParseFile(const std::string& path);
+	void CheckDeferredMembers();
+	void ReportError(uint32 line, uint32 column, const std::string& message);
+
+	Scope* PushScope(Scope* parent);
+	void PopScope();
+
 	bool ParseImport(Tokenizer* tokenizer);
+	bool ImportPlugin(const Token& token, const std::string& moduleName, const std::vector<std::string>& paths);
 	bool ParseClass(Tokenizer* tokenizer);
 	bool ParseFunction(Tokenizer* tokenizer, Class* cls);
-	bool ParseClassVariable(Tokenizer* tokenizer, Class* cls, uint64* memberOffset, uint64* staticOffset);
+	bool ParseClassVariable(Tokenizer* tokenizer, Class* cls);
+	uint64 ParseAlignment(Tokenizer* tokenizer);
 	uint16 ParseType(const Token& token);
 	uint8 ParsePointerLevel(Tokenizer* tokenizer);
 	bool ParseStatement(Function* function, Tokenizer* tokenizer);
@@ -50,9 +84,19 @@ private:
 private:
 	Program* m_Program;
 	std::vector<Scope*> m_ScopeStack;
+	std::vector<uint64> m_ScopeMarkers;
+	SegmentedBumpAllocator* m_ScopeAllocator; // Scopes are strictly nested, so popping one rewinds the allocator
+	uint32 m_NumScopes;
+	uint64 m_ParsedBytes;
 
 	std::string m_ErrorMessage;
+	std::vector<std::string> m_Errors;
+	bool m_PrintErrors;
 	std::vector<std::string> m_ParsedFiles;
+	uint32 m_NumThreads;
+	SourceLoader* m_Sources; // Only set while Parse runs
+	std::vector<DeferredMemberCheck> m_FieldIndexChecks;
+	std::vector<DeferredMemberCheck> m_FunctionReferenceChecks;
 
 	std::string m_CurrentClassName;
 	bool m_CurrentFunctionReturnsReference;
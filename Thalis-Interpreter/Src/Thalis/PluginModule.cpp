@@ -0,0 +1,148 @@
+#include "PluginModule.h"
+#include "ExecutionContext.h"
+#include "NativeCall.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+static void* OpenLibrary(const std::string& path, std::string* error)
+{
+#if defined(_WIN32)
+	void* library = (void*)LoadLibraryA(path.c_str());
+	if (!library)
+		*error = "LoadLibrary failed with error " + std::to_string(GetLastError());
+#else
+	void* library = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+	if (!library)
+		*error = dlerror();
+#endif
+	return library;
+}
+
+static void* GetLibrarySymbol(void* library, const char* name)
+{
+#if defined(_WIN32)
+	return (void*)GetProcAddress((HMODULE)library, name);
+#else
+	return dlsym(library, name);
+#endif
+}
+
+static void CloseLibrary(void* library)
+{
+#if defined(_WIN32)
+	FreeLibrary((HMODULE)library);
+#else
+	dlclose(library);
+#endif
+}
+
+PluginModule::~PluginModule()
+{
+	CloseLibrary(m_Library);
+}
+
+PluginModule* PluginModule::Load(const std::string& path, std::string* error)
+{
+	void* library = OpenLibrary(path, error);
+	if (!library)
+		return nullptr;
+
+	PluginEntry entry = (PluginEntry)GetLibrarySymbol(library, THALIS_PLUGIN_ENTRY);
+	const PluginModuleDesc* desc = entry ? entry() : nullptr;
+	if (!desc)
+	{
+		*error = path + " does not export " THALIS_PLUGIN_ENTRY;
+		CloseLibrary(library);
+		return nullptr;
+	}
+
+	if (desc->abiVersion != THALIS_PLUGIN_ABI_VERSION)
+	{
+		*error = path + " was built against plug-in ABI " + std::to_string(desc->abiVersion) +
+			", expected " + std::to_string(THALIS_PLUGIN_ABI_VERSION);
+		CloseLibrary(library);
+		return nullptr;
+	}
+
+	for (uint32 i = 0; i < desc->numFunctions; i++)
+	{
+		if (desc->functions[i].numParameters > THALIS_NATIVE_MAX_PARAMETERS)
+		{
+			*error = std::string(desc->functions[i].name) + " in " + path + " takes more than " +
+				std::to_string(THALIS_NATIVE_MAX_PARAMETERS) + " parameters";
+			CloseLibrary(library);
+			return nullptr;
+		}
+	}
+
+	return new PluginModule(library, desc);
+}
+
+std::vector<std::string> PluginModule::GetSearchPaths(const std::string& name)
+{
+#if defined(_WIN32)
+	std::string fileName = name + ".dll";
+#elif defined(__APPLE__)
+	std::string fileName = "lib" + name + ".dylib";
+#else
+	std::string fileName = "lib" + name + ".so";
+#endif
+	return { fileName, "Plugins/" + fileName };
+}
+
+uint16 PluginModule::FindFunction(const std::string& name) const
+{
+	for (uint32 i = 0; i < m_Desc->numFunctions; i++)
+	{
+		if (name == m_Desc->functions[i].name)
+			return i;
+	}
+
+	return INVALID_ID;
+}
+
+uint16 PluginModule::FindConstant(const std::string& name) const
+{
+	for (uint32 i = 0; i < m_Desc->numConstants; i++)
+	{
+		if (name == m_Desc->constants[i].name)
+			return i;
+	}
+
+	return INVALID_ID;
+}
+
+TypeInfo PluginModule::GetFunctionReturnInfo(uint16 function) const
+{
+	return NativeCall::ToTypeInfo(m_Desc->functions[function].returnType);
+}
+
+TypeInfo PluginModule::GetConstantTypeInfo(uint16 constant) const
+{
+	return NativeCall::ToTypeInfo(m_Desc->constants[constant].type);
+}
+
+Value PluginModule::CallFunction(ExecutionContext* context, uint16 function, const std::vector<Value>& args) const
+{
+	const NativeFunctionDesc& desc = m_Desc->functions[function];
+
+	NativeValue unboxed[THALIS_NATIVE_MAX_PARAMETERS];
+	for (uint32 i = 0; i < desc.numParameters; i++)
+		unboxed[i] = NativeCall::Unbox(args[i], desc.parameterTypes[i]);
+
+	NativeValue result;
+	result.u = 0;
+	desc.function(unboxed, &result);
+	return NativeCall::Box(result, desc.returnType, context->GetStackAllocator());
+}
+
+Value PluginModule::Constant(ExecutionContext* context, uint16 constant) const
+{
+	const NativeConstantDesc& desc = m_Desc->constants[constant];
+	return NativeCall::Box(desc.value, desc.type, context->GetStackAllocator());
+}
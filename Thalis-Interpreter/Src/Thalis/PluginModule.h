@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Value.h"
+#include "TypeInfo.h"
+#include "ThalisPlugin.h"
+
+class ExecutionContext;
+
+// A loaded plug-in library. Calls go straight through the function table it exported.
+class PluginModule
+{
+public:
+	~PluginModule();
+
+	// Returns nullptr and fills error if the library is missing or not a compatible plug-in
+	static PluginModule* Load(const std::string& path, std::string* error);
+
+	// Plug-ins named in an Import are searched for next to the working directory and in Plugins/
+	static std::vector<std::string> GetSearchPaths(const std::string& name);
+
+	uint16 FindFunction(const std::string& name) const;
+	uint16 FindConstant(const std::string& name) const;
+	inline uint32 GetNumParameters(uint16 function) const { return m_Desc->functions[function].numParameters; }
+	inline const NativeFunctionDesc* GetFunctionDesc(uint16 function) const { return &m_Desc->functions[function]; }
+
+	TypeInfo GetFunctionReturnInfo(uint16 function) const;
+	TypeInfo GetConstantTypeInfo(uint16 constant) const;
+
+	Value CallFunction(ExecutionContext* context, uint16 function, const std::vector<Value>& args) const;
+	Value Constant(ExecutionContext* context, uint16 constant) const;
+
+	inline const char* GetName() const { return m_Desc->name; }
+private:
+	PluginModule(void* library, const PluginModuleDesc* desc) : m_Library(library), m_Desc(desc) { }
+private:
+	void* m_Library;
+	const PluginModuleDesc* m_Desc;
+};
@@ -1,52 +1,64 @@
 #include "Program.h"
 #include "Class.h"
 #include "ASTExpression.h"
-#include "Modules/ModuleID.h"
-#include "Modules/IOModule.h"
-#include "Modules/MathModule.h"
-#include "Modules/WindowModule.h"
-#include "Modules/GLModule.h"
-#include "Modules/FSModule.h"
-#include "Modules/MemModule.h"
-#include "Modules/TimeModule.h"
+#include "PluginModule.h"
 #include "Memory/Memory.h"
+#include <algorithm>
 
-static Program* g_CompiledProgram;
+// pointerLevel in the low 6 bits, isReference and isArray in the top two
+static inline uint8 PackValueFlags(uint8 pointerLevel, bool isReference, bool isArray)
+{
+	return (pointerLevel & 0x3F) | ((uint8)isReference << 6) | ((uint8)isArray << 7);
+}
 
 Program::Program()
 {
-	m_ProgramCounter = 0;
-	m_CurrentScope = -1;
-	g_CompiledProgram = this;
-	m_StackAllocator = new BumpAllocator(Memory::KBToBytes(128));
+	m_EntryPC = 0;
+	m_EncodingSavings = 0;
 	m_HeapAllocator = new HeapAllocator();
-	m_InitializationAllocator = new BumpAllocator(Memory::KBToBytes(32));
-	m_ReturnAllocator = new BumpAllocator(Memory::KBToBytes(16));
-	m_ScopeStack.reserve(64);
-	m_ScopeStack.resize(64);
+	m_InitializationAllocator = new SegmentedBumpAllocator(Memory::KBToBytes(32), Memory::MBToBytes(AST_CAPACITY_MB));
+	m_ASTAllocator = new SegmentedBumpAllocator(Memory::KBToBytes(AST_SEGMENT_SIZE_KB), Memory::MBToBytes(AST_CAPACITY_MB));
+	m_PackAllClasses = false;
+	m_CompiledResidentSize = 0;
+	m_ExecutionResidentSize = 0;
 }
 
-void Program::ExecuteProgram(uint32 pc)
+Program::~Program()
 {
-	TimeModule::SetBeginTime();
-	uint32 initStaticsPC = GetCodeSize();
-	InitStatics();
-	CleanUpForExecution();
-	m_StackAllocator->Free();
-	AddJumpCommand(pc);
+	ChanModule::DestroyChannels(this);
 
-	m_ProgramCounter = initStaticsPC;
-	OpCode opcode = ReadOPCode();
-	while (opcode != OpCode::END)
+	for (uint32 i = 0; i < m_StringPool.size(); i++)
 	{
-		ExecuteOpCode(opcode);
-		opcode = ReadOPCode();
+		m_HeapAllocator->Free(m_StringPool[i]);
 	}
 
-	for (uint32 i = 0; i < m_StringPool.size(); i++)
+	// Left over when compilation stopped before the program was prepared for execution
+	for (uint32 i = 0; i < m_CreatedExpressions.size(); i++)
+		delete m_CreatedExpressions[i];
+
+	for (uint32 i = 0; i < m_Classes.size(); i++)
 	{
-		m_HeapAllocator->Free(m_StringPool[i]);
+		m_Classes[i]->ReleaseStaticData(this);
+		delete m_Classes[i];
 	}
+
+	m_HeapAllocator->Destroy();
+	m_InitializationAllocator->Destroy();
+	m_ASTAllocator->Destroy();
+	delete m_HeapAllocator;
+	delete m_InitializationAllocator;
+	delete m_ASTAllocator;
+
+	for (uint32 i = 0; i < m_Plugins.size(); i++)
+		delete m_Plugins[i];
+}
+
+void Program::PrepareForExecution(uint32 pc)
+{
+	m_EntryPC = GetCodeSize();
+	InitStatics();
+	CleanUpForExecution();
+	AddJumpCommand(pc);
 }
 
 void Program::AddJumpCommand(uint32 pc)
@@ -93,6 +105,14 @@ void Program::AddPushConstantInt16Command(int16 value)
 
 void Program::AddPushConstantInt32Command(int32 value)
 {
+	if (value >= INT8_MIN && value <= INT8_MAX)
+	{
+		WriteOPCode(OpCode::PUSH_INT32_SMALL);
+		WriteInt8((int8)value);
+		m_EncodingSavings += sizeof(int32) - sizeof(int8);
+		return;
+	}
+
 	WriteOPCode(OpCode::PUSH_INT32);
 	WriteInt32(value);
 }
@@ -136,7 +156,7 @@ void Program::AddPushCStrCommand(char* value)
 void Program::AddPushLocalCommand(uint16 slot)
 {
 	WriteOPCode(OpCode::PUSH_LOCAL);
-	WriteUInt16(slot);
+	m_EncodingSavings += sizeof(uint16) - WriteVarUInt(slot);
 }
 
 void Program::AddPushTypedNullCommand(uint16 type, uint8 pointerLevel)
@@ -149,7 +169,7 @@ void Program::AddPushTypedNullCommand(uint16 type, uint8 pointerLevel)
 void Program::AddPushIndexedCommand(uint64 typeSize, uint8 numIndices, uint16 indexFunctionID, uint16 classID)
 {
 	WriteOPCode(OpCode::PUSH_INDEXED);
-	WriteUInt64(typeSize);
+	m_EncodingSavings += sizeof(uint64) - WriteVarUInt(typeSize);
 	WriteUInt8(numIndices);
 	WriteUInt16(indexFunctionID);
 	if (indexFunctionID != INVALID_ID)
@@ -160,29 +180,53 @@ void Program::AddPushStaticVariableCommand(uint16 classID, uint64 offset, uint16
 {
 	WriteOPCode(OpCode::PUSH_STATIC_VARIABLE);
 	WriteUInt16(classID);
-	WriteUInt64(offset);
 	WriteUInt16(type);
-	WriteUInt8(pointerLevel);
-	WriteUInt8(isReference);
-	WriteUInt8(isArray);
+	WriteUInt8(PackValueFlags(pointerLevel, isReference, isArray));
+	m_EncodingSavings += sizeof(uint64) - WriteVarUInt(offset) + 2;
 }
 
 void Program::AddPushMemberCommand(uint16 type, uint8 pointerLevel, uint64 offset, bool isReference, bool isArray)
 {
 	WriteOPCode(OpCode::PUSH_MEMBER);
 	WriteUInt16(type);
-	WriteUInt8(pointerLevel);
-	WriteUInt64(offset);
-	WriteUInt8(isReference);
-	WriteUInt8(isArray);
+	WriteUInt8(PackValueFlags(pointerLevel, isReference, isArray));
+	m_EncodingSavings += sizeof(uint64) - WriteVarUInt(offset) + 2;
+}
+
+void Program::AddPushThisMemberCommand(uint16 type, uint8 pointerLevel, uint64 offset, bool isReference, bool isArray)
+{
+	WriteOPCode(OpCode::PUSH_THIS_MEMBER);
+	WriteUInt16(type);
+	WriteUInt8(PackValueFlags(pointerLevel, isReference, isArray));
+	WriteVarUInt(offset);
+}
+
+void Program::AddPushLocalMemberCommand(uint16 slot, bool dereferenceLocal, uint16 type, uint8 pointerLevel, uint64 offset, bool isReference, bool isArray)
+{
+	WriteOPCode(dereferenceLocal ? OpCode::PUSH_LOCAL_POINTER_MEMBER : OpCode::PUSH_LOCAL_MEMBER);
+	WriteVarUInt(slot);
+	WriteUInt16(type);
+	WriteUInt8(PackValueFlags(pointerLevel, isReference, isArray));
+	WriteVarUInt(offset);
 }
 
-uint32 Program::AddPushLoopCommand()
+uint32 Program::AddLessLocalConstJumpIfFalseCommand(uint16 slot, int64 constant)
+{
+	WriteOPCode(OpCode::LESS_LOCAL_CONST_JUMP_IF_FALSE);
+	WriteVarUInt(slot);
+	WriteVarInt(constant);
+	uint32 pos = GetCodeSize();
+	WriteUInt32(0);
+	return pos;
+}
+
+uint32 Program::AddPushLoopCommand(bool hasScope)
 {
 	WriteOPCode(OpCode::PUSH_LOOP);
 	uint32 pos = GetCodeSize();
 	WriteUInt32(0);
 	WriteUInt32(0);
+	WriteUInt8(hasScope);
 	return pos;
 }
 
@@ -276,6 +320,13 @@ void Program::AddModuleFunctionCallCommand(uint16 moduleID, uint16 functionID, u
 	WriteUInt8(usesReturnValue);
 }
 
+void Program::AddNativeCallCommand(const NativeFunctionDesc* function, bool usesReturnValue, bool reuseFirstArg)
+{
+	WriteOPCode(OpCode::NATIVE_CALL);
+	WriteUInt64((uint64)function);
+	WriteUInt8((usesReturnValue ? NATIVE_CALL_USES_RETURN_VALUE : 0) | (reuseFirstArg ? NATIVE_CALL_REUSE_FIRST_ARG : 0));
+}
+
 void Program::AddStaticFunctionCallCommand(uint16 classID, uint16 functionID, bool usesReturnValue)
 {
 	WriteOPCode(OpCode::STATIC_FUNCTION_CALL);
@@ -290,6 +341,12 @@ void Program::AddReturnCommand(uint8 returnInfo)
 	WriteUInt8(returnInfo);
 }
 
+void Program::AddYieldCommand(bool hasValue)
+{
+	WriteOPCode(OpCode::YIELD);
+	WriteUInt8(hasValue);
+}
+
 void Program::AddMemberFunctionCallCommand(uint16 classID, uint16 functionID, bool usesReturnValue)
 {
 	WriteOPCode(OpCode::MEMBER_FUNCTION_CALL);
@@ -341,16 +398,16 @@ void Program::AddAritmaticCommand(Operator op, uint16 functionID)
 	WriteUInt16(functionID);
 }
 
-void Program::AddNewCommand(uint16 type, uint16 functionID)
+void Program::AddNewCommand(uint16 type, uint16 functionID, bool inArena)
 {
-	WriteOPCode(OpCode::NEW);
+	WriteOPCode(inArena ? OpCode::NEW_IN_ARENA : OpCode::NEW);
 	WriteUInt16(type);
 	WriteUInt16(functionID);
 }
 
-void Program::AddNewArrayCommand(uint16 type, uint8 pointerLevel)
+void Program::AddNewArrayCommand(uint16 type, uint8 pointerLevel, bool inArena)
 {
-	WriteOPCode(OpCode::NEW_ARRAY);
+	WriteOPCode(inArena ? OpCode::NEW_ARRAY_IN_ARENA : OpCode::NEW_ARRAY);
 	WriteUInt16(type);
 	WriteUInt8(pointerLevel);
 }
@@ -422,7 +479,27 @@ void Program::WriteReal64(real64 value)
 
 void Program::WriteOPCode(OpCode code)
 {
-	WriteUInt16((uint16)code);
+	WriteUInt8((uint8)code);
+	m_EncodingSavings += sizeof(uint16) - sizeof(uint8);
+}
+
+uint32 Program::WriteVarUInt(uint64 value)
+{
+	uint32 numBytes = 1;
+	while (value >= 0x80)
+	{
+		m_Code.push_back((uint8)(value | 0x80));
+		value >>= 7;
+		numBytes++;
+	}
+	m_Code.push_back((uint8)value);
+	return numBytes;
+}
+
+uint32 Program::WriteVarInt(int64 value)
+{
+	// Zigzag so small negative values stay small
+	return WriteVarUInt(((uint64)value << 1) ^ (uint64)(value >> 63));
 }
 
 void Program::WriteCStr(char* cstr)
@@ -540,6 +617,15 @@ uint64 Program::GetTypeSize(uint16 type)
 	return GetClass(type)->GetSize();
 }
 
+uint64 Program::GetTypeAlignment(uint16 type)
+{
+	// Primitives are naturally aligned
+	if (Value::IsPrimitiveType(type))
+		return std::max<uint64>(GetTypeSize(type), 1);
+
+	return GetClass(type)->GetAlignment();
+}
+
 static ValueType PrimitiveTypeFromName(const std::string& name)
 {
 	if (name == "uint8")   return ValueType::UINT8;
@@ -582,7 +668,7 @@ bool Program::Resolve()
 void Program::BuildVTables()
 {
 	for (uint32 i = 0; i < m_Classes.size(); i++)
-		m_Classes[i]->BuildVTable();
+		m_Classes[i]->BuildVTable(this);
 }
 
 void Program::EmitCode()
@@ -595,1640 +681,88 @@ void Program::PrintClassCodeSizes() const
 {
 	for (uint32 i = 0; i < m_Classes.size(); i++)
 	{
-		std::cout << m_Classes[i]->GetName() << " code size: " << m_Classes[i]->GetCodeSize() << std::endl;
-	}
-}
-
-Program* Program::GetCompiledProgram()
-{
-	return g_CompiledProgram;
-}
-
-void Program::ExecuteOpCode(OpCode opcode)
-{
-	switch (opcode)
-	{
-	case OpCode::JUMP: {
-		m_ProgramCounter = ReadUInt32();
-	} break;
-	case OpCode::JUMP_IF_FALSE: {
-		uint32 target = ReadUInt32();
-		Value condition = m_Stack.back();
-		m_Stack.pop_back();
-		if (!condition.GetBool())
-			m_ProgramCounter = target;
-	} break;
-	case OpCode::PUSH_UINT8: {
-		m_Stack.push_back(Value::MakeUInt8(ReadUInt8(), m_StackAllocator));
-	} break;
-	case OpCode::PUSH_UINT16: {
-		m_Stack.push_back(Value::MakeUInt16(ReadUInt16(), m_StackAllocator));
-	} break;
-	case OpCode::PUSH_UINT32: {
-		m_Stack.push_back(Value::MakeUInt32(ReadUInt32(), m_StackAllocator));
-	} break;
-	case OpCode::PUSH_UINT64: {
-		m_Stack.push_back(Value::MakeUInt64(ReadUInt64(), m_StackAllocator));
-	} break;
-	case OpCode::PUSH_INT8: {
-		m_Stack.push_back(Value::MakeInt8(ReadInt8(), m_StackAllocator));
-	} break;
-	case OpCode::PUSH_INT16: {
-		m_Stack.push_back(Value::MakeInt16(ReadInt16(), m_StackAllocator));
-	} break;
-	case OpCode::PUSH_INT32: {
-		m_Stack.push_back(Value::MakeInt32(ReadInt32(), m_StackAllocator));
-	} break;
-	case OpCode::PUSH_INT64: {
-		m_Stack.push_back(Value::MakeInt64(ReadInt64(), m_StackAllocator));
-	} break;
-	case OpCode::PUSH_REAL32: {
-		m_Stack.push_back(Value::MakeReal32(ReadReal32(), m_StackAllocator));
-	} break;
-	case OpCode::PUSH_REAL64: {
-		m_Stack.push_back(Value::MakeReal64(ReadReal64(), m_StackAllocator));
-	} break;
-	case OpCode::PUSH_CHAR: {
-		m_Stack.push_back(Value::MakeChar(ReadInt8(), m_StackAllocator));
-	} break;
-	case OpCode::PUSH_BOOL: {
-		m_Stack.push_back(Value::MakeBool(ReadUInt8(), m_StackAllocator));
-	} break;
-	case OpCode::PUSH_CSTR: {
-		m_Stack.push_back(Value::MakePointer((uint16)ValueType::CHAR, 1, ReadCStr(), m_StackAllocator));
-	} break;
-	case OpCode::PUSH_LOCAL: {
-		uint16 slot = ReadUInt16();
-		Frame* frame = m_FrameStack.back();
-		m_Stack.push_back(frame->GetLocal(slot).Actual());
-	} break;
-	case OpCode::PUSH_TYPED_NULL: {
-		uint16 type = ReadUInt16();
-		uint8 pointerLevel = ReadUInt8();
-		m_Stack.push_back(Value::MakeNULL(type, pointerLevel));
-	} break;
-	case OpCode::PUSH_UNTYPED_NULL: {
-		m_Stack.push_back(Value::MakeNULL());
-	} break;
-	case OpCode::PUSH_INDEXED: {
-		uint64 typeSize = ReadUInt64();
-		uint8 numIndices = ReadUInt8();
-		uint16 indexFunctionID = ReadUInt16();
-
-		if (indexFunctionID != INVALID_ID)
-		{
-			uint16 classID = ReadUInt16();
-			Class* cls = GetClass(classID);
-			Function* function = cls->GetFunction(indexFunctionID);
-
-			CallFrame callFrame;
-			callFrame.basePointer = m_Stack.size();
-			callFrame.popThisStack = true;
-			callFrame.usesReturnValue = true;
-			callFrame.loopCount = m_LoopStack.size();
-			callFrame.function = function;
-
-			m_CurrentScope++;
-			m_ScopeStack[m_CurrentScope].marker = m_StackAllocator->GetMarker();
-			callFrame.scopeCount = m_CurrentScope;
-
-			Frame* frame = m_FramePool.Acquire(function->numLocals);
-			AddFunctionArgsToFrame(frame, function);
-
-			callFrame.returnPC = m_ProgramCounter;
-
-			Value objToCallFunctionOn = m_Stack.back(); m_Stack.pop_back();
-			m_ThisStack.push_back(Value::MakePointer(classID, 1, objToCallFunctionOn.data, m_StackAllocator));
-
-			m_CallStack.push_back(callFrame);
-			m_FrameStack.push_back(frame);
-
-			m_ProgramCounter = function->pc;
-
-			break;
-		}
-
-		for (uint8 i = 0; i < numIndices; i++)
-		{
-			m_Dimensions[i] = m_Stack.back().Actual().GetUInt32();
-			m_Stack.pop_back();
-		}
-
-		Value base = m_Stack.back();
-		m_Stack.pop_back();
-		
-		Value element;
-		element.type = base.type;
-		element.pointerLevel = base.pointerLevel - 1;
-		element.isArray = false;
-		element.isReference = false;
-
-		if (base.isArray)
-		{
-			uint32 index = base.Calculate1DArrayIndex(m_Dimensions);
-
-			if (element.pointerLevel > 0)
-			{
-				element.data = (void**)((uint8*)base.data + index * sizeof(void*));
-			}
-			else
-			{
-				element.data = (uint8*)base.data + index * typeSize;
-			}
-		}
-		else if (base.IsPointer())
-		{
-			void* ptr = *(void**)base.data;
-
-			uint8 pointerLevel = element.pointerLevel;
-			for (uint32 i = 0; i < numIndices; i++)
-			{
-				if (pointerLevel > 0)
-				{
-					ptr = (void**)((uint8*)ptr + m_Dimensions[i] * sizeof(void*));
-				}
-				else
-				{
-					ptr = (uint8*)ptr + m_Dimensions[i] * typeSize;
-				}
-
-				pointerLevel--;
-			}
-
-			element.data = ptr;
-		}
-
-		m_Stack.push_back(element);
-	} break;
-	case OpCode::PUSH_STATIC_VARIABLE: {
-		uint16 classID = ReadUInt16();
-		uint64 offset = ReadUInt64();
-		uint16 type = ReadUInt16();
-		uint8 pointerLevel = ReadUInt8();
-		bool isReference = ReadUInt8();
-		bool isArray = ReadUInt8();
-
-		Value value;
-		value.type = type;
-		value.pointerLevel = pointerLevel;
-		value.isArray = isArray;
-		value.data = GetClass(classID)->GetStaticData(offset);
-		value.isReference = isReference;
-
-		m_Stack.push_back(value);
-	} break;
-	case OpCode::PUSH_MEMBER: {
-		Value base = m_Stack.back();
-		m_Stack.pop_back();
-
-		Value member;
-		member.type = ReadUInt16();
-		member.pointerLevel = ReadUInt8();
-		uint64 offset = ReadUInt64();
-		member.isReference = ReadUInt8();
-		member.isArray = ReadUInt8();
-		member.data = (uint8*)base.data + offset;
-
-		m_Stack.push_back(member);
-	} break;
-	case OpCode::PUSH_THIS: {
-		m_Stack.push_back(m_ThisStack.back());
-		uint32 bp = 0;
-	} break;
-	case OpCode::DECLARE_UINT8: {
-		uint16 slot = ReadUInt16();
-		Frame* frame = m_FrameStack.back();
-		Value assignValue = m_Stack.back();
-		m_Stack.pop_back();
-		frame->DeclareLocal(slot, Value::MakeUInt8(assignValue.GetUInt8(), m_StackAllocator));
-	} break;
-	case OpCode::DECLARE_UINT16: {
-		uint16 slot = ReadUInt16();
-		Frame* frame = m_FrameStack.back();
-		Value assignValue = m_Stack.back();
-		m_Stack.pop_back();
-		frame->DeclareLocal(slot, Value::MakeUInt16(assignValue.GetUInt16(), m_StackAllocator));
-	} break;
-	case OpCode::DECLARE_UINT32: {
-		uint16 slot = ReadUInt16();
-		Frame* frame = m_FrameStack.back();
-		Value assignValue = m_Stack.back();
-		m_Stack.pop_back();
-		frame->DeclareLocal(slot, Value::MakeUInt32(assignValue.GetUInt32(), m_StackAllocator));
-	} break;
-	case OpCode::DECLARE_UINT64: {
-		uint16 slot = ReadUInt16();
-		Frame* frame = m_FrameStack.back();
-		Value assignValue = m_Stack.back();
-		m_Stack.pop_back();
-		frame->DeclareLocal(slot, Value::MakeUInt64(assignValue.GetUInt64(), m_StackAllocator));
-	} break;
-	case OpCode::DECLARE_INT8: {
-		uint16 slot = ReadUInt16();
-		Frame* frame = m_FrameStack.back();
-		Value assignValue = m_Stack.back();
-		m_Stack.pop_back();
-		frame->DeclareLocal(slot, Value::MakeInt8(assignValue.GetInt8(), m_StackAllocator));
-	} break;
-	case OpCode::DECLARE_INT16: {
-		uint16 slot = ReadUInt16();
-		Frame* frame = m_FrameStack.back();
-		Value assignValue = m_Stack.back();
-		m_Stack.pop_back();
-		frame->DeclareLocal(slot, Value::MakeInt16(assignValue.GetInt16(), m_StackAllocator));
-	} break;
-	case OpCode::DECLARE_INT32: {
-		uint16 slot = ReadUInt16();
-		Frame* frame = m_FrameStack.back();
-		Value assignValue = m_Stack.back();
-		m_Stack.pop_back();
-		frame->DeclareLocal(slot, Value::MakeInt32(assignValue.GetInt32(), m_StackAllocator));
-	} break;
-	case OpCode::DECLARE_INT64: {
-		uint16 slot = ReadUInt16();
-		Frame* frame = m_FrameStack.back();
-		Value assignValue = m_Stack.back();
-		m_Stack.pop_back();
-		frame->DeclareLocal(slot, Value::MakeInt64(assignValue.GetInt64(), m_StackAllocator));
-	} break;
-	case OpCode::DECLARE_REAL32: {
-		uint16 slot = ReadUInt16();
-		Frame* frame = m_FrameStack.back();
-		Value assignValue = m_Stack.back();
-		m_Stack.pop_back();
-		frame->DeclareLocal(slot, Value::MakeReal32(assignValue.GetReal32(), m_StackAllocator));
-	} break;
-	case OpCode::DECLARE_REAL64: {
-		uint16 slot = ReadUInt16();
-		Frame* frame = m_FrameStack.back();
-		Value assignValue = m_Stack.back();
-		m_Stack.pop_back();
-		frame->DeclareLocal(slot, Value::MakeReal64(assignValue.GetReal64(), m_StackAllocator));
-	} break;
-	case OpCode::DECLARE_CHAR: {
-		uint16 slot = ReadUInt16();
-		Frame* frame = m_FrameStack.back();
-		Value assignValue = m_Stack.back();
-		m_Stack.pop_back();
-		frame->DeclareLocal(slot, Value::MakeChar(assignValue.GetChar(), m_StackAllocator));
-	} break;
-	case OpCode::DECLARE_BOOL: {
-		uint16 slot = ReadUInt16();
-		Frame* frame = m_FrameStack.back();
-		Value assignValue = m_Stack.back();
-		m_Stack.pop_back();
-		frame->DeclareLocal(slot, Value::MakeBool(assignValue.GetBool(), m_StackAllocator));
-	} break;
-	case OpCode::DECLARE_POINTER: {
-		uint16 type = ReadUInt16();
-		uint8 pointerLevel = ReadUInt8();
-		uint16 slot = ReadUInt16();
-		Frame* frame = m_FrameStack.back();
-		Value assignValue = m_Stack.back().Clone(this, m_StackAllocator);
-
-		m_Stack.pop_back();
-		frame->DeclareLocal(slot, assignValue);
-	} break;
-	case OpCode::DECLARE_STACK_ARRAY: {
-		uint16 type = ReadUInt16();
-		uint8 elementPointerLevel = ReadUInt8();
-		uint8 numDimensions = ReadUInt8();
-		uint32 initializerCount = ReadUInt32();
-		uint16 slot = ReadUInt16();
-
-		uint32 elementCount = 1;
-		for (uint32 i = 0; i < numDimensions; i++)
-		{
-			m_Dimensions[i] = ReadUInt32();
-			elementCount *= m_Dimensions[i];
-		}
-
-		uint64 typeSize = GetTypeSize(type);
-		Value array = Value::MakeArray(this, type, elementPointerLevel, m_Dimensions, numDimensions, m_StackAllocator);
-
-		if (!Value::IsPrimitiveType(type))
-		{
-			uint32 ccount = m_PendingConstructors.size();
-			for (uint32 i = 0; i < elementCount; i++)
-			{
-				Value element;
-				element.type = type;
-				element.pointerLevel = elementPointerLevel;
-				element.isReference = false;
-				element.isArray = false;
-				element.data = (uint8*)array.data + i * typeSize;
-
-				AddConstructorRecursive(element, true);
-			}
-
-			ExecutePendingConstructors(ccount);
-		}
-
-		for (uint32 i = 0; i < initializerCount; i++)
-		{
-			Value assignValue = m_Stack.back();
-			m_Stack.pop_back();
-			array.AssignOffset(assignValue, type, elementPointerLevel, typeSize, i * typeSize);
-		}
-
-		m_FrameStack.back()->DeclareLocal(slot, array);
-	} break;
-	case OpCode::DECLARE_OBJECT_WITH_CONSTRUCTOR: {
-		uint16 type = ReadUInt16();
-		uint16 functionID = ReadUInt16();
-		uint16 slot = ReadUInt16();
-
-		Value object = Value::MakeObject(this, type, m_StackAllocator);
-		m_FrameStack.back()->DeclareLocal(slot, object);
-		m_ScopeStack[m_CurrentScope].objects.push_back(object);
-
-		uint32 ccount = m_PendingConstructors.size();
-		AddConstructorRecursive(object);
-		ExecutePendingConstructors(ccount);
-
-		if (functionID != INVALID_ID)
-		{
-			Function* function = GetClass(type)->GetFunction(functionID);
-
-			CallFrame callFrame;
-			callFrame.basePointer = m_Stack.size();
-			callFrame.popThisStack = true;
-			callFrame.usesReturnValue = false;
-			callFrame.loopCount = m_LoopStack.size();
-			callFrame.function = function;
-
-			m_CurrentScope++;
-			m_ScopeStack[m_CurrentScope].marker = m_StackAllocator->GetMarker();
-			callFrame.scopeCount = m_CurrentScope;
-
-			Frame* frame = m_FramePool.Acquire(function->numLocals);
-			AddFunctionArgsToFrame(frame, function);
-
-			callFrame.returnPC = m_ProgramCounter;
-
-			m_CallStack.push_back(callFrame);
-			m_FrameStack.push_back(frame);
-			m_ThisStack.push_back(Value::MakePointer(type, 1, object.data, m_StackAllocator));
-
-			m_ProgramCounter = function->pc;
-		}
-	} break;
-	case OpCode::DECLARE_OBJECT_WITH_ASSIGN: {
-		uint16 type = ReadUInt16();
-		uint16 slot = ReadUInt16();
-		uint16 copyConstructorID = ReadUInt16();
-
-		Value assignValue = m_Stack.back();
-		m_Stack.pop_back();
-
-		Value object = Value::MakeObject(this, type, m_StackAllocator);
-		m_FrameStack.back()->DeclareLocal(slot, object);
-		m_ScopeStack[m_CurrentScope].objects.push_back(object);
-
-		uint32 ccount = m_PendingConstructors.size();
-		AddConstructorRecursive(object);
-		ExecutePendingConstructors(ccount);
-
-		if (copyConstructorID != INVALID_ID)
-		{
-			Class* cls = GetClass(type);
-			Function* copyConstructorFunction = cls->GetFunction(copyConstructorID);
-
-			ExecuteAssignFunction(object, assignValue, copyConstructorFunction);
-		}
-		else
-		{
-			uint64 size = GetClass(type)->GetSize();
-			object.Assign(assignValue, size);
-		}
-	} break;
-	case OpCode::DECLARE_REFERENCE: {
-		uint16 slot = ReadUInt16();
-
-		Value assignValue = m_Stack.back();
-		m_Stack.pop_back();
-
-		Value reference = Value::MakeReference(assignValue, m_StackAllocator);
-		m_FrameStack.back()->DeclareLocal(slot, reference);
-	} break;
-	case OpCode::SET: {
-		uint16 assignFunctionID = ReadUInt16();
-		Value variable = m_Stack.back(); m_Stack.pop_back();
-		Value assignValue = m_Stack.back(); m_Stack.pop_back();
-
-		if (assignFunctionID == INVALID_ID)
-		{
-			if (!variable.IsPrimitive())
-			{
-				uint32 bp = 0;
-			}
-
-			variable.Assign(assignValue, GetTypeSize(variable.type));
-		}
-		else
-		{
-			Class* cls = GetClass(variable.type);
-			Function* assignFunction = cls->GetFunction(assignFunctionID);
-
-			ExecuteAssignFunction(variable, assignValue, assignFunction);
-		}
-	} break;
-	case OpCode::MODULE_CONSTANT: {
-		uint16 moduleID = ReadUInt16();
-		uint16 constantID = ReadUInt16();
-		ExecuteModuleConstant(moduleID, constantID);
-	} break;
-	case OpCode::MODULE_FUNCTION_CALL: {
-		uint16 moduleID = ReadUInt16();
-		uint16 functionID = ReadUInt16();
-		uint8 argCount = ReadUInt8();
-		bool usesReturnValue = ReadUInt8();
-
-		m_ArgStorage.clear();
-		for (uint32 i = 0; i < argCount; i++)
-		{
-			m_ArgStorage.push_back(m_Stack.back());
-			m_Stack.pop_back();
-		}
-
-		ExecuteModuleFunctionCall(moduleID, functionID, usesReturnValue);
-	} break;
-	case OpCode::STATIC_FUNCTION_CALL: {
-		uint16 classID = ReadUInt16();
-		uint16 functionID = ReadUInt16();
-		bool usesReturnValue = ReadUInt8();
-
-		Function* function = GetClass(classID)->GetFunction(functionID);
-
-		CallFrame callFrame;
-		callFrame.basePointer = m_Stack.size();
-		callFrame.popThisStack = false;
-		callFrame.usesReturnValue = usesReturnValue;
-		callFrame.loopCount = m_LoopStack.size();
-		callFrame.function = function;
-
-		m_CurrentScope++;
-		m_ScopeStack[m_CurrentScope].marker = m_StackAllocator->GetMarker();
-		callFrame.scopeCount = m_CurrentScope;
-
-		Frame* frame = m_FramePool.Acquire(function->numLocals);
-		AddFunctionArgsToFrame(frame, function);
-
-		callFrame.returnPC = m_ProgramCounter;
-
-		m_CallStack.push_back(callFrame);
-		m_FrameStack.push_back(frame);
-
-		m_ProgramCounter = function->pc;
-	} break;
-	case OpCode::RETURN: {
-		uint8 returnInfo = ReadUInt8();
-		Frame* frame = m_FrameStack.back(); m_FrameStack.pop_back();
-		CallFrame callFrame = m_CallStack.back(); m_CallStack.pop_back();
-		m_ProgramCounter = callFrame.returnPC;
-		
-		if (callFrame.popThisStack)
-			m_ThisStack.pop_back();
-
-		m_LoopStack.resize(callFrame.loopCount);
-
-		Value returnValue = Value::MakeNULL();
-		uint64 returnMarker = m_ReturnAllocator->GetMarker();
-		bool addToScope = false;
-		if (returnInfo == 1) //Returns value
-		{
-			if (callFrame.usesReturnValue)
-			{
-				returnValue = m_Stack.back().Actual();
-				if (!returnValue.IsPrimitive() && !returnValue.IsPointer())
-				{
-					Class* cls = GetClass(returnValue.type);
-					Function* copyConstructor = cls->GetCopyConstructor();
-					Value dst = Value::MakeObject(this, returnValue.type, m_ReturnAllocator);
-					uint32 ccount = m_PendingCopyConstructors.size();
-					addToScope = true;
-					if (copyConstructor)
-					{
-						m_PendingCopyConstructors.push_back({ dst, returnValue, copyConstructor });
-					}
-					else
-					{
-						AddCopyConstructorRecursive(dst, returnValue);
-					}
-
-					ExecutePendingCopyConstructors(ccount);
-					returnValue = dst;
-				}
-				else
-				{
-					returnValue = returnValue.Clone(this, m_ReturnAllocator);
-				}
-			}
-
-			m_Stack.pop_back();
-		}
-		else if (returnInfo == 2)//Returns reference
-		{
-			returnValue = m_Stack.back();
-			m_Stack.pop_back();
-		}
-
-		uint32 dcount = m_PendingDestructors.size();
-
-		uint64 freeMarker = m_ScopeStack[callFrame.scopeCount].marker;
-		for (int32 i = m_CurrentScope; i >= (int32)callFrame.scopeCount; i--)
-		{
-			ScopeInfo& scope = m_ScopeStack[i];
-			for (uint32 j = 0; j < scope.objects.size(); j++)
-			{
-				AddDestructorRecursive(scope.objects[j]);
-			}
-			scope.objects.clear();
-		}
-		m_CurrentScope = callFrame.scopeCount - 1;
-
-		ExecutePendingDestructors(dcount);
-
-		if (callFrame.function->name == "Shader")
-		{
-			uint32 bp = 0;
-		}
-
-		m_StackAllocator->FreeToMarker(freeMarker);
-
-		if (returnValue.type != INVALID_ID)
-		{
-			if(returnInfo == 2)
-			{
-				m_Stack.push_back(returnValue);
-			}
-			else
-			{
-				Value value = returnValue.Clone(this, m_StackAllocator);
-				m_ReturnAllocator->FreeToMarker(returnMarker);
-				m_Stack.push_back(value);
-
-				if (addToScope)
-				{
-					m_ScopeStack[m_CurrentScope].objects.push_back(value);
-				}
-			}
-		}
-
-		m_FramePool.Release(frame);
-	} break;
-	case OpCode::MEMBER_FUNCTION_CALL: {
-		uint16 classID = ReadUInt16();
-		uint16 functionID = ReadUInt16();
-		bool usesReturnValue = ReadUInt8();
-
-		Class* cls = GetClass(classID);
-		Function* function = cls->GetFunction(functionID);
-
-		Value objToCallFunctionOn = m_Stack.back(); m_Stack.pop_back();
-
-		CallFrame callFrame;
-		callFrame.basePointer = m_Stack.size();
-		callFrame.popThisStack = true;
-		callFrame.usesReturnValue = usesReturnValue;
-		callFrame.loopCount = m_LoopStack.size();
-		callFrame.function = function;
-
-		m_CurrentScope++;
-		m_ScopeStack[m_CurrentScope].marker = m_StackAllocator->GetMarker();
-		callFrame.scopeCount = m_CurrentScope;
-
-		Frame* frame = m_FramePool.Acquire(function->numLocals);
-		AddFunctionArgsToFrame(frame, function);
-
-		callFrame.returnPC = m_ProgramCounter;
-
-		m_ThisStack.push_back(Value::MakePointer(classID, 1, objToCallFunctionOn.data, m_StackAllocator));
-
-		m_CallStack.push_back(callFrame);
-		m_FrameStack.push_back(frame);
-
-		m_ProgramCounter = function->pc;
-	} break;
-	case OpCode::VIRTUAL_FUNCTION_CALL: {
-		uint16 functionID = ReadUInt16();
-		bool usesReturnValue = ReadUInt8();
-
-		Value objToCallFunctionOn = m_Stack.back(); m_Stack.pop_back();
-		m_ThisStack.push_back(objToCallFunctionOn);
-
-		VTable* vtable = *(VTable**)((uint8*)objToCallFunctionOn.data - sizeof(VTable*));
-		Function* function = vtable->GetFunction(functionID);
-
-		CallFrame callFrame;
-		callFrame.basePointer = m_Stack.size();
-		callFrame.popThisStack = true;
-		callFrame.usesReturnValue = usesReturnValue;
-		callFrame.loopCount = m_LoopStack.size();
-		callFrame.function = function;
-
-		m_CurrentScope++;
-		m_ScopeStack[m_CurrentScope].marker = m_StackAllocator->GetMarker();
-		callFrame.scopeCount = m_CurrentScope;
-
-		Frame* frame = m_FramePool.Acquire(function->numLocals);
-		AddFunctionArgsToFrame(frame, function);
-
-		callFrame.returnPC = m_ProgramCounter;
-
-		m_ThisStack.push_back(Value::MakePointer(objToCallFunctionOn.type, 1, objToCallFunctionOn.data, m_StackAllocator));
-
-		m_CallStack.push_back(callFrame);
-		m_FrameStack.push_back(frame);
-
-		m_ProgramCounter = function->pc;
-	} break;
-	case OpCode::CONSTRUCTOR_CALL: {
-		uint16 type = ReadUInt16();
-		uint16 functionID = ReadUInt16();
-
-		Value object = Value::MakeObject(this, type, m_StackAllocator);
-		m_ScopeStack[m_CurrentScope].objects.push_back(object);
-
-		uint32 ccount = m_PendingConstructors.size();
-		AddConstructorRecursive(object);
-		ExecutePendingConstructors(ccount);
-
-		Class* cls = GetClass(type);
-		Function* function = cls->GetFunction(functionID);
-
-		CallFrame callFrame;
-		callFrame.basePointer = m_Stack.size();
-		callFrame.popThisStack = true;
-		callFrame.usesReturnValue = false;
-		callFrame.loopCount = m_LoopStack.size();
-		callFrame.function = function;
-
-		m_CurrentScope++;
-		m_ScopeStack[m_CurrentScope].marker = m_StackAllocator->GetMarker();
-		callFrame.scopeCount = m_CurrentScope;
-
-		Frame* frame = m_FramePool.Acquire(function->numLocals);
-		AddFunctionArgsToFrame(frame, function);
-
-		callFrame.returnPC = m_ProgramCounter;
-
-		m_ThisStack.push_back(Value::MakePointer(type, 1, object.data, m_StackAllocator));
-
-		m_CallStack.push_back(callFrame);
-		m_FrameStack.push_back(frame);
-
-		m_ProgramCounter = function->pc;
-
-		m_Stack.push_back(object);
-	} break;
-	case OpCode::ADDRESS_OF: {
-		Value value = m_Stack.back();
-		m_Stack.pop_back();
-		Value pointer = Value::MakePointer(value.type, value.pointerLevel + 1, value.data, m_StackAllocator);
-		m_Stack.push_back(pointer);
-	} break;
-	case OpCode::DEREFERENCE: {
-		Value pointer = m_Stack.back();
-		m_Stack.pop_back();
-		Value value = pointer.Dereference();
-		m_Stack.push_back(value);
-	} break;
-	case OpCode::ADD: {
-		uint16 functionID = ReadUInt16();
-		Value rhs = m_Stack.back(); m_Stack.pop_back();
-		Value lhs = m_Stack.back(); m_Stack.pop_back();
-		if (lhs.IsPointer())
-		{
-			Value val = lhs;
-			val.data = (uint8*)lhs.data + rhs.GetUInt64() * GetTypeSize(lhs.type);
-			m_Stack.push_back(val);
-		}
-		else if (functionID != INVALID_ID)
-		{
-			Class* cls = GetClass(lhs.type);
-			Function* function = cls->GetFunction(functionID);
-			ExecuteArithmaticFunction(lhs, rhs, function);
-		}
-		else
-		{
-			Value value = lhs.Add(rhs, m_StackAllocator);
-			m_Stack.push_back(value);
-		}
-	} break;
-	case OpCode::SUBTRACT: {
-		uint16 functionID = ReadUInt16();
-		Value rhs = m_Stack.back(); m_Stack.pop_back();
-		Value lhs = m_Stack.back(); m_Stack.pop_back();
-		if (lhs.IsPointer())
-		{
-			Value val = lhs;
-			val.data = (uint8*)lhs.data - rhs.GetUInt64() * GetTypeSize(lhs.type);
-			m_Stack.push_back(val);
-		}
-		else if (functionID != INVALID_ID)
-		{
-			Class* cls = GetClass(lhs.type);
-			Function* function = cls->GetFunction(functionID);
-			ExecuteArithmaticFunction(lhs, rhs, function);
-		}
-		else
-		{
-			Value value = lhs.Sub(rhs, m_StackAllocator);
-			m_Stack.push_back(value);
-		}
-	} break;
-	case OpCode::MULTIPLY: {
-		uint16 functionID = ReadUInt16();
-		Value rhs = m_Stack.back(); m_Stack.pop_back();
-		Value lhs = m_Stack.back(); m_Stack.pop_back();
-		if (functionID != INVALID_ID)
-		{
-			Class* cls = GetClass(lhs.type);
-			Function* function = cls->GetFunction(functionID);
-			ExecuteArithmaticFunction(lhs, rhs, function);
-		}
-		else
-		{
-			Value value = lhs.Mul(rhs, m_StackAllocator);
-			m_Stack.push_back(value);
-		}
-	} break;
-	case OpCode::DIVIDE: {
-		uint16 functionID = ReadUInt16();
-		Value rhs = m_Stack.back(); m_Stack.pop_back();
-		Value lhs = m_Stack.back(); m_Stack.pop_back();
-		if (functionID != INVALID_ID)
-		{
-			Class* cls = GetClass(lhs.type);
-			Function* function = cls->GetFunction(functionID);
-			ExecuteArithmaticFunction(lhs, rhs, function);
-		}
-		else
-		{
-			Value value = lhs.Div(rhs, m_StackAllocator);
-			m_Stack.push_back(value);
-		}
-	} break;
-	case OpCode::MOD: {
-		uint16 functionID = ReadUInt16();
-		Value rhs = m_Stack.back(); m_Stack.pop_back();
-		Value lhs = m_Stack.back(); m_Stack.pop_back();
-		if (functionID != INVALID_ID)
-		{
-			Class* cls = GetClass(lhs.type);
-			Function* function = cls->GetFunction(functionID);
-			ExecuteArithmaticFunction(lhs, rhs, function);
-		}
-		else
-		{
-			Value value = lhs.Mod(rhs, m_StackAllocator);
-			m_Stack.push_back(value);
-		}
-	} break;
-	case OpCode::LESS: {
-		uint16 functionID = ReadUInt16();
-		Value rhs = m_Stack.back(); m_Stack.pop_back();
-		Value lhs = m_Stack.back(); m_Stack.pop_back();
-		if (functionID != INVALID_ID)
-		{
-			Class* cls = GetClass(lhs.type);
-			Function* function = cls->GetFunction(functionID);
-			ExecuteArithmaticFunction(lhs, rhs, function);
-		}
-		else
-		{
-			Value value = lhs.LessThan(rhs, m_StackAllocator);
-			m_Stack.push_back(value);
-		}
-	} break;
-	case OpCode::GREATER: {
-		uint16 functionID = ReadUInt16();
-		Value rhs = m_Stack.back(); m_Stack.pop_back();
-		Value lhs = m_Stack.back(); m_Stack.pop_back();
-		if (functionID != INVALID_ID)
-		{
-			Class* cls = GetClass(lhs.type);
-			Function* function = cls->GetFunction(functionID);
-			ExecuteArithmaticFunction(lhs, rhs, function);
-		}
-		else
-		{
-			Value value = lhs.GreaterThan(rhs, m_StackAllocator);
-			m_Stack.push_back(value);
-		}
-	} break;
-	case OpCode::LESS_EQUAL: {
-		uint16 functionID = ReadUInt16();
-		Value rhs = m_Stack.back(); m_Stack.pop_back();
-		Value lhs = m_Stack.back(); m_Stack.pop_back();
-		if (functionID != INVALID_ID)
-		{
-			Class* cls = GetClass(lhs.type);
-			Function* function = cls->GetFunction(functionID);
-			ExecuteArithmaticFunction(lhs, rhs, function);
-		}
-		else
-		{
-			Value value = lhs.LessThanOrEqual(rhs, m_StackAllocator);
-			m_Stack.push_back(value);
-		}
-	} break;
-	case OpCode::GREATER_EQUAL: {
-		uint16 functionID = ReadUInt16();
-		Value rhs = m_Stack.back(); m_Stack.pop_back();
-		Value lhs = m_Stack.back(); m_Stack.pop_back();
-		if (functionID != INVALID_ID)
-		{
-			Class* cls = GetClass(lhs.type);
-			Function* function = cls->GetFunction(functionID);
-			ExecuteArithmaticFunction(lhs, rhs, function);
-		}
-		else
-		{
-			Value value = lhs.GreaterThanOrEqual(rhs, m_StackAllocator);
-			m_Stack.push_back(value);
-		}
-	} break;
-	case OpCode::EQUALS: {
-		uint16 functionID = ReadUInt16();
-		Value rhs = m_Stack.back(); m_Stack.pop_back();
-		Value lhs = m_Stack.back(); m_Stack.pop_back();
-		if (functionID != INVALID_ID)
-		{
-			Class* cls = GetClass(lhs.type);
-			Function* function = cls->GetFunction(functionID);
-			ExecuteArithmaticFunction(lhs, rhs, function);
-		}
-		else
-		{
-			Value value = lhs.Equals(rhs, m_StackAllocator);
-			m_Stack.push_back(value);
-		}
-	} break;
-	case OpCode::NOT_EQUALS: {
-		uint16 functionID = ReadUInt16();
-		Value rhs = m_Stack.back(); m_Stack.pop_back();
-		Value lhs = m_Stack.back(); m_Stack.pop_back();
-		if (functionID != INVALID_ID)
-		{
-			Class* cls = GetClass(lhs.type);
-			Function* function = cls->GetFunction(functionID);
-			ExecuteArithmaticFunction(lhs, rhs, function);
-		}
-		else
-		{
-			Value value = lhs.NotEquals(rhs, m_StackAllocator);
-			m_Stack.push_back(value);
-		}
-	} break;
-	case OpCode::LOGICAL_AND: {
-		uint16 functionID = ReadUInt16();
-		Value rhs = m_Stack.back(); m_Stack.pop_back();
-		Value lhs = m_Stack.back(); m_Stack.pop_back();
-		Value value = lhs.LogicalAnd(rhs, m_StackAllocator);
-		m_Stack.push_back(value);
-	} break;
-	case OpCode::LOGICAL_OR: {
-		uint16 functionID = ReadUInt16();
-		Value rhs = m_Stack.back(); m_Stack.pop_back();
-		Value lhs = m_Stack.back(); m_Stack.pop_back();
-		Value value = lhs.LogicalOr(rhs, m_StackAllocator);
-		m_Stack.push_back(value);
-	} break;
-	case OpCode::PUSH_SCOPE: {
-		m_CurrentScope++;
-		m_ScopeStack[m_CurrentScope].marker = m_StackAllocator->GetMarker();
-	} break;
-	case OpCode::POP_SCOPE: {
-		ScopeInfo* scope = &m_ScopeStack[m_CurrentScope];
-		uint32 dcount = m_PendingDestructors.size();
-		for (uint32 i = 0; i < scope->objects.size(); i++)
-		{
-			AddDestructorRecursive(scope->objects[i]);
-		}
-		ExecutePendingDestructors(dcount);
-		scope->objects.clear();
-
-		m_StackAllocator->FreeToMarker(scope->marker);
-		m_CurrentScope--;
-	} break;
-	case OpCode::PUSH_LOOP: {
-		LoopFrame loop;
-		loop.startPC = ReadUInt32();
-		loop.endPC = ReadUInt32();
-		loop.scopeCount = m_CurrentScope;
-		m_LoopStack.push_back(loop);
-	} break;
-	case OpCode::POP_LOOP: {
-		m_LoopStack.pop_back();
-	} break;
-	case OpCode::UNARY_UPDATE: {
-		uint8 type = ReadUInt8();
-		bool pushToStack = ReadUInt8();
-		switch (type)
-		{
-		case 0: { //Pre-inc
-			Value value = m_Stack.back();
-			value.Increment();
-			if (!pushToStack)
-				m_Stack.pop_back();
-		} break;
-		case 1: { //Pre-dec
-			Value value = m_Stack.back();
-			value.Decrement();
-			if (!pushToStack)
-				m_Stack.pop_back();
-		} break;
-		case 2: { //Post-inc
-			Value value = m_Stack.back(); m_Stack.pop_back();
-			Value clone = pushToStack ? value.Clone(this, m_StackAllocator) : Value::MakeNULL();
-			value.Increment();
-			if (pushToStack)
-				m_Stack.push_back(clone);
-		} break;
-		case 3: { //Post-dec
-			Value value = m_Stack.back(); m_Stack.pop_back();
-			Value clone = pushToStack ? value.Clone(this, m_StackAllocator) : Value::MakeNULL();
-			value.Decrement();
-			if (pushToStack)
-				m_Stack.push_back(clone);
-		} break;
-		}
-	} break;
-	case OpCode::BREAK: {
-		LoopFrame loop = m_LoopStack.back();
-
-		for (uint32 i = loop.scopeCount + 1; i < m_CurrentScope; i++)
-		{
-			for (uint32 j = 0; j < m_ScopeStack[i].objects.size(); j++) //TODO: Call destructors
-			{
-
-			}
-
-			m_StackAllocator->FreeToMarker(m_ScopeStack[i].marker);
-		}
-
-		m_CurrentScope = loop.scopeCount + 1;
-		m_ProgramCounter = loop.endPC;
-	} break;
-	case OpCode::CONTINUE: {
-		LoopFrame loop = m_LoopStack.back();
-		
-		for (uint32 i = loop.scopeCount; i < m_ScopeStack.size(); i++)
-		{
-			for (uint32 j = 0; j < m_ScopeStack[i].objects.size(); j++) //TODO: Call destructors
-			{
-
-			}
-
-			m_StackAllocator->FreeToMarker(m_ScopeStack[i].marker);
-		}
-
-		m_ScopeStack.resize(loop.scopeCount + 1);
-		m_ProgramCounter = loop.startPC;
-	} break;
-	case OpCode::NEW: {
-		uint16 type = ReadUInt16();
-		uint16 functionID = ReadUInt16();
-		Value object = Value::MakeObject(this, type, m_HeapAllocator);
-		Value pointer = Value::MakePointer(type, 1, object.data, m_StackAllocator);
-
-		uint32 ccount = m_PendingConstructors.size();
-		AddConstructorRecursive(object);
-		ExecutePendingConstructors(ccount);
-
-		if (functionID != INVALID_ID)
-		{
-			Function* function = GetClass(type)->GetFunction(functionID);
-
-			CallFrame callFrame;
-			callFrame.basePointer = m_Stack.size();
-			callFrame.popThisStack = true;
-			callFrame.usesReturnValue = false;
-			callFrame.loopCount = m_LoopStack.size();
-			callFrame.function = function;
-
-			m_CurrentScope++;
-			m_ScopeStack[m_CurrentScope].marker = m_StackAllocator->GetMarker();
-			callFrame.scopeCount = m_CurrentScope;
-
-			Frame* frame = m_FramePool.Acquire(function->numLocals);
-			AddFunctionArgsToFrame(frame, function);
-
-			callFrame.returnPC = m_ProgramCounter;
-
-			m_ThisStack.push_back(pointer);
-
-			m_CallStack.push_back(callFrame);
-			m_FrameStack.push_back(frame);
-
-			m_ProgramCounter = function->pc;
-		}
-
-		m_Stack.push_back(pointer);
-	} break;
-	case OpCode::NEW_ARRAY: {
-		uint16 type = ReadUInt16();
-		uint8 pointerLevel = ReadUInt8();
-		uint32 size = m_Stack.back().Actual().GetUInt32();
-		m_Stack.pop_back();
-
-		Value array = Value::MakeArray(this, type, pointerLevel, &size, 1, m_HeapAllocator);
-
-		if (!Value::IsPrimitiveType(type))
-		{
-			uint32 ccount = m_PendingConstructors.size();
-			uint64 typeSize = GetTypeSize(type);
-			for (uint32 i = 0; i < size; i++)
-			{
-				Value element;
-				element.type = type;
-				element.pointerLevel = pointerLevel;
-				element.isReference = false;
-				element.isArray = false;
-				element.data = (uint8*)array.data + i * typeSize;
-
-				AddConstructorRecursive(element, true);
-			}
-
-			ExecutePendingConstructors(ccount);
-		}
-
-		Value pointer = Value::MakePointer(type, pointerLevel + 1, array.data, m_StackAllocator);
-		//pointer.isArray = true;
-		m_Stack.push_back(pointer);
-	} break;
-	case OpCode::DELETE: {
-		Value object = m_Stack.back();
-		m_Stack.pop_back();
-
-		object = object.Dereference();
-
-		uint32 dcount = m_PendingDestructors.size();
-		AddDestructorRecursive(object);
-		ExecutePendingDestructors(dcount);
-
-		m_HeapAllocator->Free((uint8*)object.data - sizeof(VTable*));
-	} break;
-	case OpCode::DELETE_ARRAY: {
-		Value heapArray = m_Stack.back().Dereference();
-		m_Stack.pop_back();
-
-		ArrayHeader* arrayHeader = (ArrayHeader*)((uint8*)heapArray.data - sizeof(ArrayHeader));
-		if (arrayHeader->elementPointerLevel == 0)
-		{
-			uint32 dcount = m_PendingDestructors.size();
-			uint64 typeSize = GetTypeSize(heapArray.type);
-			uint32 numElements = 1;
-			for (uint32 i = 0; i < arrayHeader->numDimensions; i++)
-				numElements *= arrayHeader->dimensions[i];
-
-			for (uint32 i = 0; i < numElements; i++)
-			{
-				Value element;
-				element.type = heapArray.type;
-				element.isArray = false;
-				element.pointerLevel = 0;
-				element.data = (uint8*)heapArray.data + (typeSize * i);
-				AddDestructorRecursive(element);
-			}
-
-			ExecutePendingDestructors(dcount);
-		}
-
-		m_HeapAllocator->Free(arrayHeader);
-	} break;
-	case OpCode::CAST: {
-		uint16 targetType = ReadUInt16();
-		uint8 targetPointerLevel = ReadUInt8();
-		Value value = m_Stack.back();
-		m_Stack.pop_back();
-
-		value = value.CastTo(this, targetType, targetPointerLevel, m_StackAllocator);
-		m_Stack.push_back(value);
-	} break;
-	case OpCode::NEGATE: {
-		Value value = m_Stack.back();
-		m_Stack.pop_back();
-		value = value.Negate(m_StackAllocator);
-		m_Stack.push_back(value);
-	} break;
-	case OpCode::INVERT: {
-		Value value = m_Stack.back();
-		m_Stack.pop_back();
-		value = value.Invert(m_StackAllocator);
-		m_Stack.push_back(value);
-	} break;
-	case OpCode::STRLEN: {
-		Value value = m_Stack.back();
-		m_Stack.pop_back();
-		uint32 length = strlen(value.GetCString());
-		m_Stack.push_back(Value::MakeUInt32(length, m_StackAllocator));
-	} break;
-	case OpCode::PLUS_EQUALS: {
-		Value increment = m_Stack.back();
-		m_Stack.pop_back();
-		Value value = m_Stack.back();
-		m_Stack.pop_back();
-		value.PlusEquals(increment);
-	} break;
-	case OpCode::MINUS_EQUALS: {
-		Value increment = m_Stack.back();
-		m_Stack.pop_back();
-		Value value = m_Stack.back();
-		m_Stack.pop_back();
-		value.MinusEquals(increment);
-	} break;
-	case OpCode::TIMES_EQUALS: {
-		Value increment = m_Stack.back();
-		m_Stack.pop_back();
-		Value value = m_Stack.back();
-		m_Stack.pop_back();
-		value.TimesEquals(increment);
-	} break;
-	case OpCode::DIVIDE_EQUALS: {
-		Value increment = m_Stack.back();
-		m_Stack.pop_back();
-		Value value = m_Stack.back();
-		m_Stack.pop_back();
-		value.DivideEquals(increment);
-	} break;
-	case OpCode::INT_TO_STR: {
-		Value value = m_Stack.back();
-		m_Stack.pop_back();
-		Value str = Value::MakeCStr(std::to_string(value.GetInt64()), m_StackAllocator);
-		str = Value::MakePointer((uint16)ValueType::CHAR, 1, str.data, m_StackAllocator);
-		m_Stack.push_back(str);
-	} break;
-	case OpCode::BREAK_POINT: {
-		uint32 bp = 0;
-	} break;
-	case OpCode::STR_TO_INT: {
-		Value strValue = m_Stack.back();
-		m_Stack.pop_back();
-		Value intValue = Value::MakeInt64(std::atoi((char*)*(void**)strValue.data), m_StackAllocator);
-		m_Stack.push_back(intValue);
-	} break;
-	}
-}
-
-void Program::ExecuteModuleFunctionCall(uint16 moduleID, uint16 function, bool usesReturnValue)
-{
-	Value value = Value::MakeNULL();
-	switch (moduleID)
-	{
-	case IO_MODULE_ID: value = IOModule::CallFunction(this, function, m_ArgStorage); break;
-	case MATH_MODULE_ID: value = MathModule::CallFunction(this, function, m_ArgStorage); break;
-	case WINDOW_MODULE_ID: value = WindowModule::CallFunction(this, function, m_ArgStorage); break;
-	case GL_MODULE_ID: value = GLModule::CallFunction(this, function, m_ArgStorage); break;
-	case FS_MODULE_ID: value = FSModule::CallFunction(this, function, m_ArgStorage); break;
-	case MEM_MODULE_ID: value = MemModule::CallFunction(this, function, m_ArgStorage); break;
-	case TIME_MODULE_ID: value = TimeModule::CallFunction(this, function, m_ArgStorage); break;
-	}
-
-	if (value.type != INVALID_ID && usesReturnValue)
-		m_Stack.push_back(value);
-}
-
-void Program::ExecuteModuleConstant(uint16 moduleID, uint16 constant)
-{
-	switch (moduleID)
-	{
-	case IO_MODULE_ID: m_Stack.push_back(IOModule::Constant(this, constant)); break;
-	case MATH_MODULE_ID: m_Stack.push_back(MathModule::Constant(this, constant)); break;
-	case WINDOW_MODULE_ID: m_Stack.push_back(WindowModule::Constant(this, constant)); break;
-	case GL_MODULE_ID: m_Stack.push_back(GLModule::Constant(this, constant)); break;
-	case FS_MODULE_ID: m_Stack.push_back(FSModule::Constant(this, constant)); break;
-	case MEM_MODULE_ID: m_Stack.push_back(MemModule::Constant(this, constant)); break;
-	case TIME_MODULE_ID: m_Stack.push_back(TimeModule::Constant(this, constant)); break;
-	}
-}
-
-void Program::ExecuteAssignFunction(const Value& dstValue, const Value& assignValue, Function* function)
-{
-	CallFrame callFrame;
-	callFrame.basePointer = m_Stack.size();
-	callFrame.popThisStack = true;
-	callFrame.usesReturnValue = false;
-	callFrame.loopCount = m_LoopStack.size();
-	callFrame.function = function;
-
-	m_CurrentScope++;
-	m_ScopeStack[m_CurrentScope].marker = m_StackAllocator->GetMarker();
-	callFrame.scopeCount = m_CurrentScope;
-
-	m_Stack.push_back(assignValue);
-	Frame* frame = m_FramePool.Acquire(function->numLocals);
-	AddFunctionArgsToFrame(frame, function);
-
-	callFrame.returnPC = m_ProgramCounter;
-
-	m_ThisStack.push_back(Value::MakePointer(dstValue.type, 1, dstValue.data, m_StackAllocator));
-
-	m_CallStack.push_back(callFrame);
-	m_FrameStack.push_back(frame);
-
-	m_ProgramCounter = function->pc;
-
-	while (m_ProgramCounter != callFrame.returnPC)
-	{
-		OpCode innerOpCode = ReadOPCode();
-
-		if (innerOpCode == OpCode::UNARY_UPDATE)
-		{
-			uint32 bp = 0;
-		}
-
-		if (innerOpCode == OpCode::END) break;
-		ExecuteOpCode(innerOpCode);
-	}
-}
-
-void Program::ExecuteArithmaticFunction(const Value& lhs, const Value& rhs, Function* function)
-{
-	CallFrame callFrame;
-	callFrame.basePointer = m_Stack.size();
-	callFrame.popThisStack = true;
-	callFrame.usesReturnValue = true;
-	callFrame.loopCount = m_LoopStack.size();
-	callFrame.function = function;
-
-	m_CurrentScope++;
-	m_ScopeStack[m_CurrentScope].marker = m_StackAllocator->GetMarker();
-	callFrame.scopeCount = m_CurrentScope;
-
-	m_Stack.push_back(rhs);
-	Frame* frame = m_FramePool.Acquire(function->numLocals);
-	AddFunctionArgsToFrame(frame, function);
-	callFrame.returnPC = m_ProgramCounter;
-
-	m_ThisStack.push_back(Value::MakePointer(lhs.type, 1, lhs.data, m_StackAllocator));
-
-	m_CallStack.push_back(callFrame);
-	m_FrameStack.push_back(frame);
-
-	m_ProgramCounter = function->pc;
-}
-
-void Program::ExecuteCastFunction(const Value& dstValue, const Value& srcValue, Function* function)
-{
-	CallFrame callFrame;
-	callFrame.basePointer = m_Stack.size();
-	callFrame.popThisStack = true;
-	callFrame.usesReturnValue = false;
-	callFrame.loopCount = m_LoopStack.size();
-	callFrame.function = function;
-
-	m_CurrentScope++;
-	m_ScopeStack[m_CurrentScope].marker = m_StackAllocator->GetMarker();
-	callFrame.scopeCount = m_CurrentScope;
-
-	m_Stack.push_back(srcValue);
-	Frame* frame = m_FramePool.Acquire(function->numLocals);
-	AddFunctionArgsToFrame(frame, function, false);
-
-	callFrame.returnPC = m_ProgramCounter;
-
-	m_ThisStack.push_back(Value::MakePointer(dstValue.type, 1, dstValue.data, m_StackAllocator));
-
-	m_CallStack.push_back(callFrame);
-	m_FrameStack.push_back(frame);
-
-	m_ProgramCounter = function->pc;
-
-	while (m_ProgramCounter != callFrame.returnPC)
-	{
-		OpCode innerOpCode = ReadOPCode();
-		if (innerOpCode == OpCode::END) break;
-		ExecuteOpCode(innerOpCode);
-	}
-}
-
-void Program::AddFunctionArgsToFrame(Frame* frame, Function* function, bool readCastFunctionID)
-{
-	for (int32 i = function->parameters.size() - 1; i >= 0; i--)
-	{
-		uint16 castFunctionID = INVALID_ID;
-		if (readCastFunctionID)
-			castFunctionID = ReadUInt16();
-
-		const FunctionParameter& param = function->parameters[i];
-		Value arg = m_Stack.back(); m_Stack.pop_back();
-
-		if (castFunctionID != INVALID_ID)
-		{
-			Class* toClass = GetClass(param.type.type);
-			Function* castFunction = toClass->GetFunction(castFunctionID);
-			Value original = arg;
-			arg = Value::MakeObject(this, param.type.type, m_StackAllocator);
-			m_ScopeStack[m_CurrentScope].objects.push_back(arg);
-			ExecuteCastFunction(arg, original, castFunction);
-		}
-
-		if (!param.isReference)
-		{
-			if (!Value::IsPrimitiveType(param.type.type) && param.type.pointerLevel == 0)
-			{
-				Value original = arg;
-				Class* cls = GetClass(param.type.type);
-				Function* copyConstructor = cls->GetCopyConstructor();
-				arg = Value::MakeObject(this, arg.type, m_StackAllocator);
-				ExecuteAssignFunction(arg, original, copyConstructor);
-			}
-			else
-			{
-				arg = arg.Clone(this, m_StackAllocator);
-			}
-		}
-		
-		if (arg.type != param.type.type)
-		{
-			if (arg.isReference)
-			{
-				throw std::runtime_error("Reference type mismatch");
-			}
-			else
-			{
-				arg = arg.CastTo(this, param.type.type, param.type.pointerLevel, m_StackAllocator);
-			}
-		}
-
-		frame->DeclareLocal(param.variableID, arg);
-	}
-}
-
-void Program::AddDestructorRecursive(const Value& value)
-{
-	if (value.IsPrimitive() || value.IsPointer())
-		return;
-
-	Class* cls = GetClass(value.type);
-	if (!cls)
-		return;
-
-	const std::vector<ClassField>& members = cls->GetMemberFields();
-	for (int32 i = (int32)members.size() - 1; i >= 0; i--)
-	{
-		const ClassField& field = members[i];
-
-		if (Value::IsPrimitiveType(field.type.type) || field.type.pointerLevel > 0)
-			continue;
-
-		if (field.numDimensions > 0)
-		{
-			uint64 typeSize = GetTypeSize(field.type.type);
-			uint32 numElements = 1;
-			for (uint32 j = 0; j < field.numDimensions; j++)
-				numElements *= field.dimensions[j].first;
-
-			uint8* data = (uint8*)value.data + field.offset;
-			for (uint32 j = 0; j < numElements; j++)
-			{
-				Value element;
-				element.type = field.type.type;
-				element.pointerLevel = 0;
-				element.data = data + j * typeSize;
-
-				AddDestructorRecursive(element);
-			}
-		}
-		else
-		{
-			Value member;
-			member.type = field.type.type;
-			member.pointerLevel = 0;
-			member.data = (uint8*)value.data + field.offset;
-
-			AddDestructorRecursive(member);
-		}
+		std::cout << m_Classes[i]->GetName() << " code size: " << m_Classes[i]->GetCodeSize()
+			<< " (fixed-width: " << m_Classes[i]->GetFixedWidthCodeSize() << ")" << std::endl;
 	}
 
-	m_PendingDestructors.push_back(value);
+	std::cout << "Total code size: " << m_Code.size() << " (fixed-width: " << m_Code.size() + m_EncodingSavings << ")" << std::endl;
 }
 
-void Program::ExecutePendingDestructors(uint32 offset)
+void Program::PrintPaddingReport() const
 {
-	if (offset == m_PendingDestructors.size()) return;
-
-	for (uint32 i = offset; i < m_PendingDestructors.size(); i++)
+	uint64 totalPadding = 0;
+	uint64 totalSaved = 0;
+	for (uint32 i = 0; i < m_Classes.size(); i++)
 	{
-		const Value& object = m_PendingDestructors[i];
-		Class* cls = GetClass(object.type);
-		Function* destructor = cls->GetDestructor();
-		if (!destructor)
+		const Class* cls = m_Classes[i];
+		if (cls->IsTemplateClass() || cls->GetMemberFields().empty())
 			continue;
 
-		CallFrame callFrame;
-		callFrame.basePointer = m_Stack.size();
-		callFrame.popThisStack = true;
-		callFrame.usesReturnValue = false;
-		callFrame.loopCount = m_LoopStack.size();
-		callFrame.function = destructor;
-
-		m_CurrentScope++;
-		m_ScopeStack[m_CurrentScope].marker = m_StackAllocator->GetMarker();
-		callFrame.scopeCount = m_CurrentScope;
-
-		Frame* frame = m_FramePool.Acquire(destructor->numLocals);
-		AddFunctionArgsToFrame(frame, destructor);
-
-		callFrame.returnPC = m_ProgramCounter;
-
-		m_ThisStack.push_back(Value::MakePointer(object.type, 1, object.data, m_StackAllocator));
+		uint64 padding = cls->GetPadding();
+		uint64 saved = cls->GetDeclaredOrderSize() - cls->GetSize();
+		totalPadding += padding;
+		totalSaved += saved;
 
-		m_CallStack.push_back(callFrame);
-		m_FrameStack.push_back(frame);
-
-		m_ProgramCounter = destructor->pc;
-
-		while (m_ProgramCounter != callFrame.returnPC)
-		{
-			OpCode innerOpCode = ReadOPCode();
-			if (innerOpCode == OpCode::END) break;
-			ExecuteOpCode(innerOpCode);
-		}
+		std::cout << cls->GetName() << ": " << cls->GetSize() << " bytes, align " << cls->GetAlignment() << ", padding " << padding;
+		if (cls->IsPacked())
+			std::cout << " (packed, " << saved << " bytes saved)";
+		std::cout << std::endl;
 	}
 
-	m_PendingDestructors.resize(offset);
+	std::cout << "Total padding: " << totalPadding << " bytes, saved by packing: " << totalSaved << " bytes" << std::endl;
 }
 
-void Program::AddConstructorRecursive(const Value& value, bool addValue)
+Function* Program::GetFunctionFromReference(uint32 reference, uint16* classID)
 {
-	if (value.IsPrimitive() || value.IsPointer())
-		return;
-
-	Class* cls = GetClass(value.type);
-	if (!cls)
-		return;
-
-	const std::vector<ClassField>& members = cls->GetMemberFields();
-	for (int32 i = (int32)members.size() - 1; i >= 0; i--)
-	{
-		const ClassField& field = members[i];
+	uint16 id = reference >> 16;
+	if (id < 128 || id - 128 >= m_Classes.size())
+		return nullptr;
 
-		if (Value::IsPrimitiveType(field.type.type) || field.type.pointerLevel > 0)
-			continue;
+	Class* cls = GetClass(id);
+	uint16 functionID = reference & 0xFFFF;
+	if (functionID >= cls->GetNumFunctions())
+		return nullptr;
 
-		if (field.numDimensions > 0)
-		{
-			uint64 typeSize = GetTypeSize(field.type.type);
-			uint32 numElements = 1;
-			for (uint32 j = 0; j < field.numDimensions; j++)
-				numElements *= field.dimensions[j].first;
-
-			uint8* data = (uint8*)value.data + field.offset;
-			for (uint32 j = 0; j < numElements; j++)
-			{
-				Value element;
-				element.type = field.type.type;
-				element.pointerLevel = 0;
-				element.data = data + j * typeSize;
-
-				AddConstructorRecursive(element, true);
-			}
-		}
-		else
-		{
-			Value member;
-			member.type = field.type.type;
-			member.pointerLevel = 0;
-			member.data = (uint8*)value.data + field.offset;
-
-			AddConstructorRecursive(member, true);
-		}
-	}
+	if (classID)
+		*classID = id;
 
-	if (cls->HasDefaultConstructor() && addValue)
-		m_PendingConstructors.push_back(std::make_pair(value, cls->GetDefaultConstructor()));
+	return cls->GetFunction(functionID);
 }
 
-void Program::ExecutePendingConstructors(uint32 offset)
+uint16 Program::AddPlugin(PluginModule* plugin)
 {
-	if (offset == m_PendingConstructors.size()) return;
-
-	for (uint32 i = offset; i < m_PendingConstructors.size(); i++)
-	{
-		const Value& object = m_PendingConstructors[i].first;
-		Function* constructor = m_PendingConstructors[i].second;
-
-		CallFrame callFrame;
-		callFrame.basePointer = m_Stack.size();
-		callFrame.popThisStack = true;
-		callFrame.usesReturnValue = false;
-		callFrame.loopCount = m_LoopStack.size();
-		callFrame.function = constructor;
-
-		m_CurrentScope++;
-		m_ScopeStack[m_CurrentScope].marker = m_StackAllocator->GetMarker();
-		callFrame.scopeCount = m_CurrentScope;
-
-		Frame* frame = m_FramePool.Acquire(constructor->numLocals);
-
-		callFrame.returnPC = m_ProgramCounter;
-
-		m_ThisStack.push_back(Value::MakePointer(object.type, 1, object.data, m_StackAllocator));
-
-		m_CallStack.push_back(callFrame);
-		m_FrameStack.push_back(frame);
-
-		m_ProgramCounter = constructor->pc;
-
-		while (m_ProgramCounter != callFrame.returnPC)
-		{
-			OpCode innerOpCode = ReadOPCode();
-			if (innerOpCode == OpCode::END) break;
-			ExecuteOpCode(innerOpCode);
-		}
-	}
-
-	m_PendingConstructors.resize(offset);
+	m_Plugins.push_back(plugin);
+	return PLUGIN_MODULE_ID_BASE + m_Plugins.size() - 1;
 }
 
-void Program::AddCopyConstructorRecursive(const Value& dst, const Value& src)
+uint16 Program::GetHostFunctionID(const std::string& name) const
 {
-	Class* cls = GetClass(dst.type);
-	const std::vector<ClassField>& members = cls->GetMemberFields();
-	for (uint32 i = 0; i < members.size(); i++)
+	for (uint32 i = 0; i < m_HostFunctions.size(); i++)
 	{
-		const TypeInfo& memberType = members[i].type;
-		uint64 memberOffset = members[i].offset;
-		if (Value::IsPrimitiveType(memberType.type) || memberType.pointerLevel > 0)
-			continue;
-
-		Value dstMember = Value::MakeNULL(memberType.type, 0);
-		Value srcMember = Value::MakeNULL(memberType.type, 0);
-
-		dstMember.data = (uint8*)dst.data + memberOffset;
-		srcMember.data = (uint8*)src.data + memberOffset;
-
-		Class* memberClass = GetClass(memberType.type);
-		Function* copyConstructor = memberClass->GetCopyConstructor();
-		if (copyConstructor)
-		{
-			m_PendingCopyConstructors.push_back({ dstMember, srcMember, copyConstructor });
-		}
-		else
-		{
-			AddCopyConstructorRecursive(dstMember, srcMember);
-		}
+		if (m_HostFunctions[i].name == name)
+			return i;
 	}
-}
-
-void Program::ExecutePendingCopyConstructors(uint32 offset)
-{
-	for (uint32 i = offset; i < m_PendingCopyConstructors.size(); i++)
-	{
-		const PendingCopyConstructor& cc = m_PendingCopyConstructors[i];
-		const Value& dst = cc.dst;
-		const Value& src = cc.src;
-		Function* function = cc.constructor;
 
-		m_Stack.push_back(src);
-
-		CallFrame callFrame;
-		callFrame.basePointer = m_Stack.size();
-		callFrame.popThisStack = true;
-		callFrame.usesReturnValue = false;
-		callFrame.loopCount = m_LoopStack.size();
-		callFrame.function = function;
-
-		m_CurrentScope++;
-		m_ScopeStack[m_CurrentScope].marker = m_StackAllocator->GetMarker();
-		callFrame.scopeCount = m_CurrentScope;
-
-		Frame* frame = m_FramePool.Acquire(function->numLocals);
-		AddFunctionArgsToFrame(frame, function, false);
-
-		callFrame.returnPC = m_ProgramCounter;
-
-		m_ThisStack.push_back(Value::MakePointer(dst.type, 1, dst.data, m_StackAllocator));
-
-		m_CallStack.push_back(callFrame);
-		m_FrameStack.push_back(frame);
-
-		m_ProgramCounter = function->pc;
-
-		while (m_ProgramCounter != callFrame.returnPC)
-		{
-			OpCode innerOpCode = ReadOPCode();
-			if (innerOpCode == OpCode::END) break;
-			ExecuteOpCode(innerOpCode);
-		}
-	}
-
-	m_PendingCopyConstructors.resize(offset);
+	return INVALID_ID;
 }
 
 void Program::CleanUpForExecution()
 {
+	m_CompiledResidentSize = Memory::GetResidentSetSize();
+
+	// Only the bytecode, classes and function signatures are needed from here on
+	for (uint32 i = 0; i < m_Classes.size(); i++)
+		m_Classes[i]->ReleaseCompileData();
+
+	// Destructors free what the nodes own, their memory goes away with the arena
 	for (uint32 i = 0; i < m_CreatedExpressions.size(); i++)
-	{
 		delete m_CreatedExpressions[i];
-	}
 
-	m_CreatedExpressions.reserve(0);
+	std::vector<ASTExpression*>().swap(m_CreatedExpressions);
+	m_ASTAllocator->Destroy();
 	m_InitializationAllocator->Destroy();
+
+	m_ExecutionResidentSize = Memory::GetResidentSetSize();
 }
 
 void Program::InitStatics()
@@ -2238,83 +772,3 @@ void Program::InitStatics()
 		m_Classes[i]->InitStaticData(this);
 	}
 }
-
-uint64 Program::ReadUInt64()
-{
-	uint64* value = (uint64*)&m_Code[m_ProgramCounter];
-	m_ProgramCounter += sizeof(uint64);
-	return *value;
-}
-
-uint32 Program::ReadUInt32()
-{
-	uint32* value = (uint32*)&m_Code[m_ProgramCounter];
-	m_ProgramCounter += sizeof(uint32);
-	return *value;
-}
-
-uint16 Program::ReadUInt16()
-{
-	uint16* value = (uint16*)&m_Code[m_ProgramCounter];
-	m_ProgramCounter += sizeof(uint16);
-	return *value;
-}
-
-uint8 Program::ReadUInt8()
-{
-	return m_Code[m_ProgramCounter++];
-}
-
-int8 Program::ReadInt8()
-{
-	return static_cast<int8>(m_Code[m_ProgramCounter++]);
-}
-
-int16 Program::ReadInt16()
-{
-	int16* value = (int16*)&m_Code[m_ProgramCounter];
-	m_ProgramCounter += sizeof(int16);
-	return *value;
-}
-
-int32 Program::ReadInt32()
-{
-	int32* value = (int32*)&m_Code[m_ProgramCounter];
-	m_ProgramCounter += sizeof(int32);
-	return *value;
-}
-
-int64 Program::ReadInt64()
-{
-	int64* value = (int64*)&m_Code[m_ProgramCounter];
-	m_ProgramCounter += sizeof(int64);
-	return *value;
-}
-
-real32 Program::ReadReal32()
-{
-	real32* value = (real32*)&m_Code[m_ProgramCounter];
-	m_ProgramCounter += sizeof(real32);
-	return *value;
-}
-
-real64 Program::ReadReal64()
-{
-	real64* value = (real64*)&m_Code[m_ProgramCounter];
-	m_ProgramCounter += sizeof(real64);
-	return *value;
-}
-
-OpCode Program::ReadOPCode()
-{
-	return (OpCode)ReadUInt16();
-}
-
-char* Program::ReadCStr()
-{
-	char* value = *(char**)&m_Code[m_ProgramCounter];
-	m_ProgramCounter += sizeof(char*);
-	return value;
-}
-
-
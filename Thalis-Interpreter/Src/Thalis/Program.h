@@ -6,21 +6,31 @@
 
 #include "Value.h"
 #include "Memory/BumpAllocator.h"
+#include "Memory/SegmentedBumpAllocator.h"
 #include "Memory/HeapAllocator.h"
-#include "FramePool.h"
 #include "Function.h"
 #include "Operator.h"
+#include "Modules/ChanModule.h"
+#include "Modules/HostModule.h"
+#include "Modules/ModuleID.h"
+
+#define DEFAULT_MAX_CALL_DEPTH 1024
+#define DEFAULT_STACK_SEGMENT_SIZE_KB 128
+#define DEFAULT_STACK_CAPACITY_MB 64
+#define COROUTINE_STACK_SEGMENT_SIZE_KB 4
+#define AST_SEGMENT_SIZE_KB 256
+#define AST_CAPACITY_MB 1024
 
 enum class OpCode
 {
 	PUSH_UINT8, PUSH_UINT16, PUSH_UINT32, PUSH_UINT64,
-	PUSH_INT8, PUSH_INT16, PUSH_INT32, PUSH_INT64,
+	PUSH_INT8, PUSH_INT16, PUSH_INT32, PUSH_INT64, PUSH_INT32_SMALL,
 	PUSH_REAL32, PUSH_REAL64,
 	PUSH_CHAR, PUSH_BOOL, PUSH_CSTR, PUSH_LOCAL,
 	PUSH_TYPED_NULL, PUSH_INDEXED, PUSH_STATIC_VARIABLE,
 	PUSH_MEMBER, PUSH_THIS, PUSH_UNTYPED_NULL,
 
-	PUSH_SCOPE, POP_SCOPE, PUSH_LOOP, POP_LOOP,
+	PUSH_SCOPE, POP_SCOPE, POP_MARKER_SCOPE, PUSH_LOOP, POP_LOOP,
 
 	DECLARE_UINT8, DECLARE_UINT16, DECLARE_UINT32, DECLARE_UINT64,
 	DECLARE_INT8, DECLARE_INT16, DECLARE_INT32, DECLARE_INT64,
@@ -42,60 +52,38 @@ enum class OpCode
 
 	MODULE_CONSTANT, MEMBER_FUNCTION_CALL, CONSTRUCTOR_CALL, VIRTUAL_FUNCTION_CALL,
 	MODULE_FUNCTION_CALL, STATIC_FUNCTION_CALL, RETURN, NEW, NEW_ARRAY,
+	NEW_IN_ARENA, NEW_ARRAY_IN_ARENA,
 
-	STRLEN, INT_TO_STR, STR_TO_INT,
+	STRLEN, INT_TO_STR, STR_TO_INT, FIELD_INFO,
 
 	DELETE, DELETE_ARRAY,
 
 	JUMP, JUMP_IF_FALSE, BREAK_POINT,
 
+	PUSH_THIS_MEMBER, PUSH_LOCAL_MEMBER, PUSH_LOCAL_POINTER_MEMBER,
+	LESS_LOCAL_CONST_JUMP_IF_FALSE,
+	NATIVE_CALL, YIELD,
+
 	END
 };
 
-struct CallFrame
-{
-	uint32 returnPC;      // Where to continue after function returns
-	uint32 basePointer;   // Stack index where this function's locals begin
-	bool usesReturnValue;
-	bool popThisStack;
-	uint32 loopCount;
-	uint32 scopeCount;
-	Function* function;
-};
+static_assert((uint32)OpCode::END <= UINT8_MAX, "OpCodes are encoded as a single byte");
 
-struct ScopeInfo
-{
-	ScopeInfo()
-	{
-		objects.reserve(64);
-	}
+// Scripts hold &Class.Function as a uint32, class IDs start at 128 so 0 is never a valid reference
+#define MAKE_FUNCTION_REFERENCE(ClassID, FunctionID) (((uint32)(ClassID) << 16) | (uint32)(FunctionID))
 
-	uint64 marker;
-	std::vector<Value> objects;
-};
-
-struct LoopFrame
-{
-	uint32 startPC;
-	uint32 endPC;
-	uint32 scopeCount;
-};
-
-struct PendingCopyConstructor
-{
-	Value dst;
-	Value src;
-	Function* constructor;
-};
+// Flags operand of NATIVE_CALL, which is followed by the NativeFunctionDesc pointer
+#define NATIVE_CALL_USES_RETURN_VALUE	1
+#define NATIVE_CALL_REUSE_FIRST_ARG		2
 
 class Class;
+class PluginModule;
 struct ASTExpression;
 class Program
 {
 public:
 	Program();
-
-	void ExecuteProgram(uint32 pc);
+	~Program();
 
 	void AddJumpCommand(uint32 pc);
 	void AddPushConstantUInt8Command(uint8 value);
@@ -116,8 +104,11 @@ public:
 	void AddPushIndexedCommand(uint64 typeSize, uint8 numIndices, uint16 indexFunctionID, uint16 classID);
 	void AddPushStaticVariableCommand(uint16 classID, uint64 offset, uint16 type, uint8 pointerLevel, bool isReference, bool isArray);
 	void AddPushMemberCommand(uint16 type, uint8 pointerLevel, uint64 offset, bool isReference, bool isArray);
+	void AddPushThisMemberCommand(uint16 type, uint8 pointerLevel, uint64 offset, bool isReference, bool isArray);
+	void AddPushLocalMemberCommand(uint16 slot, bool dereferenceLocal, uint16 type, uint8 pointerLevel, uint64 offset, bool isReference, bool isArray);
+	uint32 AddLessLocalConstJumpIfFalseCommand(uint16 slot, int64 constant);
 
-	uint32 AddPushLoopCommand();
+	uint32 AddPushLoopCommand(bool hasScope);
 	void AddPopLoopCommand();
 
 	void AddSetCommand(uint16 assignFunctionID);
@@ -131,8 +122,10 @@ public:
 
 	void AddModuleConstantCommand(uint16 moduleID, uint16 constant);
 	void AddModuleFunctionCallCommand(uint16 moduleID, uint16 functionID, uint8 argCount, bool usesReturnValue);
+	void AddNativeCallCommand(const NativeFunctionDesc* function, bool usesReturnValue, bool reuseFirstArg);
 	void AddStaticFunctionCallCommand(uint16 classID, uint16 functionID, bool usesReturnValue);
 	void AddReturnCommand(uint8 returnInfo);
+	void AddYieldCommand(bool hasValue);
 	void AddMemberFunctionCallCommand(uint16 classID, uint16 functionID, bool usesReturnValue);
 	void AddConstructorCallCommand(uint16 type, uint16 functionID);
 	void AddVirtualFunctionCallCommand(uint16 functionID, bool usesReturnValue);
@@ -140,8 +133,8 @@ public:
 	void AddUnaryUpdateCommand(uint8 op, bool pushToStack);
 	void AddAritmaticCommand(Operator op, uint16 functionID);
 
-	void AddNewCommand(uint16 type, uint16 functionID);
-	void AddNewArrayCommand(uint16 type, uint8 pointerLevel);
+	void AddNewCommand(uint16 type, uint16 functionID, bool inArena = false);
+	void AddNewArrayCommand(uint16 type, uint8 pointerLevel, bool inArena = false);
 
 	void AddCastCommand(uint16 targetType, uint8 targetPointerLevel);
 
@@ -156,6 +149,8 @@ public:
 	void WriteReal32(real32 value);
 	void WriteReal64(real64 value);
 	void WriteOPCode(OpCode code);
+	uint32 WriteVarUInt(uint64 value);
+	uint32 WriteVarInt(int64 value);
 	void WriteCStr(char* cstr);
 
 	void PatchUInt32(uint32 pos, uint32 value);
@@ -168,97 +163,77 @@ public:
 	std::string GetTypeName(uint16 type);
 	Class* GetClass(uint16 id);
 	Class* GetClassByName(const std::string& name);
+	Function* GetFunctionFromReference(uint32 reference, uint16* classID = nullptr);
 	uint16 GetModuleID(const std::string& name);
 	void AddModule(const std::string& name, uint16 id);
 	uint64 GetTypeSize(uint16 type);
+	uint64 GetTypeAlignment(uint16 type);
 	uint16 GetTypeID(const std::string& name);
 
 	uint32 GetCodeSize() const;
+	inline uint64 GetEncodingSavings() const { return m_EncodingSavings; }
 
 	bool Resolve();
 	void BuildVTables();
 	void EmitCode();
 
-	inline BumpAllocator* GetStackAllocator() const { return m_StackAllocator; }
+	// Emits the static initializers followed by a jump to pc and releases the compile-time
+	// data. The Program is read-only from here on and can be shared by ExecutionContexts.
+	void PrepareForExecution(uint32 pc);
+	inline uint32 GetEntryPC() const { return m_EntryPC; }
+	inline const uint8* GetCode() const { return m_Code.data(); }
+
 	inline HeapAllocator* GetHeapAllocator() const { return m_HeapAllocator; }
-	inline BumpAllocator* GetInitializationAllocator() const { return m_InitializationAllocator; }
+	inline ChanModuleState* GetChanModuleState() { return &m_ChanModuleState; }
 
-	inline uint32 GetStackSize() const { return m_Stack.size(); }
-	inline uint32 GetScopeStackSize() const { return m_CurrentScope + 1; }
-	inline uint32 GetLoopStackSize() const { return m_LoopStack.size(); }
+	// Host functions have to be set before parsing, their index is the function ID in the Host module
+	inline void SetHostFunctions(const std::vector<HostFunctionInfo>& functions) { m_HostFunctions = functions; }
+	inline const HostFunctionInfo& GetHostFunction(uint16 function) const { return m_HostFunctions[function]; }
+	uint16 GetHostFunctionID(const std::string& name) const;
 
-	inline void AddToStringPool(char* str) { m_StringPool.push_back(str); }
-	inline void AddCreatedExpression(ASTExpression* expr) { m_CreatedExpressions.push_back(expr); }
+	// Takes ownership of the plug-in and returns its module ID
+	uint16 AddPlugin(PluginModule* plugin);
+	inline PluginModule* GetPlugin(uint16 moduleID) const { return m_Plugins[moduleID - PLUGIN_MODULE_ID_BASE]; }
+	inline SegmentedBumpAllocator* GetInitializationAllocator() const { return m_InitializationAllocator; }
+	inline SegmentedBumpAllocator* GetASTAllocator() const { return m_ASTAllocator; }
 
-	inline Frame* GetFrame(uint32 frameIndex) { return m_FrameStack[frameIndex]; }
+	inline uint64 GetCompiledResidentSize() const { return m_CompiledResidentSize; }
+	inline uint64 GetExecutionResidentSize() const { return m_ExecutionResidentSize; }
 
-	inline Value StackBack() const { return m_Stack.back(); }
+	inline void SetPackAllClasses(bool pack) { m_PackAllClasses = pack; }
+	inline bool GetPackAllClasses() const { return m_PackAllClasses; }
+
+	inline void AddToStringPool(char* str) { m_StringPool.push_back(str); }
+	inline void AddCreatedExpression(ASTExpression* expr) { m_CreatedExpressions.push_back(expr); }
+	inline uint32 GetNumCreatedExpressions() const { return m_CreatedExpressions.size(); }
 
 	void PrintClassCodeSizes() const;
-public:
-	static Program* GetCompiledProgram();
+	void PrintPaddingReport() const;
 private:
-	void ExecuteOpCode(OpCode opcode);
-	void ExecuteModuleFunctionCall(uint16 moduleID, uint16 functionID, bool usesReturnValue);
-	void ExecuteModuleConstant(uint16 moduleID, uint16 constant);
-	void ExecuteAssignFunction(const Value& dstValue, const Value& assignValue, Function* function);
-	void ExecuteArithmaticFunction(const Value& lhs, const Value& rhs, Function* function);
-	void ExecuteCastFunction(const Value& dstValue, const Value& srcValue, Function* function);
-
-	void AddFunctionArgsToFrame(Frame* frame, Function* function, bool readCastFunctionID = true);
-	void AddDestructorRecursive(const Value& value);
-	void ExecutePendingDestructors(uint32 offset);
-	void AddConstructorRecursive(const Value& value, bool addValue = false);
-	void ExecutePendingConstructors(uint32 offset);
-	void AddCopyConstructorRecursive(const Value& dst, const Value& src);
-	void ExecutePendingCopyConstructors(uint32 offset);
-
 	void CleanUpForExecution();
 	void InitStatics();
-
-	uint64 ReadUInt64();
-	uint32 ReadUInt32();
-	uint16 ReadUInt16();
-	uint8 ReadUInt8();
-	int8 ReadInt8();
-	int16 ReadInt16();
-	int32 ReadInt32();
-	int64 ReadInt64();
-	real32 ReadReal32();
-	real64 ReadReal64();
-	OpCode ReadOPCode();
-	char* ReadCStr();
 private:
 	std::vector<Class*> m_Classes;
 	std::unordered_map<std::string, uint16> m_ClassNameMap;
 	std::unordered_map<std::string, uint16> m_ModuleNameMap;
 	uint16 m_ClassWithMainFunction;
 
-	std::vector<Value> m_Stack;
 	std::vector<uint8> m_Code;
-	uint32 m_ProgramCounter;
-
-	std::vector<Value> m_ArgStorage;
-
-	FramePool m_FramePool;
-	std::vector<Frame*> m_FrameStack;
-	std::vector<CallFrame> m_CallStack;
-	std::vector<ScopeInfo> m_ScopeStack;
-	int32 m_CurrentScope;
-	std::vector<LoopFrame> m_LoopStack;
-	std::vector<Value> m_ThisStack;
+	uint32 m_EntryPC;
+	uint64 m_EncodingSavings; // Bytes saved compared to the fixed-width operand encoding
 
+	bool m_PackAllClasses;
+	uint64 m_CompiledResidentSize;
+	uint64 m_ExecutionResidentSize;
 	std::vector<char*> m_StringPool;
-	uint32 m_Dimensions[MAX_ARRAY_DIMENSIONS];
-
-	BumpAllocator* m_StackAllocator;
-	HeapAllocator* m_HeapAllocator;
-	BumpAllocator* m_InitializationAllocator;
-	BumpAllocator* m_ReturnAllocator;
 
-	std::vector<Value> m_PendingDestructors;
-	std::vector<std::pair<Value, Function*>> m_PendingConstructors;
-	std::vector<PendingCopyConstructor> m_PendingCopyConstructors;
+	HeapAllocator* m_HeapAllocator; // String literals and static data
+	SegmentedBumpAllocator* m_InitializationAllocator; // Literal values referenced by the AST
+	SegmentedBumpAllocator* m_ASTAllocator; // Owns every ASTExpression, released in one go before execution
 
 	std::vector<ASTExpression*> m_CreatedExpressions;
+
+	ChanModuleState m_ChanModuleState; // Shared by every context executing this Program
+	std::vector<HostFunctionInfo> m_HostFunctions;
+	std::vector<PluginModule*> m_Plugins; // Unloaded last, after everything that could call into them
 };
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "Scheduler.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+// Orders the entries as a min-heap on time, equal times run in the order they were scheduled
+static bool RunsLater(const ScheduledEntry& a, const ScheduledEntry& b)
+{
+	if (a.time != b.time)
+		return a.time > b.time;
+
+	return a.sequence > b.sequence;
+}
+
+Scheduler::Scheduler()
+{
+	m_NextSequence = 1;
+	m_Time = 0.0;
+}
+
+uint32 Scheduler::Allocate()
+{
+	uint32 slot;
+	if (!m_FreeSlots.empty())
+	{
+		slot = m_FreeSlots.back();
+		m_FreeSlots.pop_back();
+	}
+	else
+	{
+		if (m_Generations.size() + 1 >= (1u << SCHEDULER_HANDLE_SLOT_BITS))
+			throw std::runtime_error("Too many scheduler handles");
+
+		m_Generations.push_back(0);
+		m_Sequences.push_back(0);
+		slot = m_Generations.size() - 1;
+	}
+
+	return (m_Generations[slot] << SCHEDULER_HANDLE_SLOT_BITS) | (slot + 1);
+}
+
+void Scheduler::Release(uint32 handle)
+{
+	uint32 slot = GetSlot(handle);
+	m_Sequences[slot] = 0;
+	m_Generations[slot] = (m_Generations[slot] + 1) & ((1u << (32 - SCHEDULER_HANDLE_SLOT_BITS)) - 1);
+	m_FreeSlots.push_back(slot);
+}
+
+uint32 Scheduler::GetSlot(uint32 handle) const
+{
+	uint32 slot = (handle & ((1u << SCHEDULER_HANDLE_SLOT_BITS) - 1)) - 1;
+	if (slot >= m_Generations.size() || m_Generations[slot] != handle >> SCHEDULER_HANDLE_SLOT_BITS)
+		return UINT32_MAX;
+
+	return slot;
+}
+
+void Scheduler::Schedule(uint32 handle, real64 time)
+{
+	// An earlier entry of the same handle stays in the heap and is skipped once it comes up
+	uint64 sequence = m_NextSequence++;
+	m_Sequences[GetSlot(handle)] = sequence;
+	m_Entries.push_back({ time, sequence, handle });
+	std::push_heap(m_Entries.begin(), m_Entries.end(), RunsLater);
+}
+
+void Scheduler::Unschedule(uint32 handle)
+{
+	m_Sequences[GetSlot(handle)] = 0;
+}
+
+bool Scheduler::IsScheduled(uint32 handle) const
+{
+	uint32 slot = GetSlot(handle);
+	return slot != UINT32_MAX && m_Sequences[slot] != 0;
+}
+
+uint32 Scheduler::Update(ExecutionContext* context, real64 dt, ScheduledFunction function)
+{
+	m_Time += dt;
+
+	// Take every due entry first, so the calls cannot add entries to this update
+	std::vector<ScheduledEntry> due;
+	while (!m_Entries.empty() && m_Entries.front().time <= m_Time)
+	{
+		std::pop_heap(m_Entries.begin(), m_Entries.end(), RunsLater);
+		due.push_back(m_Entries.back());
+		m_Entries.pop_back();
+	}
+
+	uint32 calls = 0;
+	for (uint32 i = 0; i < due.size(); i++)
+	{
+		const ScheduledEntry& entry = due[i];
+		uint32 slot = GetSlot(entry.handle);
+		if (slot == UINT32_MAX || m_Sequences[slot] != entry.sequence)
+			continue;
+
+		m_Sequences[slot] = 0;
+		try
+		{
+			function(context, entry.handle, entry.time);
+		}
+		catch (...)
+		{
+			for (uint32 j = i + 1; j < due.size(); j++)
+			{
+				m_Entries.push_back(due[j]);
+				std::push_heap(m_Entries.begin(), m_Entries.end(), RunsLater);
+			}
+			throw;
+		}
+		calls++;
+	}
+
+	return calls;
+}
+
+void Scheduler::Clear()
+{
+	m_Generations.clear();
+	m_Sequences.clear();
+	m_FreeSlots.clear();
+	m_Entries.clear();
+	m_NextSequence = 1;
+}
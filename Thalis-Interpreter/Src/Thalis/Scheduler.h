@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+
+#include "Common.h"
+
+#define SCHEDULER_HANDLE_SLOT_BITS 20
+
+class ExecutionContext;
+
+// Runs the work behind one due handle, time is when it was due. Scheduler::Update marks the
+// handle as not scheduled before the call, so the function may schedule or release it again.
+typedef void (*ScheduledFunction)(ExecutionContext* context, uint32 handle, real64 time);
+
+struct ScheduledEntry
+{
+	real64 time;
+	uint64 sequence; // Breaks ties in scheduling order and invalidates stale entries
+	uint32 handle;
+};
+
+// Hands out handles to slots and runs them in order of time, the modules keep what a slot
+// stands for in their own vectors indexed by GetSlot. 0 is never a valid handle. The low
+// SCHEDULER_HANDLE_SLOT_BITS of a handle are the slot plus one, the rest the slot's generation,
+// which changes every time the slot is released so a handle kept past Release stays invalid.
+// Scheduled handles sit in a min-heap ordered by time, an update only touches the due ones.
+class Scheduler
+{
+public:
+	Scheduler();
+
+	// Throws once every slot is taken
+	uint32 Allocate();
+	void Release(uint32 handle);
+
+	// UINT32_MAX for stale or invalid handles
+	uint32 GetSlot(uint32 handle) const;
+
+	// Replaces the handle's earlier entry, if it had one
+	void Schedule(uint32 handle, real64 time);
+	void Unschedule(uint32 handle);
+	bool IsScheduled(uint32 handle) const;
+
+	// Advances the clock by dt and calls function for every entry that is due by then, in order.
+	// Entries scheduled by the calls run on a later update at the earliest. If a call throws, the
+	// entries that did not get their turn stay scheduled. Returns the number of calls.
+	uint32 Update(ExecutionContext* context, real64 dt, ScheduledFunction function);
+
+	inline real64 GetTime() const { return m_Time; }
+
+	void Clear();
+private:
+	std::vector<uint32> m_Generations;
+	std::vector<uint64> m_Sequences; // Matches the entry that is still valid, 0 when not scheduled
+	std::vector<uint32> m_FreeSlots;
+	std::vector<ScheduledEntry> m_Entries;
+	uint64 m_NextSequence;
+	real64 m_Time;
+};
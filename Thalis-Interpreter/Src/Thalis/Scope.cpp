@@ -4,79 +4,100 @@ Scope::Scope(Scope* parent)
     : m_Parent(parent)
 {
     m_FunctionScope = parent ? parent->m_FunctionScope : this;
+    m_FirstLocal = m_FunctionScope->m_FunctionLocals.size();
+
+    // Slots are handed out like a stack, a block starts where its parent currently ends
+    // so sibling blocks and blocks that already ended share the same slots
+    m_NextSlot = parent ? parent->m_NextSlot : 0;
+}
+
+Scope::~Scope()
+{
+    if (m_FunctionScope != this)
+    {
+        std::vector<ScopeLocal>& locals = m_FunctionScope->m_FunctionLocals;
+        locals.erase(locals.begin() + m_FirstLocal, locals.end());
+    }
 }
 
 uint16 Scope::AddLocal(const std::string& name, const TypeInfo& typeInfo, const std::string& templateTypeName, TemplateInstantiationCommand* command)
 {
-    // This block scope's locals map is only for checking shadowing
-    if (m_Locals.find(name) != m_Locals.end())
+    std::vector<ScopeLocal>& locals = m_FunctionScope->m_FunctionLocals;
+
+    // Only this block is checked, names of enclosing blocks may be shadowed
+    for (uint32 i = m_FirstLocal; i < locals.size(); i++)
     {
-        // redeclaration in the same block
-        return m_Locals[name];
+        if (locals[i].name == name)
+        {
+            // redeclaration in the same block
+            return locals[i].slot;
+        }
     }
 
-    // This functions local slot index
-    uint16 slot = m_FunctionScope->m_LocalCount++;
+    // This function's local slot index, the function keeps the highest slot count of any block
+    uint16 slot = m_NextSlot++;
+    if (m_NextSlot > m_FunctionScope->m_LocalCount)
+        m_FunctionScope->m_LocalCount = m_NextSlot;
 
-    // Track this name in THIS block only for shadowing
-    m_Locals[name] = slot;
-    m_VariableTypes[slot] = { typeInfo, templateTypeName, command};
+    ScopeLocal local;
+    local.name = name;
+    local.slot = slot;
+    local.declaration = { typeInfo, templateTypeName, command };
+    locals.push_back(local);
 
     return slot;
 }
 
 uint16 Scope::Resolve(const std::string& name)
 {
-    Scope* scope = this;
-
-    while (scope != nullptr)
+    const std::vector<ScopeLocal>& locals = m_FunctionScope->m_FunctionLocals;
+    for (int32 i = (int32)locals.size() - 1; i >= 0; i--)
     {
-        auto it = scope->m_Locals.find(name);
-        if (it != scope->m_Locals.end())
-        {
-            return it->second;
-        }
-
-        scope = scope->m_Parent;
+        if (locals[i].name == name)
+            return locals[i].slot;
     }
 
     return INVALID_ID;
 }
 
-TypeInfo Scope::GetLocalTypeInfo(uint16 slot) const
+const ScopeLocal* Scope::FindSlot(uint16 slot) const
 {
-    const auto&& it = m_VariableTypes.find(slot);
-    if (it == m_VariableTypes.end())
+    // Ended sibling blocks are already gone, so the latest declaration of a slot is the live one
+    const std::vector<ScopeLocal>& locals = m_FunctionScope->m_FunctionLocals;
+    for (int32 i = (int32)locals.size() - 1; i >= 0; i--)
     {
-        if (m_Parent) return m_Parent->GetLocalTypeInfo(slot);
-        return TypeInfo(INVALID_ID, 0);
+        if (locals[i].slot == slot)
+            return &locals[i];
     }
 
-    return it->second.type;
+    return nullptr;
+}
+
+TypeInfo Scope::GetLocalTypeInfo(uint16 slot) const
+{
+    const ScopeLocal* local = FindSlot(slot);
+    if (!local)
+        return TypeInfo(INVALID_ID, 0);
+
+    return local->declaration.type;
 }
 
 std::string Scope::GetLocalTemplateType(uint16 slot) const
 {
-    const auto&& it = m_VariableTypes.find(slot);
-    if (it == m_VariableTypes.end())
-    {
-        if (m_Parent) return m_Parent->GetLocalTemplateType(slot);
+    const ScopeLocal* local = FindSlot(slot);
+    if (!local)
         return "";
-    }
 
-    return it->second.templateTypeName;
+    return local->declaration.templateTypeName;
 }
 
 ScopeLocalDeclaration Scope::GetDeclarationInfo(uint16 slot) const
 {
-    const auto&& it = m_VariableTypes.find(slot);
-    if (it == m_VariableTypes.end())
-    {
-        if (m_Parent) return m_Parent->GetDeclarationInfo(slot);
+    const ScopeLocal* local = FindSlot(slot);
+    if (!local)
         return { TypeInfo(INVALID_ID, 0), "", nullptr };
-    }
 
-    return it->second;
+    return local->declaration;
 }
 
 uint16 Scope::GetNumLocals() const
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <string>
-#include <unordered_map>
 #include <vector>
 #include "Common.h"
 #include "TypeInfo.h"
@@ -15,10 +14,21 @@ struct ScopeLocalDeclaration
     uint16 derivedType;
 };
 
+struct ScopeLocal
+{
+    std::string name;
+    uint16 slot;
+    ScopeLocalDeclaration declaration;
+};
+
+// Locals of a function and all its blocks live in one array owned by the function scope.
+// Blocks are parsed strictly nested, so a block owns the tail of that array from m_FirstLocal
+// and gives it back when it is destroyed. Lookups scan from the innermost declaration outwards.
 class Scope
 {
 public:
     Scope(Scope* parent = nullptr);
+    ~Scope();
     uint16 AddLocal(const std::string& name, const TypeInfo& typeInfo, const std::string& templateTypeName, TemplateInstantiationCommand* command = nullptr);
     uint16 Resolve(const std::string& name);
 
@@ -27,10 +37,13 @@ public:
     ScopeLocalDeclaration GetDeclarationInfo(uint16 slot) const;
 
     uint16 GetNumLocals() const;
+private:
+    const ScopeLocal* FindSlot(uint16 slot) const;
 private:
     Scope* m_Parent;
     Scope* m_FunctionScope;
-    std::unordered_map<std::string, uint16> m_Locals;
-    std::unordered_map<uint16, ScopeLocalDeclaration> m_VariableTypes;
+    std::vector<ScopeLocal> m_FunctionLocals; // Only used by the function scope
+    uint32 m_FirstLocal;
     uint16 m_LocalCount = 0;
+    uint16 m_NextSlot = 0;
 };
\ No newline at end of file
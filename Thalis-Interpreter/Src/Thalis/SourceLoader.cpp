@@ -0,0 +1,111 @@
+#include "SourceLoader.h"
+#include <thread>
+#include <filesystem>
+
+SourceLoader::SourceLoader(uint32 numThreads)
+{
+	m_NumThreads = std::max(numThreads, 1u);
+	m_NumLoading = 0;
+}
+
+SourceLoader::~SourceLoader()
+{
+	for (uint32 i = 0; i < m_Files.size(); i++)
+	{
+		free(m_Files[i]->contents);
+		delete m_Files[i];
+	}
+}
+
+void SourceLoader::Load(const std::string& path)
+{
+	Enqueue(path);
+
+	std::vector<std::thread> threads;
+	for (uint32 i = 1; i < m_NumThreads; i++)
+		threads.push_back(std::thread(&SourceLoader::WorkerLoop, this));
+
+	WorkerLoop();
+	for (uint32 i = 0; i < threads.size(); i++)
+		threads[i].join();
+}
+
+SourceFile* SourceLoader::Find(const std::string& path)
+{
+	auto it = m_FilesByPath.find(std::filesystem::absolute(path).generic_string());
+	if (it == m_FilesByPath.end() || !it->second->contents)
+		return nullptr;
+
+	return it->second;
+}
+
+void SourceLoader::WorkerLoop()
+{
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	while (true)
+	{
+		// Done once nothing is queued and no file that is still loading can queue more
+		m_WakeCondition.wait(lock, [this] { return !m_Queue.empty() || m_NumLoading == 0; });
+		if (m_Queue.empty())
+			break;
+
+		SourceFile* file = m_Queue.back();
+		m_Queue.pop_back();
+		m_NumLoading++;
+
+		lock.unlock();
+		LoadFile(file);
+		lock.lock();
+
+		for (uint32 i = 0; i < file->imports.size(); i++)
+			Enqueue(file->imports[i]);
+
+		m_NumLoading--;
+		m_WakeCondition.notify_all();
+	}
+}
+
+void SourceLoader::LoadFile(SourceFile* file)
+{
+	FILE* handle = fopen(file->path.c_str(), "rb");
+	if (!handle)
+		return;
+
+	fseek(handle, 0, SEEK_END);
+	file->size = ftell(handle);
+	fseek(handle, 0, SEEK_SET);
+	file->contents = (char*)malloc(file->size + 1);
+	fread(file->contents, 1, file->size, handle);
+	file->contents[file->size] = 0;
+	fclose(handle);
+
+	Tokenizer::Tokenize(file->contents, file->tokens);
+
+	// Only top level imports are parsed, anything else found here is loaded for nothing
+	for (uint32 i = 0; i + 1 < file->tokens.size(); i++)
+	{
+		const Token& path = file->tokens[i + 1];
+		if (file->tokens[i].type != TokenTypeT::IMPORT || path.type != TokenTypeT::STRING_LITERAL)
+			continue;
+
+		std::string import(path.text, path.length);
+		std::string extension = std::filesystem::path(import).extension().generic_string();
+		if (extension != ".so" && extension != ".dll" && extension != ".dylib")
+			file->imports.push_back(import);
+	}
+}
+
+void SourceLoader::Enqueue(const std::string& path)
+{
+	std::string absPath = std::filesystem::absolute(path).generic_string();
+	if (m_FilesByPath.find(absPath) != m_FilesByPath.end())
+		return;
+
+	SourceFile* file = new SourceFile();
+	file->path = absPath;
+	file->contents = nullptr;
+	file->size = 0;
+	m_Files.push_back(file);
+	m_FilesByPath[absPath] = file;
+	m_Queue.push_back(file);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+
+#include "Tokenizer.h"
+
+// A script file read and tokenized ahead of parsing
+struct SourceFile
+{
+	std::string path; // Absolute, imports are matched against it
+	char* contents;   // nullptr if the file could not be read
+	uint64 size;
+	std::vector<Token> tokens;
+	std::vector<std::string> imports; // Script files it imports, as written
+};
+
+// Discovers the import graph from the main file and reads and tokenizes every file on a
+// pool of threads, a file's imports are queued as soon as it is tokenized. The parser still
+// consumes the files in its usual serial order, so the program does not depend on the
+// number of threads or on the order the files finished in.
+class SourceLoader
+{
+public:
+	SourceLoader(uint32 numThreads);
+	~SourceLoader();
+
+	void Load(const std::string& path);
+
+	// nullptr if the file was not discovered or could not be read
+	SourceFile* Find(const std::string& path);
+
+	inline uint32 GetNumFiles() const { return m_Files.size(); }
+private:
+	void WorkerLoop();
+	void LoadFile(SourceFile* file);
+	void Enqueue(const std::string& path);
+private:
+	uint32 m_NumThreads;
+	std::vector<SourceFile*> m_Files;
+	std::unordered_map<std::string, SourceFile*> m_FilesByPath;
+
+	std::mutex m_Mutex;
+	std::condition_variable m_WakeCondition;
+	std::vector<SourceFile*> m_Queue;
+	uint32 m_NumLoading;
+};
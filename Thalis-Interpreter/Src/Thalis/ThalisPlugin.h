@@ -0,0 +1,28 @@
+#pragma once
+
+// The header native plug-in modules include. A plug-in is a shared library exporting
+// THALIS_PLUGIN_ENTRY, which returns a description of its functions and constants. Scripts
+// load it with Import <Name>; and call it like a built-in module, Name.Function(...).
+
+#include "NativeFunction.h"
+
+#define THALIS_PLUGIN_ABI_VERSION 1
+#define THALIS_PLUGIN_ENTRY "ThalisGetModule"
+
+#if defined(_WIN32)
+#define THALIS_PLUGIN_EXPORT extern "C" __declspec(dllexport)
+#else
+#define THALIS_PLUGIN_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+struct PluginModuleDesc
+{
+	uint32_t abiVersion; // THALIS_PLUGIN_ABI_VERSION the plug-in was built against
+	const char* name;
+	const NativeFunctionDesc* functions;
+	uint32_t numFunctions;
+	const NativeConstantDesc* constants;
+	uint32_t numConstants;
+};
+
+typedef const PluginModuleDesc* (*PluginEntry)();
@@ -97,6 +97,20 @@ static bool StringEqual(const char* s1, uint32 l1, const char* s2, uint32 l2)
 }
 
 Token Tokenizer::GetToken()
+{
+	if (tokens)
+	{
+		Token token = tokens[tokenIndex];
+		if (token.type != TokenTypeT::END)
+			tokenIndex++;
+
+		return token;
+	}
+
+	return ReadToken();
+}
+
+Token Tokenizer::ReadToken()
 {
 	EatWhitespace();
 
@@ -105,6 +119,7 @@ Token Tokenizer::GetToken()
 	token.text = at;
 	token.line = currentLine;
 	token.column = currentColumn;
+	token.index = 0;
 
 	switch (at[0])
 	{
@@ -403,8 +418,24 @@ Token Tokenizer::GetToken()
 				token.type = TokenTypeT::INT_TO_STR;
 			else if (StringEqual(token.text, token.length, "offsetof", 8))
 				token.type = TokenTypeT::OFFSETOF;
+			else if (StringEqual(token.text, token.length, "istrivial", 9))
+				token.type = TokenTypeT::IS_TRIVIAL;
 			else if (StringEqual(token.text, token.length, "breakpoint", 10))
 				token.type = TokenTypeT::BREAKPOINT;
+			else if (StringEqual(token.text, token.length, "align", 5))
+				token.type = TokenTypeT::ALIGN;
+			else if (StringEqual(token.text, token.length, "packed", 6))
+				token.type = TokenTypeT::PACKED;
+			else if (StringEqual(token.text, token.length, "fieldcount", 10))
+				token.type = TokenTypeT::FIELD_COUNT;
+			else if (StringEqual(token.text, token.length, "fieldoffset", 11))
+				token.type = TokenTypeT::FIELD_OFFSET;
+			else if (StringEqual(token.text, token.length, "fieldsize", 9))
+				token.type = TokenTypeT::FIELD_SIZE;
+			else if (StringEqual(token.text, token.length, "fieldindex", 10))
+				token.type = TokenTypeT::FIELD_INDEX;
+			else if (StringEqual(token.text, token.length, "yield", 5))
+				token.type = TokenTypeT::YIELD;
 		}
 		else if (IsNumber(at[0]))
 		{
@@ -456,6 +487,9 @@ bool Tokenizer::Expect(TokenTypeT type, Token* token)
 
 Token Tokenizer::PeekToken()
 {
+	if (tokens)
+		return tokens[tokenIndex];
+
 	char* prev = at;
 	Token token = GetToken();
 	at = prev;
@@ -464,7 +498,24 @@ Token Tokenizer::PeekToken()
 
 void Tokenizer::SetPeek(const Token& peek)
 {
-	at = peek.text;
+	if (tokens)
+		tokenIndex = peek.index;
+	else
+		at = peek.text;
+}
+
+void Tokenizer::Tokenize(char* text, std::vector<Token>& tokens)
+{
+	Tokenizer tokenizer;
+	tokenizer.at = text;
+	while (true)
+	{
+		Token token = tokenizer.ReadToken();
+		token.index = tokens.size();
+		tokens.push_back(token);
+		if (token.type == TokenTypeT::END)
+			break;
+	}
 }
 
 bool Tokenizer::IsTokenPrimitiveType(const Token& token)
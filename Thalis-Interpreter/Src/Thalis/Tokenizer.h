@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "Common.h"
 
 enum class TokenTypeT
@@ -17,7 +19,8 @@ enum class TokenTypeT
 	IF, ELSE, FOR, WHILE, TRUE_T, FALSE_T,
 	TEMPLATE, ARROW,
 	BITSHIFT_LEFT, BITSHIFT_RIGHT,
-	STRLEN, BREAK, CONTINUE, INHERIT, VIRTUAL, STR_TO_INT, INT_TO_STR, OFFSETOF, BREAKPOINT,
+	STRLEN, BREAK, CONTINUE, INHERIT, VIRTUAL, STR_TO_INT, INT_TO_STR, OFFSETOF, IS_TRIVIAL, BREAKPOINT, ALIGN, PACKED,
+	FIELD_COUNT, FIELD_OFFSET, FIELD_SIZE, FIELD_INDEX, YIELD,
 };
 
 struct Token
@@ -28,6 +31,7 @@ struct Token
 
 	uint32 line;
 	uint32 column;
+	uint32 index; // Position in the token list of a pre-tokenized file
 };
 
 struct Tokenizer
@@ -37,12 +41,18 @@ struct Tokenizer
 	uint32 currentLine = 1;
 	uint32 currentColumn = 1;
 
+	// Set for files tokenized ahead of parsing, tokens are then handed out from the list instead of the text
+	const Token* tokens = nullptr;
+	uint32 tokenIndex = 0;
+
 	Token GetToken();
 	bool Expect(TokenTypeT type, Token* token = nullptr);
 	Token PeekToken();
 	void SetPeek(const Token& peek);
 
 	static bool IsTokenPrimitiveType(const Token& token);
+	static void Tokenize(char* text, std::vector<Token>& tokens);
 private:
+	Token ReadToken();
 	void EatWhitespace();
 };
\ No newline at end of file
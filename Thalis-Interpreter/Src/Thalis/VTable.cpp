@@ -32,9 +32,9 @@ static int32 GetConversionScore(Program* program, const TypeInfo& from, const Ty
 	{
 		Class* toClass = program->GetClass(to.type);
 		std::vector<ASTExpression*> args;
-		args.push_back(new ASTExpressionDummy(from));
+		args.push_back(new (program) ASTExpressionDummy(from));
 		std::vector<uint16> cf;
-		uint16 functionID = toClass->GetFunctionID(toClass->GetName(), args, cf);
+		uint16 functionID = toClass->GetFunctionID(program, toClass->GetName(), args, cf);
 		if (functionID == INVALID_ID) return -1;
 		*castFunctionID = functionID;
 	}
@@ -78,10 +78,8 @@ static int32 GetConversionScore(Program* program, const TypeInfo& from, const Ty
 	return -1; // incompatible
 }
 
-int32 VTable::FindSlot(const std::string& name, const std::vector<TypeInfo>& parameters)
+int32 VTable::FindSlot(Program* program, const std::string& name, const std::vector<TypeInfo>& parameters)
 {
-	Program* program = Program::GetCompiledProgram();
-
 	Function* bestFunc = nullptr;
 	int32 bestID = INVALID_ID;
 	int bestScore = INT_MAX;
@@ -89,7 +87,7 @@ int32 VTable::FindSlot(const std::string& name, const std::vector<TypeInfo>& par
 	for (uint32 i = 0; i < functions.size(); i++)
 	{
 		Function* function = functions[i];
-		std::string sig = function->GenerateSignature();
+		std::string sig = function->GenerateSignature(program);
 
 		if (sig.rfind(name + "-", 0) != 0)
 			continue;
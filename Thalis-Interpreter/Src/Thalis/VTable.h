@@ -6,12 +6,14 @@
 #include "TypeInfo.h"
 
 struct Function;
+class Program;
 struct VTable
 {
 	std::vector<Function*> functions;
+	uint16 classID; // Dynamic type of the objects pointing at this table
 
 	VTable& operator=(const VTable& other);
 
-	int32 FindSlot(const std::string& name, const std::vector<TypeInfo>& parameters);
+	int32 FindSlot(Program* program, const std::string& name, const std::vector<TypeInfo>& parameters);
 	inline Function* GetFunction(uint16 slot) { return functions[slot]; }
 };
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "Value.h"
 #include "Program.h"
 #include "Class.h"
+#include "Memory/Memory.h"
+#include <algorithm>
 
 Value Value::Clone(Program* program, Allocator* allocator) const
 {
@@ -36,6 +38,7 @@ Value Value::CastTo(Program* program, uint16 newType, uint8 pointerLevel, Alloca
 	Value value;
 	value.type = newType;
 	value.pointerLevel = pointerLevel;
+	value.isArray = false;
 	value.isReference = false;
 	if (IsPointer())
 	{
@@ -120,12 +123,13 @@ Value Value::MakeArray(Program* program, uint16 type, uint8 elementPointerLevel,
 		numElements *= dimension[i];
 	}
 
-	uint64 arrayDataSize = typeSize * numElements + sizeof(ArrayHeader);
-	uint8* arrayData = (uint8*)allocator->Alloc(arrayDataSize);
+	uint64 headerSize = GetArrayHeaderSize(program, type, elementPointerLevel);
+	uint64 arrayDataSize = typeSize * numElements + headerSize;
+	uint8* arrayData = (uint8*)allocator->AllocAligned(arrayDataSize, GetArrayAlignment(program, type, elementPointerLevel));
 	memset(arrayData, 0, arrayDataSize);
-	memcpy(arrayData, &header, sizeof(ArrayHeader));
 
-	uint8* elements = arrayData + sizeof(ArrayHeader);
+	uint8* elements = arrayData + headerSize;
+	memcpy(elements - sizeof(ArrayHeader), &header, sizeof(ArrayHeader));
 	if (elementPointerLevel == 0 && !IsPrimitiveType(type))
 	{
 		Class* cls = program->GetClass(type);
@@ -150,20 +154,33 @@ Value Value::MakeArray(Program* program, uint16 type, uint8 elementPointerLevel,
 	return array;
 }
 
+uint64 Value::GetArrayAlignment(Program* program, uint16 type, uint8 elementPointerLevel)
+{
+	uint64 alignment = elementPointerLevel == 0 ? program->GetTypeAlignment(type) : alignof(void*);
+	return std::max<uint64>(alignment, alignof(ArrayHeader));
+}
+
+uint64 Value::GetArrayHeaderSize(Program* program, uint16 type, uint8 elementPointerLevel)
+{
+	// The header is padded in front so the first element starts on its alignment
+	return Memory::AlignUp(sizeof(ArrayHeader), GetArrayAlignment(program, type, elementPointerLevel));
+}
+
 Value Value::MakeObject(Program* program, uint16 type, Allocator* allocator)
 {
 	Class* cls = program->GetClass(type);
 	uint64 typeSize = cls->GetSize();
 
-	uint64 totalSize = sizeof(VTable*) + typeSize;
-	uint8* memory = (uint8*)allocator->Alloc(totalSize);
+	uint64 headerSize = cls->GetObjectHeaderSize();
+	uint64 totalSize = headerSize + typeSize;
+	uint8* memory = (uint8*)allocator->AllocAligned(totalSize, cls->GetObjectAlignment());
 
-	*(VTable**)memory = cls->GetVTable();
+	*(VTable**)(memory + headerSize - sizeof(VTable*)) = cls->GetVTable();
 
 	Value value;
 	value.type = type;
 	value.pointerLevel = 0;
-	value.data = memory + sizeof(VTable*);
+	value.data = memory + headerSize;
 	value.isArray = false;
 	value.isReference = false;
 
@@ -1189,5 +1189,7 @@ struct Value
 	}
 
 	static Value MakeArray(Program* program, uint16 type, uint8 elementPointerLevel, uint32* dimension, uint32 numDimensions, Allocator* allocator);
+	static uint64 GetArrayAlignment(Program* program, uint16 type, uint8 elementPointerLevel);
+	static uint64 GetArrayHeaderSize(Program* program, uint16 type, uint8 elementPointerLevel);
 	static Value MakeObject(Program* program, uint16 type, Allocator* allocator);
 };
\ No newline at end of file
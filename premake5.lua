@@ -10,6 +10,65 @@ workspace "Thalis-Dev"
 
 outputdir = "%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}"
 
+-- Everything but Main.cpp, for applications embedding the interpreter through Host.h
+project "libthalis"
+	location "Thalis-Interpreter"
+	kind "StaticLib"
+	language "C++"
+
+	targetdir ("Bin/"..outputdir.."/%{prj.name}")
+	objdir ("Bin-Int/"..outputdir.."/%{prj.name}")
+
+	includedirs
+	{
+		"Thalis-Interpreter/Libs/GLEW/include"
+	}
+
+	files
+	{
+		"Thalis-Interpreter/Src/**.h",
+		"Thalis-Interpreter/Src/**.hpp",
+		"Thalis-Interpreter/Src/**.inl",
+		"Thalis-Interpreter/Src/**.cpp",
+		"Thalis-Interpreter/Src/**.c"
+	}
+
+	removefiles
+	{
+		"Thalis-Interpreter/Src/Thalis/Main.cpp"
+	}
+
+	defines
+	{
+		"GLEW_STATIC"
+	}
+
+	filter "system:windows"
+		cppdialect "C++17"
+		staticruntime "On"
+		systemversion "10.0"
+
+		defines
+		{
+			"TLS_PLATFORM_WINDOWS"
+		}
+
+	filter "configurations:Debug"
+		defines "TLS_DEBUG"
+		symbols "On"
+		buildoptions "/MDd"
+
+	filter "configurations:Release"
+		defines "TLS_RELEASE"
+		optimize "On"
+		symbols "On"
+		buildoptions "/MD"
+
+	filter "configurations:Dist"
+		defines "TLS_DIST"
+		optimize "On"
+		buildoptions "/MD"
+
 project "Thalis-Interpreter"
 	location "Thalis-Interpreter"
 	kind "ConsoleApp"
@@ -20,22 +79,20 @@ project "Thalis-Interpreter"
 
 	includedirs
 	{
-		"%{prj.name}/Libs/GLEW/include"
+		"%{prj.name}/Libs/GLEW/include",
+		"%{prj.name}/Src/Thalis"
 	}
 
 	links
 	{
+		"libthalis",
 		"Thalis-Interpreter/Libs/GLEW/glew32s",
 		"opengl32",
 	}
 
 	files
 	{
-		"%{prj.name}/Src/**.h",
-		"%{prj.name}/Src/**.hpp",
-		"%{prj.name}/Src/**.inl",
-		"%{prj.name}/Src/**.cpp",
-		"%{prj.name}/Src/**.c"
+		"%{prj.name}/Src/Thalis/Main.cpp"
 	}
 
 	defines